@@ -274,6 +274,7 @@ void                            _clutter_actor_set_enable_paint_unmapped
 
 void                            _clutter_actor_set_has_pointer                          (ClutterActor *self,
                                                                                          gboolean      has_pointer);
+gboolean                        _clutter_actor_has_default_pick                         (ClutterActor *self);
 
 void                            _clutter_actor_queue_redraw_with_clip                   (ClutterActor       *self,
                                                                                          ClutterRedrawFlags  flags,
@@ -318,6 +319,12 @@ void                            _clutter_actor_queue_relayout_on_clones
 void                            _clutter_actor_queue_only_relayout                      (ClutterActor *actor);
 
 CoglFramebuffer *               _clutter_actor_get_active_framebuffer                   (ClutterActor *actor);
+gboolean                        _clutter_actor_get_visible_rect                         (ClutterActor *self,
+                                                                                         ClutterRect  *rect);
+gboolean                        _clutter_actor_get_background_color_set                 (ClutterActor *self,
+                                                                                         ClutterColor *color);
+
+guint                           _clutter_actor_get_saved_notifications                  (void);
 
 ClutterPaintNode *              clutter_actor_create_texture_paint_node                 (ClutterActor *self,
                                                                                          CoglTexture  *texture);
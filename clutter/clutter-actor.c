@@ -627,6 +627,7 @@
 #include "clutter-container.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
+#include "clutter-device-manager-private.h"
 #include "clutter-easing.h"
 #include "clutter-effect-private.h"
 #include "clutter-enum-types.h"
@@ -639,7 +640,7 @@
 #include "clutter-paint-node-private.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
-#include "clutter-property-transition.h"
+#include "clutter-property-transition-private.h"
 #include "clutter-scriptable.h"
 #include "clutter-script-private.h"
 #include "clutter-stage-private.h"
@@ -803,6 +804,13 @@ struct _ClutterActorPrivate
   gpointer create_child_data;
   GDestroyNotify create_child_notify;
 
+  /* the nesting level of the batch of animated properties being
+   * written, and the allocation before the batch began; see
+   * clutter_actor_batch_animated_properties()
+   */
+  guint animation_batch;
+  ClutterActorBox animation_batch_old;
+
   /* bitfields: KEEP AT THE END */
 
   /* fixed position and sizes */
@@ -840,6 +848,11 @@ struct _ClutterActorPrivate
   guint needs_compute_expand        : 1;
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
+  /* set if the geometry changed, or a relayout was queued, while
+   * writing a batch of animated properties
+   */
+  guint batch_geometry_changed      : 1;
+  guint batch_needs_relayout        : 1;
 };
 
 enum
@@ -1015,9 +1028,15 @@ typedef struct _TransitionClosure
   ClutterTransition *transition;
   gchar *name;
   gulong completed_id;
+
   guint is_implicit : 1;
 } TransitionClosure;
 
+/* the geometry notifications and relayouts coalesced while writing
+ * batches of animated properties
+ */
+static guint n_saved_notifications = 0;
+
 static void clutter_container_iface_init  (ClutterContainerIface  *iface);
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
 static void clutter_animatable_iface_init (ClutterAnimatableIface *iface);
@@ -1106,6 +1125,11 @@ static GQuark quark_actor_layout_info = 0;
 static GQuark quark_actor_transform_info = 0;
 static GQuark quark_actor_animation_info = 0;
 
+/* bumped every time an actor is added to or removed from a parent;
+ * used to validate the event chains cached by the input devices
+ */
+static guint32 hierarchy_serial = 0;
+
 G_DEFINE_TYPE_WITH_CODE (ClutterActor,
                          clutter_actor,
                          G_TYPE_INITIALLY_UNOWNED,
@@ -2376,6 +2400,16 @@ clutter_actor_notify_if_geometry_changed (ClutterActor          *self,
   ClutterActorPrivate *priv = self->priv;
   GObject *obj = G_OBJECT (self);
 
+  /* the geometry is compared with the one before the batch began
+   * once all the animated properties have been written
+   */
+  if (priv->animation_batch > 0)
+    {
+      priv->batch_geometry_changed = TRUE;
+      n_saved_notifications += 1;
+      return;
+    }
+
   g_object_freeze_notify (obj);
 
   /* to avoid excessive requisition or allocation cycles we
@@ -4149,6 +4183,8 @@ remove_child (ClutterActor *self,
   child->priv->parent = NULL;
   child->priv->prev_sibling = NULL;
   child->priv->next_sibling = NULL;
+
+  hierarchy_serial += 1;
 }
 
 typedef enum {
@@ -5923,6 +5959,11 @@ clutter_actor_dispose (GObject *object)
   /* parent must be gone at this point */
   g_assert (priv->parent == NULL);
 
+  /* top-level actors have no parent to be removed from, but they
+   * can still be the source of a cached event chain
+   */
+  hierarchy_serial += 1;
+
   if (!CLUTTER_ACTOR_IS_TOPLEVEL (self))
     {
       /* can't be mapped or realized with no parent */
@@ -9069,6 +9110,14 @@ clutter_actor_queue_relayout (ClutterActor *self)
 {
   g_return_if_fail (CLUTTER_IS_ACTOR (self));
 
+  /* queued once all the animated properties have been written */
+  if (self->priv->animation_batch > 0)
+    {
+      self->priv->batch_needs_relayout = TRUE;
+      n_saved_notifications += 1;
+      return;
+    }
+
   _clutter_actor_queue_only_relayout (self);
   clutter_actor_queue_redraw (self);
 }
@@ -12882,6 +12931,8 @@ clutter_actor_add_child_internal (ClutterActor              *self,
 
   g_assert (child->priv->parent == self);
 
+  hierarchy_serial += 1;
+
   self->priv->n_children += 1;
 
   self->priv->age += 1;
@@ -13917,6 +13968,18 @@ out:
   return retval;
 }
 
+/* only reactive actors are picked, so the pick caches of the stage
+ * are not valid any more when the reactive state of an actor changes
+ */
+static void
+clutter_actor_reactive_changed (ClutterActor *self)
+{
+  ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+  if (stage != NULL)
+    _clutter_stage_invalidate_pick_caches (CLUTTER_STAGE (stage));
+}
+
 /**
  * clutter_actor_set_reactive:
  * @actor: a #ClutterActor
@@ -13940,6 +14003,8 @@ clutter_actor_set_reactive (ClutterActor *actor,
   else
     CLUTTER_ACTOR_UNSET_FLAGS (actor, CLUTTER_ACTOR_REACTIVE);
 
+  clutter_actor_reactive_changed (actor);
+
   g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_REACTIVE]);
 }
 
@@ -15085,6 +15150,240 @@ clutter_actor_set_final_state (ClutterAnimatable *animatable,
   g_free (p_name);
 }
 
+/* writes the values interpolated by the animation table for the
+ * implicit transitions; see clutter_actor_set_animatable_property()
+ */
+static void
+clutter_actor_write_animated_property (GObject       *target,
+                                       GParamSpec    *pspec,
+                                       const gdouble *value)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (target);
+
+  g_object_freeze_notify (target);
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x_internal (actor, value[0]);
+      break;
+
+    case PROP_Y:
+      clutter_actor_set_y_internal (actor, value[0]);
+      break;
+
+    case PROP_POSITION:
+      {
+        ClutterPoint position = CLUTTER_POINT_INIT (value[0], value[1]);
+
+        clutter_actor_set_position_internal (actor, &position);
+      }
+      break;
+
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (actor, value[0]);
+      break;
+
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (actor, value[0]);
+      break;
+
+    case PROP_SIZE:
+      {
+        ClutterSize size = CLUTTER_SIZE_INIT (value[0], value[1]);
+
+        clutter_actor_set_size_internal (actor, &size);
+      }
+      break;
+
+    case PROP_DEPTH:
+      clutter_actor_set_depth_internal (actor, value[0]);
+      break;
+
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (actor, value[0]);
+      break;
+
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (actor, (guint) value[0]);
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      {
+        ClutterColor color = {
+          (guint8) value[0],
+          (guint8) value[1],
+          (guint8) value[2],
+          (guint8) value[3],
+        };
+
+        clutter_actor_set_background_color_internal (actor, &color);
+      }
+      break;
+
+    case PROP_PIVOT_POINT:
+      {
+        ClutterPoint pivot = CLUTTER_POINT_INIT (value[0], value[1]);
+
+        clutter_actor_set_pivot_point_internal (actor, &pivot);
+      }
+      break;
+
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (actor, value[0]);
+      break;
+
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (actor, value[0], pspec);
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (actor, value[0], pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (actor, value[0], pspec);
+      break;
+
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_internal (actor, value[0], pspec);
+      break;
+
+    default:
+      g_assert_not_reached ();
+      break;
+    }
+
+  g_object_thaw_notify (target);
+}
+
+/* brackets the animated properties written by the animation table at
+ * the end of a frame: the notifications are emitted, and the geometry
+ * compared and the relayout queued, once for all the properties
+ */
+static void
+clutter_actor_batch_animated_properties (GObject  *target,
+                                         gboolean  begin)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (target);
+  ClutterActorPrivate *priv = actor->priv;
+
+  if (begin)
+    {
+      if (priv->animation_batch++ > 0)
+        return;
+
+      g_object_freeze_notify (target);
+
+      clutter_actor_store_old_geometry (actor, &priv->animation_batch_old);
+      priv->batch_geometry_changed = FALSE;
+      priv->batch_needs_relayout = FALSE;
+
+      return;
+    }
+
+  g_assert (priv->animation_batch > 0);
+
+  if (--priv->animation_batch > 0)
+    return;
+
+  if (priv->batch_geometry_changed)
+    {
+      priv->batch_geometry_changed = FALSE;
+      n_saved_notifications -= 1;
+
+      clutter_actor_notify_if_geometry_changed (actor, &priv->animation_batch_old);
+    }
+
+  if (priv->batch_needs_relayout)
+    {
+      priv->batch_needs_relayout = FALSE;
+      n_saved_notifications -= 1;
+
+      clutter_actor_queue_relayout (actor);
+    }
+
+  g_object_thaw_notify (target);
+}
+
+/*< private >
+ * _clutter_actor_get_saved_notifications:
+ *
+ * Retrieves the number of geometry notifications and relayouts that
+ * were coalesced by writing the animated properties of the actors in
+ * batches, since the beginning of the program.
+ *
+ * Return value: the number of saved notifications
+ */
+guint
+_clutter_actor_get_saved_notifications (void)
+{
+  return n_saved_notifications;
+}
+
+static gboolean
+clutter_actor_can_write_animated_property (ClutterActor *self,
+                                           GParamSpec   *pspec)
+{
+  ClutterAnimatableIface *iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+
+  /* sub-classes implementing ClutterAnimatable on their own can
+   * interpolate and set the properties of ClutterActor differently
+   */
+  if (iface->set_final_state != clutter_actor_set_final_state ||
+      iface->interpolate_value != NULL)
+    return FALSE;
+
+  /* the types are interpolated like ClutterInterval does, unless
+   * a different progress function was registered for them
+   */
+  if (G_TYPE_IS_FUNDAMENTAL (G_PARAM_SPEC_VALUE_TYPE (pspec)) &&
+      _clutter_has_progress_function (G_PARAM_SPEC_VALUE_TYPE (pspec)))
+    return FALSE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_POSITION:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_SIZE:
+    case PROP_DEPTH:
+    case PROP_Z_POSITION:
+    case PROP_OPACITY:
+    case PROP_BACKGROUND_COLOR:
+    case PROP_PIVOT_POINT:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      return pspec->owner_type == CLUTTER_TYPE_ACTOR;
+
+    default:
+      return FALSE;
+    }
+}
+
 static void
 clutter_animatable_iface_init (ClutterAnimatableIface *iface)
 {
@@ -16187,7 +16486,10 @@ clutter_actor_set_flags (ClutterActor      *self,
   visible_set  = ((self->flags & CLUTTER_ACTOR_VISIBLE)  != 0);
 
   if (reactive_set != was_reactive_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    {
+      clutter_actor_reactive_changed (self);
+      g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    }
 
   if (realized_set != was_realized_set)
     g_object_notify_by_pspec (obj, obj_props[PROP_REALIZED]);
@@ -16247,7 +16549,10 @@ clutter_actor_unset_flags (ClutterActor      *self,
   visible_set  = ((self->flags & CLUTTER_ACTOR_VISIBLE)  != 0);
 
   if (reactive_set != was_reactive_set)
-    g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    {
+      clutter_actor_reactive_changed (self);
+      g_object_notify_by_pspec (obj, obj_props[PROP_REACTIVE]);
+    }
 
   if (realized_set != was_realized_set)
     g_object_notify_by_pspec (obj, obj_props[PROP_REALIZED]);
@@ -16487,6 +16792,22 @@ _clutter_actor_set_has_pointer (ClutterActor *self,
     }
 }
 
+/*< private >
+ * _clutter_actor_has_default_pick:
+ * @self: a #ClutterActor
+ *
+ * Checks whether @self uses the default implementation of the
+ * #ClutterActorClass.pick() virtual function, which only paints
+ * the allocation of the actor and its children.
+ *
+ * Return value: %TRUE if the actor uses the default pick
+ */
+gboolean
+_clutter_actor_has_default_pick (ClutterActor *self)
+{
+  return CLUTTER_ACTOR_GET_CLASS (self)->pick == clutter_actor_real_pick;
+}
+
 /**
  * clutter_actor_get_text_direction:
  * @self: a #ClutterActor
@@ -19315,6 +19636,15 @@ _clutter_actor_create_transition (ClutterActor *actor,
         }
 #endif /* CLUTTER_ENABLE_DEBUG */
 
+      /* the implicit transitions on the properties of ClutterActor are
+       * interpolated by the animation table of the master clock, which
+       * writes the values directly at the end of each frame
+       */
+      if (clutter_actor_can_write_animated_property (actor, pspec))
+        _clutter_property_transition_set_table_func (CLUTTER_PROPERTY_TRANSITION (res),
+                                                     clutter_actor_write_animated_property,
+                                                     clutter_actor_batch_animated_properties);
+
       /* this will start the transition as well */
       clutter_actor_add_transition_internal (actor, pspec->name, res, TRUE);
 
@@ -20533,14 +20863,27 @@ clutter_actor_get_content_repeat (ClutterActor *self)
   return self->priv->content_repeat;
 }
 
+/* an actor must be reactive to receive an event, unless it's the
+ * stage or this is a key event
+ */
+static inline gboolean
+clutter_actor_should_emit_event (ClutterActor *actor,
+                                 gboolean      is_toplevel,
+                                 gboolean      is_key_event)
+{
+  return CLUTTER_ACTOR_IS_REACTIVE (actor) || is_toplevel || is_key_event;
+}
+
 void
 _clutter_actor_handle_event (ClutterActor       *self,
                              const ClutterEvent *event)
 {
+  ClutterInputDevice *device;
   GPtrArray *event_tree;
   ClutterActor *iter;
   gboolean is_key_event;
-  gint i = 0;
+  gboolean use_device_chain;
+  gint last, i = 0;
 
   /* XXX - for historical reasons that are now lost in the mists of time,
    * key events are delivered regardless of whether an actor is set as
@@ -20549,40 +20892,86 @@ _clutter_actor_handle_event (ClutterActor       *self,
   is_key_event = event->type == CLUTTER_KEY_PRESS ||
                  event->type == CLUTTER_KEY_RELEASE;
 
-  event_tree = g_ptr_array_sized_new (64);
-  g_ptr_array_set_free_func (event_tree, (GDestroyNotify) g_object_unref);
+  /* the list of emitters for the event only depends on the source and
+   * on the scene graph, so we keep it around on the device and only
+   * rebuild it when either of them changed since the last event; the
+   * reactive state is checked at emission time instead. If an event
+   * for the same device is delivered while we are still walking the
+   * chain of the device, we use a chain of our own
+   */
+  device = clutter_event_get_device (event);
+  use_device_chain = device != NULL && !device->event_chain_in_use;
 
-  /* build the list of of emitters for the event */
-  iter = self;
-  while (iter != NULL)
+  if (use_device_chain)
     {
-      ClutterActor *parent = iter->priv->parent;
+      g_object_ref (device);
 
-      if (CLUTTER_ACTOR_IS_REACTIVE (iter) || /* an actor must be reactive */
-          parent == NULL ||                       /* unless it's the stage */
-          is_key_event)                          /* or this is a key event */
-        {
-          /* keep a reference on the actor, so that it remains valid
-           * for the duration of the signal emission
-           */
-          g_ptr_array_add (event_tree, g_object_ref (iter));
-        }
+      if (device->event_chain == NULL)
+        device->event_chain = g_ptr_array_sized_new (64);
+
+      device->event_chain_in_use = TRUE;
+
+      event_tree = device->event_chain;
+
+      if (device->event_chain_source == self &&
+          device->event_chain_serial == hierarchy_serial)
+        goto emit;
+
+      g_ptr_array_set_size (event_tree, 0);
+    }
+  else
+    event_tree = g_ptr_array_sized_new (64);
 
-      iter = parent;
+  /* build the list of of emitters for the event */
+  for (iter = self; iter != NULL; iter = iter->priv->parent)
+    g_ptr_array_add (event_tree, iter);
+
+  if (use_device_chain)
+    {
+      device->event_chain_source = self;
+      device->event_chain_serial = hierarchy_serial;
     }
 
+emit:
+  last = event_tree->len - 1;
+
+  /* keep a reference on the actors, so that they remain valid
+   * for the duration of the signal emission
+   */
+  for (i = 0; i <= last; i++)
+    g_object_ref (g_ptr_array_index (event_tree, i));
+
   /* Capture: from top-level downwards */
-  for (i = event_tree->len - 1; i >= 0; i--)
-    if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, TRUE))
-      goto done;
+  for (i = last; i >= 0; i--)
+    {
+      iter = g_ptr_array_index (event_tree, i);
+
+      if (clutter_actor_should_emit_event (iter, i == last, is_key_event) &&
+          clutter_actor_event (iter, event, TRUE))
+        goto done;
+    }
 
   /* Bubble: from source upwards */
-  for (i = 0; i < event_tree->len; i++)
-    if (clutter_actor_event (g_ptr_array_index (event_tree, i), event, FALSE))
-      goto done;
+  for (i = 0; i <= last; i++)
+    {
+      iter = g_ptr_array_index (event_tree, i);
+
+      if (clutter_actor_should_emit_event (iter, i == last, is_key_event) &&
+          clutter_actor_event (iter, event, FALSE))
+        goto done;
+    }
 
 done:
-  g_ptr_array_free (event_tree, TRUE);
+  for (i = 0; i <= last; i++)
+    g_object_unref (g_ptr_array_index (event_tree, i));
+
+  if (use_device_chain)
+    {
+      device->event_chain_in_use = FALSE;
+      g_object_unref (device);
+    }
+  else
+    g_ptr_array_free (event_tree, TRUE);
 }
 
 static void
@@ -20833,6 +21222,154 @@ _clutter_actor_get_active_framebuffer (ClutterActor *self)
   return _clutter_stage_get_active_framebuffer (stage);
 }
 
+static void
+transformed_rect_bounds (ClutterActor      *actor,
+                         const ClutterRect *rect,
+                         ClutterRect       *bounds)
+{
+  ClutterVertex v[4] = {
+    { rect->origin.x, rect->origin.y, 0.f },
+    { rect->origin.x + rect->size.width, rect->origin.y, 0.f },
+    { rect->origin.x, rect->origin.y + rect->size.height, 0.f },
+    { rect->origin.x + rect->size.width, rect->origin.y + rect->size.height, 0.f },
+  };
+  float x_1, y_1, x_2, y_2;
+  int i;
+
+  x_1 = y_1 = G_MAXFLOAT;
+  x_2 = y_2 = -G_MAXFLOAT;
+
+  for (i = 0; i < 4; i++)
+    {
+      ClutterVertex out;
+
+      clutter_actor_apply_transform_to_point (actor, &v[i], &out);
+
+      x_1 = MIN (x_1, out.x);
+      y_1 = MIN (y_1, out.y);
+      x_2 = MAX (x_2, out.x);
+      y_2 = MAX (y_2, out.y);
+    }
+
+  clutter_rect_init (bounds, x_1, y_1, x_2 - x_1, y_2 - y_1);
+}
+
+/*< private >
+ * _clutter_actor_get_visible_rect:
+ * @self: a #ClutterActor
+ * @rect: (out caller-allocates): return location for the visible
+ *   rectangle, in actor-relative coordinates
+ *
+ * Computes the bounding rectangle of the part of @self that can end
+ * up on screen in the current paint, by intersecting the redraw clip
+ * of the stage with the clip of @self and the clip of each of its
+ * ancestors.
+ *
+ * This function should only be called while @self is being painted
+ * on its stage; if @self is being painted through a #ClutterClone or
+ * into an offscreen framebuffer, its ancestors do not clip it, and
+ * this function will return %FALSE.
+ *
+ * Return value: %TRUE if @rect was set, and %FALSE if the visible
+ *   part of @self could not be determined
+ */
+gboolean
+_clutter_actor_get_visible_rect (ClutterActor *self,
+                                 ClutterRect  *rect)
+{
+  ClutterActor *stage, *iter;
+  cairo_rectangle_int_t redraw_clip;
+  ClutterRect visible, bounds;
+  float x_1, y_1, x_2, y_2;
+  int i;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  if (clutter_actor_is_in_clone_paint (self))
+    return FALSE;
+
+  if (cogl_get_draw_framebuffer () != _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (stage)))
+    return FALSE;
+
+  clutter_stage_get_redraw_clip_bounds (CLUTTER_STAGE (stage), &redraw_clip);
+  clutter_rect_init (&visible,
+                     redraw_clip.x, redraw_clip.y,
+                     redraw_clip.width, redraw_clip.height);
+
+  for (iter = self; iter != NULL && iter != stage; iter = iter->priv->parent)
+    {
+      ClutterActorPrivate *ipriv = iter->priv;
+      ClutterRect clip;
+
+      if (ipriv->has_clip)
+        clip = ipriv->clip;
+      else if (ipriv->clip_to_allocation)
+        clutter_rect_init (&clip, 0.f, 0.f,
+                           ipriv->allocation.x2 - ipriv->allocation.x1,
+                           ipriv->allocation.y2 - ipriv->allocation.y1);
+      else
+        continue;
+
+      transformed_rect_bounds (iter, &clip, &bounds);
+
+      if (!clutter_rect_intersection (&visible, &bounds, &visible))
+        {
+          clutter_rect_init (rect, 0.f, 0.f, 0.f, 0.f);
+          return TRUE;
+        }
+    }
+
+  /* map the visible part of the stage back into the actor */
+  x_1 = y_1 = G_MAXFLOAT;
+  x_2 = y_2 = -G_MAXFLOAT;
+
+  for (i = 0; i < 4; i++)
+    {
+      float stage_x = visible.origin.x + ((i & 1) ? visible.size.width : 0.f);
+      float stage_y = visible.origin.y + ((i & 2) ? visible.size.height : 0.f);
+      float x, y;
+
+      if (!clutter_actor_transform_stage_point (self, stage_x, stage_y, &x, &y))
+        return FALSE;
+
+      x_1 = MIN (x_1, x);
+      y_1 = MIN (y_1, y);
+      x_2 = MAX (x_2, x);
+      y_2 = MAX (y_2, y);
+    }
+
+  clutter_rect_init (rect, x_1, y_1, x_2 - x_1, y_2 - y_1);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_get_background_color_set:
+ * @self: a #ClutterActor
+ * @color: (out) (allow-none): return location for the background color
+ *
+ * Checks whether @self has a background color, and retrieves it, without
+ * going through the #ClutterActor:background-color-set property; this is
+ * meant to be used by #ClutterActorClass.paint implementations.
+ *
+ * Return value: %TRUE if the #ClutterActor:background-color of @self
+ *   is set
+ */
+gboolean
+_clutter_actor_get_background_color_set (ClutterActor *self,
+                                         ClutterColor *color)
+{
+  if (!self->priv->bg_color_set)
+    return FALSE;
+
+  if (color != NULL)
+    *color = self->priv->bg_color;
+
+  return TRUE;
+}
+
 static void
 clutter_actor_child_model__items_changed (GListModel *model,
                                           guint       position,
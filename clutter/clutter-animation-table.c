@@ -0,0 +1,514 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterAnimationTable: dense table of the interpolations driven by
+ * property transitions, advanced once per frame by the master clock.
+ *
+ * Each slot of the table holds the initial value and the distance to
+ * the final value of an animated property, unpacked into an array of
+ * doubles, and the progress computed by the timeline for the current
+ * frame. The table is stored as a structure of arrays, so that the
+ * master clock can interpolate all the animated properties in a single
+ * loop once all the timelines have been advanced, and then hand each
+ * value to the function that writes it into its target, without going
+ * through GValues and property setters.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-animation-table.h"
+
+#include "clutter-color.h"
+
+#define N_COMPONENTS    CLUTTER_ANIMATION_TABLE_MAX_COMPONENTS
+
+typedef struct {
+  GObject *target;
+  ClutterAnimationTableBatchFunc func;
+} TableBatch;
+
+enum
+{
+  SLOT_USED    = 1 << 0,
+  SLOT_PENDING = 1 << 1
+};
+
+struct _ClutterAnimationTable
+{
+  /* the number of slots in use, or free, and the size of the arrays */
+  guint n_slots;
+  guint size;
+
+  GObject **targets;
+  GParamSpec **pspecs;
+  ClutterAnimationTableFunc *funcs;
+  ClutterAnimationTableBatchFunc *batch_funcs;
+
+  /* N_COMPONENTS per slot */
+  gdouble *initial;
+  gdouble *delta;
+
+  gdouble *progress;
+  guint8 *flags;
+
+  /* gint */
+  GArray *free_slots;
+
+  /* gint; the slots with a value waiting to be written */
+  GArray *pending;
+
+  /* gdouble; the values of the pending slots */
+  GArray *values;
+
+  /* TableBatch; the targets of the pending slots */
+  GArray *batches;
+
+  guint defer_updates : 1;
+};
+
+/*< private >
+ * _clutter_animation_table_get_default:
+ *
+ * Retrieves the table used by the property transitions advanced by
+ * the master clock.
+ *
+ * Return value: (transfer none): the default #ClutterAnimationTable
+ */
+ClutterAnimationTable *
+_clutter_animation_table_get_default (void)
+{
+  static ClutterAnimationTable *default_table = NULL;
+
+  if (G_UNLIKELY (default_table == NULL))
+    {
+      default_table = g_slice_new0 (ClutterAnimationTable);
+      default_table->free_slots = g_array_new (FALSE, FALSE, sizeof (gint));
+      default_table->pending = g_array_new (FALSE, FALSE, sizeof (gint));
+      default_table->values = g_array_new (FALSE, FALSE, sizeof (gdouble));
+      default_table->batches = g_array_new (FALSE, FALSE, sizeof (TableBatch));
+    }
+
+  return default_table;
+}
+
+/*< private >
+ * _clutter_animation_table_supports_type:
+ * @value_type: a #GType
+ *
+ * Checks whether values of @value_type can be interpolated by the
+ * table: floating point and unsigned integer numbers, #ClutterPoint,
+ * #ClutterSize and #ClutterColor.
+ *
+ * Return value: %TRUE if the type is supported
+ */
+gboolean
+_clutter_animation_table_supports_type (GType value_type)
+{
+  return value_type == G_TYPE_FLOAT ||
+         value_type == G_TYPE_DOUBLE ||
+         value_type == G_TYPE_UINT ||
+         value_type == CLUTTER_TYPE_POINT ||
+         value_type == CLUTTER_TYPE_SIZE ||
+         value_type == CLUTTER_TYPE_COLOR;
+}
+
+static gboolean
+unpack_value (const GValue *value,
+              GType         value_type,
+              gdouble      *components)
+{
+  memset (components, 0, sizeof (gdouble) * N_COMPONENTS);
+
+  if (!G_VALUE_HOLDS (value, value_type))
+    return FALSE;
+
+  if (value_type == G_TYPE_FLOAT)
+    components[0] = g_value_get_float (value);
+  else if (value_type == G_TYPE_DOUBLE)
+    components[0] = g_value_get_double (value);
+  else if (value_type == G_TYPE_UINT)
+    components[0] = g_value_get_uint (value);
+  else if (value_type == CLUTTER_TYPE_POINT)
+    {
+      const ClutterPoint *point = g_value_get_boxed (value);
+
+      if (point == NULL)
+        return FALSE;
+
+      components[0] = point->x;
+      components[1] = point->y;
+    }
+  else if (value_type == CLUTTER_TYPE_SIZE)
+    {
+      const ClutterSize *size = g_value_get_boxed (value);
+
+      if (size == NULL)
+        return FALSE;
+
+      components[0] = size->width;
+      components[1] = size->height;
+    }
+  else if (value_type == CLUTTER_TYPE_COLOR)
+    {
+      const ClutterColor *color = g_value_get_boxed (value);
+
+      if (color == NULL)
+        return FALSE;
+
+      components[0] = color->red;
+      components[1] = color->green;
+      components[2] = color->blue;
+      components[3] = color->alpha;
+    }
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+clutter_animation_table_resize (ClutterAnimationTable *table,
+                                guint                  size)
+{
+  table->targets = g_renew (GObject *, table->targets, size);
+  table->pspecs = g_renew (GParamSpec *, table->pspecs, size);
+  table->funcs = g_renew (ClutterAnimationTableFunc, table->funcs, size);
+  table->batch_funcs = g_renew (ClutterAnimationTableBatchFunc, table->batch_funcs, size);
+  table->initial = g_renew (gdouble, table->initial, size * N_COMPONENTS);
+  table->delta = g_renew (gdouble, table->delta, size * N_COMPONENTS);
+  table->progress = g_renew (gdouble, table->progress, size);
+  table->flags = g_renew (guint8, table->flags, size);
+
+  table->size = size;
+}
+
+/*< private >
+ * _clutter_animation_table_add:
+ * @table: a #ClutterAnimationTable
+ * @target: the object owning the animated property
+ * @pspec: the animated property; its type must be supported by the table
+ * @func: the function writing the interpolated values of @pspec
+ * @batch_func: (allow-none): the function bracketing the values of
+ *   @target written at the end of a frame, or %NULL
+ *
+ * Adds a slot for the property @pspec of @target to the table. The
+ * table does not take a reference on @target: the slot should be
+ * removed before @target goes away.
+ *
+ * The slot has no value until _clutter_animation_table_set_interval()
+ * is called.
+ *
+ * Return value: the slot of the property
+ */
+gint
+_clutter_animation_table_add (ClutterAnimationTable     *table,
+                              GObject                   *target,
+                              GParamSpec                *pspec,
+                              ClutterAnimationTableFunc  func,
+                              ClutterAnimationTableBatchFunc batch_func)
+{
+  gint slot;
+
+  g_assert (_clutter_animation_table_supports_type (G_PARAM_SPEC_VALUE_TYPE (pspec)));
+
+  if (table->free_slots->len > 0)
+    {
+      slot = g_array_index (table->free_slots, gint, table->free_slots->len - 1);
+      g_array_set_size (table->free_slots, table->free_slots->len - 1);
+    }
+  else
+    {
+      if (table->n_slots == table->size)
+        clutter_animation_table_resize (table, MAX (table->size * 2, 64));
+
+      slot = table->n_slots++;
+    }
+
+  table->targets[slot] = target;
+  table->pspecs[slot] = pspec;
+  table->funcs[slot] = func;
+  table->batch_funcs[slot] = batch_func;
+  table->progress[slot] = 0.0;
+  table->flags[slot] = SLOT_USED;
+
+  memset (table->initial + slot * N_COMPONENTS, 0, sizeof (gdouble) * N_COMPONENTS);
+  memset (table->delta + slot * N_COMPONENTS, 0, sizeof (gdouble) * N_COMPONENTS);
+
+  return slot;
+}
+
+static void
+clutter_animation_table_begin_batch (ClutterAnimationTable *table,
+                                     gint                   slot)
+{
+  TableBatch batch;
+
+  if (table->batch_funcs[slot] == NULL)
+    return;
+
+  batch.target = g_object_ref (table->targets[slot]);
+  batch.func = table->batch_funcs[slot];
+  g_array_append_val (table->batches, batch);
+
+  batch.func (batch.target, TRUE);
+}
+
+static inline void
+clutter_animation_table_write (ClutterAnimationTable *table,
+                               gint                   slot)
+{
+  const gdouble *initial = table->initial + slot * N_COMPONENTS;
+  const gdouble *delta = table->delta + slot * N_COMPONENTS;
+  gdouble progress = table->progress[slot];
+  gdouble value[N_COMPONENTS];
+  gint i;
+
+  table->flags[slot] &= ~SLOT_PENDING;
+
+  for (i = 0; i < N_COMPONENTS; i++)
+    value[i] = initial[i] + delta[i] * progress;
+
+  table->funcs[slot] (table->targets[slot], table->pspecs[slot], value);
+}
+
+/*< private >
+ * _clutter_animation_table_remove:
+ * @table: a #ClutterAnimationTable
+ * @slot: a slot returned by _clutter_animation_table_add()
+ * @flush: whether a value waiting for the end of the frame should
+ *   be written before removing the slot
+ *
+ * Removes @slot from the table.
+ */
+void
+_clutter_animation_table_remove (ClutterAnimationTable *table,
+                                 gint                   slot,
+                                 gboolean               flush)
+{
+  g_assert (slot >= 0 && (guint) slot < table->n_slots);
+  g_assert (table->flags[slot] & SLOT_USED);
+
+  if (flush && (table->flags[slot] & SLOT_PENDING) != 0)
+    clutter_animation_table_write (table, slot);
+
+  /* the slot may still be in the list of pending slots; clearing the
+   * flags is enough for _clutter_animation_table_flush_updates() to
+   * skip it
+   */
+  table->targets[slot] = NULL;
+  table->pspecs[slot] = NULL;
+  table->funcs[slot] = NULL;
+  table->batch_funcs[slot] = NULL;
+  table->flags[slot] = 0;
+
+  g_array_append_val (table->free_slots, slot);
+}
+
+/*< private >
+ * _clutter_animation_table_set_interval:
+ * @table: a #ClutterAnimationTable
+ * @slot: a slot of the table
+ * @initial: the initial value of the interpolation
+ * @final: the final value of the interpolation
+ *
+ * Sets the values interpolated by @slot. Both values must hold the
+ * type of the property of @slot.
+ *
+ * Return value: %TRUE if the values were stored in the table
+ */
+gboolean
+_clutter_animation_table_set_interval (ClutterAnimationTable *table,
+                                       gint                   slot,
+                                       const GValue          *initial,
+                                       const GValue          *final)
+{
+  GType value_type = G_PARAM_SPEC_VALUE_TYPE (table->pspecs[slot]);
+  gdouble *initial_p = table->initial + slot * N_COMPONENTS;
+  gdouble *delta_p = table->delta + slot * N_COMPONENTS;
+  gdouble final_v[N_COMPONENTS];
+  gint i;
+
+  if (!unpack_value (initial, value_type, initial_p) ||
+      !unpack_value (final, value_type, final_v))
+    return FALSE;
+
+  for (i = 0; i < N_COMPONENTS; i++)
+    delta_p[i] = final_v[i] - initial_p[i];
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_animation_table_set_progress:
+ * @table: a #ClutterAnimationTable
+ * @slot: a slot of the table
+ * @progress: the progress of the interpolation
+ * @flush: whether the value should be written immediately
+ *
+ * Sets the progress of the interpolation of @slot.
+ *
+ * While the master clock advances the timelines, the value is only
+ * written by _clutter_animation_table_flush_updates(), unless @flush
+ * is set; outside of the master clock, the value is always written
+ * immediately.
+ *
+ * The values written immediately are notified by their target before
+ * this function returns; the other ones belong to the batch of their
+ * target that is closed by _clutter_animation_table_flush_updates().
+ */
+void
+_clutter_animation_table_set_progress (ClutterAnimationTable *table,
+                                       gint                   slot,
+                                       gdouble                progress,
+                                       gboolean               flush)
+{
+  table->progress[slot] = progress;
+
+  if (!table->defer_updates)
+    {
+      clutter_animation_table_write (table, slot);
+      return;
+    }
+
+  /* the handlers of ::new-frame and ::completed look at the value as
+   * soon as it has been written, so the batch of the target is closed
+   * before returning, instead of at the end of the frame
+   */
+  if (flush)
+    {
+      ClutterAnimationTableBatchFunc batch_func = table->batch_funcs[slot];
+      GObject *target;
+
+      if (batch_func == NULL)
+        {
+          clutter_animation_table_write (table, slot);
+          return;
+        }
+
+      target = g_object_ref (table->targets[slot]);
+
+      batch_func (target, TRUE);
+      clutter_animation_table_write (table, slot);
+      batch_func (target, FALSE);
+
+      g_object_unref (target);
+      return;
+    }
+
+  if ((table->flags[slot] & SLOT_PENDING) == 0)
+    {
+      table->flags[slot] |= SLOT_PENDING;
+      g_array_append_val (table->pending, slot);
+    }
+}
+
+/*< private >
+ * _clutter_animation_table_defer_updates:
+ * @table: a #ClutterAnimationTable
+ *
+ * Defers writing the values of the slots until the next call to
+ * _clutter_animation_table_flush_updates().
+ */
+void
+_clutter_animation_table_defer_updates (ClutterAnimationTable *table)
+{
+  table->defer_updates = TRUE;
+}
+
+/*< private >
+ * _clutter_animation_table_flush_updates:
+ * @table: a #ClutterAnimationTable
+ *
+ * Interpolates and writes the values of all the slots whose progress
+ * changed since _clutter_animation_table_defer_updates() was called.
+ */
+void
+_clutter_animation_table_flush_updates (ClutterAnimationTable *table)
+{
+  const gint *pending;
+  gdouble *values;
+  guint i, n_pending;
+
+  table->defer_updates = FALSE;
+
+  n_pending = table->pending->len;
+  if (n_pending == 0)
+    goto out;
+
+  g_array_set_size (table->values, n_pending * N_COMPONENTS);
+
+  pending = (const gint *) table->pending->data;
+  values = (gdouble *) table->values->data;
+
+  /* interpolate all the pending slots in one pass */
+  for (i = 0; i < n_pending; i++)
+    {
+      const gdouble *initial = table->initial + pending[i] * N_COMPONENTS;
+      const gdouble *delta = table->delta + pending[i] * N_COMPONENTS;
+      gdouble progress = table->progress[pending[i]];
+      gdouble *value = values + i * N_COMPONENTS;
+
+      value[0] = initial[0] + delta[0] * progress;
+      value[1] = initial[1] + delta[1] * progress;
+      value[2] = initial[2] + delta[2] * progress;
+      value[3] = initial[3] + delta[3] * progress;
+    }
+
+  /* let the targets coalesce the notifications and the relayouts
+   * caused by writing more than one of their properties
+   */
+  for (i = 0; i < n_pending; i++)
+    {
+      if ((table->flags[pending[i]] & SLOT_PENDING) != 0)
+        clutter_animation_table_begin_batch (table, pending[i]);
+    }
+
+  /* then write them; the write functions can end up adding and removing
+   * slots, and resizing the table, so we look up each slot again and
+   * skip the ones that were removed, or written in the meantime
+   */
+  for (i = 0; i < n_pending; i++)
+    {
+      gint slot = pending[i];
+
+      if ((table->flags[slot] & SLOT_PENDING) == 0)
+        continue;
+
+      table->flags[slot] &= ~SLOT_PENDING;
+      table->funcs[slot] (table->targets[slot],
+                          table->pspecs[slot],
+                          values + i * N_COMPONENTS);
+    }
+
+  g_array_set_size (table->pending, 0);
+
+out:
+  for (i = 0; i < table->batches->len; i++)
+    {
+      TableBatch *batch = &g_array_index (table->batches, TableBatch, i);
+
+      batch->func (batch->target, FALSE);
+      g_object_unref (batch->target);
+    }
+
+  g_array_set_size (table->batches, 0);
+}
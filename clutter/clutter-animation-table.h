@@ -0,0 +1,89 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterAnimationTable: dense table of the interpolations driven by
+ * property transitions, advanced once per frame by the master clock.
+ */
+
+#ifndef __CLUTTER_ANIMATION_TABLE_H__
+#define __CLUTTER_ANIMATION_TABLE_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+/* the number of components of the largest value type in the table,
+ * i.e. ClutterColor
+ */
+#define CLUTTER_ANIMATION_TABLE_MAX_COMPONENTS  4
+
+typedef struct _ClutterAnimationTable   ClutterAnimationTable;
+
+/*
+ * ClutterAnimationTableFunc:
+ * @target: the object owning the animated property
+ * @pspec: the animated property
+ * @value: the interpolated components of the value of the property
+ *
+ * Writes the interpolated value of a property.
+ */
+typedef void (* ClutterAnimationTableFunc) (GObject       *target,
+                                            GParamSpec    *pspec,
+                                            const gdouble *value);
+
+/*
+ * ClutterAnimationTableBatchFunc:
+ * @target: the object owning the animated properties
+ * @begin: %TRUE before the values of the frame are written, and
+ *   %FALSE afterwards
+ *
+ * Brackets the writes of the values of a frame, so that @target can
+ * coalesce the side effects of writing more than one property. The
+ * calls can be nested, once for each animated property of @target.
+ */
+typedef void (* ClutterAnimationTableBatchFunc) (GObject  *target,
+                                                 gboolean  begin);
+
+ClutterAnimationTable * _clutter_animation_table_get_default    (void);
+
+gboolean                _clutter_animation_table_supports_type  (GType                      value_type);
+
+gint                    _clutter_animation_table_add            (ClutterAnimationTable     *table,
+                                                                 GObject                   *target,
+                                                                 GParamSpec                *pspec,
+                                                                 ClutterAnimationTableFunc  func,
+                                                                 ClutterAnimationTableBatchFunc batch_func);
+void                    _clutter_animation_table_remove         (ClutterAnimationTable     *table,
+                                                                 gint                       slot,
+                                                                 gboolean                   flush);
+
+gboolean                _clutter_animation_table_set_interval   (ClutterAnimationTable     *table,
+                                                                 gint                       slot,
+                                                                 const GValue              *initial,
+                                                                 const GValue              *final);
+void                    _clutter_animation_table_set_progress   (ClutterAnimationTable     *table,
+                                                                 gint                       slot,
+                                                                 gdouble                    progress,
+                                                                 gboolean                   flush);
+
+void                    _clutter_animation_table_defer_updates  (ClutterAnimationTable     *table);
+void                    _clutter_animation_table_flush_updates  (ClutterAnimationTable     *table);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_ANIMATION_TABLE_H__ */
@@ -549,18 +549,32 @@ clutter_point_distance (const ClutterPoint *a,
   return sqrt ((x_d * x_d) + (y_d * y_d));
 }
 
+static void
+clutter_point_kernel (gconstpointer a,
+                      gconstpointer b,
+                      gdouble       progress,
+                      gpointer      retval)
+{
+  const ClutterPoint *ap = a;
+  const ClutterPoint *bp = b;
+  ClutterPoint *res = retval;
+
+  res->x = ap->x + (bp->x - ap->x) * progress;
+  res->y = ap->y + (bp->y - ap->y) * progress;
+}
+
 static gboolean
 clutter_point_progress (const GValue *a,
                         const GValue *b,
                         gdouble       progress,
                         GValue       *retval)
 {
-  const ClutterPoint *ap = g_value_get_boxed (a);
-  const ClutterPoint *bp = g_value_get_boxed (b);
   ClutterPoint res = CLUTTER_POINT_INIT (0, 0);
 
-  res.x = ap->x + (bp->x - ap->x) * progress;
-  res.y = ap->y + (bp->y - ap->y) * progress;
+  clutter_point_kernel (g_value_get_boxed (a),
+                        g_value_get_boxed (b),
+                        progress,
+                        &res);
 
   g_value_set_boxed (retval, &res);
 
@@ -570,7 +584,9 @@ clutter_point_progress (const GValue *a,
 G_DEFINE_BOXED_TYPE_WITH_CODE (ClutterPoint, clutter_point,
                                clutter_point_copy,
                                clutter_point_free,
-                               CLUTTER_REGISTER_INTERVAL_PROGRESS (clutter_point_progress))
+                               CLUTTER_REGISTER_INTERVAL_KERNEL (clutter_point_progress,
+                                                                 clutter_point_kernel,
+                                                                 sizeof (ClutterPoint)))
 
 
 
@@ -676,18 +692,32 @@ clutter_size_equals (const ClutterSize *a,
          fabsf (a->height - b->height) < FLOAT_EPSILON;
 }
 
+static void
+clutter_size_kernel (gconstpointer a,
+                     gconstpointer b,
+                     gdouble       progress,
+                     gpointer      retval)
+{
+  const ClutterSize *as = a;
+  const ClutterSize *bs = b;
+  ClutterSize *res = retval;
+
+  res->width = as->width + (bs->width - as->width) * progress;
+  res->height = as->height + (bs->height - as->height) * progress;
+}
+
 static gboolean
 clutter_size_progress (const GValue *a,
                        const GValue *b,
                        gdouble       progress,
                        GValue       *retval)
 {
-  const ClutterSize *as = g_value_get_boxed (a);
-  const ClutterSize *bs = g_value_get_boxed (b);
   ClutterSize res = CLUTTER_SIZE_INIT (0, 0);
 
-  res.width = as->width + (bs->width - as->width) * progress;
-  res.height = as->height + (bs->height - as->height) * progress;
+  clutter_size_kernel (g_value_get_boxed (a),
+                       g_value_get_boxed (b),
+                       progress,
+                       &res);
 
   g_value_set_boxed (retval, &res);
 
@@ -697,7 +727,9 @@ clutter_size_progress (const GValue *a,
 G_DEFINE_BOXED_TYPE_WITH_CODE (ClutterSize, clutter_size,
                                clutter_size_copy,
                                clutter_size_free,
-                               CLUTTER_REGISTER_INTERVAL_PROGRESS (clutter_size_progress))
+                               CLUTTER_REGISTER_INTERVAL_KERNEL (clutter_size_progress,
+                                                                 clutter_size_kernel,
+                                                                 sizeof (ClutterSize)))
 
 
 
@@ -1294,14 +1326,15 @@ clutter_matrix_copy (gpointer data)
   return cogl_matrix_copy (data);
 }
 
-static gboolean
-clutter_matrix_progress (const GValue *a,
-                         const GValue *b,
-                         gdouble       progress,
-                         GValue       *retval)
+static void
+clutter_matrix_kernel (gconstpointer a,
+                       gconstpointer b,
+                       gdouble       progress,
+                       gpointer      retval)
 {
-  const ClutterMatrix *matrix1 = g_value_get_boxed (a);
-  const ClutterMatrix *matrix2 = g_value_get_boxed (b);
+  const ClutterMatrix *matrix1 = a;
+  const ClutterMatrix *matrix2 = b;
+  ClutterMatrix *res = retval;
   ClutterVertex scale1 = CLUTTER_VERTEX_INIT (1.f, 1.f, 1.f);
   float shear1[3] = { 0.f, 0.f, 0.f };
   ClutterVertex rotate1 = CLUTTER_VERTEX_INIT_ZERO;
@@ -1317,9 +1350,8 @@ clutter_matrix_progress (const GValue *a,
   ClutterVertex rotate_res = CLUTTER_VERTEX_INIT_ZERO;
   ClutterVertex translate_res = CLUTTER_VERTEX_INIT_ZERO;
   ClutterVertex4 perspective_res = { 0.f, 0.f, 0.f, 0.f };
-  ClutterMatrix res;
 
-  clutter_matrix_init_identity (&res);
+  clutter_matrix_init_identity (res);
 
   _clutter_util_matrix_decompose (matrix1,
                                   &scale1, shear1, &rotate1, &translate1,
@@ -1330,37 +1362,51 @@ clutter_matrix_progress (const GValue *a,
 
   /* perspective */
   _clutter_util_vertex4_interpolate (&perspective1, &perspective2, progress, &perspective_res);
-  res.wx = perspective_res.x;
-  res.wy = perspective_res.y;
-  res.wz = perspective_res.z;
-  res.ww = perspective_res.w;
+  res->wx = perspective_res.x;
+  res->wy = perspective_res.y;
+  res->wz = perspective_res.z;
+  res->ww = perspective_res.w;
 
   /* translation */
   clutter_vertex_interpolate (&translate1, &translate2, progress, &translate_res);
-  cogl_matrix_translate (&res, translate_res.x, translate_res.y, translate_res.z);
+  cogl_matrix_translate (res, translate_res.x, translate_res.y, translate_res.z);
 
   /* rotation */
   clutter_vertex_interpolate (&rotate1, &rotate2, progress, &rotate_res);
-  cogl_matrix_rotate (&res, rotate_res.x, 1.0f, 0.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.y, 0.0f, 1.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.z, 0.0f, 0.0f, 1.0f);
+  cogl_matrix_rotate (res, rotate_res.x, 1.0f, 0.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.y, 0.0f, 1.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.z, 0.0f, 0.0f, 1.0f);
 
   /* skew */
   shear_res = shear1[2] + (shear2[2] - shear1[2]) * progress; /* YZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_yz (&res, shear_res);
+    _clutter_util_matrix_skew_yz (res, shear_res);
 
   shear_res = shear1[1] + (shear2[1] - shear1[1]) * progress; /* XZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xz (&res, shear_res);
+    _clutter_util_matrix_skew_xz (res, shear_res);
 
   shear_res = shear1[0] + (shear2[0] - shear1[0]) * progress; /* XY */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xy (&res, shear_res);
+    _clutter_util_matrix_skew_xy (res, shear_res);
 
   /* scale */
   clutter_vertex_interpolate (&scale1, &scale2, progress, &scale_res);
-  cogl_matrix_scale (&res, scale_res.x, scale_res.y, scale_res.z);
+  cogl_matrix_scale (res, scale_res.x, scale_res.y, scale_res.z);
+}
+
+static gboolean
+clutter_matrix_progress (const GValue *a,
+                         const GValue *b,
+                         gdouble       progress,
+                         GValue       *retval)
+{
+  ClutterMatrix res;
+
+  clutter_matrix_kernel (g_value_get_boxed (a),
+                         g_value_get_boxed (b),
+                         progress,
+                         &res);
 
   g_value_set_boxed (retval, &res);
 
@@ -1370,7 +1416,9 @@ clutter_matrix_progress (const GValue *a,
 G_DEFINE_BOXED_TYPE_WITH_CODE (ClutterMatrix, clutter_matrix,
                                clutter_matrix_copy,
                                clutter_matrix_free,
-                               CLUTTER_REGISTER_INTERVAL_PROGRESS (clutter_matrix_progress))
+                               CLUTTER_REGISTER_INTERVAL_KERNEL (clutter_matrix_progress,
+                                                                 clutter_matrix_kernel,
+                                                                 sizeof (ClutterMatrix)))
 
 /**
  * clutter_matrix_alloc:
@@ -30,6 +30,10 @@
  * #ClutterBlurEffect is a sub-class of #ClutterEffect that allows blurring a
  * actor and its contents.
  *
+ * The blur is a gaussian blur of the size set with
+ * clutter_blur_effect_set_radius(); the paint volume of the actor is
+ * grown by the radius, so that the blur is not clipped.
+ *
  * #ClutterBlurEffect is available since Clutter 1.4
  */
 
@@ -43,36 +47,35 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+
 #include "clutter-blur-effect.h"
 
 #include "cogl/cogl.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-private.h"
+#include "clutter-stage-private.h"
 
-#define BLUR_PADDING    2
+#define BLUR_DEFAULT_RADIUS     2
 
-/* FIXME - lame shader; we should really have a decoupled
- * horizontal/vertical two pass shader for the gaussian blur
+/* the largest radius of a single blur pass; larger radii are obtained
+ * by blurring a downsampled copy of the actor
+ */
+#define BLUR_MAX_PASS_RADIUS    8
+#define BLUR_MAX_DOWNSCALE      16
+#define BLUR_MAX_RADIUS         (BLUR_MAX_PASS_RADIUS * BLUR_MAX_DOWNSCALE)
+
+/* the blur is separable, so it is done in two passes of the same
+ * shader: a horizontal one, and a vertical one. The weights of the
+ * kernel depend on the radius, so the shader is generated for each
+ * radius of a pass
  */
-static const gchar *box_blur_glsl_declarations =
+static const gchar *blur_glsl_declarations =
 "uniform vec2 pixel_step;\n";
-#define SAMPLE(offx, offy) \
-  "cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st + pixel_step * " \
-  "vec2 (" G_STRINGIFY (offx) ", " G_STRINGIFY (offy) "));\n"
-static const gchar *box_blur_glsl_shader =
-"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st);\n"
-  SAMPLE (-1.0, -1.0)
-  SAMPLE ( 0.0, -1.0)
-  SAMPLE (+1.0, -1.0)
-  SAMPLE (-1.0,  0.0)
-  SAMPLE (+1.0,  0.0)
-  SAMPLE (-1.0, +1.0)
-  SAMPLE ( 0.0, +1.0)
-  SAMPLE (+1.0, +1.0)
-"  cogl_texel /= 9.0;\n";
-#undef SAMPLE
 
 struct _ClutterBlurEffect
 {
@@ -81,12 +84,22 @@ struct _ClutterBlurEffect
   /* a back pointer to our actor, so that we can query it */
   ClutterActor *actor;
 
-  gint pixel_step_uniform;
+  guint radius;
 
-  gint tex_width;
-  gint tex_height;
+  /* the blur passes work on a copy of the actor this many times
+   * smaller, with a radius this many times smaller
+   */
+  guint downscale;
+  guint pass_radius;
 
+  gint pixel_step_uniform;
+
+  /* paints the blurred texture */
   CoglPipeline *pipeline;
+
+  CoglPipeline *downsample_pipeline;
+  CoglPipeline *horizontal_pipeline;
+  CoglPipeline *vertical_pipeline;
 };
 
 struct _ClutterBlurEffectClass
@@ -94,12 +107,133 @@ struct _ClutterBlurEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+
+  /* the pipelines of the blur passes, for each radius */
+  CoglPipeline *pass_pipelines[BLUR_MAX_PASS_RADIUS + 1];
 };
 
+enum
+{
+  PROP_0,
+
+  PROP_RADIUS,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST];
+
 G_DEFINE_TYPE (ClutterBlurEffect,
                clutter_blur_effect,
                CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static CoglPipeline *
+clutter_blur_effect_class_get_pass_pipeline (ClutterBlurEffectClass *klass,
+                                             guint                   radius)
+{
+  gchar weight_buf[G_ASCII_DTOSTR_BUF_SIZE];
+  gchar offset_buf[G_ASCII_DTOSTR_BUF_SIZE];
+  gfloat weights[BLUR_MAX_PASS_RADIUS + 1];
+  gfloat sigma, total;
+  CoglSnippet *snippet;
+  GString *source;
+  guint i;
+
+  if (klass->pass_pipelines[radius] != NULL)
+    return klass->pass_pipelines[radius];
+
+  /* the kernel covers two standard deviations on each side */
+  sigma = radius / 2.f;
+
+  total = 0.f;
+  for (i = 0; i <= radius; i++)
+    {
+      weights[i] = expf (-(gfloat) (i * i) / (2.f * sigma * sigma));
+      total += i == 0 ? weights[i] : 2.f * weights[i];
+    }
+
+  source = g_string_new (NULL);
+
+  g_ascii_formatd (weight_buf, sizeof (weight_buf), "%.6f",
+                   weights[0] / total);
+  g_string_append_printf (source,
+                          "  cogl_texel = texture2D (cogl_sampler, "
+                          "cogl_tex_coord.st) * %s;\n",
+                          weight_buf);
+
+  /* the texture is sampled with linear filtering, so a single fetch
+   * between two texels, at the right offset, gives the weighted sum
+   * of both; this halves the number of fetches
+   */
+  for (i = 1; i <= radius; i += 2)
+    {
+      gfloat weight = weights[i];
+      gfloat offset = i;
+
+      if (i + 1 <= radius)
+        {
+          weight += weights[i + 1];
+          offset = (i * weights[i] + (i + 1) * weights[i + 1]) / weight;
+        }
+
+      g_ascii_formatd (weight_buf, sizeof (weight_buf), "%.6f",
+                       weight / total);
+      g_ascii_formatd (offset_buf, sizeof (offset_buf), "%.6f", offset);
+
+      g_string_append_printf (source,
+                              "  cogl_texel += (texture2D (cogl_sampler, "
+                              "cogl_tex_coord.st + pixel_step * %s) + "
+                              "texture2D (cogl_sampler, "
+                              "cogl_tex_coord.st - pixel_step * %s)) * %s;\n",
+                              offset_buf,
+                              offset_buf,
+                              weight_buf);
+    }
+
+  klass->pass_pipelines[radius] = cogl_pipeline_copy (klass->base_pipeline);
+
+  snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                              blur_glsl_declarations,
+                              NULL);
+  cogl_snippet_set_replace (snippet, source->str);
+  cogl_pipeline_add_layer_snippet (klass->pass_pipelines[radius], 0, snippet);
+  cogl_object_unref (snippet);
+
+  g_string_free (source, TRUE);
+
+  return klass->pass_pipelines[radius];
+}
+
+static void
+clutter_blur_effect_update_pipelines (ClutterBlurEffect *self)
+{
+  ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
+  CoglPipeline *pass_pipeline;
+
+  self->downscale = 1;
+  while (self->radius > BLUR_MAX_PASS_RADIUS * self->downscale &&
+         self->downscale < BLUR_MAX_DOWNSCALE)
+    self->downscale *= 2;
+
+  self->pass_radius = (self->radius + self->downscale - 1) / self->downscale;
+
+  g_clear_pointer (&self->horizontal_pipeline, cogl_object_unref);
+  g_clear_pointer (&self->vertical_pipeline, cogl_object_unref);
+
+  if (self->pass_radius == 0)
+    return;
+
+  pass_pipeline =
+    clutter_blur_effect_class_get_pass_pipeline (klass, self->pass_radius);
+
+  self->horizontal_pipeline = cogl_pipeline_copy (pass_pipeline);
+  self->vertical_pipeline = cogl_pipeline_copy (pass_pipeline);
+
+  self->pixel_step_uniform =
+    cogl_pipeline_get_uniform_location (self->horizontal_pipeline,
+                                        "pixel_step");
+}
+
 static gboolean
 clutter_blur_effect_pre_paint (ClutterEffect *effect)
 {
@@ -126,43 +260,146 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
     }
 
   parent_class = CLUTTER_EFFECT_CLASS (clutter_blur_effect_parent_class);
-  if (parent_class->pre_paint (effect))
-    {
-      ClutterOffscreenEffect *offscreen_effect =
-        CLUTTER_OFFSCREEN_EFFECT (effect);
-      CoglHandle texture;
-
-      texture = clutter_offscreen_effect_get_texture (offscreen_effect);
-      self->tex_width = cogl_texture_get_width (texture);
-      self->tex_height = cogl_texture_get_height (texture);
 
-      if (self->pixel_step_uniform > -1)
-        {
-          gfloat pixel_step[2];
+  return parent_class->pre_paint (effect);
+}
 
-          pixel_step[0] = 1.0f / self->tex_width;
-          pixel_step[1] = 1.0f / self->tex_height;
+/* paints the top left @width x @height pixels of @source, scaled by
+ * @scale, into @target
+ */
+static void
+clutter_blur_effect_paint_pass (CoglPipeline           *pipeline,
+                                CoglHandle              source,
+                                ClutterOffscreenTarget *target,
+                                int                     width,
+                                int                     height,
+                                int                     scale)
+{
+  CoglFramebuffer *fb = COGL_FRAMEBUFFER (target->offscreen);
+
+  cogl_pipeline_set_layer_texture (pipeline, 0, source);
+
+  /* the previous user of the target could have left it in any state,
+   * and the passes sample the pixels around the ones we paint, so we
+   * clear the whole target
+   */
+  cogl_framebuffer_set_viewport (fb, 0, 0, target->width, target->height);
+  cogl_framebuffer_orthographic (fb, 0, 0, target->width, target->height,
+                                 -1.f, 1.f);
+  cogl_framebuffer_identity_matrix (fb);
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  cogl_framebuffer_draw_textured_rectangle (fb, pipeline,
+                                            0, 0, width, height,
+                                            0.f, 0.f,
+                                            (gfloat) width * scale
+                                            / cogl_texture_get_width (source),
+                                            (gfloat) height * scale
+                                            / cogl_texture_get_height (source));
+}
 
-          cogl_pipeline_set_uniform_float (self->pipeline,
-                                           self->pixel_step_uniform,
-                                           2, /* n_components */
-                                           1, /* count */
-                                           pixel_step);
-        }
+static void
+clutter_blur_effect_set_pixel_step (ClutterBlurEffect *self,
+                                    CoglPipeline      *pipeline,
+                                    gfloat             x_step,
+                                    gfloat             y_step)
+{
+  gfloat pixel_step[2] = { x_step, y_step };
 
-      cogl_pipeline_set_layer_texture (self->pipeline, 0, texture);
+  if (self->pixel_step_uniform < 0)
+    return;
 
-      return TRUE;
-    }
-  else
-    return FALSE;
+  cogl_pipeline_set_uniform_float (pipeline,
+                                   self->pixel_step_uniform,
+                                   2, /* n_components */
+                                   1, /* count */
+                                   pixel_step);
 }
 
 static void
 clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterOffscreenTarget *blurred = NULL, *scratch = NULL;
+  ClutterOffscreenEffectClass *parent_class;
+  ClutterOffscreenPool *pool = NULL;
+  ClutterActor *stage;
+  CoglHandle texture;
+  ClutterRect rect;
   guint8 paint_opacity;
+  int width, height;
+  guint scale;
+
+  if (self->pass_radius == 0 ||
+      !clutter_offscreen_effect_get_target_rect (effect, &rect))
+    goto out;
+
+  stage = _clutter_actor_get_stage_internal (self->actor);
+  if (stage != NULL)
+    pool = _clutter_stage_get_offscreen_pool (CLUTTER_STAGE (stage));
+
+  if (pool == NULL)
+    goto out;
+
+  texture = clutter_offscreen_effect_get_texture (effect);
+  width = ceilf (clutter_rect_get_width (&rect));
+  height = ceilf (clutter_rect_get_height (&rect));
+
+  /* halve the size of the actor until we get to the downscale factor;
+   * with linear filtering, each pixel is the average of four pixels
+   */
+  for (scale = 1; scale < self->downscale; scale *= 2)
+    {
+      ClutterOffscreenTarget *half;
+
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+
+      half = _clutter_offscreen_pool_acquire (pool, width, height, self);
+      if (half == NULL)
+        goto out;
+
+      clutter_blur_effect_paint_pass (self->downsample_pipeline,
+                                      texture, half,
+                                      width, height,
+                                      2);
+
+      if (blurred != NULL)
+        _clutter_offscreen_target_release (blurred);
+
+      blurred = half;
+      texture = half->texture;
+    }
+
+  scratch = _clutter_offscreen_pool_acquire (pool, width, height, self);
+  if (scratch == NULL)
+    goto out;
+
+  /* we cannot blur in place the texture of the actor, as it is painted
+   * again if the actor does not change
+   */
+  if (blurred == NULL)
+    {
+      blurred = _clutter_offscreen_pool_acquire (pool, width, height, self);
+      if (blurred == NULL)
+        goto out;
+    }
+
+  clutter_blur_effect_set_pixel_step (self, self->horizontal_pipeline,
+                                      1.f / cogl_texture_get_width (texture),
+                                      0.f);
+  clutter_blur_effect_paint_pass (self->horizontal_pipeline,
+                                  texture, scratch,
+                                  width, height,
+                                  1);
+
+  clutter_blur_effect_set_pixel_step (self, self->vertical_pipeline,
+                                      0.f,
+                                      1.f / cogl_texture_get_height (scratch->texture));
+  clutter_blur_effect_paint_pass (self->vertical_pipeline,
+                                  scratch->texture, blurred,
+                                  width, height,
+                                  1);
 
   paint_opacity = clutter_actor_get_paint_opacity (self->actor);
 
@@ -171,28 +408,61 @@ clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
                               paint_opacity,
                               paint_opacity,
                               paint_opacity);
+  cogl_pipeline_set_layer_texture (self->pipeline, 0, blurred->texture);
   cogl_push_source (self->pipeline);
 
-  cogl_rectangle (0, 0, self->tex_width, self->tex_height);
+  /* scale the blurred copy back up */
+  cogl_rectangle_with_texture_coords (0, 0,
+                                      width * self->downscale,
+                                      height * self->downscale,
+                                      0.f, 0.f,
+                                      (gfloat) width / blurred->width,
+                                      (gfloat) height / blurred->height);
 
   cogl_pop_source ();
+
+  _clutter_offscreen_target_release (scratch);
+  _clutter_offscreen_target_release (blurred);
+
+  return;
+
+out:
+  if (scratch != NULL)
+    _clutter_offscreen_target_release (scratch);
+
+  if (blurred != NULL)
+    _clutter_offscreen_target_release (blurred);
+
+  /* we could not blur, so paint the actor as it is */
+  parent_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+  parent_class->paint_target (effect);
 }
 
 static gboolean
 clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
                                       ClutterPaintVolume *volume)
 {
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   gfloat cur_width, cur_height;
   ClutterVertex origin;
+  gfloat padding;
+
+  if (self->radius == 0)
+    return TRUE;
+
+  /* the blur spreads the actor by its radius, and scaling the blurred
+   * copy back up can spread it by a few more pixels
+   */
+  padding = self->radius + self->downscale - 1;
 
   clutter_paint_volume_get_origin (volume, &origin);
   cur_width = clutter_paint_volume_get_width (volume);
   cur_height = clutter_paint_volume_get_height (volume);
 
-  origin.x -= BLUR_PADDING;
-  origin.y -= BLUR_PADDING;
-  cur_width += 2 * BLUR_PADDING;
-  cur_height += 2 * BLUR_PADDING;
+  origin.x -= padding;
+  origin.y -= padding;
+  cur_width += 2 * padding;
+  cur_height += 2 * padding;
   clutter_paint_volume_set_origin (volume, &origin);
   clutter_paint_volume_set_width (volume, cur_width);
   clutter_paint_volume_set_height (volume, cur_height);
@@ -211,9 +481,53 @@ clutter_blur_effect_dispose (GObject *gobject)
       self->pipeline = NULL;
     }
 
+  g_clear_pointer (&self->downsample_pipeline, cogl_object_unref);
+  g_clear_pointer (&self->horizontal_pipeline, cogl_object_unref);
+  g_clear_pointer (&self->vertical_pipeline, cogl_object_unref);
+
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
 
+static void
+clutter_blur_effect_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      clutter_blur_effect_set_radius (effect, g_value_get_uint (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_blur_effect_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      g_value_set_uint (value, effect->radius);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
 {
@@ -221,7 +535,27 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   ClutterOffscreenEffectClass *offscreen_class;
 
+  /**
+   * ClutterBlurEffect:radius:
+   *
+   * The radius of the blur, in pixels; a radius of 0 disables the
+   * blur.
+   *
+   * Since: 1.28
+   */
+  obj_props[PROP_RADIUS] =
+    g_param_spec_uint ("radius",
+                       P_("Radius"),
+                       P_("The radius of the blur"),
+                       0, BLUR_MAX_RADIUS,
+                       BLUR_DEFAULT_RADIUS,
+                       CLUTTER_PARAM_READWRITE);
+
   gobject_class->dispose = clutter_blur_effect_dispose;
+  gobject_class->set_property = clutter_blur_effect_set_property;
+  gobject_class->get_property = clutter_blur_effect_get_property;
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   effect_class->pre_paint = clutter_blur_effect_pre_paint;
   effect_class->get_paint_volume = clutter_blur_effect_get_paint_volume;
@@ -237,28 +571,34 @@ clutter_blur_effect_init (ClutterBlurEffect *self)
 
   if (G_UNLIKELY (klass->base_pipeline == NULL))
     {
-      CoglSnippet *snippet;
       CoglContext *ctx =
         clutter_backend_get_cogl_context (clutter_get_default_backend ());
 
       klass->base_pipeline = cogl_pipeline_new (ctx);
 
-      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
-                                  box_blur_glsl_declarations,
-                                  NULL);
-      cogl_snippet_set_replace (snippet, box_blur_glsl_shader);
-      cogl_pipeline_add_layer_snippet (klass->base_pipeline, 0, snippet);
-      cogl_object_unref (snippet);
-
+      /* all the passes rely on linear filtering, and on the pixels
+       * outside of the textures being the same as their edges
+       */
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
                                             0, /* layer number */
                                             COGL_TEXTURE_TYPE_2D);
+      cogl_pipeline_set_layer_filters (klass->base_pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (klass->base_pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
     }
 
   self->pipeline = cogl_pipeline_copy (klass->base_pipeline);
+  self->downsample_pipeline = cogl_pipeline_copy (klass->base_pipeline);
 
-  self->pixel_step_uniform =
-    cogl_pipeline_get_uniform_location (self->pipeline, "pixel_step");
+  self->pixel_step_uniform = -1;
+
+  self->radius = BLUR_DEFAULT_RADIUS;
+  clutter_blur_effect_update_pipelines (self);
+
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (self),
+                                                  FALSE);
 }
 
 /**
@@ -276,3 +616,57 @@ clutter_blur_effect_new (void)
 {
   return g_object_new (CLUTTER_TYPE_BLUR_EFFECT, NULL);
 }
+
+/**
+ * clutter_blur_effect_set_radius:
+ * @effect: a #ClutterBlurEffect
+ * @radius: the radius of the blur, in pixels
+ *
+ * Sets the radius of the blur applied by @effect. Large radii are
+ * applied on a downsampled copy of the actor, so they are not much
+ * more expensive than small ones.
+ *
+ * Since: 1.28
+ */
+void
+clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                guint              radius)
+{
+  ClutterActor *actor;
+
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+  g_return_if_fail (radius <= BLUR_MAX_RADIUS);
+
+  if (effect->radius == radius)
+    return;
+
+  effect->radius = radius;
+  clutter_blur_effect_update_pipelines (effect);
+
+  /* the paint volume of the actor changes with the radius, so both
+   * the old and the new area have to be redrawn
+   */
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor != NULL)
+    clutter_actor_queue_redraw (actor);
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_RADIUS]);
+}
+
+/**
+ * clutter_blur_effect_get_radius:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the radius of the blur applied by @effect.
+ *
+ * Return value: the radius of the blur, in pixels
+ *
+ * Since: 1.28
+ */
+guint
+clutter_blur_effect_get_radius (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0);
+
+  return effect->radius;
+}
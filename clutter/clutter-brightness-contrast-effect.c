@@ -456,6 +456,9 @@ clutter_brightness_contrast_effect_init (ClutterBrightnessContrastEffect *self)
     cogl_pipeline_get_uniform_location (self->pipeline, "contrast");
 
   update_uniforms (self);
+
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (self),
+                                                  FALSE);
 }
 
 /**
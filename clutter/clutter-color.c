@@ -882,6 +882,15 @@ clutter_color_interpolate (const ClutterColor *initial,
   result->alpha = initial->alpha + (final->alpha - initial->alpha) * progress;
 }
 
+static void
+clutter_color_kernel (gconstpointer a,
+                      gconstpointer b,
+                      gdouble       progress,
+                      gpointer      retval)
+{
+  clutter_color_interpolate (a, b, progress, retval);
+}
+
 static gboolean
 clutter_color_progress (const GValue *a,
                         const GValue *b,
@@ -1052,7 +1061,9 @@ G_DEFINE_BOXED_TYPE_WITH_CODE (ClutterColor, clutter_color,
                                clutter_color_free,
                                CLUTTER_REGISTER_VALUE_TRANSFORM_TO (G_TYPE_STRING, clutter_value_transform_color_string)
                                CLUTTER_REGISTER_VALUE_TRANSFORM_FROM (G_TYPE_STRING, clutter_value_transform_string_color)
-                               CLUTTER_REGISTER_INTERVAL_PROGRESS (clutter_color_progress));
+                               CLUTTER_REGISTER_INTERVAL_KERNEL (clutter_color_progress,
+                                                                 clutter_color_kernel,
+                                                                 sizeof (ClutterColor)));
 
 /**
  * clutter_value_set_color:
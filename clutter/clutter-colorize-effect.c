@@ -307,6 +307,9 @@ clutter_colorize_effect_init (ClutterColorizeEffect *self)
   self->tint = default_tint;
 
   update_tint_uniform (self);
+
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (self),
+                                                  FALSE);
 }
 
 /**
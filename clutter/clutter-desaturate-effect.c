@@ -312,6 +312,9 @@ clutter_desaturate_effect_init (ClutterDesaturateEffect *self)
   self->factor = 1.0;
 
   update_factor_uniform (self);
+
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (self),
+                                                  FALSE);
 }
 
 /**
@@ -93,6 +93,25 @@ struct _ClutterInputDevice
   ClutterActor *cursor_actor;
   GHashTable   *inv_touch_sequence_actors;
 
+  /* the cached hit region of the actor underneath the pointer, used
+   * to avoid picking while the pointer does not leave it; the pointer
+   * must be inside all the quads in pick_cache_regions and outside
+   * all the boxes in pick_cache_occluders
+   */
+  GArray *pick_cache_regions;
+  GArray *pick_cache_occluders;
+  guint32 pick_cache_serial;
+
+  /* the capture and bubble chain of the last event emitted for this
+   * device, and the source actor it was built for; it holds no
+   * references, and it is only valid as long as the scene graph
+   * did not change since it was built; event_chain_in_use is set
+   * while the chain is being walked
+   */
+  GPtrArray *event_chain;
+  ClutterActor *event_chain_source;
+  guint32 event_chain_serial;
+
   /* the actor that has a grab in place for the device */
   ClutterActor *pointer_grab_actor;
   ClutterActor *keyboard_grab_actor;
@@ -134,6 +153,8 @@ struct _ClutterInputDevice
 
   guint has_cursor : 1;
   guint is_enabled : 1;
+  guint pick_cache_valid : 1;
+  guint event_chain_in_use : 1;
 };
 
 struct _ClutterInputDeviceClass
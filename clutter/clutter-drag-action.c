@@ -72,6 +72,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-marshal.h"
+#include "clutter-motion-predictor.h"
 #include "clutter-private.h"
 #include "clutter-stage-private.h"
 
@@ -103,6 +104,9 @@ struct _ClutterDragActionPrivate
   gfloat transformed_press_x;
   gfloat transformed_press_y;
 
+  ClutterMotionPrediction motion_prediction;
+  ClutterMotionPredictor predictor;
+
   guint emit_delayed_press    : 1;
   guint in_drag               : 1;
   guint motion_events_enabled : 1;
@@ -119,6 +123,7 @@ enum
   PROP_DRAG_AXIS,
   PROP_DRAG_AREA,
   PROP_DRAG_AREA_SET,
+  PROP_MOTION_PREDICTION,
 
   PROP_LAST
 };
@@ -203,52 +208,85 @@ emit_drag_begin (ClutterDragAction *action,
 }
 
 static void
-emit_drag_motion (ClutterDragAction *action,
-                  ClutterActor      *actor,
-                  ClutterEvent      *event)
+get_drag_delta (ClutterDragAction *action,
+                ClutterActor      *drag_handle,
+                gfloat             stage_x,
+                gfloat             stage_y,
+                gfloat            *delta_x,
+                gfloat            *delta_y)
 {
   ClutterDragActionPrivate *priv = action->priv;
-  ClutterActor *drag_handle = NULL;
-  gfloat delta_x, delta_y;
   gfloat motion_x, motion_y;
-  gboolean can_emit_drag_motion = TRUE;
-
-  clutter_event_get_coords (event, &priv->last_motion_x, &priv->last_motion_y);
-  priv->last_motion_state = clutter_event_get_state (event);
-  priv->last_motion_device = clutter_event_get_device (event);
-
-  if (priv->drag_handle != NULL && !priv->emit_delayed_press)
-    drag_handle = priv->drag_handle;
-  else
-    drag_handle = actor;
 
   motion_x = motion_y = 0.0f;
   clutter_actor_transform_stage_point (drag_handle,
-                                       priv->last_motion_x,
-                                       priv->last_motion_y,
+                                       stage_x,
+                                       stage_y,
                                        &motion_x, &motion_y);
 
-  delta_x = delta_y = 0.0f;
+  *delta_x = *delta_y = 0.0f;
 
   switch (priv->drag_axis)
     {
     case CLUTTER_DRAG_AXIS_NONE:
-      delta_x = motion_x - priv->transformed_press_x;
-      delta_y = motion_y - priv->transformed_press_y;
+      *delta_x = motion_x - priv->transformed_press_x;
+      *delta_y = motion_y - priv->transformed_press_y;
       break;
 
     case CLUTTER_DRAG_X_AXIS:
-      delta_x = motion_x - priv->transformed_press_x;
+      *delta_x = motion_x - priv->transformed_press_x;
       break;
 
     case CLUTTER_DRAG_Y_AXIS:
-      delta_y = motion_y - priv->transformed_press_y;
+      *delta_y = motion_y - priv->transformed_press_y;
       break;
 
     default:
       g_assert_not_reached ();
       return;
     }
+}
+
+static void
+emit_drag_motion (ClutterDragAction *action,
+                  ClutterActor      *actor,
+                  ClutterEvent      *event)
+{
+  ClutterDragActionPrivate *priv = action->priv;
+  ClutterActor *drag_handle = NULL;
+  gfloat delta_x, delta_y;
+  gfloat stage_x, stage_y;
+  gboolean can_emit_drag_motion = TRUE;
+
+  clutter_event_get_coords (event, &priv->last_motion_x, &priv->last_motion_y);
+  priv->last_motion_state = clutter_event_get_state (event);
+  priv->last_motion_device = clutter_event_get_device (event);
+
+  if (priv->drag_handle != NULL && !priv->emit_delayed_press)
+    drag_handle = priv->drag_handle;
+  else
+    drag_handle = actor;
+
+  stage_x = priv->last_motion_x;
+  stage_y = priv->last_motion_y;
+
+  if (priv->motion_prediction != CLUTTER_MOTION_PREDICTION_NONE)
+    {
+      _clutter_motion_predictor_update (&priv->predictor,
+                                        priv->motion_prediction,
+                                        priv->last_motion_x,
+                                        priv->last_motion_y,
+                                        clutter_event_get_time (event));
+
+      /* the drag threshold applies to the reported position */
+      if (!priv->emit_delayed_press)
+        _clutter_motion_predictor_predict (&priv->predictor,
+                                           priv->motion_prediction,
+                                           _clutter_motion_predictor_get_interval (priv->stage),
+                                           &stage_x, &stage_y);
+    }
+
+  get_drag_delta (action, drag_handle, stage_x, stage_y, &delta_x, &delta_y);
 
   if (priv->emit_delayed_press)
     {
@@ -304,6 +342,40 @@ emit_drag_end (ClutterDragAction *action,
       priv->last_motion_device = clutter_event_get_device (event);
     }
 
+  /* the dragged actor followed the predicted position of the pointer,
+   * which might have overshot; move it back to where the drag ended
+   */
+  if (priv->motion_prediction != CLUTTER_MOTION_PREDICTION_NONE &&
+      !priv->emit_delayed_press &&
+      event != NULL && actor != NULL)
+    {
+      ClutterActor *drag_handle;
+      gfloat delta_x, delta_y;
+      gboolean can_emit_drag_motion = TRUE;
+
+      if (priv->drag_handle != NULL)
+        drag_handle = priv->drag_handle;
+      else
+        drag_handle = actor;
+
+      get_drag_delta (action, drag_handle,
+                      priv->last_motion_x, priv->last_motion_y,
+                      &delta_x, &delta_y);
+
+      if (delta_x != 0.f || delta_y != 0.f)
+        {
+          g_signal_emit (action, drag_signals[DRAG_PROGRESS], 0,
+                         actor,
+                         delta_x, delta_y,
+                         &can_emit_drag_motion);
+
+          if (can_emit_drag_motion)
+            g_signal_emit (action, drag_signals[DRAG_MOTION], 0,
+                           actor,
+                           delta_x, delta_y);
+        }
+    }
+
   priv->in_drag = FALSE;
 
   /* we might not have emitted ::drag-begin yet */
@@ -445,6 +517,10 @@ on_drag_begin (ClutterActor      *actor,
   priv->last_motion_x = priv->press_x;
   priv->last_motion_y = priv->press_y;
 
+  _clutter_motion_predictor_init (&priv->predictor,
+                                  priv->press_x, priv->press_y,
+                                  clutter_event_get_time (event));
+
   priv->transformed_press_x = priv->press_x;
   priv->transformed_press_y = priv->press_y;
   clutter_actor_transform_stage_point (actor, priv->press_x, priv->press_y,
@@ -588,6 +664,10 @@ clutter_drag_action_set_property (GObject      *gobject,
       clutter_drag_action_set_drag_area (action, g_value_get_boxed (value));
       break;
 
+    case PROP_MOTION_PREDICTION:
+      clutter_drag_action_set_motion_prediction (action, g_value_get_enum (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -637,6 +717,10 @@ clutter_drag_action_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->drag_area_set);
       break;
 
+    case PROP_MOTION_PREDICTION:
+      g_value_set_enum (value, priv->motion_prediction);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -830,6 +914,24 @@ clutter_drag_action_class_init (ClutterDragActionClass *klass)
 			  FALSE,
 			  CLUTTER_PARAM_READABLE);
 
+  /**
+   * ClutterDragAction:motion-prediction:
+   *
+   * The predictor used to extrapolate the position of the pointer to
+   * the presentation time of the next frame while dragging.
+   *
+   * See clutter_drag_action_set_motion_prediction().
+   *
+   * Since: 1.28
+   */
+  drag_props[PROP_MOTION_PREDICTION] =
+    g_param_spec_enum ("motion-prediction",
+                       P_("Motion Prediction"),
+                       P_("The predictor used for the pointer"),
+                       CLUTTER_TYPE_MOTION_PREDICTION,
+                       CLUTTER_MOTION_PREDICTION_NONE,
+                       CLUTTER_PARAM_READWRITE);
+
 
   gobject_class->set_property = clutter_drag_action_set_property;
   gobject_class->get_property = clutter_drag_action_get_property;
@@ -1320,3 +1422,53 @@ clutter_drag_action_set_drag_area (ClutterDragAction *action,
   g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_DRAG_AREA_SET]);
   g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_DRAG_AREA]);
 }
+
+/**
+ * clutter_drag_action_set_motion_prediction:
+ * @action: a #ClutterDragAction
+ * @prediction: the predictor to use
+ *
+ * Sets the predictor used to extrapolate the position of the pointer
+ * to the time the next frame is presented, so that the dragged actor
+ * does not lag behind the pointer.
+ *
+ * The delta passed to #ClutterDragAction::drag-motion is computed from
+ * the predicted position; when the drag ends, a last motion is emitted
+ * to move the actor back to the position where the drag ended, in case
+ * the prediction overshot it.
+ *
+ * Since: 1.28
+ */
+void
+clutter_drag_action_set_motion_prediction (ClutterDragAction       *action,
+                                           ClutterMotionPrediction  prediction)
+{
+  g_return_if_fail (CLUTTER_IS_DRAG_ACTION (action));
+
+  if (action->priv->motion_prediction == prediction)
+    return;
+
+  action->priv->motion_prediction = prediction;
+
+  g_object_notify_by_pspec (G_OBJECT (action), drag_props[PROP_MOTION_PREDICTION]);
+}
+
+/**
+ * clutter_drag_action_get_motion_prediction:
+ * @action: a #ClutterDragAction
+ *
+ * Retrieves the predictor set using
+ * clutter_drag_action_set_motion_prediction().
+ *
+ * Return value: the predictor used by @action
+ *
+ * Since: 1.28
+ */
+ClutterMotionPrediction
+clutter_drag_action_get_motion_prediction (ClutterDragAction *action)
+{
+  g_return_val_if_fail (CLUTTER_IS_DRAG_ACTION (action),
+                        CLUTTER_MOTION_PREDICTION_NONE);
+
+  return action->priv->motion_prediction;
+}
@@ -147,6 +147,12 @@ CLUTTER_AVAILABLE_IN_1_12
 void            clutter_drag_action_set_drag_area      (ClutterDragAction *action,
                                                         const ClutterRect *drag_area);
 
+CLUTTER_AVAILABLE_IN_1_28
+void            clutter_drag_action_set_motion_prediction (ClutterDragAction       *action,
+                                                           ClutterMotionPrediction  prediction);
+CLUTTER_AVAILABLE_IN_1_28
+ClutterMotionPrediction clutter_drag_action_get_motion_prediction (ClutterDragAction *action);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_DRAG_ACTION_H__ */
@@ -553,3 +553,280 @@ clutter_easing_for_mode (ClutterAnimationMode mode,
 
   return _clutter_animation_modes[mode].func (t, d);
 }
+
+/*
+ * ClutterEasingTable
+ */
+
+struct _ClutterEasingTable
+{
+  volatile int ref_count;
+
+  /* the curve, either a mode with a plain easing function or
+   * CLUTTER_CUBIC_BEZIER with its control points
+   */
+  ClutterAnimationMode mode;
+  double x_1, y_1;
+  double x_2, y_2;
+
+  /* the exact values at the ends, which some curves do not reach
+   * continuously, like the exponential ones
+   */
+  float start;
+  float end;
+
+  float samples[CLUTTER_EASING_TABLE_SIZE + 1];
+};
+
+/* the first and last samples are taken just inside the range */
+#define EASING_TABLE_EPSILON    1e-9
+
+/* the tables of the plain easing functions live as long as the process;
+ * a curve that cannot be tabulated is marked with the address of this
+ * placeholder, so that we only try once
+ */
+static ClutterEasingTable *mode_tables[CLUTTER_ANIMATION_LAST];
+static char untabulated_mode;
+
+/* the tables of the cubic bezier curves, shared by control points */
+G_LOCK_DEFINE_STATIC (bezier_tables);
+static GSList *bezier_tables = NULL;
+
+static double
+easing_table_evaluate (const ClutterEasingTable *table,
+                       double                    progress)
+{
+  if (table->mode == CLUTTER_CUBIC_BEZIER)
+    return clutter_ease_cubic_bezier (progress, 1.0,
+                                      table->x_1, table->y_1,
+                                      table->x_2, table->y_2);
+
+  return clutter_easing_for_mode (table->mode, progress, 1.0);
+}
+
+/*< private >
+ * easing_table_new:
+ * @mode: the mode of the curve
+ * @x_1, @y_1, @x_2, @y_2: the control points, for a cubic bezier curve
+ *
+ * Samples the curve, and checks the table against the curve in the
+ * middle of each sampling interval, where the interpolation is the
+ * farthest from the samples.
+ *
+ * Return value: the new table, or %NULL if the curve is too steep to
+ *   be reproduced within %CLUTTER_EASING_TABLE_TOLERANCE
+ */
+static ClutterEasingTable *
+easing_table_new (ClutterAnimationMode mode,
+                  double               x_1,
+                  double               y_1,
+                  double               x_2,
+                  double               y_2)
+{
+  ClutterEasingTable *table;
+  int i;
+
+  table = g_new (ClutterEasingTable, 1);
+  table->ref_count = 1;
+  table->mode = mode;
+  table->x_1 = x_1;
+  table->y_1 = y_1;
+  table->x_2 = x_2;
+  table->y_2 = y_2;
+
+  table->start = easing_table_evaluate (table, 0.0);
+  table->end = easing_table_evaluate (table, 1.0);
+
+  for (i = 0; i <= CLUTTER_EASING_TABLE_SIZE; i++)
+    {
+      double p = (double) i / CLUTTER_EASING_TABLE_SIZE;
+
+      p = CLAMP (p, EASING_TABLE_EPSILON, 1.0 - EASING_TABLE_EPSILON);
+
+      table->samples[i] = easing_table_evaluate (table, p);
+    }
+
+  for (i = 0; i < CLUTTER_EASING_TABLE_SIZE; i++)
+    {
+      double p = (i + 0.5) / CLUTTER_EASING_TABLE_SIZE;
+
+      if (fabs (easing_table_evaluate (table, p) -
+                clutter_easing_table_sample (table, p)) > CLUTTER_EASING_TABLE_TOLERANCE)
+        {
+          g_free (table);
+
+          return NULL;
+        }
+    }
+
+  return table;
+}
+
+/*< private >
+ * clutter_easing_table_for_mode:
+ * @mode: a #ClutterAnimationMode
+ *
+ * Retrieves the table of the easing curve of @mode.
+ *
+ * The linear and step modes are not tabulated, since evaluating them
+ * is cheaper than looking them up, and tables cannot reproduce the
+ * jumps of the steps.
+ *
+ * Return value: (transfer full): a reference on the table, or %NULL
+ */
+ClutterEasingTable *
+clutter_easing_table_for_mode (ClutterAnimationMode mode)
+{
+  ClutterEasingTable *table;
+
+  switch (mode)
+    {
+    case CLUTTER_CUSTOM_MODE:
+    case CLUTTER_LINEAR:
+    case CLUTTER_STEPS:
+    case CLUTTER_STEP_START:
+    case CLUTTER_STEP_END:
+    case CLUTTER_CUBIC_BEZIER:
+      return NULL;
+
+    case CLUTTER_EASE:
+      return clutter_easing_table_for_cubic_bezier (0.25, 0.1, 0.25, 1.0);
+
+    case CLUTTER_EASE_IN:
+      return clutter_easing_table_for_cubic_bezier (0.42, 0.0, 1.0, 1.0);
+
+    case CLUTTER_EASE_OUT:
+      return clutter_easing_table_for_cubic_bezier (0.0, 0.0, 0.58, 1.0);
+
+    case CLUTTER_EASE_IN_OUT:
+      return clutter_easing_table_for_cubic_bezier (0.42, 0.0, 0.58, 1.0);
+
+    default:
+      break;
+    }
+
+  g_return_val_if_fail (mode < CLUTTER_ANIMATION_LAST, NULL);
+
+  if (g_once_init_enter (&mode_tables[mode]))
+    {
+      table = easing_table_new (mode, 0.0, 0.0, 0.0, 0.0);
+
+      if (table == NULL)
+        table = (ClutterEasingTable *) &untabulated_mode;
+
+      g_once_init_leave (&mode_tables[mode], table);
+    }
+
+  table = mode_tables[mode];
+  if (table == (ClutterEasingTable *) &untabulated_mode)
+    return NULL;
+
+  return clutter_easing_table_ref (table);
+}
+
+/*< private >
+ * clutter_easing_table_for_cubic_bezier:
+ * @x_1: the X coordinate of the first control point
+ * @y_1: the Y coordinate of the first control point
+ * @x_2: the X coordinate of the second control point
+ * @y_2: the Y coordinate of the second control point
+ *
+ * Retrieves the table of a cubic bezier curve; the tables are shared
+ * between the curves with the same control points.
+ *
+ * Return value: (transfer full): a reference on the table, or %NULL
+ *   if the curve is too steep to be tabulated
+ */
+ClutterEasingTable *
+clutter_easing_table_for_cubic_bezier (double x_1,
+                                       double y_1,
+                                       double x_2,
+                                       double y_2)
+{
+  ClutterEasingTable *table = NULL;
+  GSList *l;
+
+  G_LOCK (bezier_tables);
+
+  for (l = bezier_tables; l != NULL; l = l->next)
+    {
+      ClutterEasingTable *iter = l->data;
+
+      if (iter->x_1 == x_1 && iter->y_1 == y_1 &&
+          iter->x_2 == x_2 && iter->y_2 == y_2)
+        {
+          table = clutter_easing_table_ref (iter);
+          break;
+        }
+    }
+
+  if (table == NULL)
+    {
+      table = easing_table_new (CLUTTER_CUBIC_BEZIER, x_1, y_1, x_2, y_2);
+
+      if (table != NULL)
+        bezier_tables = g_slist_prepend (bezier_tables, table);
+    }
+
+  G_UNLOCK (bezier_tables);
+
+  return table;
+}
+
+ClutterEasingTable *
+clutter_easing_table_ref (ClutterEasingTable *table)
+{
+  g_atomic_int_inc (&table->ref_count);
+
+  return table;
+}
+
+void
+clutter_easing_table_unref (ClutterEasingTable *table)
+{
+  /* the tables of the plain easing functions are never released */
+  if (table->mode != CLUTTER_CUBIC_BEZIER)
+    {
+      g_atomic_int_add (&table->ref_count, -1);
+      return;
+    }
+
+  G_LOCK (bezier_tables);
+
+  if (g_atomic_int_dec_and_test (&table->ref_count))
+    {
+      bezier_tables = g_slist_remove (bezier_tables, table);
+      g_free (table);
+    }
+
+  G_UNLOCK (bezier_tables);
+}
+
+/*< private >
+ * clutter_easing_table_sample:
+ * @table: a #ClutterEasingTable
+ * @progress: the linear progress, between 0 and 1
+ *
+ * Looks up the value of the curve of @table at @progress.
+ *
+ * Return value: the eased progress
+ */
+double
+clutter_easing_table_sample (const ClutterEasingTable *table,
+                             double                    progress)
+{
+  double x, frac;
+  int i;
+
+  if (progress <= 0.0)
+    return table->start;
+
+  if (progress >= 1.0)
+    return table->end;
+
+  x = progress * CLUTTER_EASING_TABLE_SIZE;
+  i = (int) x;
+  frac = x - i;
+
+  return table->samples[i] + (table->samples[i + 1] - table->samples[i]) * frac;
+}
@@ -137,6 +137,37 @@ double  clutter_ease_cubic_bezier       (double t,
                                          double x_2,
                                          double y_2);
 
+/*< private >
+ * ClutterEasingTable:
+ *
+ * A precomputed table of the values of an easing curve, sampled at
+ * %CLUTTER_EASING_TABLE_SIZE intervals of the [ 0, 1 ] range of the
+ * progress and linearly interpolated in between.
+ *
+ * A table only exists if it reproduces its curve within
+ * %CLUTTER_EASING_TABLE_TOLERANCE.
+ */
+typedef struct _ClutterEasingTable      ClutterEasingTable;
+
+#define CLUTTER_EASING_TABLE_SIZE       4096
+#define CLUTTER_EASING_TABLE_TOLERANCE  1e-3
+
+G_GNUC_INTERNAL
+ClutterEasingTable *    clutter_easing_table_for_mode           (ClutterAnimationMode      mode);
+G_GNUC_INTERNAL
+ClutterEasingTable *    clutter_easing_table_for_cubic_bezier   (double                    x_1,
+                                                                 double                    y_1,
+                                                                 double                    x_2,
+                                                                 double                    y_2);
+G_GNUC_INTERNAL
+ClutterEasingTable *    clutter_easing_table_ref                (ClutterEasingTable       *table);
+G_GNUC_INTERNAL
+void                    clutter_easing_table_unref              (ClutterEasingTable       *table);
+
+G_GNUC_INTERNAL
+double                  clutter_easing_table_sample             (const ClutterEasingTable *table,
+                                                                 double                    progress);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EASING_H__ */
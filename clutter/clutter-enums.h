@@ -1484,6 +1484,29 @@ typedef enum {
   CLUTTER_SCROLL_FINISHED_VERTICAL   = 1 << 1
 } ClutterScrollFinishFlags;
 
+/**
+ * ClutterMotionPrediction:
+ * @CLUTTER_MOTION_PREDICTION_NONE: Use the last reported position of
+ *   the pointer or touch point
+ * @CLUTTER_MOTION_PREDICTION_LINEAR: Extrapolate the position using the
+ *   velocity between the last two motion events
+ * @CLUTTER_MOTION_PREDICTION_SMOOTHED: Extrapolate the position using a
+ *   velocity filtered over the whole motion history; this is less
+ *   responsive to sudden changes of direction, but it is not affected
+ *   by jitter in the reported positions
+ *
+ * The predictor used by #ClutterGestureAction and #ClutterDragAction to
+ * extrapolate the position of a pointer or touch point to the time the
+ * next frame is going to be presented.
+ *
+ * Since: 1.28
+ */
+typedef enum {
+  CLUTTER_MOTION_PREDICTION_NONE = 0,
+  CLUTTER_MOTION_PREDICTION_LINEAR,
+  CLUTTER_MOTION_PREDICTION_SMOOTHED
+} ClutterMotionPrediction;
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ENUMS_H__ */
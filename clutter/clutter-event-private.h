@@ -31,6 +31,8 @@ void            _clutter_event_set_state_full           (ClutterEvent        *ev
 void            _clutter_event_push                     (const ClutterEvent *event,
                                                          gboolean            do_copy);
 
+void            _clutter_event_reset                    (ClutterEvent       *event);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EVENT_PRIVATE_H__ */
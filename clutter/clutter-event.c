@@ -34,6 +34,7 @@
 #include "clutter-private.h"
 
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:clutter-event
@@ -1317,6 +1318,38 @@ clutter_event_copy (const ClutterEvent *event)
   return new_event;
 }
 
+static void
+clutter_event_free_data (ClutterEvent *event)
+{
+  _clutter_backend_free_event_data (clutter_get_default_backend (), event);
+
+  switch (event->type)
+    {
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+      g_free (event->button.axes);
+      break;
+
+    case CLUTTER_MOTION:
+      g_free (event->motion.axes);
+      break;
+
+    case CLUTTER_SCROLL:
+      g_free (event->scroll.axes);
+      break;
+
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCH_CANCEL:
+      g_free (event->touch.axes);
+      break;
+
+    default:
+      break;
+    }
+}
+
 /**
  * clutter_event_free:
  * @event: A #ClutterEvent.
@@ -1328,39 +1361,35 @@ clutter_event_free (ClutterEvent *event)
 {
   if (G_LIKELY (event != NULL))
     {
-      _clutter_backend_free_event_data (clutter_get_default_backend (), event);
-
-      switch (event->type)
-        {
-        case CLUTTER_BUTTON_PRESS:
-        case CLUTTER_BUTTON_RELEASE:
-          g_free (event->button.axes);
-          break;
-
-        case CLUTTER_MOTION:
-          g_free (event->motion.axes);
-          break;
-
-        case CLUTTER_SCROLL:
-          g_free (event->scroll.axes);
-          break;
-
-        case CLUTTER_TOUCH_BEGIN:
-        case CLUTTER_TOUCH_UPDATE:
-        case CLUTTER_TOUCH_END:
-        case CLUTTER_TOUCH_CANCEL:
-          g_free (event->touch.axes);
-          break;
-
-        default:
-          break;
-        }
+      clutter_event_free_data (event);
 
       g_hash_table_remove (all_events, event);
       g_slice_free (ClutterEventPrivate, (ClutterEventPrivate *) event);
     }
 }
 
+/*< private >
+ * _clutter_event_reset:
+ * @event: a #ClutterEvent allocated using clutter_event_new()
+ *
+ * Releases the resources held by @event and resets it to a newly
+ * created %CLUTTER_NOTHING event, without releasing the memory of
+ * the event itself.
+ *
+ * This allows backends to recycle events that could not be
+ * translated, or that were coalesced with newer events.
+ */
+void
+_clutter_event_reset (ClutterEvent *event)
+{
+  g_return_if_fail (is_event_allocated (event));
+
+  clutter_event_free_data (event);
+
+  memset (event, 0, sizeof (ClutterEventPrivate));
+  event->type = event->any.type = CLUTTER_NOTHING;
+}
+
 /**
  * clutter_event_get:
  *
@@ -26,6 +26,11 @@
 
 G_BEGIN_DECLS
 
+void    _clutter_gesture_action_get_predicted_delta     (ClutterGestureAction *action,
+                                                         guint                 point,
+                                                         gfloat               *delta_x,
+                                                         gfloat               *delta_y);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_GESTURE_ACTION_PRIVATE_H__ */
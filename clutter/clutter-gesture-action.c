@@ -92,7 +92,9 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-marshal.h"
+#include "clutter-motion-predictor.h"
 #include "clutter-private.h"
+#include "clutter-touch-table.h"
 
 #include <math.h>
 
@@ -111,6 +113,10 @@ typedef struct
   gint64 last_delta_time;
   gfloat last_delta_x, last_delta_y;
   gfloat release_x, release_y;
+
+  ClutterMotionPredictor predictor;
+  gfloat predicted_x, predicted_y;
+  gfloat predicted_delta_x, predicted_delta_y;
 } GesturePoint;
 
 struct _ClutterGestureActionPrivate
@@ -118,7 +124,9 @@ struct _ClutterGestureActionPrivate
   ClutterActor *stage;
 
   gint requested_nb_points;
-  GArray *points;
+
+  /* GesturePoint, keyed on the device and sequence of each point */
+  ClutterTouchTable *points;
 
   guint actor_capture_id;
   gulong stage_capture_id;
@@ -126,6 +134,8 @@ struct _ClutterGestureActionPrivate
   ClutterGestureTriggerEdge edge;
   float distance_x, distance_y;
 
+  ClutterMotionPrediction motion_prediction;
+
   guint in_gesture : 1;
 };
 
@@ -137,6 +147,7 @@ enum
   PROP_THRESHOLD_TRIGGER_EDGE,
   PROP_THRESHOLD_TRIGGER_DISTANCE_X,
   PROP_THRESHOLD_TRIGGER_DISTANCE_Y,
+  PROP_MOTION_PREDICTION,
 
   PROP_LAST
 };
@@ -162,14 +173,22 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   ClutterGestureActionPrivate *priv = action->priv;
   GesturePoint *point = NULL;
 
-  if (priv->points->len >= MAX_GESTURE_POINTS)
+  ClutterInputDevice *device = clutter_event_get_device (event);
+  ClutterEventSequence *sequence;
+
+  if (_clutter_touch_table_get_size (priv->points) >= MAX_GESTURE_POINTS)
     return NULL;
 
-  g_array_set_size (priv->points, priv->points->len + 1);
-  point = &g_array_index (priv->points, GesturePoint, priv->points->len - 1);
+  if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS)
+    sequence = clutter_event_get_event_sequence (event);
+  else
+    sequence = NULL;
+
+  point = _clutter_touch_table_insert (priv->points, device, sequence, NULL);
 
   point->last_event = clutter_event_copy (event);
-  point->device = clutter_event_get_device (event);
+  point->device = device;
+  point->sequence = sequence;
 
   clutter_event_get_coords (event, &point->press_x, &point->press_y);
   point->last_motion_x = point->press_x;
@@ -179,10 +198,11 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   point->last_delta_x = point->last_delta_y = 0;
   point->last_delta_time = 0;
 
-  if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS)
-    point->sequence = clutter_event_get_event_sequence (event);
-  else
-    point->sequence = NULL;
+  _clutter_motion_predictor_init (&point->predictor,
+                                  point->press_x, point->press_y,
+                                  clutter_event_get_time (event));
+  point->predicted_x = point->press_x;
+  point->predicted_y = point->press_y;
 
   return point;
 }
@@ -190,51 +210,53 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
 static GesturePoint *
 gesture_find_point (ClutterGestureAction *action,
                     ClutterEvent *event,
-                    gint *position)
+                    gint *slot)
 {
   ClutterGestureActionPrivate *priv = action->priv;
-  GesturePoint *point = NULL;
   ClutterEventType type = clutter_event_type (event);
   ClutterInputDevice *device = clutter_event_get_device (event);
   ClutterEventSequence *sequence = NULL;
-  gint i;
 
   if ((type != CLUTTER_BUTTON_PRESS) &&
       (type != CLUTTER_BUTTON_RELEASE) &&
       (type != CLUTTER_MOTION))
     sequence = clutter_event_get_event_sequence (event);
 
-  for (i = 0; i < priv->points->len; i++)
-    {
-      if ((g_array_index (priv->points, GesturePoint, i).device == device) &&
-          (g_array_index (priv->points, GesturePoint, i).sequence == sequence))
-        {
-          if (position != NULL)
-            *position = i;
-          point = &g_array_index (priv->points, GesturePoint, i);
-          break;
-        }
-    }
+  return _clutter_touch_table_lookup (priv->points, device, sequence, slot);
+}
 
-  return point;
+static inline GesturePoint *
+gesture_get_point (ClutterGestureAction *action,
+                   guint                 point)
+{
+  return _clutter_touch_table_get_nth (action->priv->points, point);
+}
+
+static inline guint
+gesture_get_n_points (ClutterGestureAction *action)
+{
+  return _clutter_touch_table_get_size (action->priv->points);
 }
 
 static void
-gesture_unregister_point (ClutterGestureAction *action, gint position)
+gesture_unregister_point (ClutterGestureAction *action, gint slot)
 {
   ClutterGestureActionPrivate *priv = action->priv;
 
-  if (action->priv->points->len == 0)
+  if (gesture_get_n_points (action) == 0)
     return;
 
-  g_array_remove_index (priv->points, position);
+  _clutter_touch_table_remove (priv->points, slot);
 }
 
 static void
-gesture_update_motion_point (GesturePoint *point,
-                             ClutterEvent *event)
+gesture_update_motion_point (ClutterGestureAction *action,
+                             GesturePoint         *point,
+                             ClutterEvent         *event)
 {
+  ClutterGestureActionPrivate *priv = action->priv;
   gfloat motion_x, motion_y;
+  gfloat predicted_x, predicted_y;
   gint64 _time;
 
   clutter_event_get_coords (event, &motion_x, &motion_y);
@@ -250,6 +272,35 @@ gesture_update_motion_point (GesturePoint *point,
   _time = clutter_event_get_time (event);
   point->last_delta_time = _time - point->last_motion_time;
   point->last_motion_time = _time;
+
+  if (priv->motion_prediction == CLUTTER_MOTION_PREDICTION_NONE)
+    {
+      predicted_x = motion_x;
+      predicted_y = motion_y;
+    }
+  else
+    {
+      guint interval;
+
+      /* the interval is relative to the time the event is handled,
+       * so we cannot defer the prediction to the getters
+       */
+      interval = _clutter_motion_predictor_get_interval (CLUTTER_STAGE (priv->stage));
+
+      _clutter_motion_predictor_update (&point->predictor,
+                                        priv->motion_prediction,
+                                        motion_x, motion_y,
+                                        _time);
+      _clutter_motion_predictor_predict (&point->predictor,
+                                         priv->motion_prediction,
+                                         interval,
+                                         &predicted_x, &predicted_y);
+    }
+
+  point->predicted_delta_x = predicted_x - point->predicted_x;
+  point->predicted_delta_y = predicted_y - point->predicted_y;
+  point->predicted_x = predicted_x;
+  point->predicted_y = predicted_y;
 }
 
 static void
@@ -319,7 +370,7 @@ cancel_gesture (ClutterGestureAction *action)
   actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (action));
   g_signal_emit (action, gesture_signals[GESTURE_CANCEL], 0, actor);
 
-  g_array_set_size (action->priv->points, 0);
+  _clutter_touch_table_remove_all (action->priv->points);
 }
 
 static gboolean
@@ -361,7 +412,7 @@ stage_captured_event_cb (ClutterActor         *stage,
 {
   ClutterGestureActionPrivate *priv = action->priv;
   ClutterActor *actor;
-  gint position;
+  gint slot;
   float threshold_x, threshold_y;
   gboolean return_value;
   GesturePoint *point;
@@ -375,7 +426,7 @@ stage_captured_event_cb (ClutterActor         *stage,
       event_type != CLUTTER_BUTTON_RELEASE)
     return CLUTTER_EVENT_PROPAGATE;
 
-  if ((point = gesture_find_point (action, event, &position)) == NULL)
+  if ((point = gesture_find_point (action, event, &slot)) == NULL)
     return CLUTTER_EVENT_PROPAGATE;
 
   actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (action));
@@ -401,9 +452,9 @@ stage_captured_event_cb (ClutterActor         *stage,
     case CLUTTER_TOUCH_UPDATE:
       if (!priv->in_gesture)
         {
-          if (priv->points->len < priv->requested_nb_points)
+          if (gesture_get_n_points (action) < priv->requested_nb_points)
             {
-              gesture_update_motion_point (point, event);
+              gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
@@ -412,22 +463,22 @@ stage_captured_event_cb (ClutterActor         *stage,
           if (priv->edge == CLUTTER_GESTURE_TRIGGER_EDGE_AFTER &&
               gesture_point_pass_threshold (action, point, event))
             {
-              gesture_update_motion_point (point, event);
+              gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
           if (!begin_gesture (action, actor))
             {
-              if ((point = gesture_find_point (action, event, &position)) != NULL)
-                gesture_update_motion_point (point, event);
+              if ((point = gesture_find_point (action, event, &slot)) != NULL)
+                gesture_update_motion_point (action, point, event);
               return CLUTTER_EVENT_PROPAGATE;
             }
 
-          if ((point = gesture_find_point (action, event, &position)) == NULL)
+          if ((point = gesture_find_point (action, event, &slot)) == NULL)
             return CLUTTER_EVENT_PROPAGATE;
         }
 
-      gesture_update_motion_point (point, event);
+      gesture_update_motion_point (action, point, event);
 
       g_signal_emit (action, gesture_signals[GESTURE_PROGRESS], 0, actor,
                      &return_value);
@@ -455,13 +506,13 @@ stage_captured_event_cb (ClutterActor         *stage,
         gesture_update_release_point (point, event);
 
         if (priv->in_gesture &&
-            ((priv->points->len - 1) < priv->requested_nb_points))
+            ((gesture_get_n_points (action) - 1) < priv->requested_nb_points))
           {
             priv->in_gesture = FALSE;
             g_signal_emit (action, gesture_signals[GESTURE_END], 0, actor);
           }
 
-        gesture_unregister_point (action, position);
+        gesture_unregister_point (action, slot);
       }
       break;
 
@@ -475,7 +526,7 @@ stage_captured_event_cb (ClutterActor         *stage,
             cancel_gesture (action);
           }
 
-        gesture_unregister_point (action, position);
+        gesture_unregister_point (action, slot);
       }
       break;
 
@@ -483,7 +534,7 @@ stage_captured_event_cb (ClutterActor         *stage,
       break;
     }
 
-  if (priv->points->len == 0 && priv->stage_capture_id)
+  if (gesture_get_n_points (action) == 0 && priv->stage_capture_id)
     {
       g_signal_handler_disconnect (priv->stage, priv->stage_capture_id);
       priv->stage_capture_id = 0;
@@ -520,7 +571,7 @@ actor_captured_event_cb (ClutterActor *actor,
 
   /* Start the gesture immediately if the gesture has no
    * _TRIGGER_EDGE_AFTER drag threshold. */
-  if ((priv->points->len >= priv->requested_nb_points) &&
+  if ((gesture_get_n_points (action) >= priv->requested_nb_points) &&
       (priv->edge != CLUTTER_GESTURE_TRIGGER_EDGE_AFTER))
     begin_gesture (action, actor);
 
@@ -598,6 +649,10 @@ clutter_gesture_action_set_property (GObject      *gobject,
       clutter_gesture_action_set_threshold_trigger_distance (self, self->priv->distance_x, g_value_get_float (value));
       break;
 
+    case PROP_MOTION_PREDICTION:
+      clutter_gesture_action_set_motion_prediction (self, g_value_get_enum (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -636,6 +691,10 @@ clutter_gesture_action_get_property (GObject    *gobject,
         g_value_set_float (value, gesture_get_default_threshold ());
       break;
 
+    case PROP_MOTION_PREDICTION:
+      g_value_set_enum (value, self->priv->motion_prediction);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -647,7 +706,7 @@ clutter_gesture_action_finalize (GObject *gobject)
 {
   ClutterGestureActionPrivate *priv = CLUTTER_GESTURE_ACTION (gobject)->priv;
 
-  g_array_unref (priv->points);
+  _clutter_touch_table_free (priv->points);
 
   G_OBJECT_CLASS (clutter_gesture_action_parent_class)->finalize (gobject);
 }
@@ -738,6 +797,24 @@ clutter_gesture_action_class_init (ClutterGestureActionClass *klass)
                         CLUTTER_PARAM_READWRITE |
                         G_PARAM_CONSTRUCT_ONLY);
 
+  /**
+   * ClutterGestureAction:motion-prediction:
+   *
+   * The predictor used to extrapolate the position of the touch
+   * points to the presentation time of the next frame.
+   *
+   * See clutter_gesture_action_get_predicted_coords().
+   *
+   * Since: 1.28
+   */
+  gesture_props[PROP_MOTION_PREDICTION] =
+    g_param_spec_enum ("motion-prediction",
+                       P_("Motion Prediction"),
+                       P_("The predictor used for the touch points"),
+                       CLUTTER_TYPE_MOTION_PREDICTION,
+                       CLUTTER_MOTION_PREDICTION_NONE,
+                       CLUTTER_PARAM_READWRITE);
+
   g_object_class_install_properties (gobject_class,
                                      PROP_LAST,
                                      gesture_props);
@@ -840,8 +917,9 @@ clutter_gesture_action_init (ClutterGestureAction *self)
 {
   self->priv = clutter_gesture_action_get_instance_private (self);
 
-  self->priv->points = g_array_sized_new (FALSE, TRUE, sizeof (GesturePoint), 3);
-  g_array_set_clear_func (self->priv->points, (GDestroyNotify) gesture_point_unset);
+  self->priv->points =
+    _clutter_touch_table_new (sizeof (GesturePoint),
+                              (GDestroyNotify) gesture_point_unset);
 
   self->priv->requested_nb_points = 1;
   self->priv->edge = CLUTTER_GESTURE_TRIGGER_EDGE_NONE;
@@ -884,17 +962,13 @@ clutter_gesture_action_get_press_coords (ClutterGestureAction *action,
                                          gfloat               *press_y)
 {
   g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
-  g_return_if_fail (action->priv->points->len > point);
+  g_return_if_fail (gesture_get_n_points (action) > point);
 
   if (press_x)
-    *press_x = g_array_index (action->priv->points,
-                              GesturePoint,
-                              point).press_x;
+    *press_x = gesture_get_point (action, point)->press_x;
 
   if (press_y)
-    *press_y = g_array_index (action->priv->points,
-                              GesturePoint,
-                              point).press_y;
+    *press_y = gesture_get_point (action, point)->press_y;
 }
 
 /**
@@ -919,17 +993,13 @@ clutter_gesture_action_get_motion_coords (ClutterGestureAction *action,
                                           gfloat               *motion_y)
 {
   g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
-  g_return_if_fail (action->priv->points->len > point);
+  g_return_if_fail (gesture_get_n_points (action) > point);
 
   if (motion_x)
-    *motion_x = g_array_index (action->priv->points,
-                               GesturePoint,
-                               point).last_motion_x;
+    *motion_x = gesture_get_point (action, point)->last_motion_x;
 
   if (motion_y)
-    *motion_y = g_array_index (action->priv->points,
-                               GesturePoint,
-                               point).last_motion_y;
+    *motion_y = gesture_get_point (action, point)->last_motion_y;
 }
 
 /**
@@ -958,14 +1028,10 @@ clutter_gesture_action_get_motion_delta (ClutterGestureAction *action,
   gfloat d_x, d_y;
 
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
-  g_return_val_if_fail (action->priv->points->len > point, 0);
+  g_return_val_if_fail (gesture_get_n_points (action) > point, 0);
 
-  d_x = g_array_index (action->priv->points,
-                       GesturePoint,
-                       point).last_delta_x;
-  d_y = g_array_index (action->priv->points,
-                       GesturePoint,
-                       point).last_delta_y;
+  d_x = gesture_get_point (action, point)->last_delta_x;
+  d_y = gesture_get_point (action, point)->last_delta_y;
 
   if (delta_x)
     *delta_x = d_x;
@@ -998,17 +1064,13 @@ clutter_gesture_action_get_release_coords (ClutterGestureAction *action,
                                            gfloat               *release_y)
 {
   g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
-  g_return_if_fail (action->priv->points->len > point);
+  g_return_if_fail (gesture_get_n_points (action) > point);
 
   if (release_x)
-    *release_x = g_array_index (action->priv->points,
-                                GesturePoint,
-                                point).release_x;
+    *release_x = gesture_get_point (action, point)->release_x;
 
   if (release_y)
-    *release_y = g_array_index (action->priv->points,
-                                GesturePoint,
-                                point).release_y;
+    *release_y = gesture_get_point (action, point)->release_y;
 }
 
 /**
@@ -1036,14 +1098,12 @@ clutter_gesture_action_get_velocity (ClutterGestureAction *action,
   gint64 d_t;
 
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
-  g_return_val_if_fail (action->priv->points->len > point, 0);
+  g_return_val_if_fail (gesture_get_n_points (action) > point, 0);
 
   distance = clutter_gesture_action_get_motion_delta (action, point,
                                                       &d_x, &d_y);
 
-  d_t = g_array_index (action->priv->points,
-                       GesturePoint,
-                       point).last_delta_time;
+  d_t = gesture_get_point (action, point)->last_delta_time;
 
   if (velocity_x)
     *velocity_x = d_t > FLOAT_EPSILON ? d_x / d_t : 0;
@@ -1100,12 +1160,12 @@ clutter_gesture_action_set_n_touch_points (ClutterGestureAction *action,
 
   if (priv->in_gesture)
     {
-      if (priv->points->len < priv->requested_nb_points)
+      if (gesture_get_n_points (action) < priv->requested_nb_points)
         cancel_gesture (action);
     }
   else if (priv->edge == CLUTTER_GESTURE_TRIGGER_EDGE_AFTER)
     {
-      if (priv->points->len >= priv->requested_nb_points)
+      if (gesture_get_n_points (action) >= priv->requested_nb_points)
         {
           ClutterActor *actor =
             clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (action));
@@ -1114,9 +1174,9 @@ clutter_gesture_action_set_n_touch_points (ClutterGestureAction *action,
 
           clutter_gesture_action_get_threshold_trigger_distance (action, &threshold_x, &threshold_y);
 
-          for (i = 0; i < priv->points->len; i++)
+          for (i = 0; i < gesture_get_n_points (action); i++)
             {
-              GesturePoint *point = &g_array_index (priv->points, GesturePoint, i);
+              GesturePoint *point = gesture_get_point (action, i);
 
               if ((fabsf (point->press_y - point->last_motion_y) >= threshold_y) ||
                   (fabsf (point->press_x - point->last_motion_x) >= threshold_x))
@@ -1147,7 +1207,7 @@ clutter_gesture_action_get_n_current_points (ClutterGestureAction *action)
 {
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
 
-  return action->priv->points->len;
+  return gesture_get_n_points (action);
 }
 
 /**
@@ -1166,9 +1226,9 @@ clutter_gesture_action_get_sequence (ClutterGestureAction *action,
                                      guint                 point)
 {
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), NULL);
-  g_return_val_if_fail (action->priv->points->len > point, NULL);
+  g_return_val_if_fail (gesture_get_n_points (action) > point, NULL);
 
-  return g_array_index (action->priv->points, GesturePoint, point).sequence;
+  return gesture_get_point (action, point)->sequence;
 }
 
 /**
@@ -1188,9 +1248,9 @@ clutter_gesture_action_get_device (ClutterGestureAction *action,
                                    guint                 point)
 {
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), NULL);
-  g_return_val_if_fail (action->priv->points->len > point, NULL);
+  g_return_val_if_fail (gesture_get_n_points (action) > point, NULL);
 
-  return g_array_index (action->priv->points, GesturePoint, point).device;
+  return gesture_get_point (action, point)->device;
 }
 
 /**
@@ -1212,9 +1272,9 @@ clutter_gesture_action_get_last_event (ClutterGestureAction *action,
   GesturePoint *gesture_point;
 
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), NULL);
-  g_return_val_if_fail (action->priv->points->len > point, NULL);
+  g_return_val_if_fail (gesture_get_n_points (action) > point, NULL);
 
-  gesture_point = &g_array_index (action->priv->points, GesturePoint, point);
+  gesture_point = gesture_get_point (action, point);
 
   return gesture_point->last_event;
 }
@@ -1366,3 +1426,119 @@ clutter_gesture_action_get_threshold_trigger_distance (ClutterGestureAction *act
         *y = gesture_get_default_threshold ();
     }
 }
+
+/**
+ * clutter_gesture_action_set_motion_prediction:
+ * @action: a #ClutterGestureAction
+ * @prediction: the predictor to use
+ *
+ * Sets the predictor used to extrapolate the position of the touch
+ * points of @action to the time the next frame is presented.
+ *
+ * The position reported by an input device is always at least one
+ * frame old by the time an actor that follows it is on screen; using
+ * a predictor hides part of that latency, at the cost of overshooting
+ * when the touch point changes direction.
+ *
+ * The default handler of the #ClutterPanAction::pan signal follows the
+ * predicted position of the touch point, and moves back to the last
+ * reported position when the gesture ends.
+ *
+ * Since: 1.28
+ */
+void
+clutter_gesture_action_set_motion_prediction (ClutterGestureAction    *action,
+                                              ClutterMotionPrediction  prediction)
+{
+  g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
+
+  if (action->priv->motion_prediction == prediction)
+    return;
+
+  action->priv->motion_prediction = prediction;
+
+  g_object_notify_by_pspec (G_OBJECT (action), gesture_props[PROP_MOTION_PREDICTION]);
+}
+
+/**
+ * clutter_gesture_action_get_motion_prediction:
+ * @action: a #ClutterGestureAction
+ *
+ * Retrieves the predictor set using
+ * clutter_gesture_action_set_motion_prediction().
+ *
+ * Return value: the predictor used by @action
+ *
+ * Since: 1.28
+ */
+ClutterMotionPrediction
+clutter_gesture_action_get_motion_prediction (ClutterGestureAction *action)
+{
+  g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action),
+                        CLUTTER_MOTION_PREDICTION_NONE);
+
+  return action->priv->motion_prediction;
+}
+
+/**
+ * clutter_gesture_action_get_predicted_coords:
+ * @action: a #ClutterGestureAction
+ * @point: the touch point index, with 0 being the first touch
+ *   point received by the action
+ * @predicted_x: (out) (allow-none): return location for the predicted
+ *   X coordinate, or %NULL
+ * @predicted_y: (out) (allow-none): return location for the predicted
+ *   Y coordinate, or %NULL
+ *
+ * Retrieves the coordinates, in stage space, of the touch point at the
+ * time the next frame is presented, as extrapolated at the latest
+ * motion event by the #ClutterGestureAction:motion-prediction predictor.
+ *
+ * If no predictor is set, this function returns the same coordinates
+ * as clutter_gesture_action_get_motion_coords().
+ *
+ * Since: 1.28
+ */
+void
+clutter_gesture_action_get_predicted_coords (ClutterGestureAction *action,
+                                             guint                 point,
+                                             gfloat               *predicted_x,
+                                             gfloat               *predicted_y)
+{
+  g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
+  g_return_if_fail (gesture_get_n_points (action) > point);
+
+  if (predicted_x)
+    *predicted_x = gesture_get_point (action, point)->predicted_x;
+
+  if (predicted_y)
+    *predicted_y = gesture_get_point (action, point)->predicted_y;
+}
+
+/*< private >
+ * _clutter_gesture_action_get_predicted_delta:
+ * @action: a #ClutterGestureAction
+ * @point: the touch point index
+ * @delta_x: (out) (allow-none): return location for the X delta
+ * @delta_y: (out) (allow-none): return location for the Y delta
+ *
+ * Retrieves the difference between the predicted coordinates of
+ * @point at the latest motion event and the ones at the motion event
+ * before it; this is the motion delta to apply to an actor following
+ * the predicted position.
+ */
+void
+_clutter_gesture_action_get_predicted_delta (ClutterGestureAction *action,
+                                             guint                 point,
+                                             gfloat               *delta_x,
+                                             gfloat               *delta_y)
+{
+  g_return_if_fail (CLUTTER_IS_GESTURE_ACTION (action));
+  g_return_if_fail (gesture_get_n_points (action) > point);
+
+  if (delta_x)
+    *delta_x = gesture_get_point (action, point)->predicted_delta_x;
+
+  if (delta_y)
+    *delta_y = gesture_get_point (action, point)->predicted_delta_y;
+}
@@ -174,6 +174,17 @@ void                            clutter_gesture_action_get_threshold_trigger_dis
                                                                                          float                *x,
                                                                                          float                *y);
 
+CLUTTER_AVAILABLE_IN_1_28
+void                            clutter_gesture_action_set_motion_prediction            (ClutterGestureAction      *action,
+                                                                                         ClutterMotionPrediction    prediction);
+CLUTTER_AVAILABLE_IN_1_28
+ClutterMotionPrediction         clutter_gesture_action_get_motion_prediction            (ClutterGestureAction      *action);
+CLUTTER_AVAILABLE_IN_1_28
+void                            clutter_gesture_action_get_predicted_coords             (ClutterGestureAction      *action,
+                                                                                         guint                      point,
+                                                                                         gfloat                    *predicted_x,
+                                                                                         gfloat                    *predicted_y);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_GESTURE_ACTION_H__ */
@@ -102,6 +102,9 @@ clutter_input_device_dispose (GObject *gobject)
   g_clear_pointer (&device->keys, g_array_unref);
   g_clear_pointer (&device->scroll_info, g_array_unref);
   g_clear_pointer (&device->touch_sequences_info, g_hash_table_unref);
+  g_clear_pointer (&device->pick_cache_regions, g_array_unref);
+  g_clear_pointer (&device->pick_cache_occluders, g_array_unref);
+  g_clear_pointer (&device->event_chain, g_ptr_array_unref);
 
   if (device->inv_touch_sequence_actors)
     {
@@ -430,6 +433,11 @@ clutter_input_device_init (ClutterInputDevice *self)
     g_hash_table_new_full (NULL, NULL,
                            NULL, _clutter_input_device_free_touch_info);
   self->inv_touch_sequence_actors = g_hash_table_new (NULL, NULL);
+
+  self->pick_cache_regions =
+    g_array_new (FALSE, FALSE, sizeof (ClutterVertex));
+  self->pick_cache_occluders =
+    g_array_new (FALSE, FALSE, sizeof (ClutterActorBox));
 }
 
 static ClutterTouchInfo *
@@ -556,6 +564,7 @@ _clutter_input_device_set_stage (ClutterInputDevice *device,
     return;
 
   device->stage = stage;
+  device->pick_cache_valid = FALSE;
 
   /* we leave the ->cursor_actor in place in order to check
    * if we left the stage without crossing it again; this way
@@ -640,7 +649,10 @@ _clutter_input_device_unassociate_actor (ClutterInputDevice   *device,
                                          gboolean              destroyed)
 {
   if (device->cursor_actor == actor)
-    device->cursor_actor = NULL;
+    {
+      device->cursor_actor = NULL;
+      device->pick_cache_valid = FALSE;
+    }
   else
     {
       GList *l, *sequences =
@@ -911,6 +923,153 @@ clutter_input_device_get_coords (ClutterInputDevice   *device,
   return TRUE;
 }
 
+/* checks whether (x, y) lies inside the convex quadrilateral
+ * defined by the vertices returned by
+ * clutter_actor_get_abs_allocation_vertices()
+ */
+static gboolean
+point_in_quad (const ClutterVertex *verts,
+               gfloat               x,
+               gfloat               y)
+{
+  static const int order[] = { 0, 1, 3, 2 };
+  gboolean has_positive = FALSE;
+  gboolean has_negative = FALSE;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      const ClutterVertex *a = &verts[order[i]];
+      const ClutterVertex *b = &verts[order[(i + 1) % 4]];
+      gfloat cross;
+
+      cross = (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+
+      if (cross > 0.f)
+        has_positive = TRUE;
+      else if (cross < 0.f)
+        has_negative = TRUE;
+
+      if (has_positive && has_negative)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_input_device_update_pick_cache:
+ * @device: a #ClutterInputDevice
+ * @actor: the actor that has been picked underneath the pointer
+ * @serial: the pick serial of the stage at the time of the pick
+ *
+ * Caches the hit region of @actor, so that further motion of the
+ * pointer inside it can be resolved without picking the scene.
+ *
+ * The region is only cached when we can be sure that the pick result
+ * is fully determined by the allocations of @actor and its ancestors,
+ * and by the paint boxes of the actors painted on top of it; in every
+ * other case the cache is simply left invalid.
+ */
+static void
+_clutter_input_device_update_pick_cache (ClutterInputDevice *device,
+                                         ClutterActor       *actor,
+                                         guint32             serial)
+{
+  ClutterActor *stage = CLUTTER_ACTOR (device->stage);
+  ClutterActor *iter;
+
+  device->pick_cache_valid = FALSE;
+
+  g_array_set_size (device->pick_cache_regions, 0);
+  g_array_set_size (device->pick_cache_occluders, 0);
+
+  /* hitting the stage means that we did not hit any of its children,
+   * and we cannot cheaply tell when one of them is hit
+   */
+  if (actor == NULL || actor == stage)
+    return;
+
+  /* children are painted on top of their parent, and custom pick
+   * implementations or effects may paint outside of the allocation
+   */
+  if (clutter_actor_get_n_children (actor) != 0 ||
+      !_clutter_actor_has_default_pick (actor))
+    return;
+
+  for (iter = actor; iter != stage; iter = clutter_actor_get_parent (iter))
+    {
+      ClutterActor *sibling;
+
+      if (iter == NULL)
+        return;
+
+      if (clutter_actor_has_clip (iter) || clutter_actor_has_effects (iter))
+        return;
+
+      if (iter == actor || clutter_actor_get_clip_to_allocation (iter))
+        {
+          ClutterVertex verts[4];
+
+          clutter_actor_get_abs_allocation_vertices (iter, verts);
+          g_array_append_vals (device->pick_cache_regions, verts, 4);
+        }
+
+      /* every sibling painted after the current actor may cover it */
+      for (sibling = clutter_actor_get_next_sibling (iter);
+           sibling != NULL;
+           sibling = clutter_actor_get_next_sibling (sibling))
+        {
+          ClutterActorBox box;
+
+          if (!CLUTTER_ACTOR_IS_VISIBLE (sibling))
+            continue;
+
+          if (!clutter_actor_get_paint_box (sibling, &box))
+            return;
+
+          g_array_append_val (device->pick_cache_occluders, box);
+        }
+    }
+
+  device->pick_cache_serial = serial;
+  device->pick_cache_valid = TRUE;
+}
+
+static gboolean
+_clutter_input_device_pick_cache_contains (ClutterInputDevice *device,
+                                           gfloat              x,
+                                           gfloat              y)
+{
+  guint i;
+
+  if (!device->pick_cache_valid || device->cursor_actor == NULL)
+    return FALSE;
+
+  if (device->pick_cache_serial != _clutter_stage_get_pick_serial (device->stage))
+    return FALSE;
+
+  for (i = 0; i < device->pick_cache_regions->len; i += 4)
+    {
+      const ClutterVertex *verts =
+        &g_array_index (device->pick_cache_regions, ClutterVertex, i);
+
+      if (!point_in_quad (verts, x, y))
+        return FALSE;
+    }
+
+  for (i = 0; i < device->pick_cache_occluders->len; i++)
+    {
+      const ClutterActorBox *box =
+        &g_array_index (device->pick_cache_occluders, ClutterActorBox, i);
+
+      if (clutter_actor_box_contains (box, x, y))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
 /*
  * _clutter_input_device_update:
  * @device: a #ClutterInputDevice
@@ -934,6 +1093,7 @@ _clutter_input_device_update (ClutterInputDevice   *device,
   ClutterActor *new_cursor_actor;
   ClutterActor *old_cursor_actor;
   ClutterPoint point = { -1, -1 };
+  guint32 pick_serial;
 
   if (device->device_type == CLUTTER_KEYBOARD_DEVICE)
     return NULL;
@@ -950,6 +1110,16 @@ _clutter_input_device_update (ClutterInputDevice   *device,
   clutter_input_device_get_coords (device, sequence, &point);
 
   old_cursor_actor = _clutter_input_device_get_actor (device, sequence);
+
+  /* if the pointer is still inside the cached hit region of the
+   * actor underneath it, and nothing changed in the scene since we
+   * cached it, we can skip the pick entirely
+   */
+  if (sequence == NULL &&
+      _clutter_input_device_pick_cache_contains (device, point.x, point.y))
+    return old_cursor_actor;
+
+  pick_serial = _clutter_stage_get_pick_serial (stage);
   new_cursor_actor =
     _clutter_stage_do_pick (stage, point.x, point.y, CLUTTER_PICK_REACTIVE);
 
@@ -970,12 +1140,23 @@ _clutter_input_device_update (ClutterInputDevice   *device,
 
   /* short-circuit here */
   if (new_cursor_actor == old_cursor_actor)
-    return old_cursor_actor;
+    {
+      if (sequence == NULL)
+        _clutter_input_device_update_pick_cache (device, new_cursor_actor,
+                                                 pick_serial);
+
+      return old_cursor_actor;
+    }
 
   _clutter_input_device_set_actor (device, sequence,
                                    new_cursor_actor,
                                    emit_crossing);
 
+  /* the crossing events might have changed the cursor actor */
+  if (sequence == NULL && device->cursor_actor == new_cursor_actor)
+    _clutter_input_device_update_pick_cache (device, new_cursor_actor,
+                                             pick_serial);
+
   return new_cursor_actor;
 }
 
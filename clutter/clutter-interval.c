@@ -92,8 +92,24 @@ struct _ClutterIntervalPrivate
   GType value_type;
 
   GValue *values;
+
+  /* changes every time the initial or final values change */
+  guint serial;
+
+  /* the typed interpolation of value_type, and the storage for the
+   * initial, final and computed values it works on
+   */
+  ClutterIntervalKernel kernel;
+  gpointer kernel_values;
+  gsize kernel_stride;
+  guint kernel_serial;
+  guint kernel_funcs_serial;
 };
 
+#define KERNEL_VALUE(priv,index_)       ((guint8 *) (priv)->kernel_values + (index_) * (priv)->kernel_stride)
+
+static guint interval_serial = 0;
+
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterInterval,
@@ -262,6 +278,208 @@ G_GNUC_END_IGNORE_DEPRECATIONS;
   return TRUE;
 }
 
+static void
+clutter_interval_int_kernel (gconstpointer a,
+                             gconstpointer b,
+                             gdouble       progress,
+                             gpointer      retval)
+{
+  gint ia = *(const gint *) a;
+  gint ib = *(const gint *) b;
+
+  *(gint *) retval = (progress * (ib - ia)) + ia;
+}
+
+static void
+clutter_interval_float_kernel (gconstpointer a,
+                               gconstpointer b,
+                               gdouble       progress,
+                               gpointer      retval)
+{
+  gdouble ia = *(const gfloat *) a;
+  gdouble ib = *(const gfloat *) b;
+
+  *(gfloat *) retval = (progress * (ib - ia)) + ia;
+}
+
+static void
+clutter_interval_double_kernel (gconstpointer a,
+                                gconstpointer b,
+                                gdouble       progress,
+                                gpointer      retval)
+{
+  gdouble ia = *(const gdouble *) a;
+  gdouble ib = *(const gdouble *) b;
+
+  *(gdouble *) retval = (progress * (ib - ia)) + ia;
+}
+
+static gboolean
+clutter_interval_store_value (ClutterInterval *interval,
+                              gint             index_)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+  const GValue *value = &priv->values[index_];
+  gpointer storage = KERNEL_VALUE (priv, index_);
+  gconstpointer boxed;
+
+  if (!G_IS_VALUE (value))
+    return FALSE;
+
+  switch (priv->value_type)
+    {
+    case G_TYPE_INT:
+      *(gint *) storage = g_value_get_int (value);
+      return TRUE;
+
+    case G_TYPE_FLOAT:
+      *(gfloat *) storage = g_value_get_float (value);
+      return TRUE;
+
+    case G_TYPE_DOUBLE:
+      *(gdouble *) storage = g_value_get_double (value);
+      return TRUE;
+
+    default:
+      break;
+    }
+
+  /* only boxed types register a typed progress function */
+  if (!G_VALUE_HOLDS_BOXED (value))
+    return FALSE;
+
+  boxed = g_value_get_boxed (value);
+  if (boxed == NULL)
+    return FALSE;
+
+  memcpy (storage, boxed, priv->kernel_stride);
+
+  return TRUE;
+}
+
+/*< private >
+ * clutter_interval_ensure_kernel:
+ * @interval: a #ClutterInterval
+ *
+ * Looks up the typed interpolation for the value type of @interval,
+ * and copies the initial and final values into its storage if they
+ * changed since the last time.
+ *
+ * Return value: %TRUE if the typed interpolation can be used
+ */
+static gboolean
+clutter_interval_ensure_kernel (ClutterInterval *interval)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+  guint funcs_serial = _clutter_get_progress_functions_serial ();
+
+  if (G_UNLIKELY (priv->kernel_funcs_serial != funcs_serial))
+    {
+      ClutterIntervalKernel kernel = NULL;
+      gsize size = 0;
+
+      /* the progress functions take precedence over the fundamental
+       * types we know about, just like in the untyped code path
+       */
+      if (!_clutter_get_interval_kernel (priv->value_type, &kernel, &size))
+        {
+          switch (priv->value_type)
+            {
+            case G_TYPE_INT:
+              kernel = clutter_interval_int_kernel;
+              size = sizeof (gint);
+              break;
+
+            case G_TYPE_FLOAT:
+              kernel = clutter_interval_float_kernel;
+              size = sizeof (gfloat);
+              break;
+
+            case G_TYPE_DOUBLE:
+              kernel = clutter_interval_double_kernel;
+              size = sizeof (gdouble);
+              break;
+
+            default:
+              break;
+            }
+        }
+
+      /* the computed value may point into the old storage */
+      if (G_IS_VALUE (&priv->values[RESULT]))
+        g_value_reset (&priv->values[RESULT]);
+
+      g_free (priv->kernel_values);
+
+      priv->kernel = kernel;
+      priv->kernel_stride = size;
+      priv->kernel_values = kernel != NULL ? g_malloc0 (size * N_VALUES) : NULL;
+      priv->kernel_funcs_serial = funcs_serial;
+      priv->kernel_serial = 0;
+    }
+
+  if (priv->kernel == NULL)
+    return FALSE;
+
+  if (priv->kernel_serial != priv->serial)
+    {
+      if (!clutter_interval_store_value (interval, INITIAL) ||
+          !clutter_interval_store_value (interval, FINAL))
+        return FALSE;
+
+      priv->kernel_serial = priv->serial;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+clutter_interval_compute_kernel (ClutterInterval *interval,
+                                 gdouble          factor,
+                                 GValue          *value)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+  gpointer result;
+
+  if (G_VALUE_TYPE (value) != priv->value_type ||
+      !clutter_interval_ensure_kernel (interval))
+    return FALSE;
+
+  result = KERNEL_VALUE (priv, RESULT);
+  priv->kernel (KERNEL_VALUE (priv, INITIAL),
+                KERNEL_VALUE (priv, FINAL),
+                factor,
+                result);
+
+  switch (priv->value_type)
+    {
+    case G_TYPE_INT:
+      g_value_set_int (value, *(gint *) result);
+      break;
+
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, *(gfloat *) result);
+      break;
+
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, *(gdouble *) result);
+      break;
+
+    default:
+      /* the value returned by clutter_interval_compute() can point to
+       * the storage, which lives as long as the interval; everything
+       * else gets a copy
+       */
+      if (value == &priv->values[RESULT])
+        g_value_set_static_boxed (value, result);
+      else
+        g_value_set_boxed (value, result);
+      break;
+    }
+
+  return TRUE;
+}
+
 static gboolean
 clutter_interval_real_compute_value (ClutterInterval *interval,
                                      gdouble          factor,
@@ -271,6 +489,12 @@ clutter_interval_real_compute_value (ClutterInterval *interval,
   GType value_type;
   gboolean retval = FALSE;
 
+  /* the value types we have a typed interpolation for do not need to
+   * unbox the initial and final values on every call
+   */
+  if (clutter_interval_compute_kernel (interval, factor, value))
+    return TRUE;
+
   initial = clutter_interval_peek_initial_value (interval);
   final = clutter_interval_peek_final_value (interval);
 
@@ -421,6 +645,7 @@ clutter_interval_finalize (GObject *gobject)
     g_value_unset (&priv->values[RESULT]);
 
   g_free (priv->values);
+  g_free (priv->kernel_values);
 
   G_OBJECT_CLASS (clutter_interval_parent_class)->finalize (gobject);
 }
@@ -444,14 +669,20 @@ clutter_interval_set_property (GObject      *gobject,
       if (g_value_get_boxed (value) != NULL)
         clutter_interval_set_initial_value (self, g_value_get_boxed (value));
       else if (G_IS_VALUE (&priv->values[INITIAL]))
-        g_value_unset (&priv->values[INITIAL]);
+        {
+          g_value_unset (&priv->values[INITIAL]);
+          priv->serial = ++interval_serial;
+        }
       break;
 
     case PROP_FINAL:
       if (g_value_get_boxed (value) != NULL)
         clutter_interval_set_final_value (self, g_value_get_boxed (value));
       else if (G_IS_VALUE (&priv->values[FINAL]))
-        g_value_unset (&priv->values[FINAL]);
+        {
+          g_value_unset (&priv->values[FINAL]);
+          priv->serial = ++interval_serial;
+        }
       break;
 
     default:
@@ -601,6 +832,10 @@ clutter_interval_init (ClutterInterval *self)
 
   self->priv->value_type = G_TYPE_INVALID;
   self->priv->values = g_malloc0 (sizeof (GValue) * N_VALUES);
+  self->priv->serial = ++interval_serial;
+
+  /* force the look up of the typed interpolation */
+  self->priv->kernel_funcs_serial = G_MAXUINT;
 }
 
 static inline void
@@ -613,6 +848,9 @@ clutter_interval_set_value_internal (ClutterInterval *interval,
 
   g_assert (index_ >= INITIAL && index_ <= RESULT);
 
+  if (index_ != RESULT)
+    priv->serial = ++interval_serial;
+
   if (G_IS_VALUE (&priv->values[index_]))
     g_value_unset (&priv->values[index_]);
 
@@ -1252,3 +1490,18 @@ clutter_interval_is_valid (ClutterInterval *interval)
   return G_IS_VALUE (&priv->values[INITIAL]) &&
          G_IS_VALUE (&priv->values[FINAL]);
 }
+
+/*< private >
+ * _clutter_interval_get_serial:
+ * @interval: a #ClutterInterval
+ *
+ * Retrieves a number that changes every time the initial or final
+ * values of @interval are set; no two intervals share the same serial.
+ *
+ * Return value: the serial of @interval
+ */
+guint
+_clutter_interval_get_serial (ClutterInterval *interval)
+{
+  return interval->priv->serial;
+}
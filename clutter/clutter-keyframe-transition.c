@@ -87,12 +87,38 @@ typedef struct _KeyFrame
   ClutterAnimationMode mode;
 
   ClutterInterval *interval;
+
+  /* the serials of the intervals when the boundary value of the
+   * transition was last copied into the interval of the key frame
+   */
+  guint interval_serial;
+  guint source_serial;
 } KeyFrame;
 
+/* a key frame, compiled for the evaluation: the segments are stored
+ * in the same order as the key frames, and each segment ends at the
+ * key of its key frame
+ */
+typedef struct _KeySegment
+{
+  double start;
+  double end;
+
+  ClutterEasingFunc easing;
+
+  ClutterInterval *interval;
+} KeySegment;
+
 struct _ClutterKeyframeTransitionPrivate
 {
   GArray *frames;
 
+  /* the compiled key frames; NULL if the key frames changed since
+   * they were last compiled
+   */
+  KeySegment *segments;
+  guint n_segments;
+
   gint current_frame;
 };
 
@@ -121,12 +147,32 @@ sort_by_key (gconstpointer a,
   if (fabs (k_a->key - k_b->key) < 0.0001)
     return 0;
 
-  if (k_a->key > k_a->key)
+  if (k_a->key > k_b->key)
     return 1;
 
   return -1;
 }
 
+/* copying the boundary values of the transition on every frame would
+ * make the interval of the key frame look changed to the typed
+ * interpolation, so we only copy them if either interval changed
+ */
+static inline gboolean
+key_frame_needs_boundary (const KeyFrame  *frame,
+                          ClutterInterval *interval)
+{
+  return frame->interval_serial != _clutter_interval_get_serial (frame->interval) ||
+         frame->source_serial != _clutter_interval_get_serial (interval);
+}
+
+static inline void
+key_frame_set_boundary (KeyFrame        *frame,
+                        ClutterInterval *interval)
+{
+  frame->interval_serial = _clutter_interval_get_serial (frame->interval);
+  frame->source_serial = _clutter_interval_get_serial (interval);
+}
+
 static inline void
 clutter_keyframe_transition_sort_frames (ClutterKeyframeTransition *transition)
 {
@@ -161,6 +207,8 @@ clutter_keyframe_transition_init_frames (ClutterKeyframeTransition *transition,
 
       frame.mode = CLUTTER_LINEAR;
       frame.interval = NULL;
+      frame.interval_serial = 0;
+      frame.source_serial = 0;
 
       g_array_insert_val (priv->frames, i, frame);
     }
@@ -211,6 +259,122 @@ clutter_keyframe_transition_update_frames (ClutterKeyframeTransition *transition
     }
 }
 
+static inline void
+clutter_keyframe_transition_invalidate_segments (ClutterKeyframeTransition *transition)
+{
+  ClutterKeyframeTransitionPrivate *priv = transition->priv;
+
+  g_free (priv->segments);
+  priv->segments = NULL;
+  priv->n_segments = 0;
+  priv->current_frame = -1;
+}
+
+/*
+ * clutter_keyframe_transition_compile_frames:
+ * @transition: a #ClutterKeyframeTransition
+ *
+ * Sorts the key frames, and compiles them into the table of segments
+ * used to evaluate the transition, so that each frame does not need
+ * to look at every key frame.
+ */
+static void
+clutter_keyframe_transition_compile_frames (ClutterKeyframeTransition *transition)
+{
+  ClutterKeyframeTransitionPrivate *priv = transition->priv;
+  ClutterAnimationMode last_mode;
+  guint i;
+
+  clutter_keyframe_transition_invalidate_segments (transition);
+
+  if (priv->frames == NULL)
+    return;
+
+  clutter_keyframe_transition_sort_frames (transition);
+  clutter_keyframe_transition_update_frames (transition);
+
+  /* the implicit key frame uses the easing mode of the transition; the
+   * segments are compiled again when it changes
+   */
+  last_mode = clutter_timeline_get_progress_mode (CLUTTER_TIMELINE (transition));
+
+  priv->n_segments = priv->frames->len;
+  priv->segments = g_new (KeySegment, priv->n_segments);
+
+  for (i = 0; i < priv->n_segments; i++)
+    {
+      KeyFrame *frame = &g_array_index (priv->frames, KeyFrame, i);
+      KeySegment *segment = &priv->segments[i];
+
+      if (i == priv->n_segments - 1)
+        frame->mode = last_mode;
+
+      segment->start = frame->start;
+      segment->end = frame->end;
+      segment->easing = clutter_get_easing_func_for_mode (frame->mode);
+      segment->interval = frame->interval;
+    }
+}
+
+static inline gboolean
+key_segment_contains (const KeySegment *segment,
+                      double            p)
+{
+  return p >= segment->start && p <= segment->end;
+}
+
+/*
+ * clutter_keyframe_transition_find_segment:
+ * @transition: a #ClutterKeyframeTransition
+ * @p: the normalized elapsed time, between 0.0 and 1.0
+ *
+ * Finds the segment containing @p. Since the transition usually plays
+ * in one direction, the segment of the previous frame and its neighbours
+ * are checked first; otherwise, the segment is found by a binary search
+ * on the end of the segments.
+ *
+ * Return value: the index of the segment
+ */
+static guint
+clutter_keyframe_transition_find_segment (ClutterKeyframeTransition *transition,
+                                          double                     p)
+{
+  ClutterKeyframeTransitionPrivate *priv = transition->priv;
+  const KeySegment *segments = priv->segments;
+  guint lo, hi;
+
+  if (priv->current_frame >= 0)
+    {
+      guint cursor = priv->current_frame;
+
+      if (key_segment_contains (&segments[cursor], p))
+        return cursor;
+
+      if (cursor + 1 < priv->n_segments &&
+          key_segment_contains (&segments[cursor + 1], p))
+        return cursor + 1;
+
+      if (cursor > 0 &&
+          key_segment_contains (&segments[cursor - 1], p))
+        return cursor - 1;
+    }
+
+  /* the first segment ending at, or after, p */
+  lo = 0;
+  hi = priv->n_segments - 1;
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (segments[mid].end < p)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
 static void
 clutter_keyframe_transition_compute_value (ClutterTransition *transition,
                                            ClutterAnimatable *animatable,
@@ -221,11 +385,11 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
   ClutterTimeline *timeline = CLUTTER_TIMELINE (transition);
   ClutterKeyframeTransitionPrivate *priv = self->priv;
   ClutterTransitionClass *parent_class;
-  ClutterTimelineDirection direction;
   ClutterInterval *real_interval;
   gdouble real_progress;
   double t, d, p;
   KeyFrame *cur_frame = NULL;
+  const KeySegment *segment;
 
   real_interval = interval;
   real_progress = progress;
@@ -234,43 +398,18 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
   if (priv->frames == NULL)
     goto out;
 
-  direction = clutter_timeline_get_direction (timeline);
+  if (priv->segments == NULL)
+    clutter_keyframe_transition_compile_frames (self);
 
   /* we need a normalized linear value */
   t = clutter_timeline_get_elapsed_time (timeline);
   d = clutter_timeline_get_duration (timeline);
-  p = t / d;
+  p = d > 0 ? CLAMP (t / d, 0.0, 1.0) : 1.0;
 
-  if (priv->current_frame < 0)
-    {
-      if (direction == CLUTTER_TIMELINE_FORWARD)
-        priv->current_frame = 0;
-      else
-        priv->current_frame = priv->frames->len - 1;
-    }
+  priv->current_frame = clutter_keyframe_transition_find_segment (self, p);
 
   cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
-
-  /* skip to the next key frame, depending on the direction of the timeline */
-  if (direction == CLUTTER_TIMELINE_FORWARD)
-    {
-      if (p > cur_frame->end)
-        {
-          priv->current_frame = MIN (priv->current_frame + 1,
-                                     priv->frames->len - 1);
-
-          cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
-       }
-    }
-  else
-    {
-      if (p < cur_frame->start)
-        {
-          priv->current_frame = MAX (priv->current_frame - 1, 0);
-
-          cur_frame = &g_array_index (priv->frames, KeyFrame, priv->current_frame);
-        }
-    }
+  segment = &priv->segments[priv->current_frame];
 
   /* if we are at the boundaries of the transition, use the from and to
    * value from the transition
@@ -279,24 +418,33 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
     {
       const GValue *value;
 
-      value = clutter_interval_peek_initial_value (interval);
-      clutter_interval_set_initial_value (cur_frame->interval, value);
+      if (key_frame_needs_boundary (cur_frame, interval))
+        {
+          value = clutter_interval_peek_initial_value (interval);
+          clutter_interval_set_initial_value (cur_frame->interval, value);
+          key_frame_set_boundary (cur_frame, interval);
+        }
     }
   else if (priv->current_frame == priv->frames->len - 1)
     {
       const GValue *value;
 
-      cur_frame->mode = clutter_timeline_get_progress_mode (timeline);
-
-      value = clutter_interval_peek_final_value (interval);
-      clutter_interval_set_final_value (cur_frame->interval, value);
+      if (key_frame_needs_boundary (cur_frame, interval))
+        {
+          value = clutter_interval_peek_final_value (interval);
+          clutter_interval_set_final_value (cur_frame->interval, value);
+          key_frame_set_boundary (cur_frame, interval);
+        }
     }
 
   /* update the interval to be used to interpolate the property */
-  real_interval = cur_frame->interval;
+  real_interval = segment->interval;
 
   /* normalize the progress and apply the easing mode */
-  real_progress = clutter_easing_for_mode ( cur_frame->mode, (p - cur_frame->start), (cur_frame->end - cur_frame->start));
+  if (segment->end > segment->start)
+    real_progress = segment->easing (p - segment->start, segment->end - segment->start);
+  else
+    real_progress = 1.0;
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (CLUTTER_HAS_DEBUG (ANIMATION))
@@ -317,7 +465,7 @@ clutter_keyframe_transition_compute_value (ClutterTransition *transition,
                     cur_frame->key,
                     clutter_get_easing_name_for_mode (cur_frame->mode),
                     from,
-                    direction == CLUTTER_TIMELINE_FORWARD ? "->" : "<-",
+                    clutter_timeline_get_direction (timeline) == CLUTTER_TIMELINE_FORWARD ? "->" : "<-",
                     to,
                     p, real_progress);
 
@@ -339,10 +487,7 @@ clutter_keyframe_transition_started (ClutterTimeline *timeline)
 
   transition = CLUTTER_KEYFRAME_TRANSITION (timeline);
 
-  transition->priv->current_frame = -1;
-
-  clutter_keyframe_transition_sort_frames (transition);
-  clutter_keyframe_transition_update_frames (transition);
+  clutter_keyframe_transition_compile_frames (transition);
 }
 
 static void
@@ -355,6 +500,18 @@ clutter_keyframe_transition_completed (ClutterTimeline *timeline)
   priv->current_frame = -1;
 }
 
+static void
+clutter_keyframe_transition_notify (GObject    *gobject,
+                                    GParamSpec *pspec)
+{
+  /* the implicit key frame uses the easing mode of the transition */
+  if (strcmp (pspec->name, "progress-mode") == 0)
+    clutter_keyframe_transition_invalidate_segments (CLUTTER_KEYFRAME_TRANSITION (gobject));
+
+  if (G_OBJECT_CLASS (clutter_keyframe_transition_parent_class)->notify != NULL)
+    G_OBJECT_CLASS (clutter_keyframe_transition_parent_class)->notify (gobject, pspec);
+}
+
 static void
 clutter_keyframe_transition_finalize (GObject *gobject)
 {
@@ -365,6 +522,8 @@ clutter_keyframe_transition_finalize (GObject *gobject)
   if (priv->frames != NULL)
     g_array_unref (priv->frames);
 
+  g_free (priv->segments);
+
   G_OBJECT_CLASS (clutter_keyframe_transition_parent_class)->finalize (gobject);
 }
 
@@ -375,6 +534,7 @@ clutter_keyframe_transition_class_init (ClutterKeyframeTransitionClass *klass)
   ClutterTimelineClass *timeline_class = CLUTTER_TIMELINE_CLASS (klass);
   ClutterTransitionClass *transition_class = CLUTTER_TRANSITION_CLASS (klass);
 
+  gobject_class->notify = clutter_keyframe_transition_notify;
   gobject_class->finalize = clutter_keyframe_transition_finalize;
 
   timeline_class->started = clutter_keyframe_transition_started;
@@ -387,6 +547,7 @@ static void
 clutter_keyframe_transition_init (ClutterKeyframeTransition *self)
 {
   self->priv = clutter_keyframe_transition_get_instance_private (self);
+  self->priv->current_frame = -1;
 }
 
 /**
@@ -449,6 +610,8 @@ clutter_keyframe_transition_set_key_frames (ClutterKeyframeTransition *transitio
 
       frame->key = key_frames[i];
     }
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -496,6 +659,8 @@ clutter_keyframe_transition_set_values (ClutterKeyframeTransition *transition,
           clutter_interval_new_with_values (G_VALUE_TYPE (&values[i]), NULL,
                                             &values[i]);
     }
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -538,6 +703,8 @@ clutter_keyframe_transition_set_modes (ClutterKeyframeTransition  *transition,
 
       frame->mode = modes[i];
     }
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -606,6 +773,8 @@ clutter_keyframe_transition_set (ClutterKeyframeTransition *transition,
     }
 
   va_end (args);
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -626,6 +795,8 @@ clutter_keyframe_transition_clear (ClutterKeyframeTransition *transition)
       g_array_unref (transition->priv->frames);
       transition->priv->frames = NULL;
     }
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -684,6 +855,8 @@ clutter_keyframe_transition_set_key_frame (ClutterKeyframeTransition *transition
   frame->key = key;
   frame->mode = mode;
   clutter_interval_set_final_value (frame->interval, value);
+
+  clutter_keyframe_transition_invalidate_segments (transition);
 }
 
 /**
@@ -68,6 +68,7 @@
 #include "clutter-settings-private.h"
 #include "clutter-stage-manager.h"
 #include "clutter-stage-private.h"
+#include "clutter-text-layout-cache.h"
 #include "clutter-version.h" 	/* For flavour define */
 
 #ifdef CLUTTER_WINDOWING_OSX
@@ -114,8 +115,13 @@ static gboolean clutter_disable_mipmap_text  = FALSE;
 static gboolean clutter_use_fuzzy_picking    = FALSE;
 static gboolean clutter_enable_accessibility = TRUE;
 static gboolean clutter_sync_to_vblank       = TRUE;
+static gboolean clutter_use_virtual_clock    = FALSE;
+
+static gchar *clutter_frame_timings          = NULL;
 
 static guint clutter_default_fps             = 60;
+static guint clutter_offscreen_budget        = 0;
+static gint clutter_text_layout_cache_size   = -1;
 
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
@@ -1530,6 +1536,33 @@ pre_parse_hook (GOptionContext  *context,
   if (g_strcmp0 (env_string, "none") == 0)
     clutter_sync_to_vblank = FALSE;
 
+  env_string = g_getenv ("CLUTTER_VIRTUAL_CLOCK");
+  if (env_string)
+    clutter_use_virtual_clock = TRUE;
+
+  env_string = g_getenv ("CLUTTER_FRAME_TIMINGS");
+  if (env_string)
+    {
+      g_free (clutter_frame_timings);
+      clutter_frame_timings = g_strdup (env_string);
+    }
+
+  env_string = g_getenv ("CLUTTER_OFFSCREEN_BUDGET");
+  if (env_string)
+    {
+      gint64 budget = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_offscreen_budget = CLAMP (budget, 1, 4096);
+    }
+
+  env_string = g_getenv ("CLUTTER_TEXT_LAYOUT_CACHE_SIZE");
+  if (env_string)
+    {
+      gint64 cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_text_layout_cache_size = CLAMP (cache_size, 0, 1024);
+    }
+
   return _clutter_backend_pre_parse (backend, error);
 }
 
@@ -1563,8 +1596,14 @@ post_parse_hook (GOptionContext  *context,
 
   clutter_context->frame_rate = clutter_default_fps;
   clutter_context->show_fps = clutter_show_fps;
+  clutter_context->use_virtual_clock = clutter_use_virtual_clock;
+  clutter_context->frame_timings = clutter_frame_timings;
+  clutter_context->offscreen_budget = (gsize) clutter_offscreen_budget * 1024 * 1024;
   clutter_context->options_parsed = TRUE;
 
+  if (clutter_text_layout_cache_size >= 0)
+    _clutter_text_layout_cache_set_max_size ((gsize) clutter_text_layout_cache_size * 1024 * 1024);
+
   /* If not asked to defer display setup, call clutter_init_real(),
    * which in turn calls the backend post parse hooks.
    */
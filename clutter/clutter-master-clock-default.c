@@ -27,18 +27,36 @@
  *
  * The #ClutterMasterClockDefault class is the default implementation
  * of #ClutterMasterClock.
+ *
+ * When the CLUTTER_VIRTUAL_CLOCK environment variable is set, the clock
+ * runs on virtual time: its time starts at zero, each frame advances
+ * it by exactly one frame interval, as set by the default frame rate,
+ * and the next frame starts as soon as the previous one is done. The
+ * stages are laid out and painted into offscreen framebuffers, instead
+ * of their windows, so that the time spent on each frame does not
+ * depend on the display. If a file was set using the
+ * CLUTTER_FRAME_TIMINGS environment variable, the time spent laying
+ * out, painting and picking each stage is written into it, one frame
+ * per line, as comma separated values.
  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
+#include <stdio.h>
+#include <glib/gstdio.h>
+
 #include "clutter-master-clock.h"
 #include "clutter-master-clock-default.h"
+#include "clutter-actor-private.h"
+#include "clutter-animation-table.h"
+#include "clutter-backend.h"
 #include "clutter-debug.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-timeline-registry.h"
 
 #ifdef CLUTTER_ENABLE_DEBUG
 #define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
@@ -56,12 +74,19 @@
 
 typedef struct _ClutterClockSource              ClutterClockSource;
 
+typedef struct {
+  CoglFramebuffer *framebuffer;
+
+  int width;
+  int height;
+} VirtualTarget;
+
 struct _ClutterMasterClockDefault
 {
   GObject parent_instance;
 
-  /* the list of timelines handled by the clock */
-  GSList *timelines;
+  /* the running timelines handled by the clock */
+  ClutterTimelineRegistry timelines;
 
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
@@ -69,6 +94,18 @@ struct _ClutterMasterClockDefault
   /* the previous state of the clock, in usecs, used to compute the delta */
   gint64 prev_tick;
 
+  /* the time of the clock on virtual time, in usecs */
+  gint64 virtual_time;
+
+  /* the number of frames processed on virtual time */
+  guint64 n_frames;
+
+  /* ClutterStage -> VirtualTarget, on virtual time */
+  GHashTable *targets;
+
+  /* the file the timings of the virtual frames are written into, if any */
+  FILE *timings;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 frame_budget;
   gint64 remaining_budget;
@@ -88,6 +125,9 @@ struct _ClutterMasterClockDefault
   guint ensure_next_iteration : 1;
 
   guint paused : 1;
+
+  /* whether the clock runs on virtual time */
+  guint is_virtual : 1;
 };
 
 struct _ClutterClockSource
@@ -142,7 +182,7 @@ master_clock_is_running (ClutterMasterClockDefault *master_clock)
   if (master_clock->paused)
     return FALSE;
 
-  if (master_clock->timelines)
+  if (!_clutter_timeline_registry_is_empty (&master_clock->timelines))
     return TRUE;
 
   for (l = stages; l; l = l->next)
@@ -162,6 +202,15 @@ master_clock_is_running (ClutterMasterClockDefault *master_clock)
   return FALSE;
 }
 
+static gint64
+master_clock_get_time (ClutterMasterClockDefault *master_clock)
+{
+  if (master_clock->is_virtual)
+    return master_clock->virtual_time;
+
+  return g_source_get_time (master_clock->source);
+}
+
 static gint
 master_clock_get_swap_wait_time (ClutterMasterClockDefault *master_clock)
 {
@@ -185,7 +234,7 @@ master_clock_get_swap_wait_time (ClutterMasterClockDefault *master_clock)
     }
   else
     {
-      gint64 now = g_source_get_time (master_clock->source);
+      gint64 now = master_clock_get_time (master_clock);
       if (min_update_time < now)
         {
           return 0;
@@ -238,7 +287,8 @@ master_clock_list_ready_stages (ClutterMasterClockDefault *master_clock)
        * vblank and really match the vsync frequency.
        */
       if (clutter_actor_is_mapped (l->data) &&
-          update_time != -1 && update_time <= master_clock->cur_tick)
+          (master_clock->is_virtual ||
+           (update_time != -1 && update_time <= master_clock->cur_tick)))
         result = g_slist_prepend (result, g_object_ref (l->data));
     }
 
@@ -257,7 +307,7 @@ master_clock_reschedule_stage_updates (ClutterMasterClockDefault *master_clock,
       _clutter_stage_clear_update_time (l->data);
 
       /* And if there is still work to be done, schedule a new one */
-      if (master_clock->timelines ||
+      if (!_clutter_timeline_registry_is_empty (&master_clock->timelines) ||
           _clutter_stage_has_queued_events (l->data) ||
           _clutter_stage_needs_update (l->data))
         _clutter_stage_schedule_update (l->data);
@@ -282,6 +332,12 @@ master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
   if (!master_clock_is_running (master_clock))
     return -1;
 
+  /* On virtual time the clock does not wait for the stages, and the
+   * next frame starts as soon as the previous one is done
+   */
+  if (master_clock->is_virtual)
+    return 0;
+
   /* If all of the stages are busy waiting for a swap-buffers to complete
    * then we wait for one to be ready.. */
   swap_delay = master_clock_get_swap_wait_time (master_clock);
@@ -319,7 +375,7 @@ master_clock_next_frame_delay (ClutterMasterClockDefault *master_clock)
   /* Otherwise, wait at least 1/frame_rate seconds since we last
    * started a frame
    */
-  now = g_source_get_time (master_clock->source);
+  now = master_clock_get_time (master_clock);
 
   next = master_clock->prev_tick;
 
@@ -382,39 +438,25 @@ master_clock_process_events (ClutterMasterClockDefault *master_clock,
 static void
 master_clock_advance_timelines (ClutterMasterClockDefault *master_clock)
 {
-  GSList *timelines, *l;
+  ClutterAnimationTable *table;
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
 
-  /* we protect ourselves from timelines being removed during
-   * the advancement by other timelines by copying the list of
-   * timelines, taking a reference on them, iterating over the
-   * copied list and then releasing the reference.
-   *
-   * we cannot simply take a reference on the timelines and still
-   * use the list held by the master clock because the do_tick()
-   * might result in the creation of a new timeline, which gets
-   * added at the end of the list with no reference increase and
-   * thus gets disposed at the end of the iteration.
-   *
-   * this implies that a newly added timeline will not be advanced
-   * by this clock iteration, which is perfectly fine since we're
-   * in its first cycle.
-   *
-   * we also cannot steal the master clock timelines list because
-   * a timeline might be removed as the direct result of do_tick()
-   * and remove_timeline() would not find the timeline, failing
-   * and leaving a dangling pointer behind.
+  /* the property transitions using the animation table only store
+   * their progress while the timelines are advanced; the values are
+   * interpolated and written all at once afterwards
    */
-  timelines = g_slist_copy (master_clock->timelines);
-  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+  table = _clutter_animation_table_get_default ();
+  _clutter_animation_table_defer_updates (table);
+
+  _clutter_timeline_registry_advance (&master_clock->timelines,
+                                      master_clock->cur_tick / 1000);
 
-  for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+  _clutter_animation_table_flush_updates (table);
 
-  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
-  g_slist_free (timelines);
+  CLUTTER_NOTE (ANIMATION, "Notifications saved by batching: %u",
+                _clutter_actor_get_saved_notifications ());
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -424,12 +466,169 @@ master_clock_advance_timelines (ClutterMasterClockDefault *master_clock)
 #endif
 }
 
+static void
+virtual_target_free (gpointer data)
+{
+  VirtualTarget *target = data;
+
+  if (target->framebuffer != NULL)
+    cogl_object_unref (target->framebuffer);
+
+  g_slice_free (VirtualTarget, target);
+}
+
+static void
+on_stage_removed (ClutterStageManager       *stage_manager,
+                  ClutterStage              *stage,
+                  ClutterMasterClockDefault *master_clock)
+{
+  g_hash_table_remove (master_clock->targets, stage);
+}
+
+/* retrieves the offscreen framebuffer @stage is painted into on
+ * virtual time, and makes sure it has the size of the stage
+ */
+static CoglFramebuffer *
+master_clock_get_virtual_framebuffer (ClutterMasterClockDefault *master_clock,
+                                      ClutterStage              *stage)
+{
+  VirtualTarget *target;
+  CoglContext *context;
+  CoglTexture *texture;
+  float width, height;
+  GError *error = NULL;
+
+  _clutter_stage_get_viewport (stage, NULL, NULL, &width, &height);
+
+  target = g_hash_table_lookup (master_clock->targets, stage);
+  if (target == NULL)
+    {
+      target = g_slice_new0 (VirtualTarget);
+      g_hash_table_insert (master_clock->targets, stage, target);
+    }
+
+  if (target->framebuffer != NULL &&
+      target->width == (int) width &&
+      target->height == (int) height)
+    return target->framebuffer;
+
+  if (target->framebuffer != NULL)
+    {
+      cogl_object_unref (target->framebuffer);
+      target->framebuffer = NULL;
+    }
+
+  target->width = MAX ((int) width, 1);
+  target->height = MAX ((int) height, 1);
+
+  context = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  texture = cogl_texture_2d_new_with_size (context, target->width, target->height);
+  target->framebuffer = cogl_offscreen_new_with_texture (texture);
+  cogl_object_unref (texture);
+
+  if (!cogl_framebuffer_allocate (target->framebuffer, &error))
+    {
+      g_critical ("Unable to allocate the offscreen framebuffer of the "
+                  "virtual master clock: %s",
+                  error->message);
+      g_error_free (error);
+
+      cogl_object_unref (target->framebuffer);
+      target->framebuffer = NULL;
+    }
+
+  return target->framebuffer;
+}
+
+/*
+ * master_clock_update_virtual_stage:
+ * @master_clock: a #ClutterMasterClockDefault
+ * @stage: the #ClutterStage to update
+ * @n_stage: the position of @stage in the list of stages
+ *
+ * Lays out and paints @stage into its offscreen framebuffer, and
+ * records the time spent doing so.
+ *
+ * Return value: %TRUE if @stage was painted
+ */
+static gboolean
+master_clock_update_virtual_stage (ClutterMasterClockDefault *master_clock,
+                                   ClutterStage              *stage,
+                                   guint                      n_stage)
+{
+  CoglFramebuffer *framebuffer;
+  gint64 layout_time, paint_time, pick_time;
+  gint64 start;
+  float width, height;
+  gboolean painted = FALSE;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) ||
+      !CLUTTER_ACTOR_IS_REALIZED (stage))
+    return FALSE;
+
+  start = g_get_monotonic_time ();
+  _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  layout_time = g_get_monotonic_time () - start;
+
+  paint_time = 0;
+  pick_time = 0;
+
+  framebuffer = master_clock_get_virtual_framebuffer (master_clock, stage);
+  if (framebuffer != NULL)
+    {
+      start = g_get_monotonic_time ();
+      painted = _clutter_stage_paint_offscreen (stage, framebuffer);
+
+      /* wait for the GPU, so that the time of the paint includes the
+       * time spent rendering the frame
+       */
+      if (painted)
+        cogl_framebuffer_finish (framebuffer);
+
+      paint_time = g_get_monotonic_time () - start;
+    }
+
+  /* picking is driven by the input events, which do not happen on
+   * virtual time; we pick the center of the stage on each frame, so
+   * that the cost of picking the scene is measured as well. The
+   * regions cached by the input devices are dropped first, so that
+   * the measured pick stands for the first pick the devices do after
+   * this frame, which cannot use the regions cached before it
+   */
+  if (master_clock->timings != NULL && painted)
+    {
+      _clutter_stage_get_viewport (stage, NULL, NULL, &width, &height);
+
+      _clutter_stage_invalidate_pick_caches (stage);
+
+      start = g_get_monotonic_time ();
+      _clutter_stage_do_pick (stage, width / 2, height / 2, CLUTTER_PICK_REACTIVE);
+      pick_time = g_get_monotonic_time () - start;
+    }
+
+  if (master_clock->timings != NULL)
+    {
+      fprintf (master_clock->timings,
+               "%" G_GUINT64_FORMAT ",%" G_GINT64_FORMAT ",%u,"
+               "%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT ",%" G_GINT64_FORMAT "\n",
+               master_clock->n_frames,
+               master_clock->cur_tick,
+               n_stage,
+               layout_time,
+               paint_time,
+               pick_time);
+    }
+
+  return painted;
+}
+
 static gboolean
 master_clock_update_stages (ClutterMasterClockDefault *master_clock,
                             GSList                    *stages)
 {
   gboolean stages_updated = FALSE;
   GSList *l;
+  guint n_stage;
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
@@ -439,8 +638,15 @@ master_clock_update_stages (ClutterMasterClockDefault *master_clock,
   /* Update any stage that needs redraw/relayout after the clock
    * is advanced.
    */
-  for (l = stages; l != NULL; l = l->next)
-    stages_updated |= _clutter_stage_do_update (l->data);
+  for (l = stages, n_stage = 0; l != NULL; l = l->next, n_stage++)
+    {
+      if (master_clock->is_virtual)
+        stages_updated |= master_clock_update_virtual_stage (master_clock,
+                                                             l->data,
+                                                             n_stage);
+      else
+        stages_updated |= _clutter_stage_do_update (l->data);
+    }
 
   _clutter_run_repaint_functions (CLUTTER_REPAINT_FLAGS_POST_PAINT);
 
@@ -537,8 +743,14 @@ clutter_clock_dispatch (GSource     *source,
 
   _clutter_threads_acquire_lock ();
 
+  /* On virtual time, each frame advances the clock by exactly one
+   * frame interval
+   */
+  if (master_clock->is_virtual)
+    master_clock->virtual_time += G_USEC_PER_SEC / clutter_get_default_frame_rate ();
+
   /* Get the time to use for this frame */
-  master_clock->cur_tick = g_source_get_time (source);
+  master_clock->cur_tick = master_clock_get_time (master_clock);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   master_clock->remaining_budget = master_clock->frame_budget;
@@ -578,6 +790,9 @@ clutter_clock_dispatch (GSource     *source,
 
   master_clock->prev_tick = master_clock->cur_tick;
 
+  if (master_clock->is_virtual)
+    master_clock->n_frames += 1;
+
   _clutter_threads_release_lock ();
 
   return TRUE;
@@ -588,7 +803,19 @@ clutter_master_clock_default_finalize (GObject *gobject)
 {
   ClutterMasterClockDefault *master_clock = CLUTTER_MASTER_CLOCK_DEFAULT (gobject);
 
-  g_slist_free (master_clock->timelines);
+  _clutter_timeline_registry_clear (&master_clock->timelines);
+
+  if (master_clock->is_virtual)
+    {
+      g_signal_handlers_disconnect_by_func (clutter_stage_manager_get_default (),
+                                            on_stage_removed,
+                                            master_clock);
+
+      g_hash_table_unref (master_clock->targets);
+
+      if (master_clock->timings != NULL)
+        fclose (master_clock->timings);
+    }
 
   G_OBJECT_CLASS (clutter_master_clock_default_parent_class)->finalize (gobject);
 }
@@ -604,14 +831,42 @@ clutter_master_clock_default_class_init (ClutterMasterClockDefaultClass *klass)
 static void
 clutter_master_clock_default_init (ClutterMasterClockDefault *self)
 {
+  ClutterMainContext *context = _clutter_context_get_default ();
   GSource *source;
 
   source = clutter_clock_source_new (self);
   self->source = source;
 
+  _clutter_timeline_registry_init (&self->timelines);
+
   self->idle = FALSE;
   self->ensure_next_iteration = FALSE;
   self->paused = FALSE;
+  self->is_virtual = FALSE;
+
+  if (context->use_virtual_clock)
+    {
+      self->is_virtual = TRUE;
+      self->virtual_time = 0;
+      self->n_frames = 0;
+
+      self->targets = g_hash_table_new_full (NULL, NULL, NULL, virtual_target_free);
+
+      g_signal_connect (clutter_stage_manager_get_default (), "stage-removed",
+                        G_CALLBACK (on_stage_removed),
+                        self);
+
+      if (context->frame_timings != NULL)
+        {
+          self->timings = g_fopen (context->frame_timings, "w");
+
+          if (self->timings != NULL)
+            fputs ("frame,time,stage,layout,paint,pick\n", self->timings);
+          else
+            g_warning ("Unable to open '%s' to write the timings of the frames",
+                       context->frame_timings);
+        }
+    }
 
 #ifdef CLUTTER_ENABLE_DEBUG
   self->frame_budget = G_USEC_PER_SEC / 60;
@@ -627,17 +882,8 @@ clutter_master_clock_default_add_timeline (ClutterMasterClock *clock,
                                            ClutterTimeline    *timeline)
 {
   ClutterMasterClockDefault *master_clock = (ClutterMasterClockDefault *) clock;
-  gboolean is_first;
-
-  if (g_slist_find (master_clock->timelines, timeline))
-    return;
-
-  is_first = master_clock->timelines == NULL;
-
-  master_clock->timelines = g_slist_prepend (master_clock->timelines,
-                                             timeline);
 
-  if (is_first)
+  if (_clutter_timeline_registry_add (&master_clock->timelines, timeline))
     {
       master_clock_schedule_stage_updates (master_clock);
       _clutter_master_clock_start_running (clock);
@@ -650,8 +896,7 @@ clutter_master_clock_default_remove_timeline (ClutterMasterClock *clock,
 {
   ClutterMasterClockDefault *master_clock = (ClutterMasterClockDefault *) clock;
 
-  master_clock->timelines = g_slist_remove (master_clock->timelines,
-                                            timeline);
+  _clutter_timeline_registry_remove (&master_clock->timelines, timeline);
 }
 
 static void
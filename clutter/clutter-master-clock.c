@@ -62,7 +62,9 @@ _clutter_master_clock_get_default (void)
   if (G_UNLIKELY (context->master_clock == NULL))
     {
 #ifdef CLUTTER_WINDOWING_GDK
-    if (CLUTTER_IS_BACKEND_GDK (context->backend))
+    /* virtual time is only implemented by the default master clock */
+    if (CLUTTER_IS_BACKEND_GDK (context->backend) &&
+        !context->use_virtual_clock)
       context->master_clock = g_object_new (CLUTTER_TYPE_MASTER_CLOCK_GDK, NULL);
     else
 #endif
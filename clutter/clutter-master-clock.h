@@ -68,6 +68,9 @@ void                    _clutter_timeline_advance                       (Clutter
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+gint                    _clutter_timeline_get_registry_index            (ClutterTimeline    *timeline);
+void                    _clutter_timeline_set_registry_index            (ClutterTimeline    *timeline,
+                                                                         gint                index_);
 
 G_END_DECLS
 
@@ -0,0 +1,170 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterMotionPredictor: extrapolates the position of a pointer or
+ * touch point to the presentation time of the next frame.
+ *
+ * Actions that move actors along with the pointer always lag behind
+ * it, because the position they use was reported before the frame is
+ * drawn, and the frame is presented on the vertical refresh following
+ * the update. The predictor keeps an estimate of the velocity of the
+ * pointer, and extrapolates the last reported position by the time
+ * left until the presentation of the next frame.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-motion-predictor.h"
+
+#include "clutter-main.h"
+#include "clutter-stage-private.h"
+
+/* if the pointer did not move for this long, we consider it stopped,
+ * and we do not use the velocity of the previous motion
+ */
+#define MAX_SAMPLE_INTERVAL     100
+
+/* we never extrapolate further than this, as the error grows with
+ * the prediction interval
+ */
+#define MAX_PREDICTION_INTERVAL 50
+
+/* the weight of each new velocity sample for the smoothed predictor;
+ * this is the gain of an alpha-beta filter with a constant velocity
+ * model, which is what a Kalman filter converges to for this kind of
+ * input
+ */
+#define SMOOTHING_FACTOR        0.4f
+
+void
+_clutter_motion_predictor_init (ClutterMotionPredictor *predictor,
+                                gfloat                  x,
+                                gfloat                  y,
+                                guint32                 time_)
+{
+  predictor->x = x;
+  predictor->y = y;
+  predictor->time = time_;
+  predictor->velocity_x = 0.f;
+  predictor->velocity_y = 0.f;
+}
+
+void
+_clutter_motion_predictor_update (ClutterMotionPredictor  *predictor,
+                                  ClutterMotionPrediction  mode,
+                                  gfloat                   x,
+                                  gfloat                   y,
+                                  guint32                  time_)
+{
+  guint32 d_t = time_ - predictor->time;
+  gfloat velocity_x, velocity_y;
+
+  /* events with the same timestamp, e.g. coming from the same
+   * hardware frame, carry no velocity information
+   */
+  if (d_t == 0)
+    {
+      predictor->x = x;
+      predictor->y = y;
+      return;
+    }
+
+  if (d_t > MAX_SAMPLE_INTERVAL)
+    {
+      _clutter_motion_predictor_init (predictor, x, y, time_);
+      return;
+    }
+
+  velocity_x = (x - predictor->x) / d_t;
+  velocity_y = (y - predictor->y) / d_t;
+
+  switch (mode)
+    {
+    case CLUTTER_MOTION_PREDICTION_NONE:
+    case CLUTTER_MOTION_PREDICTION_LINEAR:
+      predictor->velocity_x = velocity_x;
+      predictor->velocity_y = velocity_y;
+      break;
+
+    case CLUTTER_MOTION_PREDICTION_SMOOTHED:
+      predictor->velocity_x += SMOOTHING_FACTOR * (velocity_x - predictor->velocity_x);
+      predictor->velocity_y += SMOOTHING_FACTOR * (velocity_y - predictor->velocity_y);
+      break;
+    }
+
+  predictor->x = x;
+  predictor->y = y;
+  predictor->time = time_;
+}
+
+void
+_clutter_motion_predictor_predict (const ClutterMotionPredictor *predictor,
+                                   ClutterMotionPrediction       mode,
+                                   guint                         interval,
+                                   gfloat                       *predicted_x,
+                                   gfloat                       *predicted_y)
+{
+  gfloat x = predictor->x;
+  gfloat y = predictor->y;
+
+  if (mode != CLUTTER_MOTION_PREDICTION_NONE)
+    {
+      interval = MIN (interval, MAX_PREDICTION_INTERVAL);
+
+      x += predictor->velocity_x * interval;
+      y += predictor->velocity_y * interval;
+    }
+
+  if (predicted_x != NULL)
+    *predicted_x = x;
+
+  if (predicted_y != NULL)
+    *predicted_y = y;
+}
+
+/*< private >
+ * _clutter_motion_predictor_get_interval:
+ * @stage: (allow-none): the #ClutterStage showing the motion
+ *
+ * Computes the time, in milliseconds, between now and the presentation
+ * of the next frame of @stage: the time left until the next update of
+ * the stage, plus the frame that is being drawn in the meantime.
+ *
+ * Return value: the prediction interval, in milliseconds
+ */
+guint
+_clutter_motion_predictor_get_interval (ClutterStage *stage)
+{
+  gint64 update_time, now;
+  guint interval;
+
+  interval = 1000 / MAX (clutter_get_default_frame_rate (), 1);
+
+  if (stage == NULL)
+    return interval;
+
+  update_time = _clutter_stage_get_update_time (stage);
+  now = g_get_monotonic_time ();
+
+  if (update_time > now)
+    interval += (update_time - now) / 1000;
+
+  return MIN (interval, MAX_PREDICTION_INTERVAL);
+}
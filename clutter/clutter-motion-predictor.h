@@ -0,0 +1,62 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterMotionPredictor: extrapolates the position of a pointer or
+ * touch point to the presentation time of the next frame.
+ */
+
+#ifndef __CLUTTER_MOTION_PREDICTOR_H__
+#define __CLUTTER_MOTION_PREDICTOR_H__
+
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-enums.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterMotionPredictor  ClutterMotionPredictor;
+
+struct _ClutterMotionPredictor
+{
+  /* the last reported position, and its event time in milliseconds */
+  gfloat x, y;
+  guint32 time;
+
+  /* velocity, in pixels per millisecond */
+  gfloat velocity_x, velocity_y;
+};
+
+void    _clutter_motion_predictor_init          (ClutterMotionPredictor       *predictor,
+                                                 gfloat                        x,
+                                                 gfloat                        y,
+                                                 guint32                       time_);
+void    _clutter_motion_predictor_update        (ClutterMotionPredictor       *predictor,
+                                                 ClutterMotionPrediction       mode,
+                                                 gfloat                        x,
+                                                 gfloat                        y,
+                                                 guint32                       time_);
+void    _clutter_motion_predictor_predict       (const ClutterMotionPredictor *predictor,
+                                                 ClutterMotionPrediction       mode,
+                                                 guint                         interval,
+                                                 gfloat                       *predicted_x,
+                                                 gfloat                       *predicted_y);
+
+guint   _clutter_motion_predictor_get_interval  (ClutterStage                 *stage);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_MOTION_PREDICTOR_H__ */
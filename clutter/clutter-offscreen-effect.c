@@ -74,6 +74,8 @@
 
 #include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-offscreen-effect-private.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-private.h"
 #include "clutter-stage-private.h"
 
@@ -86,6 +88,15 @@ struct _ClutterOffscreenEffectPrivate
   ClutterActor *actor;
   ClutterActor *stage;
 
+  /* the render target acquired from the pool of the stage, unless
+     a sub-class creates its own textures */
+  ClutterOffscreenTarget *pool_target;
+
+  /* the render target released after the last paint; this is not a
+     reference, and it is only used to reclaim the target from the
+     pool, in case nobody else used it in the meantime */
+  ClutterOffscreenTarget *last_target;
+
   gfloat x_offset;
   gfloat y_offset;
 
@@ -107,12 +118,79 @@ struct _ClutterOffscreenEffectPrivate
      and it won't cause a redraw to be queued on the parent's
      children. */
   CoglMatrix last_matrix_drawn;
+
+  guint persistent_target : 1;
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterOffscreenEffect,
                                      clutter_offscreen_effect,
                                      CLUTTER_TYPE_EFFECT)
 
+static CoglHandle
+clutter_offscreen_effect_real_create_texture (ClutterOffscreenEffect *effect,
+                                              gfloat                  width,
+                                              gfloat                  height);
+
+/* only the effects giving back their render target between paints
+ * use the pool; the persistent ones, and the ones creating their own
+ * textures, keep a texture of the exact size of their paint box
+ */
+#define USES_OFFSCREEN_POOL(self) \
+  (!(self)->priv->persistent_target && \
+   CLUTTER_OFFSCREEN_EFFECT_GET_CLASS (self)->create_texture == \
+   clutter_offscreen_effect_real_create_texture)
+
+static void
+clutter_offscreen_effect_release_target (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->pool_target == NULL)
+    return;
+
+  priv->last_target = priv->pool_target;
+
+  _clutter_offscreen_target_release (priv->pool_target);
+  priv->pool_target = NULL;
+
+  cogl_handle_unref (priv->offscreen);
+  priv->offscreen = NULL;
+
+  cogl_handle_unref (priv->texture);
+  priv->texture = NULL;
+}
+
+static gboolean
+clutter_offscreen_effect_reclaim_target (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+  ClutterOffscreenTarget *target = priv->last_target;
+  ClutterOffscreenPool *pool;
+  ClutterActor *stage;
+
+  priv->last_target = NULL;
+
+  stage = _clutter_actor_get_stage_internal (priv->actor);
+  if (stage == NULL)
+    return FALSE;
+
+  pool = _clutter_stage_get_offscreen_pool (CLUTTER_STAGE (stage));
+  if (pool == NULL || !_clutter_offscreen_pool_reclaim (pool, target, self))
+    return FALSE;
+
+  CLUTTER_NOTE (PAINT, "Reclaimed the offscreen target [%p] of '%s'",
+                target,
+                _clutter_actor_get_debug_name (priv->actor));
+
+  priv->pool_target = target;
+  priv->offscreen = cogl_handle_ref (target->offscreen);
+  priv->texture = cogl_handle_ref (target->texture);
+
+  cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
+
+  return TRUE;
+}
+
 static void
 clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
                                     ClutterActor     *actor)
@@ -125,6 +203,9 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
   meta_class->set_actor (meta, actor);
 
   /* clear out the previous state */
+  clutter_offscreen_effect_release_target (self);
+  priv->last_target = NULL;
+
   if (priv->offscreen != NULL)
     {
       cogl_handle_unref (priv->offscreen);
@@ -182,6 +263,40 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
                                        COGL_PIPELINE_FILTER_NEAREST);
     }
 
+  if (USES_OFFSCREEN_POOL (self))
+    {
+      ClutterOffscreenPool *pool;
+
+      /* give back the current target first, so that it can be picked
+       * again if it is big enough
+       */
+      clutter_offscreen_effect_release_target (self);
+
+      pool = _clutter_stage_get_offscreen_pool (CLUTTER_STAGE (priv->stage));
+      if (pool == NULL)
+        return FALSE;
+
+      priv->pool_target =
+        _clutter_offscreen_pool_acquire (pool, fbo_width, fbo_height, self);
+      if (priv->pool_target == NULL)
+        {
+          priv->fbo_width = 0;
+          priv->fbo_height = 0;
+
+          return FALSE;
+        }
+
+      priv->offscreen = cogl_handle_ref (priv->pool_target->offscreen);
+      priv->texture = cogl_handle_ref (priv->pool_target->texture);
+
+      cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
+
+      priv->fbo_width = fbo_width;
+      priv->fbo_height = fbo_height;
+
+      return TRUE;
+    }
+
   if (priv->texture != NULL)
     {
       cogl_handle_unref (priv->texture);
@@ -349,10 +464,43 @@ clutter_offscreen_effect_pre_paint (ClutterEffect *effect)
   return TRUE;
 }
 
+/* retrieves the size of the area of the target that contains the
+ * actor; when the target comes from the pool, it can be bigger than
+ * that, and it can be given back to the pool after the paint, so we
+ * use the size we asked for
+ */
+static gboolean
+clutter_offscreen_effect_get_paint_size (ClutterOffscreenEffect *effect,
+                                         gfloat                 *width,
+                                         gfloat                 *height)
+{
+  ClutterOffscreenEffectPrivate *priv = effect->priv;
+
+  if (USES_OFFSCREEN_POOL (effect))
+    {
+      if (priv->fbo_width <= 0 || priv->fbo_height <= 0)
+        return FALSE;
+
+      *width = priv->fbo_width;
+      *height = priv->fbo_height;
+
+      return TRUE;
+    }
+
+  if (priv->texture == NULL)
+    return FALSE;
+
+  *width = cogl_texture_get_width (priv->texture);
+  *height = cogl_texture_get_height (priv->texture);
+
+  return TRUE;
+}
+
 static void
 clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterOffscreenEffectPrivate *priv = effect->priv;
+  gfloat width, height;
   guint8 paint_opacity;
 
   paint_opacity = clutter_actor_get_paint_opacity (priv->actor);
@@ -367,13 +515,16 @@ clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect)
   /* At this point we are in stage coordinates translated so if
    * we draw our texture using a textured quad the size of the paint
    * box then we will overlay where the actor would have drawn if it
-   * hadn't been redirected offscreen.
+   * hadn't been redirected offscreen. The texture can be bigger than
+   * the paint box, in which case we only draw the part we painted.
    */
-  cogl_rectangle_with_texture_coords (0, 0,
-                                      cogl_texture_get_width (priv->texture),
-                                      cogl_texture_get_height (priv->texture),
+  if (!clutter_offscreen_effect_get_paint_size (effect, &width, &height))
+    return;
+
+  cogl_rectangle_with_texture_coords (0, 0, width, height,
                                       0.0, 0.0,
-                                      1.0, 1.0);
+                                      width / cogl_texture_get_width (priv->texture),
+                                      height / cogl_texture_get_height (priv->texture));
 }
 
 static void
@@ -431,6 +582,11 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
 
   cogl_get_modelview_matrix (&matrix);
 
+  /* If we gave back the target to the pool after the last paint, it
+     still has our contents unless somebody else used it since */
+  if (priv->offscreen == NULL && priv->last_target != NULL)
+    clutter_offscreen_effect_reclaim_target (self);
+
   /* If we've already got a cached image for the same matrix and the
      actor hasn't been redrawn then we can just use the cached image
      in the fbo */
@@ -445,6 +601,11 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
     }
   else
     clutter_offscreen_effect_paint_texture (self);
+
+  /* Unless we were asked to keep it, we give the target back to the
+     pool, so that the other effects painted after us can use it */
+  if (!priv->persistent_target)
+    clutter_offscreen_effect_release_target (self);
 }
 
 static void
@@ -453,6 +614,8 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   ClutterOffscreenEffect *self = CLUTTER_OFFSCREEN_EFFECT (gobject);
   ClutterOffscreenEffectPrivate *priv = self->priv;
 
+  clutter_offscreen_effect_release_target (self);
+
   if (priv->offscreen)
     cogl_handle_unref (priv->offscreen);
 
@@ -488,6 +651,10 @@ static void
 clutter_offscreen_effect_init (ClutterOffscreenEffect *self)
 {
   self->priv = clutter_offscreen_effect_get_instance_private (self);
+
+  /* sub-classes can use the texture outside of the paint, so they
+     have to opt into sharing it */
+  self->priv->persistent_target = TRUE;
 }
 
 /**
@@ -504,6 +671,10 @@ clutter_offscreen_effect_init (ClutterOffscreenEffect *self)
  * used instead of clutter_offscreen_effect_get_target() when the
  * effect subclass wants to paint using its own material.
  *
+ * If @effect does not keep a persistent render target, as set by
+ * clutter_offscreen_effect_set_persistent_target(), the texture is
+ * given back to the stage once @effect has been painted.
+ *
  * Return value: (transfer none): a #CoglHandle or %COGL_INVALID_HANDLE. The
  *   returned texture is owned by Clutter and it should not be
  *   modified or freed
@@ -527,7 +698,10 @@ clutter_offscreen_effect_get_texture (ClutterOffscreenEffect *effect)
  * buffer created by @effect
  *
  * You should only use the returned #CoglMaterial when painting. The
- * returned material might change between different frames.
+ * returned material might change between different frames, and the
+ * texture it uses is given back to the stage after the paint unless
+ * the render target is persistent, as set by
+ * clutter_offscreen_effect_set_persistent_target().
  *
  * Return value: (transfer none): a #CoglMaterial or %NULL. The
  *   returned material is owned by Clutter and it should not be
@@ -612,20 +786,20 @@ clutter_offscreen_effect_get_target_size (ClutterOffscreenEffect *effect,
                                           gfloat                 *width,
                                           gfloat                 *height)
 {
-  ClutterOffscreenEffectPrivate *priv;
+  gfloat paint_width, paint_height;
 
   g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect), FALSE);
 
-  priv = effect->priv;
-
-  if (priv->texture == NULL)
+  if (!clutter_offscreen_effect_get_paint_size (effect,
+                                                &paint_width,
+                                                &paint_height))
     return FALSE;
 
   if (width)
-    *width = cogl_texture_get_width (priv->texture);
+    *width = paint_width;
 
   if (height)
-    *height = cogl_texture_get_height (priv->texture);
+    *height = paint_height;
 
   return TRUE;
 }
@@ -638,6 +812,11 @@ clutter_offscreen_effect_get_target_size (ClutterOffscreenEffect *effect,
  * Retrieves the origin and size of the offscreen buffer used by @effect to
  * paint the actor to which it has been applied.
  *
+ * If @effect does not keep a persistent render target, the texture
+ * returned by clutter_offscreen_effect_get_texture() can be bigger than
+ * the returned rectangle, in which case only its top left corner
+ * contains the actor.
+ *
  * This function should only be called by #ClutterOffscreenEffect
  * implementations, from within the #ClutterOffscreenEffectClass.paint_target()
  * virtual function.
@@ -652,20 +831,101 @@ clutter_offscreen_effect_get_target_rect (ClutterOffscreenEffect *effect,
                                           ClutterRect            *rect)
 {
   ClutterOffscreenEffectPrivate *priv;
+  gfloat width, height;
 
   g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect), FALSE);
   g_return_val_if_fail (rect != NULL, FALSE);
 
   priv = effect->priv;
 
-  if (priv->texture == NULL)
+  if (!clutter_offscreen_effect_get_paint_size (effect, &width, &height))
     return FALSE;
 
   clutter_rect_init (rect,
                      priv->x_offset,
                      priv->y_offset,
-                     cogl_texture_get_width (priv->texture),
-                     cogl_texture_get_height (priv->texture));
+                     width,
+                     height);
 
   return TRUE;
 }
+
+/**
+ * clutter_offscreen_effect_set_persistent_target:
+ * @effect: a #ClutterOffscreenEffect
+ * @persistent: whether @effect should keep its render target
+ *
+ * By default, a #ClutterOffscreenEffect keeps its render target for
+ * itself, with a texture of the size of the paint box of its actor, at
+ * the cost of the memory it uses. Effects that only use the render
+ * target while painting can share it with the other effects on the
+ * same stage between paints instead, by setting @persistent to %FALSE;
+ * the contents of the render target are then only reused on the next
+ * paint if no other effect painted into it in the meantime. Shared
+ * textures can be bigger than the paint box, so that actors changing
+ * size keep using the same ones.
+ *
+ * Effects that are not persistent must not use the texture returned by
+ * clutter_offscreen_effect_get_texture() outside of their paint.
+ *
+ * This setting has no effect on sub-classes overriding the
+ * #ClutterOffscreenEffectClass.create_texture() virtual function, as
+ * their render targets are never shared.
+ *
+ * Since: 1.28
+ */
+void
+clutter_offscreen_effect_set_persistent_target (ClutterOffscreenEffect *effect,
+                                                gboolean                persistent)
+{
+  ClutterOffscreenEffectPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect));
+
+  priv = effect->priv;
+
+  persistent = !!persistent;
+  if (priv->persistent_target == persistent)
+    return;
+
+  priv->persistent_target = persistent;
+
+  /* the render target is not allocated in the same way, so it is
+     created again on the next paint */
+  clutter_offscreen_effect_release_target (effect);
+  priv->last_target = NULL;
+
+  if (priv->offscreen != NULL)
+    {
+      cogl_handle_unref (priv->offscreen);
+      priv->offscreen = NULL;
+    }
+
+  if (priv->texture != NULL)
+    {
+      cogl_handle_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
+  priv->fbo_width = 0;
+  priv->fbo_height = 0;
+}
+
+/**
+ * clutter_offscreen_effect_get_persistent_target:
+ * @effect: a #ClutterOffscreenEffect
+ *
+ * Retrieves whether @effect keeps its render target between paints, as
+ * set by clutter_offscreen_effect_set_persistent_target().
+ *
+ * Return value: %TRUE if the render target is kept
+ *
+ * Since: 1.28
+ */
+gboolean
+clutter_offscreen_effect_get_persistent_target (ClutterOffscreenEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect), FALSE);
+
+  return effect->priv->persistent_target;
+}
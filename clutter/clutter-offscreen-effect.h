@@ -117,6 +117,12 @@ CLUTTER_AVAILABLE_IN_1_14
 gboolean        clutter_offscreen_effect_get_target_rect        (ClutterOffscreenEffect *effect,
                                                                  ClutterRect            *rect);
 
+CLUTTER_AVAILABLE_IN_1_28
+void            clutter_offscreen_effect_set_persistent_target  (ClutterOffscreenEffect *effect,
+                                                                 gboolean                persistent);
+CLUTTER_AVAILABLE_IN_1_28
+gboolean        clutter_offscreen_effect_get_persistent_target  (ClutterOffscreenEffect *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_OFFSCREEN_EFFECT_H__ */
@@ -0,0 +1,419 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterOffscreenPool: the offscreen render targets shared by the
+ * effects painted on a stage.
+ *
+ * The effects acquire a render target before redirecting the paint of
+ * their actor, and release it once they painted its contents; since
+ * the effects are painted one after the other, the same few targets
+ * are enough for all the effects of a stage. The sizes of the targets
+ * are rounded up, so that actors changing size do not need a new
+ * target on every frame.
+ *
+ * Released targets are kept around, within a memory budget, and the
+ * ones that have not been used for a while are destroyed. A released
+ * target keeps its contents until it is acquired again, so its last
+ * user can reclaim it to paint the same contents again.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-offscreen-pool.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+/* the number of frames after which an unused target is destroyed */
+#define CLUTTER_OFFSCREEN_POOL_MAX_AGE  60
+
+struct _ClutterOffscreenPool
+{
+  /* all the targets of the pool, in use or not; the pool holds a
+   * reference on each of them
+   */
+  GPtrArray *targets;
+
+  gsize budget;
+  gsize size;
+
+  guint frame_counter;
+
+  guint n_acquired;
+  guint n_allocated;
+  guint n_evicted;
+};
+
+static inline int
+round_to_bucket (int size)
+{
+  size = MAX (size, 1);
+
+  return (size + CLUTTER_OFFSCREEN_POOL_BUCKET_SIZE - 1)
+       / CLUTTER_OFFSCREEN_POOL_BUCKET_SIZE
+       * CLUTTER_OFFSCREEN_POOL_BUCKET_SIZE;
+}
+
+static inline gsize
+target_get_size (const ClutterOffscreenTarget *target)
+{
+  /* the targets are RGBA, at 4 bytes per pixel */
+  return (gsize) target->width * target->height * 4;
+}
+
+ClutterOffscreenTarget *
+_clutter_offscreen_target_ref (ClutterOffscreenTarget *target)
+{
+  g_atomic_int_inc (&target->ref_count);
+
+  return target;
+}
+
+void
+_clutter_offscreen_target_unref (ClutterOffscreenTarget *target)
+{
+  if (g_atomic_int_dec_and_test (&target->ref_count))
+    {
+      cogl_handle_unref (target->offscreen);
+      cogl_handle_unref (target->texture);
+
+      g_slice_free (ClutterOffscreenTarget, target);
+    }
+}
+
+ClutterOffscreenPool *
+_clutter_offscreen_pool_new (void)
+{
+  ClutterOffscreenPool *pool = g_slice_new0 (ClutterOffscreenPool);
+
+  pool->targets = g_ptr_array_new ();
+  pool->budget = CLUTTER_OFFSCREEN_POOL_DEFAULT_BUDGET;
+
+  return pool;
+}
+
+void
+_clutter_offscreen_pool_free (ClutterOffscreenPool *pool)
+{
+  guint i;
+
+  /* the targets still in use outlive the pool */
+  for (i = 0; i < pool->targets->len; i++)
+    {
+      ClutterOffscreenTarget *target = g_ptr_array_index (pool->targets, i);
+
+      target->pool = NULL;
+      _clutter_offscreen_target_unref (target);
+    }
+
+  g_ptr_array_unref (pool->targets);
+
+  g_slice_free (ClutterOffscreenPool, pool);
+}
+
+static void
+clutter_offscreen_pool_remove_index (ClutterOffscreenPool *pool,
+                                     guint                 index_)
+{
+  ClutterOffscreenTarget *target = g_ptr_array_index (pool->targets, index_);
+
+  g_ptr_array_remove_index_fast (pool->targets, index_);
+
+  pool->size -= target_get_size (target);
+  pool->n_evicted += 1;
+
+  CLUTTER_NOTE (PAINT, "Destroying offscreen target %dx%d [%p]",
+                target->width, target->height,
+                target);
+
+  target->pool = NULL;
+  _clutter_offscreen_target_unref (target);
+}
+
+/* destroys the least recently used free targets until the pool
+ * fits its budget
+ */
+static void
+clutter_offscreen_pool_enforce_budget (ClutterOffscreenPool *pool)
+{
+  while (pool->size > pool->budget)
+    {
+      ClutterOffscreenTarget *oldest = NULL;
+      guint i, oldest_index = 0;
+
+      for (i = 0; i < pool->targets->len; i++)
+        {
+          ClutterOffscreenTarget *target = g_ptr_array_index (pool->targets, i);
+
+          if (target->in_use)
+            continue;
+
+          if (oldest == NULL || target->last_used < oldest->last_used)
+            {
+              oldest = target;
+              oldest_index = i;
+            }
+        }
+
+      /* everything is in use */
+      if (oldest == NULL)
+        break;
+
+      clutter_offscreen_pool_remove_index (pool, oldest_index);
+    }
+}
+
+void
+_clutter_offscreen_pool_set_budget (ClutterOffscreenPool *pool,
+                                    gsize                 budget)
+{
+  pool->budget = budget;
+
+  clutter_offscreen_pool_enforce_budget (pool);
+}
+
+static ClutterOffscreenTarget *
+clutter_offscreen_pool_allocate (ClutterOffscreenPool *pool,
+                                 int                   width,
+                                 int                   height)
+{
+  ClutterOffscreenTarget *target;
+  CoglHandle texture, offscreen;
+
+  texture = cogl_texture_new_with_size (width, height,
+                                        COGL_TEXTURE_NO_SLICING,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (texture == NULL)
+    return NULL;
+
+  offscreen = cogl_offscreen_new_to_texture (texture);
+  if (offscreen == NULL)
+    {
+      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+      cogl_handle_unref (texture);
+      return NULL;
+    }
+
+  target = g_slice_new0 (ClutterOffscreenTarget);
+  target->ref_count = 1;
+  target->pool = pool;
+  target->texture = texture;
+  target->offscreen = offscreen;
+  target->width = width;
+  target->height = height;
+
+  g_ptr_array_add (pool->targets, target);
+
+  pool->size += target_get_size (target);
+  pool->n_allocated += 1;
+
+  CLUTTER_NOTE (PAINT, "Allocated offscreen target %dx%d [%p]",
+                width, height,
+                target);
+
+  return target;
+}
+
+/*< private >
+ * _clutter_offscreen_pool_acquire:
+ * @pool: a #ClutterOffscreenPool
+ * @width: the minimum width of the target
+ * @height: the minimum height of the target
+ * @owner: the user of the target
+ *
+ * Acquires a render target at least as big as @width and @height. The
+ * target must be given back using _clutter_offscreen_target_release().
+ *
+ * Return value: (transfer full): a render target, or %NULL
+ */
+ClutterOffscreenTarget *
+_clutter_offscreen_pool_acquire (ClutterOffscreenPool *pool,
+                                 int                   width,
+                                 int                   height,
+                                 gconstpointer         owner)
+{
+  ClutterOffscreenTarget *target = NULL;
+  guint i;
+
+  width = round_to_bucket (width);
+  height = round_to_bucket (height);
+
+  pool->n_acquired += 1;
+
+  for (i = 0; i < pool->targets->len; i++)
+    {
+      ClutterOffscreenTarget *iter = g_ptr_array_index (pool->targets, i);
+
+      if (iter->in_use || iter->width != width || iter->height != height)
+        continue;
+
+      target = iter;
+
+      /* prefer the target the owner used last */
+      if (iter->owner == owner)
+        break;
+    }
+
+  if (target == NULL)
+    {
+      target = clutter_offscreen_pool_allocate (pool, width, height);
+      if (target == NULL)
+        return NULL;
+
+      /* make room for the new target, if possible */
+      target->in_use = TRUE;
+      clutter_offscreen_pool_enforce_budget (pool);
+    }
+
+  target->in_use = TRUE;
+  target->owner = owner;
+
+  return _clutter_offscreen_target_ref (target);
+}
+
+/*< private >
+ * _clutter_offscreen_pool_reclaim:
+ * @pool: a #ClutterOffscreenPool
+ * @target: a target previously released by @owner
+ * @owner: the last user of @target
+ *
+ * Acquires @target again, if nobody else acquired it since @owner
+ * released it, and it was not destroyed in the meantime; in that case
+ * @target still holds the contents painted by @owner.
+ *
+ * The @target pointer is only compared, and it is not dereferenced
+ * unless it still belongs to @pool.
+ *
+ * Return value: %TRUE if @target was acquired; in that case, it
+ *   must be given back using _clutter_offscreen_target_release()
+ */
+gboolean
+_clutter_offscreen_pool_reclaim (ClutterOffscreenPool   *pool,
+                                 ClutterOffscreenTarget *target,
+                                 gconstpointer           owner)
+{
+  guint i;
+
+  for (i = 0; i < pool->targets->len; i++)
+    {
+      if (g_ptr_array_index (pool->targets, i) != target)
+        continue;
+
+      if (target->in_use || target->owner != owner)
+        return FALSE;
+
+      pool->n_acquired += 1;
+
+      target->in_use = TRUE;
+      _clutter_offscreen_target_ref (target);
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*< private >
+ * _clutter_offscreen_target_release:
+ * @target: (transfer full): a target acquired from a #ClutterOffscreenPool
+ *
+ * Gives @target back to its pool, if the pool still exists, and
+ * releases the reference on it.
+ */
+void
+_clutter_offscreen_target_release (ClutterOffscreenTarget *target)
+{
+  ClutterOffscreenPool *pool = target->pool;
+
+  if (pool != NULL)
+    {
+      target->in_use = FALSE;
+      target->last_used = pool->frame_counter;
+    }
+
+  _clutter_offscreen_target_unref (target);
+
+  if (pool != NULL)
+    clutter_offscreen_pool_enforce_budget (pool);
+}
+
+/*< private >
+ * _clutter_offscreen_pool_end_frame:
+ * @pool: a #ClutterOffscreenPool
+ *
+ * Destroys the targets that have not been used for a while; this
+ * should be called once per painted frame.
+ */
+void
+_clutter_offscreen_pool_end_frame (ClutterOffscreenPool *pool)
+{
+  guint i;
+
+  pool->frame_counter += 1;
+
+  i = 0;
+  while (i < pool->targets->len)
+    {
+      ClutterOffscreenTarget *target = g_ptr_array_index (pool->targets, i);
+
+      if (!target->in_use &&
+          pool->frame_counter - target->last_used > CLUTTER_OFFSCREEN_POOL_MAX_AGE)
+        clutter_offscreen_pool_remove_index (pool, i);
+      else
+        i += 1;
+    }
+}
+
+/*< private >
+ * _clutter_offscreen_pool_get_stats:
+ * @pool: a #ClutterOffscreenPool
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Retrieves the number of render targets of @pool and the memory they
+ * use, along with how many times they were acquired, allocated and
+ * destroyed since @pool was created.
+ */
+void
+_clutter_offscreen_pool_get_stats (ClutterOffscreenPool      *pool,
+                                   ClutterOffscreenPoolStats *stats)
+{
+  guint i;
+
+  memset (stats, 0, sizeof (ClutterOffscreenPoolStats));
+
+  for (i = 0; i < pool->targets->len; i++)
+    {
+      ClutterOffscreenTarget *target = g_ptr_array_index (pool->targets, i);
+
+      if (!target->in_use)
+        {
+          stats->n_free_targets += 1;
+          stats->free_size += target_get_size (target);
+        }
+    }
+
+  stats->n_targets = pool->targets->len;
+  stats->size = pool->size;
+  stats->n_acquired = pool->n_acquired;
+  stats->n_allocated = pool->n_allocated;
+  stats->n_evicted = pool->n_evicted;
+}
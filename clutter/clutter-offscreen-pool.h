@@ -0,0 +1,115 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterOffscreenPool: the offscreen render targets shared by the
+ * effects painted on a stage.
+ */
+
+#ifndef __CLUTTER_OFFSCREEN_POOL_H__
+#define __CLUTTER_OFFSCREEN_POOL_H__
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+/* the sizes of the render targets are rounded up to a multiple of
+ * this, so that an actor changing size keeps using the same target
+ */
+#define CLUTTER_OFFSCREEN_POOL_BUCKET_SIZE      32
+
+/* the memory used by default by the render targets of a stage */
+#define CLUTTER_OFFSCREEN_POOL_DEFAULT_BUDGET   (64 * 1024 * 1024)
+
+typedef struct _ClutterOffscreenPool    ClutterOffscreenPool;
+typedef struct _ClutterOffscreenTarget  ClutterOffscreenTarget;
+typedef struct _ClutterOffscreenPoolStats ClutterOffscreenPoolStats;
+
+struct _ClutterOffscreenTarget
+{
+  /*< private >*/
+  volatile int ref_count;
+
+  /* the pool the target belongs to; NULL if the pool was destroyed */
+  ClutterOffscreenPool *pool;
+
+  CoglHandle texture;
+  CoglHandle offscreen;
+
+  int width;
+  int height;
+
+  /* the last user of the target; the contents of a released target
+   * are still valid for its last user until someone else acquires it
+   */
+  gconstpointer owner;
+
+  /* the frame in which the target was last released */
+  guint last_used;
+
+  guint in_use : 1;
+};
+
+struct _ClutterOffscreenPoolStats
+{
+  /* the number of render targets, and the memory they use */
+  guint n_targets;
+  gsize size;
+
+  /* the number of render targets not in use, and their memory */
+  guint n_free_targets;
+  gsize free_size;
+
+  /* the number of times a render target was requested, and how
+   * many times a new render target had to be allocated
+   */
+  guint n_acquired;
+  guint n_allocated;
+
+  /* the number of render targets destroyed, to stay within the
+   * budget or because they were not used for a while
+   */
+  guint n_evicted;
+};
+
+ClutterOffscreenPool *          _clutter_offscreen_pool_new             (void);
+void                            _clutter_offscreen_pool_free            (ClutterOffscreenPool    *pool);
+
+void                            _clutter_offscreen_pool_set_budget      (ClutterOffscreenPool    *pool,
+                                                                         gsize                    budget);
+
+ClutterOffscreenTarget *        _clutter_offscreen_pool_acquire         (ClutterOffscreenPool    *pool,
+                                                                         int                      width,
+                                                                         int                      height,
+                                                                         gconstpointer            owner);
+gboolean                        _clutter_offscreen_pool_reclaim         (ClutterOffscreenPool    *pool,
+                                                                         ClutterOffscreenTarget  *target,
+                                                                         gconstpointer            owner);
+
+void                            _clutter_offscreen_pool_end_frame       (ClutterOffscreenPool    *pool);
+
+void                            _clutter_offscreen_pool_get_stats       (ClutterOffscreenPool    *pool,
+                                                                         ClutterOffscreenPoolStats *stats);
+
+ClutterOffscreenTarget *        _clutter_offscreen_target_ref           (ClutterOffscreenTarget  *target);
+void                            _clutter_offscreen_target_unref         (ClutterOffscreenTarget  *target);
+void                            _clutter_offscreen_target_release       (ClutterOffscreenTarget  *target);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_OFFSCREEN_POOL_H__ */
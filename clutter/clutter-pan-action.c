@@ -109,6 +109,13 @@ struct _ClutterPanActionPrivate
   gfloat release_x;
   gfloat release_y;
 
+  /* The distance between the predicted and the reported positions of
+   * the touch point, accumulated by the default ::pan handler while
+   * following the predicted position
+   */
+  gfloat overshoot_x;
+  gfloat overshoot_y;
+
   guint should_interpolate : 1;
 
   PinState pin_state;
@@ -248,6 +255,7 @@ gesture_begin (ClutterGestureAction  *gesture,
   priv->state = PAN_STATE_PANNING;
   priv->interpolated_x = priv->interpolated_y = 0.0f;
   priv->dx = priv->dy = 0.0f;
+  priv->overshoot_x = priv->overshoot_y = 0.0f;
 
   return TRUE;
 }
@@ -263,6 +271,27 @@ gesture_progress (ClutterGestureAction *gesture,
   return TRUE;
 }
 
+/* the default ::pan handler followed the predicted position of the
+ * touch point, which might have overshot; move the children of the
+ * actor back to where the touch point was last reported
+ */
+static void
+settle_predicted_motion (ClutterPanAction *self,
+                         ClutterActor     *actor)
+{
+  ClutterPanActionPrivate *priv = self->priv;
+  ClutterMatrix transform;
+
+  if (priv->overshoot_x == 0.0f && priv->overshoot_y == 0.0f)
+    return;
+
+  clutter_actor_get_child_transform (actor, &transform);
+  cogl_matrix_translate (&transform, -priv->overshoot_x, -priv->overshoot_y, 0.0f);
+  clutter_actor_set_child_transform (actor, &transform);
+
+  priv->overshoot_x = priv->overshoot_y = 0.0f;
+}
+
 static void
 gesture_cancel (ClutterGestureAction *gesture,
                 ClutterActor         *actor)
@@ -270,6 +299,8 @@ gesture_cancel (ClutterGestureAction *gesture,
   ClutterPanAction *self = CLUTTER_PAN_ACTION (gesture);
   ClutterPanActionPrivate *priv = self->priv;
 
+  settle_predicted_motion (self, actor);
+
   priv->state = PAN_STATE_INACTIVE;
 }
 
@@ -286,6 +317,8 @@ gesture_end (ClutterGestureAction *gesture,
 
   clutter_gesture_action_get_release_coords (CLUTTER_GESTURE_ACTION (self), 0, &priv->release_x, &priv->release_y);
 
+  settle_predicted_motion (self, actor);
+
   if (!priv->should_interpolate)
     {
       priv->state = PAN_STATE_INACTIVE;
@@ -330,16 +363,67 @@ gesture_end (ClutterGestureAction *gesture,
     }
 }
 
+static void
+constrain_motion_delta (ClutterPanAction *self,
+                        gfloat           *delta_x,
+                        gfloat           *delta_y)
+{
+  ClutterPanActionPrivate *priv = self->priv;
+
+  switch (priv->pan_axis)
+    {
+    case CLUTTER_PAN_AXIS_NONE:
+      break;
+
+    case CLUTTER_PAN_AXIS_AUTO:
+      if (priv->pin_state == SCROLL_PINNED_VERTICAL)
+        *delta_x = 0.0f;
+      else if (priv->pin_state == SCROLL_PINNED_HORIZONTAL)
+        *delta_y = 0.0f;
+      break;
+
+    case CLUTTER_PAN_X_AXIS:
+      *delta_y = 0.0f;
+      break;
+
+    case CLUTTER_PAN_Y_AXIS:
+      *delta_x = 0.0f;
+      break;
+    }
+}
+
 static gboolean
 clutter_pan_action_real_pan (ClutterPanAction *self,
                              ClutterActor     *actor,
                              gboolean          is_interpolated)
 {
+  ClutterPanActionPrivate *priv = self->priv;
   gfloat dx, dy;
   ClutterMatrix transform;
 
   clutter_pan_action_get_constrained_motion_delta (self, 0, &dx, &dy);
 
+  /* follow the predicted position of the touch point, which is the
+   * same as the reported one unless a predictor has been set on the
+   * gesture action; the difference is taken back when the gesture ends
+   */
+  if (priv->state == PAN_STATE_PANNING)
+    {
+      gfloat predicted_dx, predicted_dy;
+
+      _clutter_gesture_action_get_predicted_delta (CLUTTER_GESTURE_ACTION (self),
+                                                   0,
+                                                   &predicted_dx,
+                                                   &predicted_dy);
+      constrain_motion_delta (self, &predicted_dx, &predicted_dy);
+
+      priv->overshoot_x += predicted_dx - dx;
+      priv->overshoot_y += predicted_dy - dy;
+
+      dx = predicted_dx;
+      dy = predicted_dy;
+    }
+
   clutter_actor_get_child_transform (actor, &transform);
   cogl_matrix_translate (&transform, dx, dy, 0.0f);
   clutter_actor_set_child_transform (actor, &transform);
@@ -876,35 +960,13 @@ clutter_pan_action_get_constrained_motion_delta (ClutterPanAction *self,
                                                  gfloat           *out_delta_x,
                                                  gfloat           *out_delta_y)
 {
-  ClutterPanActionPrivate *priv;
   gfloat delta_x = 0.f, delta_y = 0.f, distance;
 
   g_return_val_if_fail (CLUTTER_IS_PAN_ACTION (self), 0.0f);
 
-  priv = self->priv;
-
   distance = clutter_pan_action_get_motion_delta (self, point, &delta_x, &delta_y);
 
-  switch (priv->pan_axis)
-    {
-    case CLUTTER_PAN_AXIS_NONE:
-      break;
-
-    case CLUTTER_PAN_AXIS_AUTO:
-      if (priv->pin_state == SCROLL_PINNED_VERTICAL)
-        delta_x = 0.0f;
-      else if (priv->pin_state == SCROLL_PINNED_HORIZONTAL)
-        delta_y = 0.0f;
-      break;
-
-    case CLUTTER_PAN_X_AXIS:
-      delta_y = 0.0f;
-      break;
-
-    case CLUTTER_PAN_Y_AXIS:
-      delta_x = 0.0f;
-      break;
-    }
+  constrain_motion_delta (self, &delta_x, &delta_y);
 
   if (out_delta_x)
     *out_delta_x = delta_x;
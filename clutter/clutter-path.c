@@ -94,20 +94,42 @@ static GParamSpec *obj_props[PROP_LAST];
 
 typedef struct _ClutterPathNodeFull ClutterPathNodeFull;
 
+/* the distance between two samples of a curve, along the curve */
+#define CLUTTER_PATH_SAMPLE_SPACING     4
+#define CLUTTER_PATH_MAX_SAMPLES        256
+
 struct _ClutterPathNodeFull
 {
   ClutterPathNode k;
 
   ClutterBezier *bezier;
 
+  /* the positions along a curve, evenly spaced by length */
+  ClutterKnot *samples;
+  guint n_samples;
+
   guint length;
 };
 
+typedef struct _ClutterPathSegment
+{
+  ClutterPathNodeFull *node;
+
+  /* the distance along the path at which the node ends */
+  guint end;
+} ClutterPathSegment;
+
 struct _ClutterPathPrivate
 {
   GSList *nodes, *nodes_tail;
   gboolean nodes_dirty;
 
+  /* the nodes, in order, with their distance along the path; this is
+   * rebuilt with the node data when the nodes change
+   */
+  ClutterPathSegment *segments;
+  guint n_segments;
+
   guint total_length;
 };
 
@@ -238,6 +260,8 @@ clutter_path_finalize (GObject *object)
 
   clutter_path_clear (self);
 
+  g_free (self->priv->segments);
+
   G_OBJECT_CLASS (clutter_path_parent_class)->finalize (object);
 }
 
@@ -1231,6 +1255,33 @@ clutter_path_node_distance (const ClutterKnot *start,
   return (guint) t;
 }
 
+/* samples the curve of @node by length, so that positions along the
+ * curve can be interpolated without walking the bezier
+ */
+static void
+clutter_path_node_sample_curve (ClutterPathNodeFull *node)
+{
+  guint n_samples, i;
+
+  n_samples = node->length / CLUTTER_PATH_SAMPLE_SPACING + 2;
+  n_samples = MIN (n_samples, CLUTTER_PATH_MAX_SAMPLES);
+
+  if (node->n_samples != n_samples)
+    {
+      g_free (node->samples);
+      node->samples = g_new (ClutterKnot, n_samples);
+      node->n_samples = n_samples;
+    }
+
+  for (i = 0; i < n_samples; i++)
+    {
+      _clutter_bezier_advance (node->bezier,
+                               (gint64) i * CLUTTER_BEZIER_MAX_LENGTH
+                               / (n_samples - 1),
+                               &node->samples[i]);
+    }
+}
+
 static void
 clutter_path_ensure_node_data (ClutterPath *path)
 {
@@ -1244,9 +1295,19 @@ clutter_path_ensure_node_data (ClutterPath *path)
       ClutterKnot loop_start = { 0, 0 };
       ClutterKnot points[3];
 
+      guint n_nodes, i;
+
       priv->total_length = 0;
 
-      for (l = priv->nodes; l; l = l->next)
+      n_nodes = g_slist_length (priv->nodes);
+      if (priv->n_segments != n_nodes)
+        {
+          g_free (priv->segments);
+          priv->segments = g_new (ClutterPathSegment, n_nodes);
+          priv->n_segments = n_nodes;
+        }
+
+      for (l = priv->nodes, i = 0; l; l = l->next, i++)
         {
           ClutterPathNodeFull *node = l->data;
           gboolean relative = (node->k.type & CLUTTER_PATH_RELATIVE) != 0;
@@ -1318,6 +1379,7 @@ clutter_path_ensure_node_data (ClutterPath *path)
 
               node->length = _clutter_bezier_get_length (node->bezier);
 
+              clutter_path_node_sample_curve (node);
               break;
 
             case CLUTTER_PATH_CLOSE:
@@ -1332,12 +1394,116 @@ clutter_path_ensure_node_data (ClutterPath *path)
             }
 
           priv->total_length += node->length;
+
+          priv->segments[i].node = node;
+          priv->segments[i].end = priv->total_length;
         }
 
       priv->nodes_dirty = FALSE;
     }
 }
 
+/* finds the first node, starting from @first, that ends after
+ * @point_distance; the distance of the nodes only grows along the
+ * path, so this is a binary search
+ */
+static guint
+clutter_path_find_segment (ClutterPathPrivate *priv,
+                           guint               point_distance,
+                           guint               first)
+{
+  guint lo = first, hi = priv->n_segments - 1;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (point_distance < priv->segments[mid].end)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+
+  return lo;
+}
+
+static void
+clutter_path_node_get_position (const ClutterPathNodeFull *node,
+                                guint                      point_distance,
+                                ClutterKnot               *position)
+{
+  switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
+    {
+    case CLUTTER_PATH_MOVE_TO:
+      *position = node->k.points[1];
+      break;
+
+    case CLUTTER_PATH_LINE_TO:
+    case CLUTTER_PATH_CLOSE:
+      if (node->length == 0)
+        *position = node->k.points[1];
+      else
+        {
+          position->x = (node->k.points[1].x
+                         + ((node->k.points[2].x - node->k.points[1].x)
+                            * (gint) point_distance / (gint) node->length));
+          position->y = (node->k.points[1].y
+                         + ((node->k.points[2].y - node->k.points[1].y)
+                            * (gint) point_distance / (gint) node->length));
+        }
+      break;
+
+    case CLUTTER_PATH_CURVE_TO:
+      if (node->length == 0)
+        *position = node->k.points[2];
+      else
+        {
+          const ClutterKnot *a, *b;
+          float f;
+          guint i;
+
+          /* interpolate between the two closest samples */
+          f = (float) point_distance * (node->n_samples - 1) / node->length;
+          i = MIN ((guint) f, node->n_samples - 2);
+          f -= i;
+
+          a = &node->samples[i];
+          b = &node->samples[i + 1];
+
+          position->x = a->x + (gint) floorf ((b->x - a->x) * f + 0.5f);
+          position->y = a->y + (gint) floorf ((b->y - a->y) * f + 0.5f);
+        }
+      break;
+    }
+}
+
+static guint
+clutter_path_get_position_internal (ClutterPath *path,
+                                    gdouble      progress,
+                                    guint        first,
+                                    ClutterKnot *position)
+{
+  ClutterPathPrivate *priv = path->priv;
+  const ClutterPathSegment *segment;
+  guint point_distance, node_num;
+
+  /* Convert the progress to a length along the path */
+  point_distance = progress * priv->total_length;
+
+  /* Find the node that covers this point */
+  node_num = clutter_path_find_segment (priv, point_distance, first);
+  segment = &priv->segments[node_num];
+
+  /* Convert the point distance to a distance along the node */
+  point_distance -= MIN (point_distance, segment->end - segment->node->length);
+  if (point_distance > segment->node->length)
+    point_distance = segment->node->length;
+
+  clutter_path_node_get_position (segment->node, point_distance, position);
+
+  return node_num;
+}
+
 /**
  * clutter_path_get_position:
  * @path: a #ClutterPath
@@ -1357,81 +1523,86 @@ clutter_path_get_position (ClutterPath *path,
                            gdouble progress,
                            ClutterKnot *position)
 {
-  ClutterPathPrivate *priv;
-  GSList *l;
-  guint point_distance, length = 0, node_num = 0;
-  ClutterPathNodeFull *node;
-
   g_return_val_if_fail (CLUTTER_IS_PATH (path), 0);
   g_return_val_if_fail (progress >= 0.0 && progress <= 1.0, 0);
 
-  priv = path->priv;
-
   clutter_path_ensure_node_data (path);
 
   /* Special case if the path is empty, just return 0,0 for want of
      something better */
-  if (priv->nodes == NULL)
+  if (path->priv->nodes == NULL)
     {
       memset (position, 0, sizeof (ClutterKnot));
       return 0;
     }
 
-  /* Convert the progress to a length along the path */
-  point_distance = progress * priv->total_length;
+  return clutter_path_get_position_internal (path, progress, 0, position);
+}
 
-  /* Find the node that covers this point */
-  for (l = priv->nodes;
-       l->next && point_distance >= (((ClutterPathNodeFull *) l->data)->length
-                                     + length);
-       l = l->next)
+/**
+ * clutter_path_get_positions:
+ * @path: a #ClutterPath
+ * @n_positions: the number of positions to compute
+ * @progress: (array length=n_positions): the positions along the path,
+ *   as fractions of its length, between 0.0 and 1.0
+ * @positions: (out caller-allocates) (array length=n_positions): return
+ *   location for the positions
+ * @nodes: (out caller-allocates) (array length=n_positions) (allow-none):
+ *   return location for the index of the node used to calculate each
+ *   position, or %NULL
+ *
+ * Computes the positions at many points along @path at once; this is
+ * equivalent to calling clutter_path_get_position() for each element
+ * of @progress, but it is faster, especially if @progress is sorted.
+ *
+ * This is useful to update many actors following the same path.
+ *
+ * Since: 1.28
+ */
+void
+clutter_path_get_positions (ClutterPath   *path,
+                            guint          n_positions,
+                            const gdouble *progress,
+                            ClutterKnot   *positions,
+                            guint         *nodes)
+{
+  guint i, node_num;
+  gdouble last_progress;
+
+  g_return_if_fail (CLUTTER_IS_PATH (path));
+  g_return_if_fail (n_positions == 0 || (progress != NULL && positions != NULL));
+
+  clutter_path_ensure_node_data (path);
+
+  if (path->priv->nodes == NULL)
     {
-      length += ((ClutterPathNodeFull *) l->data)->length;
-      node_num++;
-    }
+      memset (positions, 0, sizeof (ClutterKnot) * n_positions);
+      if (nodes != NULL)
+        memset (nodes, 0, sizeof (guint) * n_positions);
 
-  node = l->data;
+      return;
+    }
 
-  /* Convert the point distance to a distance along the node */
-  point_distance -= length;
-  if (point_distance > node->length)
-    point_distance = node->length;
+  node_num = 0;
+  last_progress = 0.0;
 
-  switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
+  for (i = 0; i < n_positions; i++)
     {
-    case CLUTTER_PATH_MOVE_TO:
-      *position = node->k.points[1];
-      break;
+      gdouble p = CLAMP (progress[i], 0.0, 1.0);
 
-    case CLUTTER_PATH_LINE_TO:
-    case CLUTTER_PATH_CLOSE:
-      if (node->length == 0)
-        *position = node->k.points[1];
-      else
-        {
-          position->x = (node->k.points[1].x
-                         + ((node->k.points[2].x - node->k.points[1].x)
-                            * (gint) point_distance / (gint) node->length));
-          position->y = (node->k.points[1].y
-                         + ((node->k.points[2].y - node->k.points[1].y)
-                            * (gint) point_distance / (gint) node->length));
-        }
-      break;
+      /* the search can start from the last node as long as the
+       * positions move forward along the path
+       */
+      if (p < last_progress)
+        node_num = 0;
 
-    case CLUTTER_PATH_CURVE_TO:
-      if (node->length == 0)
-        *position = node->k.points[2];
-      else
-        {
-          _clutter_bezier_advance (node->bezier,
-                                   point_distance * CLUTTER_BEZIER_MAX_LENGTH
-                                   / node->length,
-                                   position);
-        }
-      break;
-    }
+      node_num = clutter_path_get_position_internal (path, p, node_num,
+                                                     &positions[i]);
+      last_progress = p;
 
-  return node_num;
+      if (nodes != NULL)
+        nodes[i] = node_num;
+    }
 }
 
 /**
@@ -1466,6 +1637,8 @@ clutter_path_node_full_free (ClutterPathNodeFull *node)
   if (node->bezier)
     _clutter_bezier_free (node->bezier);
 
+  g_free (node->samples);
+
   g_slice_free (ClutterPathNodeFull, node);
 }
 
@@ -173,6 +173,12 @@ CLUTTER_AVAILABLE_IN_1_0
 guint        clutter_path_get_position         (ClutterPath           *path,
                                                 gdouble                progress,
                                                 ClutterKnot           *position);
+CLUTTER_AVAILABLE_IN_1_28
+void         clutter_path_get_positions        (ClutterPath           *path,
+                                                guint                  n_positions,
+                                                const gdouble         *progress,
+                                                ClutterKnot           *positions,
+                                                guint                 *nodes);
 CLUTTER_AVAILABLE_IN_1_0
 guint        clutter_path_get_length           (ClutterPath           *path);
 
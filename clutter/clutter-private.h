@@ -60,6 +60,10 @@ typedef struct _ClutterVertex4          ClutterVertex4;
   clutter_interval_register_progress_func (g_define_type_id, func);     \
 }
 
+#define CLUTTER_REGISTER_INTERVAL_KERNEL(func,kernel,size)            { \
+  _clutter_register_interval_kernel (g_define_type_id, func, kernel, size); \
+}
+
 #define CLUTTER_PRIVATE_FLAGS(a)	 (((ClutterActor *) (a))->private_flags)
 #define CLUTTER_SET_PRIVATE_FLAGS(a,f)	 (CLUTTER_PRIVATE_FLAGS (a) |= (f))
 #define CLUTTER_UNSET_PRIVATE_FLAGS(a,f) (CLUTTER_PRIVATE_FLAGS (a) &= ~(f))
@@ -168,12 +172,21 @@ struct _ClutterMainContext
   /* main settings singleton */
   ClutterSettings *settings;
 
+  /* the file the virtual master clock writes the frame timings into */
+  gchar *frame_timings;
+
+  /* the memory budget of the offscreen render targets of each stage,
+   * in bytes, or 0 for the default
+   */
+  gsize offscreen_budget;
+
   /* boolean flags */
   guint is_initialized          : 1;
   guint motion_events_per_actor : 1;
   guint defer_display_setup     : 1;
   guint options_parsed          : 1;
   guint show_fps                : 1;
+  guint use_virtual_clock       : 1;
 };
 
 /* shared between clutter-main.c and clutter-frame-source.c */
@@ -302,6 +315,21 @@ typedef enum _ClutterCullResult
   CLUTTER_CULL_RESULT_PARTIAL
 } ClutterCullResult;
 
+/*
+ * ClutterIntervalKernel:
+ * @initial: the initial value
+ * @final: the final value
+ * @progress: the progress factor
+ * @result: return location for the interpolated value
+ *
+ * Interpolates between two values stored using their C type, like
+ * a #gfloat or a #ClutterColor, without going through a #GValue.
+ */
+typedef void (* ClutterIntervalKernel) (gconstpointer initial,
+                                        gconstpointer final,
+                                        gdouble       progress,
+                                        gpointer      result);
+
 gboolean        _clutter_has_progress_function  (GType gtype);
 gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *initial,
@@ -309,6 +337,17 @@ gboolean        _clutter_run_progress_function  (GType gtype,
                                                  gdouble progress,
                                                  GValue *retval);
 
+void            _clutter_register_interval_kernel       (GType                  gtype,
+                                                         ClutterProgressFunc    func,
+                                                         ClutterIntervalKernel  kernel,
+                                                         gsize                  size);
+gboolean        _clutter_get_interval_kernel            (GType                  gtype,
+                                                         ClutterIntervalKernel *kernel,
+                                                         gsize                 *size);
+guint           _clutter_get_progress_functions_serial  (void);
+
+guint           _clutter_interval_get_serial    (ClutterInterval *interval);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_PRIVATE_H__ */
@@ -0,0 +1,15 @@
+#ifndef __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__
+#define __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__
+
+#include <clutter/clutter-property-transition.h>
+#include "clutter-animation-table.h"
+
+G_BEGIN_DECLS
+
+void    _clutter_property_transition_set_table_func     (ClutterPropertyTransition      *transition,
+                                                         ClutterAnimationTableFunc       func,
+                                                         ClutterAnimationTableBatchFunc  batch_func);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__ */
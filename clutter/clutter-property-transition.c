@@ -34,12 +34,13 @@
 #include "config.h"
 #endif
 
-#include "clutter-property-transition.h"
+#include "clutter-property-transition-private.h"
 
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
+#include "clutter-timeline.h"
 #include "clutter-transition.h"
 
 struct _ClutterPropertyTransitionPrivate
@@ -47,6 +48,14 @@ struct _ClutterPropertyTransitionPrivate
   char *property_name;
 
   GParamSpec *pspec;
+
+  /* the slot in the animation table, if the property is animated
+   * through it, and the serial of the interval it holds
+   */
+  ClutterAnimationTableFunc table_func;
+  ClutterAnimationTableBatchFunc table_batch_func;
+  gint table_slot;
+  guint table_serial;
 };
 
 enum
@@ -94,6 +103,103 @@ clutter_property_transition_ensure_interval (ClutterPropertyTransition *transiti
     }
 }
 
+static void
+clutter_property_transition_release_slot (ClutterPropertyTransition *transition)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+
+  if (priv->table_slot < 0)
+    return;
+
+  _clutter_animation_table_remove (_clutter_animation_table_get_default (),
+                                   priv->table_slot,
+                                   FALSE);
+  priv->table_slot = -1;
+}
+
+static void
+clutter_property_transition_ensure_slot (ClutterPropertyTransition *transition,
+                                         ClutterAnimatable         *animatable)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+
+  if (priv->table_slot >= 0)
+    return;
+
+  if (priv->table_func == NULL || priv->pspec == NULL)
+    return;
+
+  if (!_clutter_animation_table_supports_type (G_PARAM_SPEC_VALUE_TYPE (priv->pspec)))
+    return;
+
+  priv->table_slot =
+    _clutter_animation_table_add (_clutter_animation_table_get_default (),
+                                  G_OBJECT (animatable),
+                                  priv->pspec,
+                                  priv->table_func,
+                                  priv->table_batch_func);
+
+  /* the interval is unpacked on the first frame */
+  priv->table_serial = 0;
+}
+
+static gboolean
+timeline_is_at_end (ClutterTimeline *timeline)
+{
+  if (clutter_timeline_get_direction (timeline) == CLUTTER_TIMELINE_FORWARD)
+    return clutter_timeline_get_elapsed_time (timeline) >= clutter_timeline_get_duration (timeline);
+
+  return clutter_timeline_get_elapsed_time (timeline) <= 0;
+}
+
+static gboolean
+clutter_property_transition_compute_slot (ClutterPropertyTransition *transition,
+                                          ClutterAnimatable         *animatable,
+                                          ClutterInterval           *interval,
+                                          gdouble                    progress)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+  ClutterAnimationTable *table = _clutter_animation_table_get_default ();
+  static guint new_frame_id = 0;
+  guint serial;
+  gboolean flush;
+
+  serial = _clutter_interval_get_serial (interval);
+  if (serial != priv->table_serial)
+    {
+      clutter_property_transition_ensure_interval (transition, animatable, interval);
+
+      /* intervals with their own compute_value(), or holding a type
+       * that is not the type of the property, go through the slow path
+       */
+      if (G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL ||
+          !_clutter_animation_table_set_interval (table, priv->table_slot,
+                                                  clutter_interval_peek_initial_value (interval),
+                                                  clutter_interval_peek_final_value (interval)))
+        {
+          clutter_property_transition_release_slot (transition);
+          priv->table_func = NULL;
+          return FALSE;
+        }
+
+      priv->table_serial = serial;
+    }
+
+  if (G_UNLIKELY (new_frame_id == 0))
+    new_frame_id = g_signal_lookup ("new-frame", CLUTTER_TYPE_TIMELINE);
+
+  /* the value can be written at the end of the frame, unless somebody
+   * could look at it before then: a ::new-frame handler, or the handlers
+   * of ::completed and ::stopped on the last frame of the timeline
+   */
+  flush = timeline_is_at_end (CLUTTER_TIMELINE (transition)) ||
+          g_signal_has_handler_pending (transition, new_frame_id, 0, TRUE);
+
+  _clutter_animation_table_set_progress (table, priv->table_slot, progress, flush);
+
+  return TRUE;
+}
+
 static void
 clutter_property_transition_attached (ClutterTransition *transition,
                                       ClutterAnimatable *animatable)
@@ -111,6 +217,8 @@ clutter_property_transition_attached (ClutterTransition *transition,
   if (priv->pspec == NULL)
     return;
 
+  clutter_property_transition_ensure_slot (self, animatable);
+
   interval = clutter_transition_get_interval (transition);
   if (interval == NULL)
     return;
@@ -125,6 +233,8 @@ clutter_property_transition_detached (ClutterTransition *transition,
   ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
   ClutterPropertyTransitionPrivate *priv = self->priv;
 
+  clutter_property_transition_release_slot (self);
+
   priv->pspec = NULL; 
 }
 
@@ -144,11 +254,31 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
   if (priv->pspec == NULL)
     return;
 
+  if (priv->table_slot >= 0 &&
+      clutter_property_transition_compute_slot (self, animatable, interval, progress))
+    return;
+
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
+  /* unless the animatable interpolates on its own, we can pass along
+   * the value computed by the interval without copying it
+   */
+  if (i_type == p_type &&
+      CLUTTER_ANIMATABLE_GET_IFACE (animatable)->interpolate_value == NULL)
+    {
+      const GValue *computed = clutter_interval_compute (interval, progress);
+
+      if (computed != NULL)
+        clutter_animatable_set_final_state (animatable,
+                                            priv->property_name,
+                                            computed);
+
+      return;
+    }
+
   g_value_init (&value, i_type);
 
   res = clutter_animatable_interpolate_value (animatable,
@@ -238,6 +368,8 @@ clutter_property_transition_finalize (GObject *gobject)
 
   priv = CLUTTER_PROPERTY_TRANSITION (gobject)->priv;
 
+  clutter_property_transition_release_slot (CLUTTER_PROPERTY_TRANSITION (gobject));
+
   g_free (priv->property_name);
 
   G_OBJECT_CLASS (clutter_property_transition_parent_class)->finalize (gobject);
@@ -278,6 +410,7 @@ static void
 clutter_property_transition_init (ClutterPropertyTransition *self)
 {
   self->priv = clutter_property_transition_get_instance_private (self);
+  self->priv->table_slot = -1;
 }
 
 /**
@@ -326,12 +459,15 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
   priv->property_name = g_strdup (property_name);
   priv->pspec = NULL;
 
+  clutter_property_transition_release_slot (transition);
+
   animatable =
     clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
   if (animatable != NULL)
     {
       priv->pspec = clutter_animatable_find_property (animatable,
                                                       priv->property_name);
+      clutter_property_transition_ensure_slot (transition, animatable);
     }
 
   g_object_notify_by_pspec (G_OBJECT (transition),
@@ -358,3 +494,41 @@ clutter_property_transition_get_property_name (ClutterPropertyTransition *transi
 
   return transition->priv->property_name;
 }
+
+/*< private >
+ * _clutter_property_transition_set_table_func:
+ * @transition: a #ClutterPropertyTransition
+ * @func: (allow-none): the function writing the value of the property,
+ *   or %NULL
+ * @batch_func: (allow-none): the function bracketing the values written
+ *   at the end of each frame, or %NULL
+ *
+ * Makes @transition interpolate its property through the animation
+ * table of the master clock, writing the value with @func at the end
+ * of each frame instead of using clutter_animatable_set_final_state().
+ *
+ * The table is only used if the property has one of the value types
+ * the table supports, and the interval of @transition is a plain
+ * #ClutterInterval of the same type.
+ */
+void
+_clutter_property_transition_set_table_func (ClutterPropertyTransition      *transition,
+                                             ClutterAnimationTableFunc       func,
+                                             ClutterAnimationTableBatchFunc  batch_func)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+  ClutterAnimatable *animatable;
+
+  if (priv->table_func == func && priv->table_batch_func == batch_func)
+    return;
+
+  clutter_property_transition_release_slot (transition);
+
+  priv->table_func = func;
+  priv->table_batch_func = batch_func;
+
+  animatable =
+    clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
+  if (animatable != NULL)
+    clutter_property_transition_ensure_slot (transition, animatable);
+}
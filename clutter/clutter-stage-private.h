@@ -26,6 +26,7 @@
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
 #include <clutter/clutter-private.h>
+#include <clutter/clutter-offscreen-pool.h>
 
 #include <cogl/cogl.h>
 
@@ -60,6 +61,8 @@ void                _clutter_stage_maybe_setup_viewport  (ClutterStage
 void                _clutter_stage_maybe_relayout        (ClutterActor          *stage);
 gboolean            _clutter_stage_needs_update          (ClutterStage          *stage);
 gboolean            _clutter_stage_do_update             (ClutterStage          *stage);
+gboolean            _clutter_stage_paint_offscreen       (ClutterStage          *stage,
+                                                          CoglFramebuffer       *framebuffer);
 
 void     _clutter_stage_queue_event                       (ClutterStage *stage,
                                                            ClutterEvent *event,
@@ -90,12 +93,16 @@ void                          _clutter_stage_queue_redraw_entry_invalidate (Clut
 
 CoglFramebuffer *_clutter_stage_get_active_framebuffer (ClutterStage *stage);
 
+ClutterOffscreenPool *_clutter_stage_get_offscreen_pool (ClutterStage *stage);
+
 gint32          _clutter_stage_acquire_pick_id          (ClutterStage *stage,
                                                          ClutterActor *actor);
 void            _clutter_stage_release_pick_id          (ClutterStage *stage,
                                                          gint32        pick_id);
 ClutterActor *  _clutter_stage_get_actor_by_pick_id     (ClutterStage *stage,
                                                          gint32        pick_id);
+guint32         _clutter_stage_get_pick_serial          (ClutterStage *stage);
+void            _clutter_stage_invalidate_pick_caches   (ClutterStage *stage);
 
 void            _clutter_stage_add_pointer_drag_actor    (ClutterStage       *stage,
                                                           ClutterInputDevice *device,
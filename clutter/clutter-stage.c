@@ -69,6 +69,7 @@
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-master-clock.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
@@ -132,6 +133,14 @@ struct _ClutterStagePrivate
 
   CoglFramebuffer *active_framebuffer;
 
+  /* the framebuffer the stage is painted into, instead of its
+   * window, by _clutter_stage_paint_offscreen()
+   */
+  CoglFramebuffer *offscreen_framebuffer;
+
+  /* the render targets shared by the offscreen effects */
+  ClutterOffscreenPool *offscreen_pool;
+
   gint sync_delay;
 
   GTimer *fps_timer;
@@ -139,6 +148,13 @@ struct _ClutterStagePrivate
 
   ClutterIDPool *pick_id_pool;
 
+  /* bumped every time something that may change the result of a
+   * pick is queued; input devices use it to validate their cached
+   * pointer regions
+   */
+  guint32 pick_serial;
+  gint32 timer_n_picks;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
 #endif /* CLUTTER_ENABLE_DEBUG */
@@ -610,6 +626,12 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
    * offscreen framebuffer.
    */
 
+  if (priv->offscreen_framebuffer != NULL)
+    {
+      priv->active_framebuffer = priv->offscreen_framebuffer;
+      return;
+    }
+
   priv->active_framebuffer =
     _clutter_stage_window_get_active_framebuffer (priv->impl);
 
@@ -1129,6 +1151,9 @@ clutter_stage_do_redraw (ClutterStage *stage)
 
   _clutter_stage_window_redraw (priv->impl);
 
+  if (priv->offscreen_pool != NULL)
+    _clutter_offscreen_pool_end_frame (priv->offscreen_pool);
+
   if (_clutter_context_get_show_fps ())
     {
       priv->timer_n_frames += 1;
@@ -1138,8 +1163,26 @@ clutter_stage_do_redraw (ClutterStage *stage)
           g_print ("*** FPS for %s: %i ***\n",
                    _clutter_actor_get_debug_name (actor),
                    priv->timer_n_frames);
+          g_print ("*** Picks for %s: %i ***\n",
+                   _clutter_actor_get_debug_name (actor),
+                   priv->timer_n_picks);
+
+          if (priv->offscreen_pool != NULL)
+            {
+              ClutterOffscreenPoolStats stats;
+
+              _clutter_offscreen_pool_get_stats (priv->offscreen_pool, &stats);
+              g_print ("*** Offscreen targets for %s: %u (%" G_GSIZE_FORMAT " KiB), "
+                       "%u free (%" G_GSIZE_FORMAT " KiB); "
+                       "%u acquired, %u allocated, %u destroyed ***\n",
+                       _clutter_actor_get_debug_name (actor),
+                       stats.n_targets, stats.size / 1024,
+                       stats.n_free_targets, stats.free_size / 1024,
+                       stats.n_acquired, stats.n_allocated, stats.n_evicted);
+            }
 
           priv->timer_n_frames = 0;
+          priv->timer_n_picks = 0;
           g_timer_start (priv->fps_timer);
         }
     }
@@ -1201,6 +1244,64 @@ _clutter_stage_do_update (ClutterStage *stage)
   return TRUE;
 }
 
+/*< private >
+ * _clutter_stage_paint_offscreen:
+ * @stage: A #ClutterStage
+ * @framebuffer: the #CoglFramebuffer to paint into
+ *
+ * Paints @stage into @framebuffer, instead of its window, if a redraw
+ * is pending. The stage must have been laid out already.
+ *
+ * This is used by the master clocks that do not present the frames.
+ *
+ * Return value: %TRUE if the stage was painted
+ */
+gboolean
+_clutter_stage_paint_offscreen (ClutterStage    *stage,
+                                CoglFramebuffer *framebuffer)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  int window_scale;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage) || priv->impl == NULL)
+    return FALSE;
+
+  if (!priv->redraw_pending)
+    return FALSE;
+
+  clutter_stage_maybe_finish_queue_redraws (stage);
+
+  _clutter_backend_ensure_context (clutter_get_default_backend (), stage);
+
+  /* updates the projection of the stage */
+  _clutter_stage_maybe_setup_viewport (stage);
+
+  window_scale = _clutter_stage_window_get_scale_factor (priv->impl);
+
+  cogl_push_framebuffer (framebuffer);
+
+  cogl_framebuffer_set_viewport (framebuffer,
+                                 priv->viewport[0] * window_scale,
+                                 priv->viewport[1] * window_scale,
+                                 priv->viewport[2] * window_scale,
+                                 priv->viewport[3] * window_scale);
+  cogl_framebuffer_set_projection_matrix (framebuffer, &priv->projection);
+
+  priv->offscreen_framebuffer = framebuffer;
+  _clutter_stage_do_paint (stage, NULL);
+  priv->offscreen_framebuffer = NULL;
+
+  cogl_pop_framebuffer ();
+
+  if (priv->offscreen_pool != NULL)
+    _clutter_offscreen_pool_end_frame (priv->offscreen_pool);
+
+  /* reset the guard, so that new redraws are possible */
+  priv->redraw_pending = FALSE;
+
+  return TRUE;
+}
+
 static void
 clutter_stage_real_queue_relayout (ClutterActor *self)
 {
@@ -1214,6 +1315,8 @@ clutter_stage_real_queue_relayout (ClutterActor *self)
       priv->relayout_pending = TRUE;
     }
 
+  priv->pick_serial += 1;
+
   /* chain up */
   parent_class = CLUTTER_ACTOR_CLASS (clutter_stage_parent_class);
   parent_class->queue_relayout (self);
@@ -1430,6 +1533,8 @@ _clutter_stage_do_pick (ClutterStage   *stage,
 
   CLUTTER_NOTE (PICK, "Performing pick at %i,%i", x, y);
 
+  priv->timer_n_picks += 1;
+
   cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
   cogl_clear (&stage_pick_id, COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH);
 
@@ -1717,6 +1822,12 @@ clutter_stage_dispose (GObject *object)
 
   clutter_actor_destroy_all_children (CLUTTER_ACTOR (object));
 
+  if (priv->offscreen_pool != NULL)
+    {
+      _clutter_offscreen_pool_free (priv->offscreen_pool);
+      priv->offscreen_pool = NULL;
+    }
+
   g_list_free_full (priv->pending_queue_redraws,
                     (GDestroyNotify) free_queue_redraw_entry);
   priv->pending_queue_redraws = NULL;
@@ -1743,6 +1854,9 @@ clutter_stage_finalize (GObject *object)
 
   _clutter_id_pool_free (priv->pick_id_pool);
 
+  if (priv->offscreen_pool != NULL)
+    _clutter_offscreen_pool_free (priv->offscreen_pool);
+
   if (priv->fps_timer != NULL)
     g_timer_destroy (priv->fps_timer);
 
@@ -3950,6 +4064,11 @@ _clutter_stage_queue_actor_redraw (ClutterStage *stage,
   CLUTTER_NOTE (CLIPPING, "stage_queue_actor_redraw (actor=%s, clip=%p): ",
                 _clutter_actor_get_debug_name (actor), clip);
 
+  /* anything that queues a redraw may also change what is underneath
+   * the pointer, so we need to invalidate the pick caches
+   */
+  priv->pick_serial += 1;
+
   if (!priv->redraw_pending)
     {
       ClutterMasterClock *master_clock;
@@ -4198,6 +4317,38 @@ clutter_stage_get_motion_events_enabled (ClutterStage *stage)
   return stage->priv->motion_events_enabled;
 }
 
+/*< private >
+ * _clutter_stage_get_offscreen_pool:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the pool of the render targets shared by the offscreen
+ * effects painted on @stage.
+ *
+ * Return value: (transfer none): the pool of render targets, or %NULL
+ *   if @stage is being destroyed
+ */
+ClutterOffscreenPool *
+_clutter_stage_get_offscreen_pool (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return NULL;
+
+  if (priv->offscreen_pool == NULL)
+    {
+      ClutterMainContext *context = _clutter_context_get_default ();
+
+      priv->offscreen_pool = _clutter_offscreen_pool_new ();
+
+      if (context->offscreen_budget > 0)
+        _clutter_offscreen_pool_set_budget (priv->offscreen_pool,
+                                            context->offscreen_budget);
+    }
+
+  return priv->offscreen_pool;
+}
+
 /* NB: The presumption shouldn't be that a stage can't be comprised
  * of multiple internal framebuffers, so instead of simply naming
  * this function _clutter_stage_get_framebuffer(), the "active"
@@ -4232,6 +4383,36 @@ _clutter_stage_release_pick_id (ClutterStage *stage,
   _clutter_id_pool_remove (priv->pick_id_pool, pick_id);
 }
 
+/*< private >
+ * _clutter_stage_get_pick_serial:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves a serial number that changes every time the contents
+ * of @stage may have changed in a way that invalidates the results
+ * of a previous pick.
+ *
+ * Return value: the current pick serial
+ */
+guint32
+_clutter_stage_get_pick_serial (ClutterStage *stage)
+{
+  return stage->priv->pick_serial;
+}
+
+/*< private >
+ * _clutter_stage_invalidate_pick_caches:
+ * @stage: a #ClutterStage
+ *
+ * Invalidates the results of the previous picks on @stage, for changes
+ * that affect picking without queueing a redraw or a relayout, like
+ * the reactive state of an actor.
+ */
+void
+_clutter_stage_invalidate_pick_caches (ClutterStage *stage)
+{
+  stage->priv->pick_serial += 1;
+}
+
 ClutterActor *
 _clutter_stage_get_actor_by_pick_id (ClutterStage *stage,
                                      gint32        pick_id)
@@ -0,0 +1,36 @@
+/* clutter-text-buffer-private.h
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __CLUTTER_TEXT_BUFFER_PRIVATE_H__
+#define __CLUTTER_TEXT_BUFFER_PRIVATE_H__
+
+#include <clutter/clutter-text-buffer.h>
+
+G_BEGIN_DECLS
+
+gsize           _clutter_text_buffer_offset_to_bytes    (ClutterTextBuffer *buffer,
+                                                         gint               offset);
+gint            _clutter_text_buffer_bytes_to_offset    (ClutterTextBuffer *buffer,
+                                                         gsize              index_);
+const gchar *   _clutter_text_buffer_get_text_range     (ClutterTextBuffer *buffer,
+                                                         gsize              start_index,
+                                                         gsize              n_bytes);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_BUFFER_PRIVATE_H__ */
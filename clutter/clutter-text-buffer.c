@@ -23,7 +23,7 @@
 #include "config.h"
 #endif
 
-#include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 
@@ -52,6 +52,9 @@
 /* Initial size of buffer, in bytes */
 #define MIN_SIZE 16
 
+/* Number of characters between two entries of the offset index */
+#define INDEX_STRIDE 256
+
 enum {
   PROP_0,
   PROP_TEXT,
@@ -79,6 +82,30 @@ struct _ClutterTextBufferPrivate
   gsize  normal_text_size;
   gsize  normal_text_bytes;
   guint  normal_text_chars;
+
+  /* The text is stored as a gap buffer: the gap starts at this byte
+   * offset of the text, and it takes all the unused bytes of the
+   * storage, so that edits close to each other only move the text
+   * between them
+   */
+  gsize  normal_gap_start;
+
+  /* A contiguous copy of the text, built by get_text() when the gap
+   * is not at the end of the text, and freed by the next edit
+   */
+  gchar *normal_text_copy;
+
+  /* A contiguous copy of a range of the text split by the gap, built
+   * by _clutter_text_buffer_get_text_range(), and freed by the next
+   * edit or the next copy of a range
+   */
+  gchar *normal_range_copy;
+  gsize  normal_range_bytes;
+
+  /* The byte offset in the text of every INDEX_STRIDE-th character;
+   * the index is built lazily, and it is truncated by edits
+   */
+  GArray *normal_index;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterTextBuffer, clutter_text_buffer, G_TYPE_OBJECT)
@@ -101,15 +128,249 @@ trash_area (gchar *area,
     *varea++ = 0;
 }
 
+#define GAP_BYTES(pv)   ((pv)->normal_text_size - (pv)->normal_text_bytes)
+
+static void
+normal_clear_range_copy (ClutterTextBufferPrivate *pv)
+{
+  if (pv->normal_range_copy == NULL)
+    return;
+
+  trash_area (pv->normal_range_copy, pv->normal_range_bytes);
+  g_free (pv->normal_range_copy);
+  pv->normal_range_copy = NULL;
+  pv->normal_range_bytes = 0;
+}
+
+static void
+normal_clear_text_copy (ClutterTextBufferPrivate *pv)
+{
+  normal_clear_range_copy (pv);
+
+  if (pv->normal_text_copy == NULL)
+    return;
+
+  trash_area (pv->normal_text_copy, pv->normal_text_bytes);
+  g_free (pv->normal_text_copy);
+  pv->normal_text_copy = NULL;
+}
+
+/* Moves the gap to the byte offset @pos of the text */
+static void
+normal_move_gap (ClutterTextBufferPrivate *pv,
+                 gsize                     pos)
+{
+  gsize gap = GAP_BYTES (pv);
+  gsize lo, hi;
+
+  if (pos == pv->normal_gap_start)
+    return;
+
+  if (pos < pv->normal_gap_start)
+    {
+      gsize d = pv->normal_gap_start - pos;
+
+      g_memmove (pv->normal_text + pos + gap, pv->normal_text + pos, d);
+
+      lo = pos;
+      hi = pos + MIN (d, gap);
+    }
+  else
+    {
+      gsize d = pos - pv->normal_gap_start;
+      gsize gap_end = pv->normal_gap_start + gap;
+
+      g_memmove (pv->normal_text + pv->normal_gap_start,
+                 pv->normal_text + gap_end,
+                 d);
+
+      lo = MAX (gap_end, pos);
+      hi = MIN (gap_end + d, pos + gap);
+    }
+
+  /* Could be a password, so can't leave stuff in the gap. */
+  if (hi > lo)
+    trash_area (pv->normal_text + lo, hi - lo);
+
+  pv->normal_gap_start = pos;
+}
+
+/* Returns the byte offset of the text @n_chars characters after @pos */
+static gsize
+normal_skip_chars (ClutterTextBufferPrivate *pv,
+                   gsize                     pos,
+                   guint                     n_chars)
+{
+  const gchar *p, *end;
+
+  if (pos < pv->normal_gap_start)
+    {
+      end = pv->normal_text + pv->normal_gap_start;
+
+      for (p = pv->normal_text + pos; n_chars > 0 && p < end; n_chars--)
+        p = g_utf8_next_char (p);
+
+      pos = p - pv->normal_text;
+    }
+
+  if (n_chars > 0)
+    {
+      gsize gap = GAP_BYTES (pv);
+
+      end = pv->normal_text + pv->normal_text_size;
+
+      for (p = pv->normal_text + pos + gap; n_chars > 0 && p < end; n_chars--)
+        p = g_utf8_next_char (p);
+
+      pos = p - pv->normal_text - gap;
+    }
+
+  return pos;
+}
+
+/* Returns the number of characters between the byte offsets @pos and
+ * @end_pos of the text
+ */
+static guint
+normal_count_chars (ClutterTextBufferPrivate *pv,
+                    gsize                     pos,
+                    gsize                     end_pos)
+{
+  guint n_chars = 0;
+
+  if (pos < pv->normal_gap_start)
+    {
+      gsize end = MIN (end_pos, pv->normal_gap_start);
+
+      n_chars += g_utf8_strlen (pv->normal_text + pos, end - pos);
+      pos = end;
+    }
+
+  if (pos < end_pos)
+    n_chars += g_utf8_strlen (pv->normal_text + pos + GAP_BYTES (pv),
+                              end_pos - pos);
+
+  return n_chars;
+}
+
+/* Makes sure the offset index has an entry for the character @offset */
+static void
+normal_ensure_index (ClutterTextBufferPrivate *pv,
+                     guint                     offset)
+{
+  guint last = MIN (offset, pv->normal_text_chars) / INDEX_STRIDE;
+
+  if (pv->normal_index->len == 0)
+    {
+      gsize zero = 0;
+
+      g_array_append_val (pv->normal_index, zero);
+    }
+
+  while (pv->normal_index->len <= last)
+    {
+      gsize pos = g_array_index (pv->normal_index, gsize, pv->normal_index->len - 1);
+
+      pos = normal_skip_chars (pv, pos, INDEX_STRIDE);
+      g_array_append_val (pv->normal_index, pos);
+    }
+}
+
+/* Drops the entries of the index after the character @offset */
+static inline void
+normal_truncate_index (ClutterTextBufferPrivate *pv,
+                       guint                     offset)
+{
+  guint len = offset / INDEX_STRIDE + 1;
+
+  if (pv->normal_index->len > len)
+    g_array_set_size (pv->normal_index, len);
+}
+
+static gsize
+normal_offset_to_bytes (ClutterTextBufferPrivate *pv,
+                        guint                     offset)
+{
+  gsize pos;
+
+  if (offset >= pv->normal_text_chars)
+    return pv->normal_text_bytes;
+
+  normal_ensure_index (pv, offset);
+
+  pos = g_array_index (pv->normal_index, gsize, offset / INDEX_STRIDE);
+
+  return normal_skip_chars (pv, pos, offset % INDEX_STRIDE);
+}
+
+static guint
+normal_bytes_to_offset (ClutterTextBufferPrivate *pv,
+                        gsize                     index_)
+{
+  guint lo, hi;
+
+  if (index_ >= pv->normal_text_bytes)
+    return pv->normal_text_chars;
+
+  /* build the index until it covers @index_ */
+  normal_ensure_index (pv, 0);
+  while (pv->normal_index->len * INDEX_STRIDE <= pv->normal_text_chars &&
+         g_array_index (pv->normal_index, gsize, pv->normal_index->len - 1) < index_)
+    normal_ensure_index (pv, pv->normal_index->len * INDEX_STRIDE);
+
+  /* find the last entry at or before @index_ */
+  lo = 0;
+  hi = pv->normal_index->len;
+  while (hi - lo > 1)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (pv->normal_index, gsize, mid) <= index_)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo * INDEX_STRIDE +
+         normal_count_chars (pv, g_array_index (pv->normal_index, gsize, lo), index_);
+}
+
 static const gchar*
 clutter_text_buffer_normal_get_text (ClutterTextBuffer *buffer,
                                   gsize          *n_bytes)
 {
+  ClutterTextBufferPrivate *pv = buffer->priv;
+
   if (n_bytes)
-    *n_bytes = buffer->priv->normal_text_bytes;
-  if (!buffer->priv->normal_text)
+    *n_bytes = pv->normal_text_bytes;
+  if (!pv->normal_text)
       return "";
-  return buffer->priv->normal_text;
+
+  /* when the gap is at the end the text is already contiguous, and
+   * there's always room for the terminating zero, as the storage is
+   * never full; otherwise we don't move the gap, which would cost two
+   * moves of the text for each edit in the middle of it, and we copy
+   * the two halves of the text instead
+   */
+  if (pv->normal_gap_start == pv->normal_text_bytes)
+    {
+      pv->normal_text[pv->normal_text_bytes] = '\0';
+      return pv->normal_text;
+    }
+
+  if (pv->normal_text_copy == NULL)
+    {
+      gsize tail = pv->normal_text_bytes - pv->normal_gap_start;
+
+      pv->normal_text_copy = g_malloc (pv->normal_text_bytes + 1);
+      memcpy (pv->normal_text_copy, pv->normal_text, pv->normal_gap_start);
+      memcpy (pv->normal_text_copy + pv->normal_gap_start,
+              pv->normal_text + pv->normal_text_size - tail,
+              tail);
+      pv->normal_text_copy[pv->normal_text_bytes] = '\0';
+    }
+
+  return pv->normal_text_copy;
 }
 
 static guint
@@ -131,10 +392,13 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
 
   n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
 
+  normal_clear_text_copy (pv);
+
   /* Need more memory */
   if (n_bytes + pv->normal_text_bytes + 1 > pv->normal_text_size)
     {
       gchar *et_new;
+      gsize tail;
 
       prev_size = pv->normal_text_size;
 
@@ -161,23 +425,35 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
             }
         }
 
+      /* Keep the gap where it is, and the text after it at the end
+       * of the new storage
+       */
+      tail = pv->normal_text_bytes - pv->normal_gap_start;
+
       /* Could be a password, so can't leave stuff in memory. */
       et_new = g_malloc (pv->normal_text_size);
-      memcpy (et_new, pv->normal_text, MIN (prev_size, pv->normal_text_size));
+      if (pv->normal_text != NULL)
+        {
+          memcpy (et_new, pv->normal_text, pv->normal_gap_start);
+          memcpy (et_new + pv->normal_text_size - tail,
+                  pv->normal_text + prev_size - tail,
+                  tail);
+        }
       trash_area (pv->normal_text, prev_size);
       g_free (pv->normal_text);
       pv->normal_text = et_new;
     }
 
   /* Actual text insertion */
-  at = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-  g_memmove (pv->normal_text + at + n_bytes, pv->normal_text + at, pv->normal_text_bytes - at);
+  at = normal_offset_to_bytes (pv, position);
+  normal_move_gap (pv, at);
   memcpy (pv->normal_text + at, chars, n_bytes);
 
   /* Book keeping */
+  pv->normal_gap_start += n_bytes;
   pv->normal_text_bytes += n_bytes;
   pv->normal_text_chars += n_chars;
-  pv->normal_text[pv->normal_text_bytes] = '\0';
+  normal_truncate_index (pv, position);
 
   clutter_text_buffer_emit_inserted_text (buffer, position, chars, n_chars);
   return n_chars;
@@ -198,19 +474,23 @@ clutter_text_buffer_normal_delete_text (ClutterTextBuffer *buffer,
 
   if (n_chars > 0)
     {
-      start = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-      end = g_utf8_offset_to_pointer (pv->normal_text, position + n_chars) - pv->normal_text;
+      start = normal_offset_to_bytes (pv, position);
+      end = normal_skip_chars (pv, start, n_chars);
 
-      g_memmove (pv->normal_text + start, pv->normal_text + end, pv->normal_text_bytes + 1 - end);
-      pv->normal_text_chars -= n_chars;
-      pv->normal_text_bytes -= (end - start);
+      normal_clear_text_copy (pv);
+
+      /* the deleted text becomes part of the gap */
+      normal_move_gap (pv, start);
 
       /*
-       * Could be a password, make sure we don't leave anything sensitive after
-       * the terminating zero.  Note, that the terminating zero already trashed
-       * one byte.
+       * Could be a password, make sure we don't leave anything sensitive
+       * in the gap.
        */
-      trash_area (pv->normal_text + pv->normal_text_bytes + 1, end - start - 1);
+      trash_area (pv->normal_text + start + GAP_BYTES (pv), end - start);
+
+      pv->normal_text_chars -= n_chars;
+      pv->normal_text_bytes -= (end - start);
+      normal_truncate_index (pv, position);
 
       clutter_text_buffer_emit_deleted_text (buffer, position, n_chars);
     }
@@ -254,6 +534,10 @@ clutter_text_buffer_init (ClutterTextBuffer *self)
   self->priv->normal_text_chars = 0;
   self->priv->normal_text_bytes = 0;
   self->priv->normal_text_size = 0;
+  self->priv->normal_gap_start = 0;
+  self->priv->normal_text_copy = NULL;
+  self->priv->normal_range_copy = NULL;
+  self->priv->normal_index = g_array_new (FALSE, FALSE, sizeof (gsize));
 }
 
 static void
@@ -262,6 +546,8 @@ clutter_text_buffer_finalize (GObject *obj)
   ClutterTextBuffer *buffer = CLUTTER_TEXT_BUFFER (obj);
   ClutterTextBufferPrivate *pv = buffer->priv;
 
+  normal_clear_text_copy (pv);
+
   if (pv->normal_text)
     {
       trash_area (pv->normal_text, pv->normal_text_size);
@@ -269,8 +555,11 @@ clutter_text_buffer_finalize (GObject *obj)
       pv->normal_text = NULL;
       pv->normal_text_bytes = pv->normal_text_size = 0;
       pv->normal_text_chars = 0;
+      pv->normal_gap_start = 0;
     }
 
+  g_array_unref (pv->normal_index);
+
   G_OBJECT_CLASS (clutter_text_buffer_parent_class)->finalize (obj);
 }
 
@@ -511,6 +800,10 @@ clutter_text_buffer_get_bytes (ClutterTextBuffer *buffer)
   klass = CLUTTER_TEXT_BUFFER_GET_CLASS (buffer);
   g_return_val_if_fail (klass->get_text != NULL, 0);
 
+  /* the default buffer knows its size without joining its text */
+  if (klass->get_text == clutter_text_buffer_normal_get_text)
+    return buffer->priv->normal_text_bytes;
+
   (*klass->get_text) (buffer, &bytes);
   return bytes;
 }
@@ -764,3 +1057,143 @@ clutter_text_buffer_emit_deleted_text (ClutterTextBuffer *buffer,
   g_return_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer));
   g_signal_emit (buffer, signals[DELETED_TEXT], 0, position, n_chars);
 }
+
+static inline gboolean
+clutter_text_buffer_is_normal (ClutterTextBuffer *buffer)
+{
+  ClutterTextBufferClass *klass = CLUTTER_TEXT_BUFFER_GET_CLASS (buffer);
+
+  return klass->get_text == clutter_text_buffer_normal_get_text &&
+         klass->get_length == clutter_text_buffer_normal_get_length &&
+         klass->insert_text == clutter_text_buffer_normal_insert_text &&
+         klass->delete_text == clutter_text_buffer_normal_delete_text;
+}
+
+/*< private >
+ * _clutter_text_buffer_offset_to_bytes:
+ * @buffer: a #ClutterTextBuffer
+ * @offset: a character offset, or -1 for the end of the buffer
+ *
+ * Converts a character offset into a byte offset in the text returned
+ * by clutter_text_buffer_get_text().
+ *
+ * The default implementation of #ClutterTextBuffer keeps an index of
+ * the byte offsets, so that this does not need to scan the text from
+ * the start; derived classes go through the text.
+ *
+ * Return value: the byte offset
+ */
+gsize
+_clutter_text_buffer_offset_to_bytes (ClutterTextBuffer *buffer,
+                                      gint               offset)
+{
+  const gchar *text, *p;
+
+  g_return_val_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer), 0);
+
+  if (clutter_text_buffer_is_normal (buffer))
+    {
+      if (offset < 0)
+        return buffer->priv->normal_text_bytes;
+
+      return normal_offset_to_bytes (buffer->priv, offset);
+    }
+
+  text = clutter_text_buffer_get_text (buffer);
+  if (offset < 0)
+    return strlen (text);
+
+  for (p = text; *p && offset-- > 0; p = g_utf8_next_char (p));
+
+  return p - text;
+}
+
+/*< private >
+ * _clutter_text_buffer_bytes_to_offset:
+ * @buffer: a #ClutterTextBuffer
+ * @index_: a byte offset in the text returned by
+ *   clutter_text_buffer_get_text()
+ *
+ * Converts a byte offset into a character offset; this is the inverse
+ * of _clutter_text_buffer_offset_to_bytes().
+ *
+ * Return value: the character offset
+ */
+gint
+_clutter_text_buffer_bytes_to_offset (ClutterTextBuffer *buffer,
+                                      gsize              index_)
+{
+  const gchar *text;
+
+  g_return_val_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer), 0);
+
+  if (clutter_text_buffer_is_normal (buffer))
+    return normal_bytes_to_offset (buffer->priv, index_);
+
+  text = clutter_text_buffer_get_text (buffer);
+
+  return g_utf8_pointer_to_offset (text, text + index_);
+}
+
+/*< private >
+ * _clutter_text_buffer_get_text_range:
+ * @buffer: a #ClutterTextBuffer
+ * @start_index: the position of the range, in bytes
+ * @n_bytes: the length of the range, in bytes
+ *
+ * Retrieves a range of the contents of the buffer.
+ *
+ * The default implementation of #ClutterTextBuffer returns the range
+ * in place when it is on one side of the gap, and only copies the
+ * range otherwise, so that looking at the text around an edit does
+ * not join the whole text like clutter_text_buffer_get_text() does;
+ * derived classes return a pointer into their text.
+ *
+ * Return value: a pointer to @n_bytes bytes of text, which is not
+ *   nul-terminated; the pointer is valid until the buffer emits a
+ *   signal, or until the next call to this function
+ */
+const gchar *
+_clutter_text_buffer_get_text_range (ClutterTextBuffer *buffer,
+                                     gsize              start_index,
+                                     gsize              n_bytes)
+{
+  ClutterTextBufferPrivate *pv;
+  gsize end_index = start_index + n_bytes;
+  gsize head;
+
+  g_return_val_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer), NULL);
+
+  if (!clutter_text_buffer_is_normal (buffer))
+    return clutter_text_buffer_get_text (buffer) + start_index;
+
+  pv = buffer->priv;
+
+  g_return_val_if_fail (end_index <= pv->normal_text_bytes, NULL);
+
+  if (pv->normal_text == NULL)
+    return "";
+
+  if (end_index <= pv->normal_gap_start)
+    return pv->normal_text + start_index;
+
+  if (start_index >= pv->normal_gap_start)
+    return pv->normal_text + start_index + GAP_BYTES (pv);
+
+  /* the whole text has already been joined since the last edit */
+  if (pv->normal_text_copy != NULL)
+    return pv->normal_text_copy + start_index;
+
+  normal_clear_range_copy (pv);
+
+  head = pv->normal_gap_start - start_index;
+
+  pv->normal_range_copy = g_malloc (n_bytes);
+  pv->normal_range_bytes = n_bytes;
+  memcpy (pv->normal_range_copy, pv->normal_text + start_index, head);
+  memcpy (pv->normal_range_copy + head,
+          pv->normal_text + pv->normal_gap_start + GAP_BYTES (pv),
+          n_bytes - head);
+
+  return pv->normal_range_copy;
+}
@@ -0,0 +1,419 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextLayoutCache: process-wide cache of the PangoLayouts of
+ * non-editable ClutterText actors.
+ *
+ * Lists and tables tend to contain many labels showing the same text
+ * with the same font at the same width; instead of having each one of
+ * them shape the text and build the glyph geometry on its own, the
+ * layouts are shared through this cache, keyed on everything that
+ * affects the result of laying out the text.
+ *
+ * Layouts in the cache are shared, so they must never be modified:
+ * a ClutterText whose contents change gets a new layout instead of
+ * updating the shared one in place. The cache is bounded by an
+ * estimate of the memory used by the layouts, and evicts the least
+ * recently used ones when it goes over budget; evicting a layout only
+ * drops the reference held by the cache, so the actors using it are
+ * not affected.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-text-layout-cache.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+
+/* a rough estimate of the memory used by a shaped and cached layout
+ * for each byte of text: the glyph strings, the log attributes, and
+ * the vertices of the display list built by CoglPango
+ */
+#define LAYOUT_BYTES_PER_CHAR   64
+#define LAYOUT_BASE_SIZE        1024
+
+#define DEFAULT_MAX_SIZE        (4 * 1024 * 1024)
+
+/* the key is the first member, so that entries can be used as keys
+ * of the hash table
+ */
+typedef struct
+{
+  /* the key points into the layout, except for the attributes, which
+   * are copied since the actor that created the layout may modify its
+   * own list in place, and for the base direction, which is a property
+   * of the PangoContext of the actor that created the layout, and may
+   * change after the layout has been created
+   */
+  ClutterTextLayoutKey key;
+
+  PangoLayout *layout;
+  gsize size;
+
+  GList link;
+} CacheEntry;
+
+typedef struct
+{
+  GHashTable *entries;
+
+  /* most recently used first */
+  GQueue lru;
+
+  gsize size;
+  gsize max_size;
+} LayoutCache;
+
+static LayoutCache *layout_cache = NULL;
+
+static GQuark quark_shared_layout = 0;
+
+static guint
+layout_key_hash (gconstpointer data)
+{
+  const ClutterTextLayoutKey *key = data;
+  guint hash;
+
+  hash = g_str_hash (key->text);
+
+  if (key->font_desc != NULL)
+    hash ^= pango_font_description_hash (key->font_desc);
+
+  hash = hash * 31 + key->width;
+  hash = hash * 31 + key->height;
+  hash = hash * 31 + (key->ellipsize | (key->wrap << 3) | (key->alignment << 5)
+                      | (key->justify << 7) | (key->single_paragraph << 8)
+                      | (key->base_dir << 9));
+
+  return hash;
+}
+
+static gboolean
+attributes_equal (PangoAttribute *attr,
+                  GSList         *attrs)
+{
+  for (; attrs != NULL; attrs = attrs->next)
+    {
+      if (pango_attribute_equal (attr, attrs->data))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* PangoAttrList has no equality function, so we walk both lists and
+ * compare the attributes applying to each range of the text
+ */
+static gboolean
+attr_list_equal (PangoAttrList *a,
+                 PangoAttrList *b)
+{
+  PangoAttrIterator *iter_a, *iter_b;
+  gboolean res = TRUE;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  iter_a = pango_attr_list_get_iterator (a);
+  iter_b = pango_attr_list_get_iterator (b);
+
+  while (res)
+    {
+      gint start_a, end_a, start_b, end_b;
+      GSList *attrs_a, *attrs_b, *l;
+      gboolean has_next_a, has_next_b;
+
+      pango_attr_iterator_range (iter_a, &start_a, &end_a);
+      pango_attr_iterator_range (iter_b, &start_b, &end_b);
+
+      if (start_a != start_b || end_a != end_b)
+        {
+          res = FALSE;
+          break;
+        }
+
+      attrs_a = pango_attr_iterator_get_attrs (iter_a);
+      attrs_b = pango_attr_iterator_get_attrs (iter_b);
+
+      if (g_slist_length (attrs_a) != g_slist_length (attrs_b))
+        res = FALSE;
+
+      for (l = attrs_a; res && l != NULL; l = l->next)
+        res = attributes_equal (l->data, attrs_b);
+
+      g_slist_free_full (attrs_a, (GDestroyNotify) pango_attribute_destroy);
+      g_slist_free_full (attrs_b, (GDestroyNotify) pango_attribute_destroy);
+
+      has_next_a = pango_attr_iterator_next (iter_a);
+      has_next_b = pango_attr_iterator_next (iter_b);
+
+      if (has_next_a != has_next_b)
+        res = FALSE;
+
+      if (!has_next_a)
+        break;
+    }
+
+  pango_attr_iterator_destroy (iter_a);
+  pango_attr_iterator_destroy (iter_b);
+
+  return res;
+}
+
+static gboolean
+layout_key_equal (gconstpointer data_a,
+                  gconstpointer data_b)
+{
+  const ClutterTextLayoutKey *a = data_a;
+  const ClutterTextLayoutKey *b = data_b;
+
+  if (a->width != b->width ||
+      a->height != b->height ||
+      a->ellipsize != b->ellipsize ||
+      a->wrap != b->wrap ||
+      a->alignment != b->alignment ||
+      !a->justify != !b->justify ||
+      !a->single_paragraph != !b->single_paragraph ||
+      a->base_dir != b->base_dir)
+    return FALSE;
+
+  if (strcmp (a->text, b->text) != 0)
+    return FALSE;
+
+  if (a->font_desc != b->font_desc &&
+      (a->font_desc == NULL || b->font_desc == NULL ||
+       !pango_font_description_equal (a->font_desc, b->font_desc)))
+    return FALSE;
+
+  return attr_list_equal (a->attrs, b->attrs);
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_object_unref (entry->layout);
+
+  if (entry->key.attrs != NULL)
+    pango_attr_list_unref (entry->key.attrs);
+
+  g_slice_free (CacheEntry, entry);
+}
+
+static void
+layout_cache_remove (LayoutCache *cache,
+                     CacheEntry  *entry)
+{
+  g_queue_unlink (&cache->lru, &entry->link);
+  cache->size -= entry->size;
+
+  g_hash_table_remove (cache->entries, &entry->key);
+}
+
+static void
+layout_cache_trim (LayoutCache *cache,
+                   gsize        max_size)
+{
+  while (cache->size > max_size && cache->lru.tail != NULL)
+    {
+      CLUTTER_NOTE (ACTOR, "Evicting shared layout '%.20s' (cache: %" G_GSIZE_FORMAT " bytes)",
+                    ((CacheEntry *) cache->lru.tail->data)->key.text,
+                    cache->size);
+
+      layout_cache_remove (cache, cache->lru.tail->data);
+    }
+}
+
+static void
+on_font_changed (ClutterBackend *backend)
+{
+  /* the font options and the resolution are shared by the PangoContext
+   * of every actor, and the cached layouts do not know about them
+   */
+  _clutter_text_layout_cache_clear ();
+}
+
+static LayoutCache *
+layout_cache_get_default (void)
+{
+  ClutterBackend *backend;
+
+  if (G_LIKELY (layout_cache != NULL))
+    return layout_cache;
+
+  layout_cache = g_new0 (LayoutCache, 1);
+  layout_cache->entries = g_hash_table_new_full (layout_key_hash,
+                                                 layout_key_equal,
+                                                 NULL,
+                                                 cache_entry_free);
+  g_queue_init (&layout_cache->lru);
+  layout_cache->max_size = DEFAULT_MAX_SIZE;
+
+  quark_shared_layout = g_quark_from_static_string ("clutter-text-shared-layout");
+
+  backend = clutter_get_default_backend ();
+  g_signal_connect (backend, "font-changed",
+                    G_CALLBACK (on_font_changed),
+                    NULL);
+  g_signal_connect (backend, "resolution-changed",
+                    G_CALLBACK (on_font_changed),
+                    NULL);
+
+  return layout_cache;
+}
+
+/*< private >
+ * _clutter_text_layout_cache_lookup:
+ * @key: the description of the layout
+ *
+ * Looks up a shared layout matching @key.
+ *
+ * Return value: (transfer full): a reference on the shared layout, or
+ *   %NULL if no layout matches @key; the returned layout must not be
+ *   modified
+ */
+PangoLayout *
+_clutter_text_layout_cache_lookup (const ClutterTextLayoutKey *key)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+  CacheEntry *entry;
+
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry == NULL)
+    return NULL;
+
+  /* move the entry to the front of the LRU list */
+  g_queue_unlink (&cache->lru, &entry->link);
+  g_queue_push_head_link (&cache->lru, &entry->link);
+
+  return g_object_ref (entry->layout);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_insert:
+ * @layout: a #PangoLayout
+ * @base_dir: the base direction used to lay out @layout
+ *
+ * Adds @layout to the cache, and marks it as shared; the layout must
+ * not be modified after this call. Layouts that are too large compared
+ * to the size of the cache are not added.
+ */
+void
+_clutter_text_layout_cache_insert (PangoLayout    *layout,
+                                   PangoDirection  base_dir)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+  CacheEntry *entry, *old_entry;
+  const gchar *text;
+  gsize size;
+
+  text = pango_layout_get_text (layout);
+  size = LAYOUT_BASE_SIZE + strlen (text) * LAYOUT_BYTES_PER_CHAR;
+
+  /* a single large text would evict everything else */
+  if (size > cache->max_size / 8)
+    return;
+
+  entry = g_slice_new0 (CacheEntry);
+  entry->layout = g_object_ref (layout);
+  entry->size = size;
+  entry->link.data = entry;
+
+  entry->key.text = text;
+  entry->key.attrs = pango_layout_get_attributes (layout);
+  if (entry->key.attrs != NULL)
+    entry->key.attrs = pango_attr_list_copy (entry->key.attrs);
+  entry->key.font_desc = pango_layout_get_font_description (layout);
+  entry->key.base_dir = base_dir;
+  entry->key.width = pango_layout_get_width (layout);
+  entry->key.height = pango_layout_get_height (layout);
+  entry->key.ellipsize = pango_layout_get_ellipsize (layout);
+  entry->key.wrap = pango_layout_get_wrap (layout);
+  entry->key.alignment = pango_layout_get_alignment (layout);
+  entry->key.justify = pango_layout_get_justify (layout);
+  entry->key.single_paragraph = pango_layout_get_single_paragraph_mode (layout);
+
+  g_object_set_qdata (G_OBJECT (layout), quark_shared_layout, GINT_TO_POINTER (TRUE));
+
+  /* this replaces any existing entry for the same key */
+  old_entry = g_hash_table_lookup (cache->entries, &entry->key);
+  if (old_entry != NULL)
+    layout_cache_remove (cache, old_entry);
+
+  g_hash_table_add (cache->entries, entry);
+  g_queue_push_head_link (&cache->lru, &entry->link);
+  cache->size += size;
+
+  layout_cache_trim (cache, cache->max_size);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_is_shared:
+ * @layout: a #PangoLayout
+ *
+ * Checks whether @layout has been handed out by the cache; shared
+ * layouts must not be modified, even after they have been evicted,
+ * as other actors may still be using them.
+ *
+ * Return value: %TRUE if @layout is shared
+ */
+gboolean
+_clutter_text_layout_cache_is_shared (PangoLayout *layout)
+{
+  if (quark_shared_layout == 0)
+    return FALSE;
+
+  return g_object_get_qdata (G_OBJECT (layout), quark_shared_layout) != NULL;
+}
+
+void
+_clutter_text_layout_cache_clear (void)
+{
+  if (layout_cache == NULL)
+    return;
+
+  layout_cache_trim (layout_cache, 0);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_set_max_size:
+ * @max_size: the maximum size of the cache, in bytes
+ *
+ * Sets the memory budget of the cache; the size of each layout is an
+ * estimate based on the length of its text. Setting a maximum size of
+ * 0 disables the cache.
+ */
+void
+_clutter_text_layout_cache_set_max_size (gsize max_size)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+
+  cache->max_size = max_size;
+
+  layout_cache_trim (cache, max_size);
+}
@@ -0,0 +1,60 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextLayoutCache: process-wide cache of the PangoLayouts of
+ * non-editable ClutterText actors.
+ */
+
+#ifndef __CLUTTER_TEXT_LAYOUT_CACHE_H__
+#define __CLUTTER_TEXT_LAYOUT_CACHE_H__
+
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTextLayoutKey    ClutterTextLayoutKey;
+
+/* everything that affects the result of laying out a ClutterText */
+struct _ClutterTextLayoutKey
+{
+  const gchar *text;
+  PangoAttrList *attrs;
+  const PangoFontDescription *font_desc;
+  PangoDirection base_dir;
+
+  gint width;
+  gint height;
+
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap;
+  PangoAlignment alignment;
+  gboolean justify;
+  gboolean single_paragraph;
+};
+
+PangoLayout *   _clutter_text_layout_cache_lookup       (const ClutterTextLayoutKey *key);
+void            _clutter_text_layout_cache_insert       (PangoLayout                *layout,
+                                                         PangoDirection              base_dir);
+gboolean        _clutter_text_layout_cache_is_shared    (PangoLayout                *layout);
+void            _clutter_text_layout_cache_clear        (void);
+
+void            _clutter_text_layout_cache_set_max_size (gsize                       max_size);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_LAYOUT_CACHE_H__ */
@@ -0,0 +1,873 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextParagraphs: index of the paragraphs of a large text, laid
+ * out one paragraph at a time.
+ *
+ * A single PangoLayout for a text of a few megabytes keeps the shaped
+ * glyphs of every line around, as well as the vertices CoglPango builds
+ * for them. Instead, the text is split into paragraphs, each laid out
+ * by its own PangoLayout, and only the layouts of the paragraphs close
+ * to what is being painted are kept.
+ *
+ * The height of a paragraph is estimated from the font metrics until
+ * its layout has been created once; after that, the measured height is
+ * remembered even if the layout itself is released. The vertical
+ * position of each paragraph is the sum of the heights of the ones
+ * before it; since measuring a paragraph moves all the following ones,
+ * the heights are kept in a Fenwick tree, so that both updating the
+ * height of a paragraph and finding the position of one take a
+ * logarithmic time.
+ *
+ * Editing the text only splits again the paragraphs that contain the
+ * edit; the paragraphs after it keep their layouts and heights, and
+ * only their start is moved.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-text-paragraphs.h"
+#include "clutter-text-buffer-private.h"
+
+/* the number of paragraphs before and after the painted ones whose
+ * layouts are kept around, so that scrolling by small amounts does
+ * not need to lay out the text again
+ */
+#define KEEP_PARAGRAPHS         16
+
+struct _ClutterTextParagraphs
+{
+  /* array of ClutterTextParagraph */
+  GArray *paragraphs;
+
+  /* the paragraphs that currently have a layout */
+  GArray *live;
+
+  ClutterTextParagraphFunc func;
+  gpointer user_data;
+
+  /* the font metrics used to estimate the size of the paragraphs
+   * that were not laid out yet
+   */
+  gint line_height;
+  gint char_width;
+
+  gint width;
+  gboolean wrap;
+
+  gint64 height;
+
+  /* the width of the widest paragraphs, and how many of them there
+   * are; when the last of them gets narrower, the width is computed
+   * again the next time it is needed
+   */
+  gint max_width;
+  guint n_widest;
+  gboolean max_width_valid;
+
+  /* the Fenwick tree of the heights of the paragraphs; the node at
+   * position i, starting from 1, holds the sum of the heights of the
+   * (i & -i) paragraphs ending with the paragraph i - 1
+   */
+  gint64 *heights;
+};
+
+static inline ClutterTextParagraph *
+get_paragraph (ClutterTextParagraphs *paragraphs,
+               guint                  paragraph)
+{
+  return &g_array_index (paragraphs->paragraphs, ClutterTextParagraph, paragraph);
+}
+
+static gint
+estimate_height (const ClutterTextParagraphs *paragraphs,
+                 const ClutterTextParagraph  *paragraph,
+                 gint                         width,
+                 gboolean                     wrap)
+{
+  gint64 n_lines = 1;
+
+  if (wrap && width > 0 && paragraph->n_chars > 0)
+    {
+      gint64 text_width = (gint64) paragraph->n_chars * paragraphs->char_width;
+
+      n_lines = MAX (1, (text_width + width - 1) / width);
+    }
+
+  return MIN (n_lines * paragraphs->line_height, G_MAXINT);
+}
+
+static gint
+estimate_width (const ClutterTextParagraphs *paragraphs,
+                const ClutterTextParagraph  *paragraph)
+{
+  return MIN ((gint64) paragraph->n_chars * paragraphs->char_width, G_MAXINT);
+}
+
+static void
+release_layouts (ClutterTextParagraphs *paragraphs)
+{
+  guint i;
+
+  for (i = 0; i < paragraphs->live->len; i++)
+    {
+      guint paragraph = g_array_index (paragraphs->live, guint, i);
+
+      g_clear_object (&get_paragraph (paragraphs, paragraph)->layout);
+    }
+
+  g_array_set_size (paragraphs->live, 0);
+}
+
+static void
+heights_build (ClutterTextParagraphs *paragraphs)
+{
+  guint n = paragraphs->paragraphs->len;
+  guint i;
+
+  for (i = 1; i <= n; i++)
+    paragraphs->heights[i] = get_paragraph (paragraphs, i - 1)->height;
+
+  for (i = 1; i <= n; i++)
+    {
+      guint parent = i + (i & -i);
+
+      if (parent <= n)
+        paragraphs->heights[parent] += paragraphs->heights[i];
+    }
+}
+
+static void
+heights_add (ClutterTextParagraphs *paragraphs,
+             guint                  paragraph,
+             gint64                 delta)
+{
+  guint n = paragraphs->paragraphs->len;
+  guint i;
+
+  for (i = paragraph + 1; i <= n; i += i & -i)
+    paragraphs->heights[i] += delta;
+}
+
+/* the sum of the heights of the paragraphs before @paragraph */
+static gint64
+heights_sum (ClutterTextParagraphs *paragraphs,
+             guint                  paragraph)
+{
+  gint64 sum = 0;
+  guint i;
+
+  for (i = paragraph; i > 0; i -= i & -i)
+    sum += paragraphs->heights[i];
+
+  return sum;
+}
+
+static void
+update_max_width (ClutterTextParagraphs *paragraphs)
+{
+  guint i;
+
+  paragraphs->max_width = 0;
+  paragraphs->n_widest = 0;
+
+  for (i = 0; i < paragraphs->paragraphs->len; i++)
+    {
+      gint width = get_paragraph (paragraphs, i)->width;
+
+      if (width > paragraphs->max_width)
+        {
+          paragraphs->max_width = width;
+          paragraphs->n_widest = 1;
+        }
+      else if (width == paragraphs->max_width)
+        paragraphs->n_widest += 1;
+    }
+
+  paragraphs->max_width_valid = TRUE;
+}
+
+static void
+set_paragraph_width (ClutterTextParagraphs *paragraphs,
+                     ClutterTextParagraph  *p,
+                     gint                   width)
+{
+  if (width == p->width)
+    return;
+
+  if (paragraphs->max_width_valid)
+    {
+      if (width > paragraphs->max_width)
+        {
+          paragraphs->max_width = width;
+          paragraphs->n_widest = 1;
+        }
+      else if (width == paragraphs->max_width)
+        paragraphs->n_widest += 1;
+      else if (p->width == paragraphs->max_width)
+        {
+          paragraphs->n_widest -= 1;
+          paragraphs->max_width_valid = paragraphs->n_widest > 0;
+        }
+    }
+
+  p->width = width;
+}
+
+/* splits the text between @start and @end into paragraphs, appended
+ * to @array; @text points to the text at @start, and it ends a paragraph
+ * at @end, so the last paragraph never includes a separator
+ */
+static void
+split_paragraphs (ClutterTextParagraphs *paragraphs,
+                  GArray                *array,
+                  const gchar           *text,
+                  gsize                  start,
+                  gsize                  end,
+                  gint                   offset)
+{
+  const gchar *p = text;
+  const gchar *text_end = text + (end - start);
+
+  /* a text ending with a separator has an empty paragraph at the
+   * end, just like a PangoLayout has an empty line
+   */
+  while (TRUE)
+    {
+      ClutterTextParagraph paragraph = { 0, };
+      const gchar *sep;
+
+      sep = memchr (p, '\n', text_end - p);
+      if (sep == NULL)
+        sep = text_end;
+
+      paragraph.start_index = start + (p - text);
+      paragraph.start_offset = offset;
+      paragraph.n_bytes = sep - p;
+      paragraph.n_chars = g_utf8_strlen (p, sep - p);
+      paragraph.height = estimate_height (paragraphs, &paragraph,
+                                          paragraphs->width,
+                                          paragraphs->wrap);
+      paragraph.width = estimate_width (paragraphs, &paragraph);
+
+      g_array_append_val (array, paragraph);
+
+      if (sep == text_end)
+        break;
+
+      offset += paragraph.n_chars + 1;
+      p = sep + 1;
+    }
+}
+
+/* replaces the paragraphs between @first and @last, included, with the
+ * paragraphs of the text of @buffer between @start and @end; only that
+ * range of the text is looked at, so that the buffer does not need to
+ * join the whole text after each edit. Then moves the following
+ * paragraphs by @delta_bytes and @delta_chars; the layouts of the other
+ * paragraphs are kept
+ */
+static void
+replace_paragraphs (ClutterTextParagraphs *paragraphs,
+                    ClutterTextBuffer     *buffer,
+                    guint                  first,
+                    guint                  last,
+                    gsize                  start,
+                    gsize                  end,
+                    gssize                 delta_bytes,
+                    gint                   delta_chars)
+{
+  const gchar *text;
+  GArray *added;
+  guint n_removed, i, n_live = 0;
+  gint shift;
+
+  text = _clutter_text_buffer_get_text_range (buffer, start, end - start);
+
+  added = g_array_new (FALSE, TRUE, sizeof (ClutterTextParagraph));
+  split_paragraphs (paragraphs, added, text, start, end,
+                    get_paragraph (paragraphs, first)->start_offset);
+
+  n_removed = last - first + 1;
+  shift = (gint) added->len - (gint) n_removed;
+
+  for (i = 0; i < paragraphs->live->len; i++)
+    {
+      guint paragraph = g_array_index (paragraphs->live, guint, i);
+
+      if (paragraph < first)
+        g_array_index (paragraphs->live, guint, n_live++) = paragraph;
+      else if (paragraph > last)
+        g_array_index (paragraphs->live, guint, n_live++) = paragraph + shift;
+      else
+        g_clear_object (&get_paragraph (paragraphs, paragraph)->layout);
+    }
+
+  g_array_set_size (paragraphs->live, n_live);
+
+  for (i = first; i <= last; i++)
+    {
+      ClutterTextParagraph *p = get_paragraph (paragraphs, i);
+
+      paragraphs->height -= p->height;
+
+      if (paragraphs->max_width_valid && p->width == paragraphs->max_width)
+        {
+          paragraphs->n_widest -= 1;
+          paragraphs->max_width_valid = paragraphs->n_widest > 0;
+        }
+    }
+
+  for (i = 0; i < added->len; i++)
+    {
+      const ClutterTextParagraph *p = &g_array_index (added, ClutterTextParagraph, i);
+
+      paragraphs->height += p->height;
+
+      if (paragraphs->max_width_valid)
+        {
+          if (p->width > paragraphs->max_width)
+            {
+              paragraphs->max_width = p->width;
+              paragraphs->n_widest = 1;
+            }
+          else if (p->width == paragraphs->max_width)
+            paragraphs->n_widest += 1;
+        }
+
+      /* the tree keeps its shape if the number of paragraphs does not
+       * change, so only the heights that changed are updated
+       */
+      if (shift == 0)
+        heights_add (paragraphs, first + i,
+                     (gint64) p->height - get_paragraph (paragraphs, first + i)->height);
+    }
+
+  g_array_remove_range (paragraphs->paragraphs, first, n_removed);
+  g_array_insert_vals (paragraphs->paragraphs, first, added->data, added->len);
+
+  for (i = first + added->len; i < paragraphs->paragraphs->len; i++)
+    {
+      ClutterTextParagraph *p = get_paragraph (paragraphs, i);
+
+      p->start_index += delta_bytes;
+      p->start_offset += delta_chars;
+    }
+
+  if (shift != 0)
+    {
+      paragraphs->heights = g_renew (gint64, paragraphs->heights,
+                                     paragraphs->paragraphs->len + 1);
+      heights_build (paragraphs);
+    }
+
+  g_array_unref (added);
+}
+
+/*< private >
+ * _clutter_text_paragraphs_new:
+ * @text: the text to split
+ * @n_bytes: the length of @text, in bytes
+ * @line_height: the estimated height of a line, in Pango units
+ * @char_width: the estimated width of a character, in Pango units
+ * @func: the function creating the layout of a paragraph
+ * @user_data: data for @func
+ *
+ * Splits @text into paragraphs; @text is not copied, and the layouts
+ * are created on demand by @func from the position of each paragraph.
+ *
+ * Return value: the newly created index
+ */
+ClutterTextParagraphs *
+_clutter_text_paragraphs_new (const gchar              *text,
+                              gsize                     n_bytes,
+                              gint                      line_height,
+                              gint                      char_width,
+                              ClutterTextParagraphFunc  func,
+                              gpointer                  user_data)
+{
+  ClutterTextParagraphs *paragraphs;
+  guint i;
+
+  paragraphs = g_slice_new0 (ClutterTextParagraphs);
+  paragraphs->paragraphs = g_array_new (FALSE, TRUE, sizeof (ClutterTextParagraph));
+  paragraphs->live = g_array_new (FALSE, FALSE, sizeof (guint));
+  paragraphs->func = func;
+  paragraphs->user_data = user_data;
+  paragraphs->line_height = MAX (line_height, 1);
+  paragraphs->char_width = MAX (char_width, 1);
+  paragraphs->width = -1;
+
+  split_paragraphs (paragraphs, paragraphs->paragraphs, text, 0, n_bytes, 0);
+
+  for (i = 0; i < paragraphs->paragraphs->len; i++)
+    paragraphs->height += get_paragraph (paragraphs, i)->height;
+
+  paragraphs->heights = g_new0 (gint64, paragraphs->paragraphs->len + 1);
+  heights_build (paragraphs);
+
+  update_max_width (paragraphs);
+
+  return paragraphs;
+}
+
+void
+_clutter_text_paragraphs_free (ClutterTextParagraphs *paragraphs)
+{
+  if (paragraphs == NULL)
+    return;
+
+  release_layouts (paragraphs);
+
+  g_array_unref (paragraphs->paragraphs);
+  g_array_unref (paragraphs->live);
+  g_free (paragraphs->heights);
+
+  g_slice_free (ClutterTextParagraphs, paragraphs);
+}
+
+static gsize
+get_n_bytes (ClutterTextParagraphs *paragraphs)
+{
+  const ClutterTextParagraph *last;
+
+  last = get_paragraph (paragraphs, paragraphs->paragraphs->len - 1);
+
+  return last->start_index + last->n_bytes;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get_length:
+ * @paragraphs: a #ClutterTextParagraphs
+ *
+ * Retrieves the length of the text split by @paragraphs.
+ *
+ * Return value: the length of the text, in characters
+ */
+gint
+_clutter_text_paragraphs_get_length (ClutterTextParagraphs *paragraphs)
+{
+  const ClutterTextParagraph *last;
+
+  last = get_paragraph (paragraphs, paragraphs->paragraphs->len - 1);
+
+  return last->start_offset + last->n_chars;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_insert_text:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @buffer: the buffer holding the text, after the insertion
+ * @offset: the position of the inserted text, in characters
+ * @n_chars: the length of the inserted text, in characters
+ *
+ * Updates @paragraphs after some text was inserted. Only the paragraph
+ * containing @offset is split again, and only its layout is released;
+ * the following paragraphs are moved, and keep their layouts.
+ */
+void
+_clutter_text_paragraphs_insert_text (ClutterTextParagraphs *paragraphs,
+                                      ClutterTextBuffer     *buffer,
+                                      gint                   offset,
+                                      gint                   n_chars)
+{
+  const ClutterTextParagraph *p;
+  gsize n_bytes = clutter_text_buffer_get_bytes (buffer);
+  gssize delta_bytes;
+  guint i;
+
+  g_return_if_fail (n_bytes >= get_n_bytes (paragraphs));
+
+  delta_bytes = n_bytes - get_n_bytes (paragraphs);
+
+  i = _clutter_text_paragraphs_find_offset (paragraphs, offset);
+  p = get_paragraph (paragraphs, i);
+
+  replace_paragraphs (paragraphs, buffer, i, i,
+                      p->start_index,
+                      p->start_index + p->n_bytes + delta_bytes,
+                      delta_bytes,
+                      n_chars);
+}
+
+/*< private >
+ * _clutter_text_paragraphs_delete_text:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @buffer: the buffer holding the text, after the deletion
+ * @offset: the position of the deleted text, in characters
+ * @n_chars: the length of the deleted text, in characters
+ *
+ * Updates @paragraphs after some text was deleted. The paragraphs the
+ * deleted text spanned are merged, and only their layouts are released.
+ */
+void
+_clutter_text_paragraphs_delete_text (ClutterTextParagraphs *paragraphs,
+                                      ClutterTextBuffer     *buffer,
+                                      gint                   offset,
+                                      gint                   n_chars)
+{
+  const ClutterTextParagraph *p;
+  gsize n_bytes = clutter_text_buffer_get_bytes (buffer);
+  gssize delta_bytes;
+  guint first, last;
+
+  g_return_if_fail (n_bytes <= get_n_bytes (paragraphs));
+
+  delta_bytes = (gssize) n_bytes - (gssize) get_n_bytes (paragraphs);
+
+  first = _clutter_text_paragraphs_find_offset (paragraphs, offset);
+  last = _clutter_text_paragraphs_find_offset (paragraphs, offset + n_chars);
+  p = get_paragraph (paragraphs, last);
+
+  replace_paragraphs (paragraphs, buffer, first, last,
+                      get_paragraph (paragraphs, first)->start_index,
+                      p->start_index + p->n_bytes + delta_bytes,
+                      delta_bytes,
+                      -n_chars);
+}
+
+/*< private >
+ * _clutter_text_paragraphs_set_width:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @width: the width of the layouts, in Pango units, or -1
+ * @wrap: whether the paragraphs are wrapped at @width
+ *
+ * Sets the width of the layouts of the paragraphs. If the width
+ * changes, the existing layouts are released; if the paragraphs are
+ * wrapped, their heights are estimated again as well.
+ */
+void
+_clutter_text_paragraphs_set_width (ClutterTextParagraphs *paragraphs,
+                                    gint                   width,
+                                    gboolean               wrap)
+{
+  guint i;
+
+  if (paragraphs->width == width && paragraphs->wrap == wrap)
+    return;
+
+  release_layouts (paragraphs);
+
+  /* the height of a paragraph only depends on the width if it is
+   * wrapped; otherwise the width is only used for the alignment
+   */
+  if (wrap || paragraphs->wrap)
+    {
+      paragraphs->height = 0;
+
+      for (i = 0; i < paragraphs->paragraphs->len; i++)
+        {
+          ClutterTextParagraph *paragraph = get_paragraph (paragraphs, i);
+
+          paragraph->height = estimate_height (paragraphs, paragraph, width, wrap);
+          paragraph->width = estimate_width (paragraphs, paragraph);
+          paragraph->measured = FALSE;
+
+          paragraphs->height += paragraph->height;
+        }
+
+      heights_build (paragraphs);
+      update_max_width (paragraphs);
+    }
+
+  paragraphs->width = width;
+  paragraphs->wrap = wrap;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get_width:
+ * @paragraphs: a #ClutterTextParagraphs
+ *
+ * Retrieves the width of the widest paragraph; the width of the
+ * paragraphs that were not laid out yet is estimated.
+ *
+ * Return value: the width, in Pango units
+ */
+gint
+_clutter_text_paragraphs_get_width (ClutterTextParagraphs *paragraphs)
+{
+  if (!paragraphs->max_width_valid)
+    update_max_width (paragraphs);
+
+  return paragraphs->max_width;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get_height:
+ * @paragraphs: a #ClutterTextParagraphs
+ *
+ * Retrieves the height of the whole text at the current width; the
+ * height of the paragraphs that were not laid out yet is estimated.
+ *
+ * Return value: the height, in Pango units
+ */
+gint64
+_clutter_text_paragraphs_get_height (ClutterTextParagraphs *paragraphs)
+{
+  return paragraphs->height;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_estimate_height:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @width: a width, in Pango units, or -1
+ * @wrap: whether the paragraphs would be wrapped at @width
+ *
+ * Estimates the height of the whole text at a width that might not
+ * be the current one, without affecting the paragraphs.
+ *
+ * Return value: the height, in Pango units
+ */
+gint64
+_clutter_text_paragraphs_estimate_height (ClutterTextParagraphs *paragraphs,
+                                          gint                   width,
+                                          gboolean               wrap)
+{
+  gint64 height = 0;
+  guint i;
+
+  if (width == paragraphs->width && wrap == paragraphs->wrap)
+    return paragraphs->height;
+
+  /* the measured heights are still valid if nothing wraps */
+  if (!wrap && !paragraphs->wrap)
+    return paragraphs->height;
+
+  for (i = 0; i < paragraphs->paragraphs->len; i++)
+    height += estimate_height (paragraphs, get_paragraph (paragraphs, i), width, wrap);
+
+  return height;
+}
+
+guint
+_clutter_text_paragraphs_get_size (ClutterTextParagraphs *paragraphs)
+{
+  return paragraphs->paragraphs->len;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @paragraph: the index of a paragraph
+ *
+ * Retrieves a paragraph, with its vertical position updated.
+ *
+ * Return value: (transfer none): the paragraph; the pointer is only
+ *   valid until @paragraphs is modified
+ */
+const ClutterTextParagraph *
+_clutter_text_paragraphs_get (ClutterTextParagraphs *paragraphs,
+                              guint                  paragraph)
+{
+  ClutterTextParagraph *p;
+
+  g_return_val_if_fail (paragraph < paragraphs->paragraphs->len, NULL);
+
+  p = get_paragraph (paragraphs, paragraph);
+  p->y = heights_sum (paragraphs, paragraph);
+
+  return p;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get_layout:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @paragraph: the index of a paragraph
+ *
+ * Retrieves the layout of a paragraph, creating it if needed; the
+ * first time a paragraph is laid out, its estimated size is replaced
+ * by the measured one, which moves all the following paragraphs.
+ *
+ * Return value: (transfer none): the layout of the paragraph
+ */
+PangoLayout *
+_clutter_text_paragraphs_get_layout (ClutterTextParagraphs *paragraphs,
+                                     guint                  paragraph)
+{
+  ClutterTextParagraph *p;
+  PangoRectangle logical_rect;
+
+  g_return_val_if_fail (paragraph < paragraphs->paragraphs->len, NULL);
+
+  p = get_paragraph (paragraphs, paragraph);
+  if (p->layout != NULL)
+    return p->layout;
+
+  p->layout = paragraphs->func (p->start_index, p->n_bytes,
+                                paragraphs->width,
+                                paragraphs->user_data);
+  g_array_append_val (paragraphs->live, paragraph);
+
+  pango_layout_get_extents (p->layout, NULL, &logical_rect);
+
+  if (!p->measured || p->height != logical_rect.y + logical_rect.height)
+    {
+      gint height = logical_rect.y + logical_rect.height;
+
+      heights_add (paragraphs, paragraph, height - p->height);
+
+      paragraphs->height += height - p->height;
+      p->height = height;
+      p->measured = TRUE;
+    }
+
+  set_paragraph_width (paragraphs, p, logical_rect.x + logical_rect.width);
+
+  return p->layout;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_find_y:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @y: a vertical position, in Pango units
+ *
+ * Finds the paragraph at the vertical position @y; positions before
+ * the text map to the first paragraph, and positions after the text
+ * to the last one.
+ *
+ * Return value: the index of the paragraph
+ */
+guint
+_clutter_text_paragraphs_find_y (ClutterTextParagraphs *paragraphs,
+                                 gint64                 y)
+{
+  guint n = paragraphs->paragraphs->len;
+  guint pos = 0, step;
+
+  /* walk down the tree, skipping every paragraph ending before @y */
+  for (step = 1; step <= n / 2; step <<= 1)
+    ;
+
+  for (; step > 0; step >>= 1)
+    {
+      if (pos + step <= n && paragraphs->heights[pos + step] <= y)
+        {
+          pos += step;
+          y -= paragraphs->heights[pos];
+        }
+    }
+
+  return MIN (pos, n - 1);
+}
+
+/*< private >
+ * _clutter_text_paragraphs_find_offset:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @offset: a position in the text, in characters
+ *
+ * Finds the paragraph containing the character at @offset; the
+ * separator at the end of a paragraph belongs to that paragraph.
+ *
+ * Return value: the index of the paragraph
+ */
+guint
+_clutter_text_paragraphs_find_offset (ClutterTextParagraphs *paragraphs,
+                                      gint                   offset)
+{
+  guint lo = 0, hi = paragraphs->paragraphs->len;
+
+  while (hi - lo > 1)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (get_paragraph (paragraphs, mid)->start_offset <= offset)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_find_index:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @index_: a position in the text, in bytes
+ *
+ * Finds the paragraph containing the byte at @index_.
+ *
+ * Return value: the index of the paragraph
+ */
+guint
+_clutter_text_paragraphs_find_index (ClutterTextParagraphs *paragraphs,
+                                     gsize                  index_)
+{
+  guint lo = 0, hi = paragraphs->paragraphs->len;
+
+  while (hi - lo > 1)
+    {
+      guint mid = lo + (hi - lo) / 2;
+
+      if (get_paragraph (paragraphs, mid)->start_index <= index_)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/*< private >
+ * _clutter_text_paragraphs_trim:
+ * @paragraphs: a #ClutterTextParagraphs
+ * @first: the first paragraph in use
+ * @last: the last paragraph in use
+ *
+ * Releases the layouts of the paragraphs that are not close to the
+ * range between @first and @last.
+ */
+void
+_clutter_text_paragraphs_trim (ClutterTextParagraphs *paragraphs,
+                               guint                  first,
+                               guint                  last)
+{
+  guint i, n_live = 0;
+
+  first = first > KEEP_PARAGRAPHS ? first - KEEP_PARAGRAPHS : 0;
+  last = last < G_MAXUINT - KEEP_PARAGRAPHS ? last + KEEP_PARAGRAPHS : G_MAXUINT;
+
+  for (i = 0; i < paragraphs->live->len; i++)
+    {
+      guint paragraph = g_array_index (paragraphs->live, guint, i);
+
+      if (paragraph >= first && paragraph <= last)
+        g_array_index (paragraphs->live, guint, n_live++) = paragraph;
+      else
+        g_clear_object (&get_paragraph (paragraphs, paragraph)->layout);
+    }
+
+  g_array_set_size (paragraphs->live, n_live);
+}
+
+/*< private >
+ * _clutter_text_paragraphs_get_n_layouts:
+ * @paragraphs: a #ClutterTextParagraphs
+ *
+ * Retrieves the number of paragraphs whose layout is around.
+ *
+ * Return value: the number of layouts
+ */
+guint
+_clutter_text_paragraphs_get_n_layouts (ClutterTextParagraphs *paragraphs)
+{
+  return paragraphs->live->len;
+}
@@ -0,0 +1,120 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextParagraphs: index of the paragraphs of a large text, laid
+ * out one paragraph at a time.
+ */
+
+#ifndef __CLUTTER_TEXT_PARAGRAPHS_H__
+#define __CLUTTER_TEXT_PARAGRAPHS_H__
+
+#include <pango/pango.h>
+#include <clutter/clutter-text-buffer.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTextParagraphs   ClutterTextParagraphs;
+typedef struct _ClutterTextParagraph    ClutterTextParagraph;
+
+/* all sizes and positions are in Pango units */
+struct _ClutterTextParagraph
+{
+  /* the position of the first character of the paragraph in the
+   * whole text, in bytes and in characters
+   */
+  gsize start_index;
+  gint start_offset;
+
+  /* the size of the paragraph, without the separator */
+  gint n_bytes;
+  gint n_chars;
+
+  gint64 y;
+  gint height;
+  gint width;
+
+  /* the layout of the paragraph, if it is currently around */
+  PangoLayout *layout;
+
+  /* whether the height of the paragraph is known, or estimated */
+  guint measured : 1;
+};
+
+/*
+ * ClutterTextParagraphFunc:
+ * @start_index: the position of the paragraph in the text, in bytes
+ * @n_bytes: the length of the paragraph, in bytes
+ * @width: the width of the layout, in Pango units, or -1
+ * @user_data: data passed to _clutter_text_paragraphs_new()
+ *
+ * Creates the layout of a paragraph; the layout is owned by the
+ * #ClutterTextParagraphs that called the function.
+ */
+typedef PangoLayout * (* ClutterTextParagraphFunc) (gsize    start_index,
+                                                    gsize    n_bytes,
+                                                    gint     width,
+                                                    gpointer user_data);
+
+ClutterTextParagraphs *         _clutter_text_paragraphs_new            (const gchar              *text,
+                                                                         gsize                     n_bytes,
+                                                                         gint                      line_height,
+                                                                         gint                      char_width,
+                                                                         ClutterTextParagraphFunc  func,
+                                                                         gpointer                  user_data);
+void                            _clutter_text_paragraphs_free           (ClutterTextParagraphs    *paragraphs);
+
+gint                            _clutter_text_paragraphs_get_length     (ClutterTextParagraphs    *paragraphs);
+void                            _clutter_text_paragraphs_insert_text    (ClutterTextParagraphs    *paragraphs,
+                                                                         ClutterTextBuffer        *buffer,
+                                                                         gint                      offset,
+                                                                         gint                      n_chars);
+void                            _clutter_text_paragraphs_delete_text    (ClutterTextParagraphs    *paragraphs,
+                                                                         ClutterTextBuffer        *buffer,
+                                                                         gint                      offset,
+                                                                         gint                      n_chars);
+
+void                            _clutter_text_paragraphs_set_width      (ClutterTextParagraphs    *paragraphs,
+                                                                         gint                      width,
+                                                                         gboolean                  wrap);
+gint                            _clutter_text_paragraphs_get_width      (ClutterTextParagraphs    *paragraphs);
+gint64                          _clutter_text_paragraphs_get_height     (ClutterTextParagraphs    *paragraphs);
+gint64                          _clutter_text_paragraphs_estimate_height (ClutterTextParagraphs   *paragraphs,
+                                                                         gint                      width,
+                                                                         gboolean                  wrap);
+
+guint                           _clutter_text_paragraphs_get_size       (ClutterTextParagraphs    *paragraphs);
+const ClutterTextParagraph *    _clutter_text_paragraphs_get            (ClutterTextParagraphs    *paragraphs,
+                                                                         guint                     paragraph);
+PangoLayout *                   _clutter_text_paragraphs_get_layout     (ClutterTextParagraphs    *paragraphs,
+                                                                         guint                     paragraph);
+
+guint                           _clutter_text_paragraphs_find_y         (ClutterTextParagraphs    *paragraphs,
+                                                                         gint64                    y);
+guint                           _clutter_text_paragraphs_find_offset    (ClutterTextParagraphs    *paragraphs,
+                                                                         gint                      offset);
+guint                           _clutter_text_paragraphs_find_index     (ClutterTextParagraphs    *paragraphs,
+                                                                         gsize                     index_);
+
+void                            _clutter_text_paragraphs_trim           (ClutterTextParagraphs    *paragraphs,
+                                                                         guint                     first,
+                                                                         guint                     last);
+guint                           _clutter_text_paragraphs_get_n_layouts  (ClutterTextParagraphs    *paragraphs);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_PARAGRAPHS_H__ */
@@ -0,0 +1,238 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextShaper: measures text layouts on worker threads.
+ *
+ * Creating and measuring the PangoLayout of a ClutterText is the most
+ * expensive part of populating a container with many labels, and most
+ * of those labels are not even going to be painted. The shaper lays
+ * out a copy of the text on a pool of worker threads, and reports the
+ * extents of the layout back to the main thread, so that ClutterText
+ * can answer size requests without shaping the text itself.
+ *
+ * Pango objects cannot be shared across threads, so each worker uses
+ * its own font map and PangoContext, configured like the context of
+ * the actor that submitted the job; the layout created by the worker
+ * is only used to measure the text, and it is discarded once the job
+ * completes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pango/pangocairo.h>
+
+#include "clutter-text-shaper.h"
+
+#include "clutter-debug.h"
+#include "clutter-main.h"
+
+struct _ClutterTextShapeJob
+{
+  /* a copy of the key, owned by the job */
+  ClutterTextLayoutKey key;
+
+  PangoFontDescription *context_font_desc;
+  cairo_font_options_t *font_options;
+  gdouble resolution;
+
+  /* results */
+  PangoRectangle logical_rect;
+  PangoRectangle line_rect;
+
+  ClutterTextShapeFunc func;
+  gpointer user_data;
+
+  /* set in the main thread, read by the workers */
+  volatile gint cancelled;
+};
+
+static GThreadPool *shaper_pool = NULL;
+
+/* each worker thread has its own font map and context */
+static GPrivate shaper_context = G_PRIVATE_INIT (g_object_unref);
+
+static void
+shape_job_free (gpointer data)
+{
+  ClutterTextShapeJob *job = data;
+
+  g_free ((gchar *) job->key.text);
+
+  if (job->key.attrs != NULL)
+    pango_attr_list_unref (job->key.attrs);
+
+  if (job->key.font_desc != NULL)
+    pango_font_description_free ((PangoFontDescription *) job->key.font_desc);
+
+  if (job->context_font_desc != NULL)
+    pango_font_description_free (job->context_font_desc);
+
+  if (job->font_options != NULL)
+    cairo_font_options_destroy (job->font_options);
+
+  g_slice_free (ClutterTextShapeJob, job);
+}
+
+static gboolean
+shape_job_complete (gpointer data)
+{
+  ClutterTextShapeJob *job = data;
+
+  if (!g_atomic_int_get (&job->cancelled))
+    job->func (job, &job->logical_rect, &job->line_rect, job->user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static PangoContext *
+shaper_get_context (void)
+{
+  PangoContext *context = g_private_get (&shaper_context);
+
+  if (context == NULL)
+    {
+      PangoFontMap *font_map = pango_cairo_font_map_new ();
+
+      context = pango_font_map_create_context (font_map);
+      g_private_set (&shaper_context, context);
+
+      g_object_unref (font_map);
+    }
+
+  return context;
+}
+
+static void
+shaper_thread_func (gpointer data,
+                    gpointer pool_data)
+{
+  ClutterTextShapeJob *job = data;
+  const ClutterTextLayoutKey *key = &job->key;
+  PangoContext *context;
+  PangoLayout *layout;
+  PangoLayoutLine *line;
+
+  if (g_atomic_int_get (&job->cancelled))
+    goto out;
+
+  context = shaper_get_context ();
+  pango_context_set_base_dir (context, key->base_dir);
+  pango_context_set_font_description (context, job->context_font_desc);
+  pango_cairo_context_set_font_options (context, job->font_options);
+  pango_cairo_context_set_resolution (context, job->resolution);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_text (layout, key->text, -1);
+  pango_layout_set_attributes (layout, key->attrs);
+  pango_layout_set_font_description (layout, key->font_desc);
+  pango_layout_set_alignment (layout, key->alignment);
+  pango_layout_set_single_paragraph_mode (layout, key->single_paragraph);
+  pango_layout_set_justify (layout, key->justify);
+  pango_layout_set_wrap (layout, key->wrap);
+  pango_layout_set_ellipsize (layout, key->ellipsize);
+  pango_layout_set_width (layout, key->width);
+  pango_layout_set_height (layout, key->height);
+
+  pango_layout_get_extents (layout, NULL, &job->logical_rect);
+
+  line = pango_layout_get_line_readonly (layout, 0);
+  if (line != NULL)
+    pango_layout_line_get_extents (line, NULL, &job->line_rect);
+
+  g_object_unref (layout);
+
+out:
+  clutter_threads_add_idle_full (G_PRIORITY_DEFAULT,
+                                 shape_job_complete,
+                                 job,
+                                 shape_job_free);
+}
+
+/*< private >
+ * _clutter_text_shaper_submit:
+ * @context: the #PangoContext the layout would be created with
+ * @key: the description of the layout
+ * @func: function to call in the main thread when the job completes
+ * @user_data: data to pass to @func
+ *
+ * Queues a job measuring the layout described by @key on a worker
+ * thread. Everything @key points to is copied.
+ *
+ * Return value: (transfer none): the job, which can be passed to
+ *   _clutter_text_shaper_cancel() until @func is called
+ */
+ClutterTextShapeJob *
+_clutter_text_shaper_submit (PangoContext               *context,
+                             const ClutterTextLayoutKey *key,
+                             ClutterTextShapeFunc        func,
+                             gpointer                    user_data)
+{
+  ClutterTextShapeJob *job;
+  const cairo_font_options_t *font_options;
+
+  if (G_UNLIKELY (shaper_pool == NULL))
+    {
+      gint n_threads = CLAMP (g_get_num_processors () / 2, 1, 4);
+
+      shaper_pool = g_thread_pool_new (shaper_thread_func, NULL,
+                                       n_threads,
+                                       FALSE,
+                                       NULL);
+    }
+
+  job = g_slice_new0 (ClutterTextShapeJob);
+  job->key = *key;
+  job->key.text = g_strdup (key->text);
+
+  if (key->attrs != NULL)
+    job->key.attrs = pango_attr_list_copy (key->attrs);
+
+  if (key->font_desc != NULL)
+    job->key.font_desc = pango_font_description_copy (key->font_desc);
+
+  job->context_font_desc =
+    pango_font_description_copy (pango_context_get_font_description (context));
+
+  font_options = pango_cairo_context_get_font_options (context);
+  if (font_options != NULL)
+    job->font_options = cairo_font_options_copy (font_options);
+
+  job->resolution = pango_cairo_context_get_resolution (context);
+
+  job->func = func;
+  job->user_data = user_data;
+
+  g_thread_pool_push (shaper_pool, job, NULL);
+
+  return job;
+}
+
+/*< private >
+ * _clutter_text_shaper_cancel:
+ * @job: a pending #ClutterTextShapeJob
+ *
+ * Cancels @job; its completion function will not be called, and the
+ * job must not be used after this function returns.
+ */
+void
+_clutter_text_shaper_cancel (ClutterTextShapeJob *job)
+{
+  g_atomic_int_set (&job->cancelled, TRUE);
+}
@@ -0,0 +1,55 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextShaper: measures text layouts on worker threads.
+ */
+
+#ifndef __CLUTTER_TEXT_SHAPER_H__
+#define __CLUTTER_TEXT_SHAPER_H__
+
+#include <clutter/clutter-types.h>
+#include "clutter-text-layout-cache.h"
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTextShapeJob     ClutterTextShapeJob;
+
+/*
+ * ClutterTextShapeFunc:
+ * @job: the job that completed
+ * @logical_rect: the logical extents of the layout, in Pango units
+ * @line_rect: the logical extents of the first line of the layout
+ * @user_data: the data passed to _clutter_text_shaper_submit()
+ *
+ * Called in the main thread when a job completes; @job is freed after
+ * the function returns.
+ */
+typedef void (* ClutterTextShapeFunc) (ClutterTextShapeJob  *job,
+                                       const PangoRectangle *logical_rect,
+                                       const PangoRectangle *line_rect,
+                                       gpointer              user_data);
+
+ClutterTextShapeJob *   _clutter_text_shaper_submit     (PangoContext               *context,
+                                                         const ClutterTextLayoutKey *key,
+                                                         ClutterTextShapeFunc        func,
+                                                         gpointer                    user_data);
+void                    _clutter_text_shaper_cancel     (ClutterTextShapeJob        *job);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_SHAPER_H__ */
@@ -59,7 +59,10 @@
 #include "clutter-marshal.h"
 #include "clutter-private.h"    /* includes <cogl-pango/cogl-pango.h> */
 #include "clutter-property-transition.h"
-#include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
+#include "clutter-text-layout-cache.h"
+#include "clutter-text-paragraphs.h"
+#include "clutter-text-shaper.h"
 #include "clutter-units.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-scriptable.h"
@@ -82,7 +85,14 @@
  */
 #define N_CACHED_LAYOUTS        6
 
+/* Layouts with fewer lines than this are always painted in one go,
+ * using the display list that CoglPango caches for the layout
+ */
+#define MIN_LINES_FOR_CULLING   64
+
 typedef struct _LayoutCache     LayoutCache;
+typedef struct _LayoutLine      LayoutLine;
+typedef struct _AsyncExtents    AsyncExtents;
 
 struct _LayoutCache
 {
@@ -96,6 +106,58 @@ struct _LayoutCache
    * new layout is needed the last used cache is replaced)
    */
   guint age;
+
+  /* The serial of the contents the layout was created with; edits
+   * to the buffer do not evict the cached layouts, they just make
+   * them stale, so that they can be updated in place if they are
+   * used again
+   */
+  guint contents_serial;
+
+  /* Whether the layout is a private copy of a shared layout, returned
+   * by clutter_text_get_layout(); it is never updated in place, since
+   * the caller may still be holding a reference on it
+   */
+  guint is_copy : 1;
+};
+
+/* The position of each line of a PangoLayout, in Pango units; the
+ * lines of a layout are stored in a GSList, so we keep them in an
+ * array attached to the layout to be able to find the lines inside
+ * a vertical range without walking the whole layout
+ */
+struct _LayoutLine
+{
+  PangoLayoutLine *line;
+
+  gint x;
+  gint baseline;
+
+  gint y_1;
+  gint y_2;
+
+  /* the logical extents of the line */
+  gint logical_y;
+  gint logical_width;
+  gint logical_height;
+
+  /* whether all the runs of the line are left-to-right */
+  guint ltr : 1;
+};
+
+/* The extents of a layout measured on a worker thread, when the
+ * ClutterText:async-layout property is set
+ */
+struct _AsyncExtents
+{
+  /* the width of the layout, in Pango units */
+  gint width;
+
+  /* the pending job, or NULL once the extents have been measured */
+  ClutterTextShapeJob *job;
+
+  PangoRectangle logical_rect;
+  PangoRectangle line_rect;
 };
 
 struct _ClutterTextPrivate
@@ -113,6 +175,17 @@ struct _ClutterTextPrivate
 
   LayoutCache cached_layouts[N_CACHED_LAYOUTS];
   guint cache_age;
+  guint contents_serial;
+
+  /* array of AsyncExtents, at most N_CACHED_LAYOUTS */
+  GArray *async_extents;
+
+  /* the paragraphs of the text, when the ClutterText:large-document
+   * property is set, and the range of them that was last painted
+   */
+  ClutterTextParagraphs *paragraphs;
+  guint paint_first_paragraph;
+  guint paint_last_paragraph;
 
   /* These are the attributes set by the attributes property */
   PangoAttrList *attrs;
@@ -190,6 +263,8 @@ struct _ClutterTextPrivate
   guint activatable             : 1;
   guint selectable              : 1;
   guint selection_color_set     : 1;
+  guint async_layout            : 1;
+  guint large_document          : 1;
   guint in_select_drag          : 1;
   guint in_select_touch         : 1;
   guint cursor_color_set        : 1;
@@ -236,6 +311,8 @@ enum
   PROP_SINGLE_LINE_MODE,
   PROP_SELECTED_TEXT_COLOR,
   PROP_SELECTED_TEXT_COLOR_SET,
+  PROP_ASYNC_LAYOUT,
+  PROP_LARGE_DOCUMENT,
 
   PROP_LAST
 };
@@ -256,6 +333,8 @@ enum
 
 static guint text_signals[LAST_SIGNAL] = { 0, };
 
+static GQuark quark_layout_lines = 0;
+
 static void clutter_text_settings_changed_cb (ClutterText *text);
 static void buffer_connect_signals (ClutterText *self);
 static void buffer_disconnect_signals (ClutterText *self);
@@ -486,19 +565,62 @@ clutter_text_ensure_effective_attributes (ClutterText *self)
     }
 }
 
-static PangoLayout *
-clutter_text_create_layout_no_cache (ClutterText       *text,
-				     gint               width,
-				     gint               height,
-				     PangoEllipsizeMode ellipsize)
+static PangoDirection
+clutter_text_resolve_base_dir (ClutterText *text,
+                               const gchar *contents,
+                               gsize        contents_len)
+{
+  PangoDirection pango_dir;
+
+  if (text->priv->password_char != 0)
+    pango_dir = PANGO_DIRECTION_NEUTRAL;
+  else
+    pango_dir = pango_find_base_dir (contents, contents_len);
+
+  if (pango_dir == PANGO_DIRECTION_NEUTRAL)
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+      ClutterTextDirection text_dir;
+
+      if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
+        pango_dir = _clutter_backend_get_keymap_direction (backend);
+      else
+        {
+          text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
+
+          if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
+            pango_dir = PANGO_DIRECTION_RTL;
+          else
+            pango_dir = PANGO_DIRECTION_LTR;
+        }
+    }
+
+  return pango_dir;
+}
+
+/*
+ * clutter_text_set_layout_contents:
+ * @text: a #ClutterText
+ * @layout: a #PangoLayout
+ *
+ * Sets the displayed text, the pre-edit string and the attributes
+ * of @text on @layout; everything else on the layout is left as it
+ * is, so that this can be used to update a cached layout after the
+ * contents of the buffer change.
+ */
+static void
+clutter_text_set_layout_contents (ClutterText *text,
+                                  PangoLayout *layout)
 {
   ClutterTextPrivate *priv = text->priv;
-  PangoLayout *layout;
   gchar *contents;
   gsize contents_len;
 
-  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
-  pango_layout_set_font_description (layout, priv->font_desc);
+  /* the layout might have been used with the pre-edit attributes */
+  pango_layout_set_attributes (layout, NULL);
+
+  /* the lines of the layout are going to change */
+  g_object_set_qdata (G_OBJECT (layout), quark_layout_lines, NULL);
 
   contents = clutter_text_get_display_text (text);
   contents_len = strlen (contents);
@@ -534,28 +656,7 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
     {
       PangoDirection pango_dir;
 
-      if (priv->password_char != 0)
-        pango_dir = PANGO_DIRECTION_NEUTRAL;
-      else
-        pango_dir = pango_find_base_dir (contents, contents_len);
-
-      if (pango_dir == PANGO_DIRECTION_NEUTRAL)
-        {
-          ClutterBackend *backend = clutter_get_default_backend ();
-          ClutterTextDirection text_dir;
-
-          if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
-            pango_dir = _clutter_backend_get_keymap_direction (backend);
-          else
-            {
-              text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
-
-              if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
-                pango_dir = PANGO_DIRECTION_RTL;
-              else
-                pango_dir = PANGO_DIRECTION_LTR;
-           }
-        }
+      pango_dir = clutter_text_resolve_base_dir (text, contents, contents_len);
 
       pango_context_set_base_dir (clutter_actor_get_pango_context (CLUTTER_ACTOR (text)), pango_dir);
 
@@ -571,6 +672,23 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   if (priv->effective_attrs != NULL)
     pango_layout_set_attributes (layout, priv->effective_attrs);
 
+  g_free (contents);
+}
+
+static PangoLayout *
+clutter_text_create_layout_no_cache (ClutterText       *text,
+				     gint               width,
+				     gint               height,
+				     PangoEllipsizeMode ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoLayout *layout;
+
+  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+  pango_layout_set_font_description (layout, priv->font_desc);
+
+  clutter_text_set_layout_contents (text, layout);
+
   pango_layout_set_alignment (layout, priv->alignment);
   pango_layout_set_single_paragraph_mode (layout, priv->single_line_mode);
   pango_layout_set_justify (layout, priv->justify);
@@ -580,142 +698,39 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   pango_layout_set_width (layout, width);
   pango_layout_set_height (layout, height);
 
-  g_free (contents);
-
   return layout;
 }
 
-static void
-clutter_text_dirty_cache (ClutterText *text)
-{
-  ClutterTextPrivate *priv = text->priv;
-  int i;
-
-  /* Delete the cached layouts so they will be recreated the next time
-     they are needed */
-  for (i = 0; i < N_CACHED_LAYOUTS; i++)
-    if (priv->cached_layouts[i].layout)
-      {
-	g_object_unref (priv->cached_layouts[i].layout);
-	priv->cached_layouts[i].layout = NULL;
-      }
-
-  clutter_text_dirty_paint_volume (text);
-}
-
 /*
- * clutter_text_set_font_description_internal:
- * @self: a #ClutterText
- * @desc: a #PangoFontDescription
- *
- * Sets @desc as the font description to be used by the #ClutterText
- * actor. The #PangoFontDescription is copied.
- *
- * This function will also set the :font-name field as a side-effect
- *
- * This function will evict the layout cache, and queue a relayout if
- * the #ClutterText actor has contents.
+ * clutter_text_get_layout_params:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width, or -1
+ * @allocation_height: the allocation height, or -1
+ * @width_p: (out): return location for the width of the layout,
+ *   in Pango units
+ * @height_p: (out): return location for the height of the layout,
+ *   in Pango units
+ * @ellipsize_p: (out): return location for the ellipsization mode
+ *   of the layout
+ *
+ * Computes the parameters of the layout needed for the given
+ * allocation size.
  */
-static inline void
-clutter_text_set_font_description_internal (ClutterText          *self,
-                                            PangoFontDescription *desc,
-                                            gboolean              is_default_font)
-{
-  ClutterTextPrivate *priv = self->priv;
-
-  priv->is_default_font = is_default_font;
-
-  if (priv->font_desc == desc ||
-      pango_font_description_equal (priv->font_desc, desc))
-    return;
-
-  if (priv->font_desc != NULL)
-    pango_font_description_free (priv->font_desc);
-
-  priv->font_desc = pango_font_description_copy (desc);
-
-  /* update the font name string we use */
-  g_free (priv->font_name);
-  priv->font_name = pango_font_description_to_string (priv->font_desc);
-
-  clutter_text_dirty_cache (self);
-
-  if (clutter_text_buffer_get_length (get_buffer (self)) != 0)
-    clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
-
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_FONT_DESCRIPTION]);
-}
-
 static void
-clutter_text_settings_changed_cb (ClutterText *text)
+clutter_text_get_layout_params (ClutterText        *text,
+                                gfloat              allocation_width,
+                                gfloat              allocation_height,
+                                gint               *width_p,
+                                gint               *height_p,
+                                PangoEllipsizeMode *ellipsize_p)
 {
   ClutterTextPrivate *priv = text->priv;
-  guint password_hint_time = 0;
-  ClutterSettings *settings;
-
-  settings = clutter_settings_get_default ();
-
-  g_object_get (settings, "password-hint-time", &password_hint_time, NULL);
-
-  priv->show_password_hint = password_hint_time > 0;
-  priv->password_hint_timeout = password_hint_time;
-
-  if (priv->is_default_font)
-    {
-      PangoFontDescription *font_desc;
-      gchar *font_name = NULL;
-
-      g_object_get (settings, "font-name", &font_name, NULL);
-
-      CLUTTER_NOTE (ACTOR, "Text[%p]: default font changed to '%s'",
-                    text,
-                    font_name);
-
-      font_desc = pango_font_description_from_string (font_name);
-      clutter_text_set_font_description_internal (text, font_desc, TRUE);
-
-      pango_font_description_free (font_desc);
-      g_free (font_name);
-    }
-
-  clutter_text_dirty_cache (text);
-  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
-}
-
-static void
-clutter_text_direction_changed_cb (GObject    *gobject,
-                                   GParamSpec *pspec)
-{
-  clutter_text_dirty_cache (CLUTTER_TEXT (gobject));
 
-  /* no need to queue a relayout: set_text_direction() will do that for us */
-}
-
-/*
- * clutter_text_create_layout:
- * @text: a #ClutterText
- * @allocation_width: the allocation width
- * @allocation_height: the allocation height
- *
- * Like clutter_text_create_layout_no_cache(), but will also ensure
- * the glyphs cache. If a previously cached layout generated using the
- * same width is available then that will be used instead of
- * generating a new one.
- */
-static PangoLayout *
-clutter_text_create_layout (ClutterText *text,
-                            gfloat       allocation_width,
-                            gfloat       allocation_height)
-{
-  ClutterTextPrivate *priv = text->priv;
-  LayoutCache *oldest_cache = priv->cached_layouts;
-  gboolean found_free_cache = FALSE;
-  gint width = -1;
-  gint height = -1;
-  PangoEllipsizeMode ellipsize = PANGO_ELLIPSIZE_NONE;
-  int i;
+  *width_p = -1;
+  *height_p = -1;
+  *ellipsize_p = PANGO_ELLIPSIZE_NONE;
 
-  /* First determine the width, height, and ellipsize mode that
+  /* Determine the width, height, and ellipsize mode that
    * we need for the layout. The ellipsize mode depends on
    * allocation_width/allocation_size as follows:
    *
@@ -740,7 +755,7 @@ clutter_text_create_layout (ClutterText *text,
       else
         {
           if (!priv->editable)
-            ellipsize = priv->ellipsize;
+            *ellipsize_p = priv->ellipsize;
         }
     }
 
@@ -758,7 +773,7 @@ clutter_text_create_layout (ClutterText *text,
        !((priv->editable && priv->single_line_mode) ||
          (priv->ellipsize == PANGO_ELLIPSIZE_NONE && !priv->wrap))))
     {
-      width = allocation_width * 1024 + 0.5f;
+      *width_p = allocation_width * 1024 + 0.5f;
     }
 
   /* Pango only uses height if ellipsization is enabled, so don't set
@@ -775,101 +790,1127 @@ clutter_text_create_layout (ClutterText *text,
       priv->ellipsize != PANGO_ELLIPSIZE_NONE &&
       !priv->single_line_mode)
     {
-      height = allocation_height * 1024 + 0.5f;
+      *height_p = allocation_height * 1024 + 0.5f;
     }
+}
 
-  /* Search for a cached layout with the same width and keep
-   * track of the oldest one
-   */
-  for (i = 0; i < N_CACHED_LAYOUTS; i++)
-    {
-      if (priv->cached_layouts[i].layout == NULL)
-	{
-	  /* Always prefer free cache spaces */
-	  found_free_cache = TRUE;
-	  oldest_cache = priv->cached_layouts + i;
-	}
-      else
-        {
-          PangoLayout *cached = priv->cached_layouts[i].layout;
-          gint cached_width = pango_layout_get_width (cached);
-	  gint cached_height = pango_layout_get_height (cached);
-	  gint cached_ellipsize = pango_layout_get_ellipsize (cached);
-
-	  if (cached_width == width &&
-	      cached_height == height &&
-	      cached_ellipsize == ellipsize)
-	    {
-              /* If this cached layout is using the same size then we can
-               * just return that directly
-               */
-              CLUTTER_NOTE (ACTOR,
-                            "ClutterText: %p: cache hit for size %.2fx%.2f",
-                            text,
-                            allocation_width,
-                            allocation_height);
+/*
+ * clutter_text_init_layout_key:
+ * @text: a #ClutterText
+ * @contents: the displayed text
+ * @width: the width of the layout, in Pango units
+ * @height: the height of the layout, in Pango units
+ * @ellipsize: the ellipsization mode of the layout
+ * @key: (out caller-allocates): the key to initialize
+ *
+ * Describes the layout of @contents with the current state of @text;
+ * the key points to @contents and to the private data of @text.
+ */
+static void
+clutter_text_init_layout_key (ClutterText          *text,
+                              const gchar          *contents,
+                              gint                  width,
+                              gint                  height,
+                              PangoEllipsizeMode    ellipsize,
+                              ClutterTextLayoutKey *key)
+{
+  ClutterTextPrivate *priv = text->priv;
 
-              return priv->cached_layouts[i].layout;
-	    }
+  clutter_text_ensure_effective_attributes (text);
 
-	  /* When getting the preferred height for a specific width,
-	   * we might be able to reuse the layout from getting the
-	   * preferred width. If the width that the layout gives
-	   * unconstrained is less than the width that we are using
-	   * than the height will be unaffected by that width.
-	   */
-	  if (allocation_height < 0 &&
-              cached_width == -1 &&
-              cached_ellipsize == ellipsize)
-	    {
-	      PangoRectangle logical_rect;
+  key->text = contents;
+  key->attrs = priv->effective_attrs;
+  key->font_desc = priv->font_desc;
+  key->base_dir = clutter_text_resolve_base_dir (text, contents, strlen (contents));
+  key->width = width;
+  key->height = height;
+  key->ellipsize = ellipsize;
+  key->wrap = priv->wrap_mode;
+  key->alignment = priv->alignment;
+  key->justify = priv->justify;
+  key->single_paragraph = priv->single_line_mode;
+}
 
-	      pango_layout_get_extents (priv->cached_layouts[i].layout,
+/*
+ * clutter_text_create_shared_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units
+ * @height: the height of the layout, in Pango units
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Retrieves a layout for the contents of @text from the layout cache
+ * shared by all the #ClutterText actors, or creates a new one and adds
+ * it to the shared cache.
+ *
+ * Return value: (transfer full): a shared #PangoLayout, which must
+ *   not be modified
+ */
+static PangoLayout *
+clutter_text_create_shared_layout (ClutterText        *text,
+                                   gint                width,
+                                   gint                height,
+                                   PangoEllipsizeMode  ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextLayoutKey key;
+  PangoLayout *layout;
+  gchar *contents;
+
+  contents = clutter_text_get_display_text (text);
+  clutter_text_init_layout_key (text, contents, width, height, ellipsize, &key);
+
+  layout = _clutter_text_layout_cache_lookup (&key);
+  if (layout != NULL)
+    {
+      CLUTTER_NOTE (ACTOR, "ClutterText: %p: shared layout cache hit", text);
+
+      priv->resolved_direction = key.base_dir;
+    }
+  else
+    {
+      layout = clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+      cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+      _clutter_text_layout_cache_insert (layout, key.base_dir);
+    }
+
+  g_free (contents);
+
+  return layout;
+}
+
+static inline gboolean
+clutter_text_use_paragraphs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  /* the preedit string is only shown in the layout of the whole text */
+  return priv->large_document &&
+         !priv->single_line_mode &&
+         !priv->preedit_set &&
+         priv->password_char == 0;
+}
+
+static inline gboolean
+clutter_text_use_async_layout (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  return priv->async_layout &&
+         !priv->editable &&
+         !clutter_text_use_paragraphs (text) &&
+         clutter_text_buffer_get_length (get_buffer (text)) > 0;
+}
+
+static void
+clutter_text_clear_async_extents (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  guint i;
+
+  if (priv->async_extents == NULL)
+    return;
+
+  for (i = 0; i < priv->async_extents->len; i++)
+    {
+      AsyncExtents *extents = &g_array_index (priv->async_extents, AsyncExtents, i);
+
+      if (extents->job != NULL)
+        _clutter_text_shaper_cancel (extents->job);
+    }
+
+  g_array_set_size (priv->async_extents, 0);
+}
+
+static void
+async_extents_done (ClutterTextShapeJob  *job,
+                    const PangoRectangle *logical_rect,
+                    const PangoRectangle *line_rect,
+                    gpointer              user_data)
+{
+  ClutterText *text = user_data;
+  ClutterTextPrivate *priv = text->priv;
+  guint i;
+
+  for (i = 0; i < priv->async_extents->len; i++)
+    {
+      AsyncExtents *extents = &g_array_index (priv->async_extents, AsyncExtents, i);
+
+      if (extents->job == job)
+        {
+          extents->job = NULL;
+          extents->logical_rect = *logical_rect;
+          extents->line_rect = *line_rect;
+
+          clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+          break;
+        }
+    }
+}
+
+/*
+ * clutter_text_estimate_extents:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @logical_rect: (out): return location for the estimated extents
+ * @line_rect: (out): return location for the estimated extents of
+ *   the first line
+ *
+ * Guesses the extents of the layout of @text from the size of the font
+ * and the number of characters, while the layout is being measured.
+ */
+static void
+clutter_text_estimate_extents (ClutterText    *text,
+                               gint            width,
+                               PangoRectangle *logical_rect,
+                               PangoRectangle *line_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  gdouble font_size, line_height, text_width, n_lines;
+
+  font_size = pango_font_description_get_size (priv->font_desc);
+  if (!pango_font_description_get_size_is_absolute (priv->font_desc))
+    {
+      gdouble resolution;
+
+      resolution = clutter_backend_get_resolution (clutter_get_default_backend ());
+      if (resolution < 0)
+        resolution = 96.0; /* fall back */
+
+      font_size *= resolution / 72.0;
+    }
+
+  /* an average glyph is about half as wide as the font size, and
+   * lines are spaced by about 1.2 times the font size
+   */
+  line_height = font_size * 1.2;
+  text_width = clutter_text_buffer_get_length (buffer) * font_size * 0.5;
+
+  n_lines = 1;
+  if (width > 0 && text_width > width)
+    {
+      n_lines = ceil (text_width / width);
+      text_width = width;
+    }
+
+  logical_rect->x = logical_rect->y = 0;
+  logical_rect->width = MIN (text_width, G_MAXINT / 2);
+  logical_rect->height = MIN (line_height * n_lines, G_MAXINT / 2);
+
+  *line_rect = *logical_rect;
+  line_rect->height = line_height;
+}
+
+/*
+ * clutter_text_get_async_extents:
+ * @text: a #ClutterText
+ * @allocation_width: the width to measure the layout for, or -1
+ * @logical_rect: (out): return location for the extents of the layout
+ * @line_rect: (out): return location for the extents of its first line
+ *
+ * Retrieves the extents of the layout of @text measured by a worker
+ * thread; if the layout has not been measured yet, the measurement is
+ * queued, and @logical_rect and @line_rect are set to an estimate. A
+ * relayout is queued once the measurement completes.
+ */
+static void
+clutter_text_get_async_extents (ClutterText    *text,
+                                gfloat          allocation_width,
+                                PangoRectangle *logical_rect,
+                                PangoRectangle *line_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextLayoutKey key;
+  AsyncExtents extents;
+  PangoEllipsizeMode ellipsize;
+  gint width, height;
+  gchar *contents;
+  guint i;
+
+  clutter_text_get_layout_params (text,
+                                  allocation_width, -1,
+                                  &width, &height,
+                                  &ellipsize);
+
+  if (priv->async_extents == NULL)
+    priv->async_extents = g_array_sized_new (FALSE, FALSE,
+                                             sizeof (AsyncExtents),
+                                             N_CACHED_LAYOUTS);
+
+  for (i = 0; i < priv->async_extents->len; i++)
+    {
+      AsyncExtents *cached = &g_array_index (priv->async_extents, AsyncExtents, i);
+
+      if (cached->width != width)
+        continue;
+
+      if (cached->job != NULL)
+        clutter_text_estimate_extents (text, width, logical_rect, line_rect);
+      else
+        {
+          *logical_rect = cached->logical_rect;
+          *line_rect = cached->line_rect;
+        }
+
+      return;
+    }
+
+  /* drop the oldest measurement */
+  if (priv->async_extents->len == N_CACHED_LAYOUTS)
+    {
+      AsyncExtents *oldest = &g_array_index (priv->async_extents, AsyncExtents, 0);
+
+      if (oldest->job != NULL)
+        _clutter_text_shaper_cancel (oldest->job);
+
+      g_array_remove_index (priv->async_extents, 0);
+    }
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: measuring layout for width %.2f",
+                text,
+                allocation_width);
+
+  contents = clutter_text_get_display_text (text);
+  clutter_text_init_layout_key (text, contents, width, height, ellipsize, &key);
+
+  memset (&extents, 0, sizeof (AsyncExtents));
+  extents.width = width;
+  extents.job = _clutter_text_shaper_submit (clutter_actor_get_pango_context (CLUTTER_ACTOR (text)),
+                                             &key,
+                                             async_extents_done,
+                                             text);
+  g_array_append_val (priv->async_extents, extents);
+
+  g_free (contents);
+
+  clutter_text_estimate_extents (text, width, logical_rect, line_rect);
+}
+
+typedef struct
+{
+  PangoAttrList *attrs;
+  guint start;
+  guint end;
+} AttributesSlice;
+
+static gboolean
+slice_attribute (PangoAttribute *attr,
+                 gpointer        data)
+{
+  AttributesSlice *slice = data;
+
+  if (attr->start_index < slice->end && attr->end_index > slice->start)
+    {
+      PangoAttribute *copy = pango_attribute_copy (attr);
+
+      copy->start_index = MAX (attr->start_index, slice->start) - slice->start;
+      copy->end_index = MIN (attr->end_index, slice->end) - slice->start;
+
+      pango_attr_list_insert (slice->attrs, copy);
+    }
+
+  /* we are only walking the list, nothing is filtered out */
+  return FALSE;
+}
+
+/*
+ * clutter_text_create_paragraph_layout:
+ * @start_index: the position of the paragraph in the buffer, in bytes
+ * @n_bytes: the length of the paragraph, in bytes
+ * @width: the width of the layout, in Pango units, or -1
+ * @user_data: the #ClutterText
+ *
+ * Creates the layout of a single paragraph of the contents of the
+ * buffer, with the attributes covering it shifted to the start of
+ * the paragraph.
+ */
+static PangoLayout *
+clutter_text_create_paragraph_layout (gsize    start_index,
+                                      gsize    n_bytes,
+                                      gint     width,
+                                      gpointer user_data)
+{
+  ClutterText *text = user_data;
+  ClutterTextPrivate *priv = text->priv;
+  const gchar *contents;
+  PangoLayout *layout;
+
+  contents = _clutter_text_buffer_get_text_range (get_buffer (text),
+                                                  start_index,
+                                                  n_bytes);
+
+  layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+  pango_layout_set_font_description (layout, priv->font_desc);
+  pango_layout_set_text (layout, contents, n_bytes);
+
+  clutter_text_ensure_effective_attributes (text);
+
+  if (priv->effective_attrs != NULL)
+    {
+      AttributesSlice slice;
+
+      slice.attrs = pango_attr_list_new ();
+      slice.start = start_index;
+      slice.end = start_index + n_bytes;
+
+      pango_attr_list_filter (priv->effective_attrs, slice_attribute, &slice);
+
+      pango_layout_set_attributes (layout, slice.attrs);
+      pango_attr_list_unref (slice.attrs);
+    }
+
+  pango_layout_set_alignment (layout, priv->alignment);
+  pango_layout_set_justify (layout, priv->justify);
+  pango_layout_set_wrap (layout, priv->wrap_mode);
+  pango_layout_set_width (layout, width);
+
+  /* without a height, ellipsizing a wrapped paragraph would leave a
+   * single line; we only ellipsize each line of unwrapped text
+   */
+  if (!priv->wrap)
+    pango_layout_set_ellipsize (layout, priv->ellipsize);
+
+  return layout;
+}
+
+/*
+ * clutter_text_get_paragraph_width:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width, or -1
+ *
+ * Computes the width of the layouts of the paragraphs for the given
+ * allocation width; the width is only set when wrapping or
+ * ellipsizing, since Pango wraps any layout with a width.
+ *
+ * Return value: the width, in Pango units, or -1
+ */
+static gint
+clutter_text_get_paragraph_width (ClutterText *text,
+                                  gfloat       allocation_width)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  if (allocation_width < 0)
+    return -1;
+
+  if (!priv->wrap && priv->ellipsize == PANGO_ELLIPSIZE_NONE)
+    return -1;
+
+  return allocation_width * 1024 + 0.5f;
+}
+
+static void
+clutter_text_clear_paragraphs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  g_clear_pointer (&priv->paragraphs, _clutter_text_paragraphs_free);
+}
+
+/*
+ * clutter_text_ensure_paragraphs:
+ * @text: a #ClutterText
+ *
+ * Splits the contents of the buffer into paragraphs, if needed. The
+ * size of each paragraph is estimated from the metrics of the font
+ * until it is laid out.
+ *
+ * Return value: (transfer none): the paragraphs of @text
+ */
+static ClutterTextParagraphs *
+clutter_text_ensure_paragraphs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextBuffer *buffer = get_buffer (text);
+  PangoContext *context;
+  PangoFontMetrics *metrics;
+  const gchar *contents;
+  gsize n_bytes;
+
+  /* the paragraphs are updated by the handlers of the edits of the
+   * buffer, which may run after the contents are queried
+   */
+  if (priv->paragraphs != NULL &&
+      _clutter_text_paragraphs_get_length (priv->paragraphs) != clutter_text_buffer_get_length (buffer))
+    clutter_text_clear_paragraphs (text);
+
+  if (priv->paragraphs != NULL)
+    return priv->paragraphs;
+
+  contents = clutter_text_buffer_get_text (buffer);
+  n_bytes = clutter_text_buffer_get_bytes (buffer);
+
+  context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+
+  /* each paragraph resolves its own direction; this is only used for
+   * the paragraphs without strong characters
+   */
+  priv->resolved_direction = clutter_text_resolve_base_dir (text, contents, n_bytes);
+  pango_context_set_base_dir (context, priv->resolved_direction);
+
+  metrics = pango_context_get_metrics (context, priv->font_desc, NULL);
+
+  priv->paragraphs =
+    _clutter_text_paragraphs_new (contents, n_bytes,
+                                  pango_font_metrics_get_ascent (metrics) +
+                                  pango_font_metrics_get_descent (metrics),
+                                  pango_font_metrics_get_approximate_char_width (metrics),
+                                  clutter_text_create_paragraph_layout,
+                                  text);
+
+  pango_font_metrics_unref (metrics);
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: %u paragraphs",
+                text,
+                _clutter_text_paragraphs_get_size (priv->paragraphs));
+
+  return priv->paragraphs;
+}
+
+/*
+ * clutter_text_get_paragraph_layout:
+ * @text: a #ClutterText
+ * @paragraph: the index of a paragraph
+ *
+ * Retrieves the layout of a paragraph. Laying out a paragraph for the
+ * first time replaces its estimated size, which changes the preferred
+ * size of @text, so we queue a relayout in that case.
+ *
+ * Return value: (transfer none): the layout of the paragraph
+ */
+static PangoLayout *
+clutter_text_get_paragraph_layout (ClutterText *text,
+                                   guint        paragraph)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (text);
+  PangoLayout *layout;
+  gint64 height;
+  gint width;
+
+  height = _clutter_text_paragraphs_get_height (paragraphs);
+  width = _clutter_text_paragraphs_get (paragraphs, paragraph)->width;
+  layout = _clutter_text_paragraphs_get_layout (paragraphs, paragraph);
+
+  if (_clutter_text_paragraphs_get_height (paragraphs) != height ||
+      _clutter_text_paragraphs_get (paragraphs, paragraph)->width != width)
+    clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+
+  return layout;
+}
+
+static void
+clutter_text_dirty_layouts (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  int i;
+
+  /* Delete the cached layouts so they will be recreated the next time
+     they are needed */
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    if (priv->cached_layouts[i].layout)
+      {
+	g_object_unref (priv->cached_layouts[i].layout);
+	priv->cached_layouts[i].layout = NULL;
+      }
+
+  clutter_text_clear_async_extents (text);
+
+  clutter_text_dirty_paint_volume (text);
+}
+
+static void
+clutter_text_dirty_cache (ClutterText *text)
+{
+  clutter_text_dirty_layouts (text);
+  clutter_text_clear_paragraphs (text);
+}
+
+/*
+ * clutter_text_dirty_contents:
+ * @text: a #ClutterText
+ *
+ * Marks the cached layouts as stale after the contents of the buffer
+ * changed. Unlike clutter_text_dirty_cache(), this keeps the layouts
+ * around: the ones that are used again are updated in place by
+ * clutter_text_create_layout(), which is cheaper than creating a new
+ * layout, and the ones that are not used again, like the layouts
+ * created by a width request for a size that is not going to be
+ * allocated, do not cost anything.
+ *
+ * The paragraphs are kept as well: the handlers of the edits of the
+ * buffer only split again the paragraphs that were edited.
+ */
+static void
+clutter_text_dirty_contents (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  priv->contents_serial += 1;
+
+  clutter_text_clear_async_extents (text);
+
+  clutter_text_dirty_paint_volume (text);
+}
+
+/*
+ * clutter_text_set_font_description_internal:
+ * @self: a #ClutterText
+ * @desc: a #PangoFontDescription
+ *
+ * Sets @desc as the font description to be used by the #ClutterText
+ * actor. The #PangoFontDescription is copied.
+ *
+ * This function will also set the :font-name field as a side-effect
+ *
+ * This function will evict the layout cache, and queue a relayout if
+ * the #ClutterText actor has contents.
+ */
+static inline void
+clutter_text_set_font_description_internal (ClutterText          *self,
+                                            PangoFontDescription *desc,
+                                            gboolean              is_default_font)
+{
+  ClutterTextPrivate *priv = self->priv;
+
+  priv->is_default_font = is_default_font;
+
+  if (priv->font_desc == desc ||
+      pango_font_description_equal (priv->font_desc, desc))
+    return;
+
+  if (priv->font_desc != NULL)
+    pango_font_description_free (priv->font_desc);
+
+  priv->font_desc = pango_font_description_copy (desc);
+
+  /* update the font name string we use */
+  g_free (priv->font_name);
+  priv->font_name = pango_font_description_to_string (priv->font_desc);
+
+  clutter_text_dirty_cache (self);
+
+  if (clutter_text_buffer_get_length (get_buffer (self)) != 0)
+    clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_FONT_DESCRIPTION]);
+}
+
+static void
+clutter_text_settings_changed_cb (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  guint password_hint_time = 0;
+  ClutterSettings *settings;
+
+  settings = clutter_settings_get_default ();
+
+  g_object_get (settings, "password-hint-time", &password_hint_time, NULL);
+
+  priv->show_password_hint = password_hint_time > 0;
+  priv->password_hint_timeout = password_hint_time;
+
+  if (priv->is_default_font)
+    {
+      PangoFontDescription *font_desc;
+      gchar *font_name = NULL;
+
+      g_object_get (settings, "font-name", &font_name, NULL);
+
+      CLUTTER_NOTE (ACTOR, "Text[%p]: default font changed to '%s'",
+                    text,
+                    font_name);
+
+      font_desc = pango_font_description_from_string (font_name);
+      clutter_text_set_font_description_internal (text, font_desc, TRUE);
+
+      pango_font_description_free (font_desc);
+      g_free (font_name);
+    }
+
+  clutter_text_dirty_cache (text);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+}
+
+static void
+clutter_text_direction_changed_cb (GObject    *gobject,
+                                   GParamSpec *pspec)
+{
+  clutter_text_dirty_cache (CLUTTER_TEXT (gobject));
+
+  /* no need to queue a relayout: set_text_direction() will do that for us */
+}
+
+/*
+ * clutter_text_create_layout:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width
+ * @allocation_height: the allocation height
+ *
+ * Like clutter_text_create_layout_no_cache(), but will also ensure
+ * the glyphs cache. If a previously cached layout generated using the
+ * same width is available then that will be used instead of
+ * generating a new one.
+ */
+static PangoLayout *
+clutter_text_create_layout (ClutterText *text,
+                            gfloat       allocation_width,
+                            gfloat       allocation_height)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *oldest_cache = priv->cached_layouts;
+  gboolean found_free_cache = FALSE;
+  gint width, height;
+  PangoEllipsizeMode ellipsize;
+  int i;
+
+  clutter_text_get_layout_params (text,
+                                  allocation_width,
+                                  allocation_height,
+                                  &width,
+                                  &height,
+                                  &ellipsize);
+
+  /* Search for a cached layout with the same width and keep
+   * track of the oldest one
+   */
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      if (priv->cached_layouts[i].layout == NULL)
+	{
+	  /* Always prefer free cache spaces */
+	  found_free_cache = TRUE;
+	  oldest_cache = priv->cached_layouts + i;
+	}
+      else if (priv->cached_layouts[i].contents_serial != priv->contents_serial)
+        {
+          PangoLayout *cached = priv->cached_layouts[i].layout;
+
+          /* A stale layout for the same size can be updated in place,
+           * unless other actors are using it; otherwise it is the first
+           * candidate for eviction, as its extents cannot be used
+           * without laying it out again
+           */
+          if (!_clutter_text_layout_cache_is_shared (cached) &&
+              !priv->cached_layouts[i].is_copy &&
+              pango_layout_get_width (cached) == width &&
+              pango_layout_get_height (cached) == height &&
+              pango_layout_get_ellipsize (cached) == ellipsize)
+            {
+              CLUTTER_NOTE (ACTOR,
+                            "ClutterText: %p: updating stale layout for size %.2fx%.2f",
+                            text,
+                            allocation_width,
+                            allocation_height);
+
+              clutter_text_set_layout_contents (text, cached);
+              cogl_pango_ensure_glyph_cache_for_layout (cached);
+
+              priv->cached_layouts[i].contents_serial = priv->contents_serial;
+              priv->cached_layouts[i].age = priv->cache_age++;
+
+              return cached;
+            }
+
+          if (!found_free_cache)
+            {
+              found_free_cache = TRUE;
+              oldest_cache = priv->cached_layouts + i;
+            }
+        }
+      else
+        {
+          PangoLayout *cached = priv->cached_layouts[i].layout;
+          gint cached_width = pango_layout_get_width (cached);
+	  gint cached_height = pango_layout_get_height (cached);
+	  gint cached_ellipsize = pango_layout_get_ellipsize (cached);
+
+	  if (cached_width == width &&
+	      cached_height == height &&
+	      cached_ellipsize == ellipsize)
+	    {
+              /* If this cached layout is using the same size then we can
+               * just return that directly
+               */
+              CLUTTER_NOTE (ACTOR,
+                            "ClutterText: %p: cache hit for size %.2fx%.2f",
+                            text,
+                            allocation_width,
+                            allocation_height);
+
+              return priv->cached_layouts[i].layout;
+	    }
+
+	  /* When getting the preferred height for a specific width,
+	   * we might be able to reuse the layout from getting the
+	   * preferred width. If the width that the layout gives
+	   * unconstrained is less than the width that we are using
+	   * than the height will be unaffected by that width.
+	   */
+	  if (allocation_height < 0 &&
+              cached_width == -1 &&
+              cached_ellipsize == ellipsize)
+	    {
+	      PangoRectangle logical_rect;
+
+	      pango_layout_get_extents (priv->cached_layouts[i].layout,
                                         NULL,
                                         &logical_rect);
 
-	      if (logical_rect.width <= width)
-		{
-		  /* We've been asked for our height for the width we gave as a result
-		   * of a _get_preferred_width call
-		   */
-		  CLUTTER_NOTE (ACTOR,
-                                "ClutterText: %p: cache hit for size %.2fx%.2f "
-				"(unwrapped width narrower than given width)",
-				text,
-				allocation_width,
-				allocation_height);
+	      if (logical_rect.width <= width)
+		{
+		  /* We've been asked for our height for the width we gave as a result
+		   * of a _get_preferred_width call
+		   */
+		  CLUTTER_NOTE (ACTOR,
+                                "ClutterText: %p: cache hit for size %.2fx%.2f "
+				"(unwrapped width narrower than given width)",
+				text,
+				allocation_width,
+				allocation_height);
+
+		  return priv->cached_layouts[i].layout;
+		}
+	    }
+
+	  if (!found_free_cache &&
+	      (priv->cached_layouts[i].age < oldest_cache->age))
+	    {
+	      oldest_cache = priv->cached_layouts + i;
+	    }
+        }
+    }
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: cache miss for size %.2fx%.2f",
+		text,
+                allocation_width,
+                allocation_height);
+
+  /* If we make it here then we didn't have a cached version so we
+     need to recreate the layout */
+  if (oldest_cache->layout)
+    g_object_unref (oldest_cache->layout);
+
+  /* editable actors change their contents all the time, and we want
+   * to update their layouts in place instead of sharing them
+   */
+  if (!priv->editable)
+    oldest_cache->layout =
+      clutter_text_create_shared_layout (text, width, height, ellipsize);
+  else
+    {
+      oldest_cache->layout =
+        clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+
+      cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+    }
+
+  /* Mark the 'time' this cache was created and advance the time */
+  oldest_cache->age = priv->cache_age++;
+  oldest_cache->contents_serial = priv->contents_serial;
+  oldest_cache->is_copy = FALSE;
+  return oldest_cache->layout;
+}
+
+/*
+ * clutter_text_get_current_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves the layout for the current size of @self; unlike the
+ * public clutter_text_get_layout(), the returned layout may be shared
+ * with other actors, so it must not be modified.
+ */
+static PangoLayout *
+clutter_text_get_current_layout (ClutterText *self)
+{
+  gfloat width, height;
+
+  if (self->priv->editable && self->priv->single_line_mode)
+    return clutter_text_create_layout (self, -1, -1);
+
+  clutter_actor_get_size (CLUTTER_ACTOR (self), &width, &height);
+
+  return clutter_text_create_layout (self, width, height);
+}
+
+static void
+layout_line_clear (gpointer data)
+{
+  LayoutLine *l = data;
+
+  pango_layout_line_unref (l->line);
+}
+
+/*
+ * clutter_text_get_layout_lines:
+ * @layout: a #PangoLayout
+ *
+ * Retrieves the position of each line of @layout; the positions are
+ * computed the first time and cached on the layout until its contents
+ * change.
+ *
+ * Return value: (transfer none): an array of #LayoutLine
+ */
+static GArray *
+clutter_text_get_layout_lines (PangoLayout *layout)
+{
+  PangoLayoutIter *iter;
+  GArray *lines;
+
+  lines = g_object_get_qdata (G_OBJECT (layout), quark_layout_lines);
+  if (lines != NULL)
+    return lines;
+
+  lines = g_array_sized_new (FALSE, FALSE, sizeof (LayoutLine),
+                             pango_layout_get_line_count (layout));
+  g_array_set_clear_func (lines, layout_line_clear);
+
+  iter = pango_layout_get_iter (layout);
+
+  do
+    {
+      PangoRectangle logical_rect;
+      LayoutLine l;
+
+      GSList *runs;
+
+      pango_layout_iter_get_line_extents (iter, NULL, &logical_rect);
+      pango_layout_iter_get_line_yrange (iter, &l.y_1, &l.y_2);
+
+      l.line = pango_layout_line_ref (pango_layout_iter_get_line_readonly (iter));
+      l.x = logical_rect.x;
+      l.baseline = pango_layout_iter_get_baseline (iter);
+
+      l.logical_y = logical_rect.y;
+      l.logical_width = logical_rect.width;
+      l.logical_height = logical_rect.height;
+
+      l.ltr = l.line->resolved_dir == PANGO_DIRECTION_LTR;
+      for (runs = l.line->runs; runs != NULL && l.ltr; runs = runs->next)
+        {
+          PangoLayoutRun *run = runs->data;
+
+          if (run->item->analysis.level % 2 != 0)
+            l.ltr = FALSE;
+        }
+
+      g_array_append_val (lines, l);
+    }
+  while (pango_layout_iter_next_line (iter));
+
+  pango_layout_iter_free (iter);
+
+  g_object_set_qdata_full (G_OBJECT (layout), quark_layout_lines,
+                           lines,
+                           (GDestroyNotify) g_array_unref);
+
+  return lines;
+}
+
+/* Returns the index of the first line in @lines that ends after @y */
+static guint
+layout_lines_find_y (GArray *lines,
+                     gint    y)
+{
+  guint lo = 0, hi = lines->len;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (lines, LayoutLine, mid).y_2 <= y)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* Returns the index of the line of @lines containing the byte @index_,
+ * using the same rules as Pango: bytes in the paragraph delimiters
+ * belong to the line before them
+ */
+static guint
+layout_lines_find_index (GArray *lines,
+                         gint    index_)
+{
+  guint lo = 0, hi = lines->len;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (lines, LayoutLine, mid).line->start_index <= index_)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo > 0 ? lo - 1 : 0;
+}
+
+/*
+ * clutter_text_layout_xy_to_index:
+ * @layout: a #PangoLayout
+ * @x: the X coordinate, in Pango units
+ * @y: the Y coordinate, in Pango units
+ * @index_: (out): return location for the byte index
+ * @trailing: (out): return location for the trailing position
+ *
+ * Like pango_layout_xy_to_index(), but finds the line with a binary
+ * search on the cached line positions, instead of walking the lines of
+ * the layout; only the line under @y is then inspected by Pango.
+ */
+static void
+clutter_text_layout_xy_to_index (PangoLayout *layout,
+                                 gint         x,
+                                 gint         y,
+                                 gint        *index_,
+                                 gint        *trailing)
+{
+  GArray *lines = clutter_text_get_layout_lines (layout);
+  const LayoutLine *l;
+  guint i;
+
+  i = layout_lines_find_y (lines, y);
+  if (i == lines->len)
+    i = lines->len - 1;
+  else if (i > 0)
+    {
+      const LayoutLine *prev = &g_array_index (lines, LayoutLine, i - 1);
+      const LayoutLine *next = &g_array_index (lines, LayoutLine, i);
+
+      /* coordinates between two lines go to the closest one */
+      if (y < next->y_1 && y < prev->y_2 + (next->y_1 - prev->y_2) / 2)
+        i -= 1;
+    }
+
+  l = &g_array_index (lines, LayoutLine, i);
+
+  pango_layout_line_x_to_index (l->line, x - l->x, index_, trailing);
+}
+
+/*
+ * clutter_text_layout_get_cursor_pos:
+ * @layout: a #PangoLayout
+ * @index_: the byte index of the cursor
+ * @pos: (out): return location for the strong cursor position
+ *
+ * Like pango_layout_get_cursor_pos(), but finds the line with a binary
+ * search on the cached line positions. Lines with right-to-left runs
+ * need the direction of each character to place the strong cursor,
+ * which Pango does not expose, so they are left to Pango.
+ */
+static void
+clutter_text_layout_get_cursor_pos (PangoLayout    *layout,
+                                    gint            index_,
+                                    PangoRectangle *pos)
+{
+  GArray *lines = clutter_text_get_layout_lines (layout);
+  const LayoutLine *l;
+  PangoLayoutLine *line;
+  gint x;
+
+  l = &g_array_index (lines, LayoutLine, layout_lines_find_index (lines, index_));
+  line = l->line;
 
-		  return priv->cached_layouts[i].layout;
-		}
-	    }
+  if (!l->ltr)
+    {
+      pango_layout_get_cursor_pos (layout, index_, pos, NULL);
+      return;
+    }
 
-	  if (!found_free_cache &&
-	      (priv->cached_layouts[i].age < oldest_cache->age))
-	    {
-	      oldest_cache = priv->cached_layouts + i;
-	    }
-        }
+  /* the strong cursor is at the trailing edge of the character
+   * before it
+   */
+  if (index_ == line->start_index)
+    x = 0;
+  else if (index_ >= line->start_index + line->length)
+    x = l->logical_width;
+  else
+    {
+      const gchar *text = pango_layout_get_text (layout);
+      gint prev_index;
+
+      prev_index = g_utf8_prev_char (text + index_) - text;
+      pango_layout_line_index_to_x (line, prev_index, TRUE, &x);
     }
 
-  CLUTTER_NOTE (ACTOR, "ClutterText: %p: cache miss for size %.2fx%.2f",
-		text,
-                allocation_width,
-                allocation_height);
+  pos->x = l->x + x;
+  pos->y = l->logical_y;
+  pos->width = 0;
+  pos->height = l->logical_height;
+}
 
-  /* If we make it here then we didn't have a cached version so we
-     need to recreate the layout */
-  if (oldest_cache->layout)
-    g_object_unref (oldest_cache->layout);
+/*
+ * clutter_text_paragraphs_xy_to_index:
+ * @text: a #ClutterText
+ * @x: the X coordinate, in Pango units
+ * @y: the Y coordinate, in Pango units
+ * @index_: (out): return location for the position in the buffer,
+ *   in bytes
+ * @trailing: (out): return location for the trailing edge
+ *
+ * Hit tests the paragraph at @y; the paragraphs are only used for the
+ * text of the buffer, so the byte positions are those of the buffer.
+ */
+static void
+clutter_text_paragraphs_xy_to_index (ClutterText *text,
+                                     gint         x,
+                                     gint64       y,
+                                     gint        *index_,
+                                     gint        *trailing)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (text);
+  const ClutterTextParagraph *paragraph;
+  PangoLayout *layout;
+  guint i;
 
-  oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+  i = _clutter_text_paragraphs_find_y (paragraphs, y);
+  layout = clutter_text_get_paragraph_layout (text, i);
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
 
-  cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+  clutter_text_layout_xy_to_index (layout,
+                                   x, CLAMP (y - paragraph->y, 0, G_MAXINT),
+                                   index_, trailing);
 
-  /* Mark the 'time' this cache was created and advance the time */
-  oldest_cache->age = priv->cache_age++;
-  return oldest_cache->layout;
+  *index_ += paragraph->start_index;
+}
+
+/*
+ * clutter_text_paragraphs_get_cursor_pos:
+ * @text: a #ClutterText
+ * @position: a position in the buffer, in characters
+ * @pos: (out): return location for the cursor rectangle, relative to
+ *   its paragraph
+ * @y: (out): return location for the position of the paragraph
+ *
+ * Retrieves the cursor rectangle at @position.
+ */
+static void
+clutter_text_paragraphs_get_cursor_pos (ClutterText    *text,
+                                        gint            position,
+                                        PangoRectangle *pos,
+                                        gint64         *y)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (text);
+  const ClutterTextParagraph *paragraph;
+  PangoLayout *layout;
+  gsize index_;
+  guint i;
+
+  index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (text), position);
+
+  i = _clutter_text_paragraphs_find_offset (paragraphs, position);
+  layout = clutter_text_get_paragraph_layout (text, i);
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+  clutter_text_layout_get_cursor_pos (layout,
+                                      index_ - paragraph->start_index,
+                                      pos);
+
+  *y = paragraph->y;
 }
 
 /**
@@ -901,9 +1942,18 @@ clutter_text_coords_to_position (ClutterText *self,
   px = (x - self->priv->text_x) * PANGO_SCALE;
   py = (y - self->priv->text_y) * PANGO_SCALE;
 
-  pango_layout_xy_to_index (clutter_text_get_layout (self),
-                            px, py,
-                            &index_, &trailing);
+  if (clutter_text_use_paragraphs (self))
+    {
+      clutter_text_paragraphs_xy_to_index (self,
+                                           px, (gint64) ((gdouble) y * PANGO_SCALE),
+                                           &index_, &trailing);
+
+      return index_ + trailing;
+    }
+
+  clutter_text_layout_xy_to_index (clutter_text_get_current_layout (self),
+                                   px, py,
+                                   &index_, &trailing);
 
   return index_ + trailing;
 }
@@ -947,6 +1997,27 @@ clutter_text_position_to_coords (ClutterText *self,
   if (position < -1 || position > n_chars)
     return FALSE;
 
+  if (clutter_text_use_paragraphs (self))
+    {
+      gint64 paragraph_y;
+
+      clutter_text_paragraphs_get_cursor_pos (self,
+                                              position == -1 ? n_chars : position,
+                                              &rect,
+                                              &paragraph_y);
+
+      if (x)
+        *x = (gfloat) rect.x / 1024.0f;
+
+      if (y)
+        *y = (gfloat) ((paragraph_y + rect.y) / 1024.0);
+
+      if (line_height)
+        *line_height = (gfloat) rect.height / 1024.0f;
+
+      return TRUE;
+    }
+
   if (priv->password_char != 0)
     password_char_bytes = g_unichar_to_utf8 (priv->password_char, NULL);
 
@@ -967,6 +2038,11 @@ clutter_text_position_to_coords (ClutterText *self,
     {
       index_ = 0;
     }
+  else if (priv->preedit_str == NULL && priv->password_char == 0)
+    {
+      /* the displayed text is the contents of the buffer */
+      index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (self), position);
+    }
   else
     {
       gchar *text = clutter_text_get_display_text (self);
@@ -987,9 +2063,9 @@ clutter_text_position_to_coords (ClutterText *self,
       g_string_free (tmp, TRUE);
     }
 
-  pango_layout_get_cursor_pos (clutter_text_get_layout (self),
-                               index_,
-                               &rect, NULL);
+  clutter_text_layout_get_cursor_pos (clutter_text_get_current_layout (self),
+                                      index_,
+                                      &rect);
 
   if (x)
     {
@@ -1313,6 +2389,14 @@ clutter_text_set_property (GObject      *gobject,
       clutter_text_set_selected_text_color (self, clutter_value_get_color (value));
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      clutter_text_set_async_layout (self, g_value_get_boolean (value));
+      break;
+
+    case PROP_LARGE_DOCUMENT:
+      clutter_text_set_large_document (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1442,6 +2526,14 @@ clutter_text_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->selected_text_color_set);
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      g_value_set_boolean (value, priv->async_layout);
+      break;
+
+    case PROP_LARGE_DOCUMENT:
+      g_value_set_boolean (value, priv->large_document);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1498,6 +2590,9 @@ clutter_text_finalize (GObject *gobject)
   if (priv->preedit_attrs)
     pango_attr_list_unref (priv->preedit_attrs);
 
+  if (priv->async_extents != NULL)
+    g_array_unref (priv->async_extents);
+
   clutter_text_dirty_paint_volume (self);
 
   clutter_text_set_buffer (self, NULL);
@@ -1510,50 +2605,50 @@ typedef void (* ClutterTextSelectionFunc) (ClutterText           *text,
                                            const ClutterActorBox *box,
                                            gpointer               user_data);
 
+/*
+ * clutter_text_foreach_layout_selection_rectangle:
+ * @self: a #ClutterText
+ * @layout: the layout of the text, or of one of its paragraphs
+ * @start_index: the start of the selection inside @layout, in bytes
+ * @end_index: the end of the selection inside @layout, in bytes
+ * @y_offset: the position of @layout, in Pango units
+ * @func: the function to call for each rectangle
+ * @user_data: data for @func
+ *
+ * Calls @func for the rectangles covering the selected text on each
+ * line of @layout.
+ */
 static void
-clutter_text_foreach_selection_rectangle (ClutterText              *self,
-                                          ClutterTextSelectionFunc  func,
-                                          gpointer                  user_data)
+clutter_text_foreach_layout_selection_rectangle (ClutterText              *self,
+                                                 PangoLayout              *layout,
+                                                 gint                      start_index,
+                                                 gint                      end_index,
+                                                 gint64                    y_offset,
+                                                 ClutterTextSelectionFunc  func,
+                                                 gpointer                  user_data)
 {
   ClutterTextPrivate *priv = self->priv;
-  PangoLayout *layout = clutter_text_get_layout (self);
-  gchar *utf8 = clutter_text_get_display_text (self);
-  gint lines;
-  gint start_index;
-  gint end_index;
-  gint line_no;
-
-  if (priv->position == 0)
-    start_index = 0;
-  else
-    start_index = offset_to_bytes (utf8, priv->position);
-
-  if (priv->selection_bound == 0)
-    end_index = 0;
-  else
-    end_index = offset_to_bytes (utf8, priv->selection_bound);
-
-  if (start_index > end_index)
-    {
-      gint temp = start_index;
-      start_index = end_index;
-      end_index = temp;
-    }
+  GArray *lines;
+  guint line_no;
 
-  lines = pango_layout_get_line_count (layout);
+  lines = clutter_text_get_layout_lines (layout);
 
-  for (line_no = 0; line_no < lines; line_no++)
+  for (line_no = 0; line_no < lines->len; line_no++)
     {
-      PangoLayoutLine *line;
+      const LayoutLine *l = &g_array_index (lines, LayoutLine, line_no);
+      PangoLayoutLine *line = l->line;
       gint n_ranges;
       gint *ranges;
       gint i;
-      gint index_;
       gint maxindex;
       ClutterActorBox box;
-      gfloat y, height;
 
-      line = pango_layout_get_line_readonly (layout, line_no);
+      /* the lines are sorted by index, so we can stop at the first
+       * line past the selection
+       */
+      if (line->start_index > end_index)
+        break;
+
       pango_layout_line_x_to_index (line, G_MAXINT, &maxindex, NULL);
       if (maxindex < start_index)
         continue;
@@ -1561,14 +2656,10 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
       pango_layout_line_get_x_ranges (line, start_index, end_index,
                                       &ranges,
                                       &n_ranges);
-      pango_layout_line_x_to_index (line, 0, &index_, NULL);
-
-      clutter_text_position_to_coords (self,
-                                       bytes_to_offset (utf8, index_),
-                                       NULL, &y, &height);
 
-      box.y1 = y;
-      box.y2 = y + height;
+      /* the same rectangle as the cursor at the start of the line */
+      box.y1 = (y_offset + l->logical_y) / 1024.0;
+      box.y2 = box.y1 + l->logical_height / 1024.0f;
 
       for (i = 0; i < n_ranges; i++)
         {
@@ -1593,6 +2684,107 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 
       g_free (ranges);
     }
+}
+
+/*
+ * clutter_text_foreach_paragraph_selection_rectangle:
+ * @self: a #ClutterText
+ * @start: the start of the selection, in characters
+ * @end: the end of the selection, in characters
+ * @func: the function to call for each rectangle
+ * @user_data: data for @func
+ *
+ * Calls @func for the rectangles covering the selected text on the
+ * paragraphs that were last painted; the selection may span the whole
+ * text, and we do not want to lay out all of it.
+ */
+static void
+clutter_text_foreach_paragraph_selection_rectangle (ClutterText              *self,
+                                                    gint                      start,
+                                                    gint                      end,
+                                                    ClutterTextSelectionFunc  func,
+                                                    gpointer                  user_data)
+{
+  ClutterTextPrivate *priv = self->priv;
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (self);
+  ClutterTextBuffer *buffer = get_buffer (self);
+  gsize start_index, end_index;
+  guint first, last, i;
+
+  start_index = _clutter_text_buffer_offset_to_bytes (buffer, start);
+  end_index = _clutter_text_buffer_offset_to_bytes (buffer, end);
+
+  first = MAX (_clutter_text_paragraphs_find_offset (paragraphs, start),
+               priv->paint_first_paragraph);
+  last = MIN (_clutter_text_paragraphs_find_offset (paragraphs, end),
+              priv->paint_last_paragraph);
+
+  for (i = first; i <= last && i < _clutter_text_paragraphs_get_size (paragraphs); i++)
+    {
+      const ClutterTextParagraph *paragraph;
+      PangoLayout *layout;
+      gsize paragraph_end;
+
+      layout = clutter_text_get_paragraph_layout (self, i);
+      paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+      paragraph_end = paragraph->start_index + paragraph->n_bytes;
+
+      clutter_text_foreach_layout_selection_rectangle (self, layout,
+                                                       MAX (start_index, paragraph->start_index) - paragraph->start_index,
+                                                       MIN (end_index, paragraph_end) - paragraph->start_index,
+                                                       paragraph->y,
+                                                       func, user_data);
+    }
+}
+
+static void
+clutter_text_foreach_selection_rectangle (ClutterText              *self,
+                                          ClutterTextSelectionFunc  func,
+                                          gpointer                  user_data)
+{
+  ClutterTextPrivate *priv = self->priv;
+  PangoLayout *layout;
+  gchar *utf8;
+  gint start_index;
+  gint end_index;
+
+  if (clutter_text_use_paragraphs (self))
+    {
+      gint n_chars = clutter_text_buffer_get_length (get_buffer (self));
+      gint start = priv->position == -1 ? n_chars : priv->position;
+      gint end = priv->selection_bound == -1 ? n_chars : priv->selection_bound;
+
+      clutter_text_foreach_paragraph_selection_rectangle (self,
+                                                          MIN (start, end),
+                                                          MAX (start, end),
+                                                          func, user_data);
+      return;
+    }
+
+  layout = clutter_text_get_current_layout (self);
+  utf8 = clutter_text_get_display_text (self);
+
+  if (priv->position == 0)
+    start_index = 0;
+  else
+    start_index = offset_to_bytes (utf8, priv->position);
+
+  if (priv->selection_bound == 0)
+    end_index = 0;
+  else
+    end_index = offset_to_bytes (utf8, priv->selection_bound);
+
+  if (start_index > end_index)
+    {
+      gint temp = start_index;
+      start_index = end_index;
+      end_index = temp;
+    }
+
+  clutter_text_foreach_layout_selection_rectangle (self, layout,
+                                                   start_index, end_index,
+                                                   0,
+                                                   func, user_data);
 
   g_free (utf8);
 }
@@ -1605,6 +2797,26 @@ add_selection_rectangle_to_path (ClutterText           *text,
   cogl_path_rectangle (user_data, box->x1, box->y1, box->x2, box->y2);
 }
 
+/* Draws the paragraphs in the range that was last painted */
+static void
+clutter_text_render_paragraphs (ClutterText     *self,
+                                const CoglColor *color)
+{
+  ClutterTextPrivate *priv = self->priv;
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (self);
+  guint i;
+
+  for (i = priv->paint_first_paragraph;
+       i <= priv->paint_last_paragraph && i < _clutter_text_paragraphs_get_size (paragraphs);
+       i++)
+    {
+      PangoLayout *layout = clutter_text_get_paragraph_layout (self, i);
+      const ClutterTextParagraph *paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+      cogl_pango_render_layout (layout, 0, paragraph->y / PANGO_SCALE, color, 0);
+    }
+}
+
 /* Draws the selected text, its background, and the cursor */
 static void
 selection_paint (ClutterText *self)
@@ -1638,7 +2850,6 @@ selection_paint (ClutterText *self)
   else
     {
       /* Paint selection background first */
-      PangoLayout *layout = clutter_text_get_layout (self);
       CoglPath *selection_path = cogl_path_new ();
       CoglColor cogl_color = { 0, };
       CoglFramebuffer *fb;
@@ -1681,10 +2892,209 @@ selection_paint (ClutterText *self)
                                 color->blue,
                                 paint_opacity * color->alpha / 255);
 
-      cogl_pango_render_layout (layout, priv->text_x, 0, &cogl_color, 0);
+      if (clutter_text_use_paragraphs (self))
+        clutter_text_render_paragraphs (self, &cogl_color);
+      else
+        cogl_pango_render_layout (clutter_text_get_current_layout (self),
+                                  priv->text_x, 0,
+                                  &cogl_color, 0);
+
+      cogl_framebuffer_pop_clip (fb);
+    }
+}
+
+/*
+ * clutter_text_paragraphs_move_word:
+ * @self: a #ClutterText
+ * @start: a position in the buffer, in characters, or -1
+ * @forward: whether to move to the end of the word, or to its start
+ *
+ * Word movement using the log attributes of the paragraph containing
+ * @start; moving past the start or the end of a paragraph moves onto
+ * the separator.
+ *
+ * Return value: the new position
+ */
+static gint
+clutter_text_paragraphs_move_word (ClutterText *self,
+                                   gint         start,
+                                   gboolean     forward)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (self);
+  const ClutterTextParagraph *paragraph;
+  PangoLogAttr *log_attrs = NULL;
+  PangoLayout *layout;
+  gint n_attrs = 0;
+  gint pos;
+  guint i;
+
+  if (start == -1)
+    start = clutter_text_buffer_get_length (get_buffer (self));
+
+  i = _clutter_text_paragraphs_find_offset (paragraphs, start);
+  layout = clutter_text_get_paragraph_layout (self, i);
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+  pos = start - paragraph->start_offset;
+
+  if (forward && pos >= paragraph->n_chars)
+    return start + 1;
+
+  if (!forward && pos == 0)
+    return MAX (start - 1, 0);
+
+  pango_layout_get_log_attrs (layout, &log_attrs, &n_attrs);
+
+  if (forward)
+    {
+      pos += 1;
+      while (pos < paragraph->n_chars && !log_attrs[pos].is_word_end)
+        pos += 1;
+    }
+  else
+    {
+      pos -= 1;
+      while (pos > 0 && !log_attrs[pos].is_word_start)
+        pos -= 1;
+    }
+
+  g_free (log_attrs);
+
+  return paragraph->start_offset + pos;
+}
+
+/*
+ * clutter_text_paragraphs_move_line:
+ * @self: a #ClutterText
+ * @start: a position in the buffer, in characters, or -1
+ * @to_end: whether to move to the end of the line, or to its start
+ *
+ * Moves to the start or the end of the line containing @start, inside
+ * the layout of its paragraph.
+ *
+ * Return value: the new position
+ */
+static gint
+clutter_text_paragraphs_move_line (ClutterText *self,
+                                   gint         start,
+                                   gboolean     to_end)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (self);
+  ClutterTextBuffer *buffer = get_buffer (self);
+  const ClutterTextParagraph *paragraph;
+  PangoLayoutLine *layout_line;
+  PangoLayout *layout;
+  gint line_no;
+  gint index_;
+  gint trailing;
+  guint i;
+
+  if (start == -1)
+    start = clutter_text_buffer_get_length (buffer);
+
+  i = _clutter_text_paragraphs_find_offset (paragraphs, start);
+  layout = clutter_text_get_paragraph_layout (self, i);
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+  index_ = _clutter_text_buffer_offset_to_bytes (buffer, start) - paragraph->start_index;
+
+  pango_layout_index_to_line_x (layout, index_, 0, &line_no, NULL);
+
+  layout_line = pango_layout_get_line_readonly (layout, line_no);
+  if (layout_line == NULL)
+    return start;
+
+  if (to_end)
+    {
+      pango_layout_line_x_to_index (layout_line, G_MAXINT, &index_, &trailing);
+
+      if (trailing > 0)
+        {
+          const gchar *text = pango_layout_get_text (layout);
+
+          index_ = g_utf8_offset_to_pointer (text + index_, trailing) - text;
+        }
+    }
+  else
+    pango_layout_line_x_to_index (layout_line, 0, &index_, NULL);
+
+  return _clutter_text_buffer_bytes_to_offset (buffer, paragraph->start_index + index_);
+}
+
+/*
+ * clutter_text_paragraphs_move_vertically:
+ * @self: a #ClutterText
+ * @start: a position in the buffer, in characters, or -1
+ * @x: (inout): the horizontal position to move to, in Pango units, or
+ *   -1 to use the one of @start
+ * @down: whether to move to the next line, or to the previous one
+ *
+ * Moves to the line after or before the one containing @start, which
+ * is in the next or previous paragraph if @start is on the last or
+ * first line of its paragraph.
+ *
+ * Return value: the new position, or -1 if there is no such line
+ */
+static gint
+clutter_text_paragraphs_move_vertically (ClutterText *self,
+                                         gint         start,
+                                         gint        *x,
+                                         gboolean     down)
+{
+  ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (self);
+  ClutterTextBuffer *buffer = get_buffer (self);
+  const ClutterTextParagraph *paragraph;
+  PangoLayoutLine *layout_line;
+  PangoLayout *layout;
+  gint line_no, line_x;
+  gint index_;
+  gint trailing;
+  guint i;
+
+  if (start == -1)
+    start = clutter_text_buffer_get_length (buffer);
+
+  i = _clutter_text_paragraphs_find_offset (paragraphs, start);
+  layout = clutter_text_get_paragraph_layout (self, i);
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+  index_ = _clutter_text_buffer_offset_to_bytes (buffer, start) - paragraph->start_index;
+
+  pango_layout_index_to_line_x (layout, index_, 0, &line_no, &line_x);
+
+  if (*x == -1)
+    *x = line_x;
+
+  line_no += down ? 1 : -1;
+
+  if (line_no < 0)
+    {
+      if (i == 0)
+        return -1;
+
+      i -= 1;
+      layout = clutter_text_get_paragraph_layout (self, i);
+      line_no = pango_layout_get_line_count (layout) - 1;
+    }
+  else if (line_no >= pango_layout_get_line_count (layout))
+    {
+      if (i + 1 >= _clutter_text_paragraphs_get_size (paragraphs))
+        return -1;
+
+      i += 1;
+      layout = clutter_text_get_paragraph_layout (self, i);
+      line_no = 0;
+    }
+
+  paragraph = _clutter_text_paragraphs_get (paragraphs, i);
+
+  layout_line = pango_layout_get_line_readonly (layout, line_no);
+  if (layout_line == NULL)
+    return -1;
+
+  pango_layout_line_x_to_index (layout_line, *x, &index_, &trailing);
 
-      cogl_framebuffer_pop_clip (fb);
-    }
+  return _clutter_text_buffer_bytes_to_offset (buffer, paragraph->start_index + index_) + trailing;
 }
 
 static gint
@@ -1695,10 +3105,15 @@ clutter_text_move_word_backward (ClutterText *self,
 
   if (clutter_text_buffer_get_length (get_buffer (self)) > 0 && start > 0)
     {
-      PangoLayout *layout = clutter_text_get_layout (self);
+      PangoLayout *layout;
       PangoLogAttr *log_attrs = NULL;
       gint n_attrs = 0;
 
+      if (clutter_text_use_paragraphs (self))
+        return clutter_text_paragraphs_move_word (self, start, FALSE);
+
+      layout = clutter_text_get_current_layout (self);
+
       pango_layout_get_log_attrs (layout, &log_attrs, &n_attrs);
 
       retval = start - 1;
@@ -1721,10 +3136,15 @@ clutter_text_move_word_forward (ClutterText *self,
   n_chars = clutter_text_buffer_get_length (get_buffer (self));
   if (n_chars > 0 && start < n_chars)
     {
-      PangoLayout *layout = clutter_text_get_layout (self);
+      PangoLayout *layout;
       PangoLogAttr *log_attrs = NULL;
       gint n_attrs = 0;
 
+      if (clutter_text_use_paragraphs (self))
+        return clutter_text_paragraphs_move_word (self, start, TRUE);
+
+      layout = clutter_text_get_current_layout (self);
+
       pango_layout_get_log_attrs (layout, &log_attrs, &n_attrs);
 
       retval = start + 1;
@@ -1746,15 +3166,16 @@ clutter_text_move_line_start (ClutterText *self,
   gint line_no;
   gint index_;
   gint position;
-  const gchar *text;
 
-  layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
+  if (clutter_text_use_paragraphs (self))
+    return clutter_text_paragraphs_move_line (self, start, FALSE);
+
+  layout = clutter_text_get_current_layout (self);
 
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, start);
+    index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (self), start);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -1766,7 +3187,7 @@ clutter_text_move_line_start (ClutterText *self,
 
   pango_layout_line_x_to_index (layout_line, 0, &index_, NULL);
 
-  position = bytes_to_offset (text, index_);
+  position = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
 
   return position;
 }
@@ -1782,15 +3203,16 @@ clutter_text_move_line_end (ClutterText *self,
   gint index_;
   gint trailing;
   gint position;
-  const gchar *text;
 
-  layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
+  if (clutter_text_use_paragraphs (self))
+    return clutter_text_paragraphs_move_line (self, start, TRUE);
+
+  layout = clutter_text_get_current_layout (self);
 
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (self), priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -1803,7 +3225,7 @@ clutter_text_move_line_end (ClutterText *self,
   pango_layout_line_x_to_index (layout_line, G_MAXINT, &index_, &trailing);
   index_ += trailing;
 
-  position = bytes_to_offset (text, index_);
+  position = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
 
   return position;
 }
@@ -1876,12 +3298,10 @@ clutter_text_press (ClutterActor *actor,
   res = clutter_actor_transform_stage_point (actor, x, y, &x, &y);
   if (res)
     {
-      const char *text;
       int offset;
 
       index_ = clutter_text_coords_to_position (self, x, y);
-      text = clutter_text_buffer_get_text (get_buffer (self));
-      offset = bytes_to_offset (text, index_);
+      offset = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
 
       /* what we select depends on the number of button clicks we
        * receive, and whether we are selectable:
@@ -1943,7 +3363,6 @@ clutter_text_move (ClutterActor *actor,
   gfloat x, y;
   gint index_, offset;
   gboolean res;
-  const gchar *text;
 
   if (!priv->in_select_drag)
     return CLUTTER_EVENT_PROPAGATE;
@@ -1955,8 +3374,7 @@ clutter_text_move (ClutterActor *actor,
     return CLUTTER_EVENT_PROPAGATE;
 
   index_ = clutter_text_coords_to_position (self, x, y);
-  text = clutter_text_buffer_get_text (get_buffer (self));
-  offset = bytes_to_offset (text, index_);
+  offset = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
 
   if (priv->selectable)
     clutter_text_set_cursor_position (self, offset);
@@ -2212,6 +3630,164 @@ clutter_text_compute_layout_offsets (ClutterText           *self,
 
 #define TEXT_PADDING    2
 
+/*
+ * clutter_text_render_layout:
+ * @text: a #ClutterText
+ * @layout: the #PangoLayout to paint
+ * @color: the color of the text
+ *
+ * Paints @layout at the current text offsets; if only part of the
+ * actor is visible, e.g. because it is inside a scrolling container
+ * that clips its children, only the lines of @layout that intersect
+ * the visible area are painted.
+ */
+static void
+clutter_text_render_layout (ClutterText     *text,
+                            PangoLayout     *layout,
+                            const CoglColor *color)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterRect visible;
+  GArray *lines;
+  guint first, last, i;
+  gint y_1, y_2;
+
+  if (pango_layout_get_line_count (layout) < MIN_LINES_FOR_CULLING ||
+      !_clutter_actor_get_visible_rect (CLUTTER_ACTOR (text), &visible))
+    goto paint_all;
+
+  lines = clutter_text_get_layout_lines (layout);
+
+  y_1 = (visible.origin.y - priv->text_y) * PANGO_SCALE;
+  y_2 = (visible.origin.y + visible.size.height - priv->text_y) * PANGO_SCALE;
+
+  /* the ink of a line can overflow its logical rectangle, so we also
+   * paint the lines right outside of the visible area
+   */
+  first = layout_lines_find_y (lines, y_1);
+  if (first > 0)
+    first -= 1;
+
+  last = layout_lines_find_y (lines, y_2);
+  if (last < lines->len)
+    last += 1;
+
+  /* if everything is visible, we can use the display list that
+   * CoglPango caches for the whole layout
+   */
+  if (first == 0 && last == lines->len)
+    goto paint_all;
+
+  CLUTTER_NOTE (PAINT, "painting lines %u-%u of %u", first, last, lines->len);
+
+  for (i = first; i < last; i++)
+    {
+      const LayoutLine *l = &g_array_index (lines, LayoutLine, i);
+
+      cogl_pango_render_layout_line (l->line,
+                                     priv->text_x * PANGO_SCALE + l->x,
+                                     priv->text_y * PANGO_SCALE + l->baseline,
+                                     color);
+    }
+
+  return;
+
+paint_all:
+  cogl_pango_render_layout (layout, priv->text_x, priv->text_y, color, 0);
+}
+
+/*
+ * clutter_text_paint_paragraphs:
+ * @text: a #ClutterText
+ * @fb: the framebuffer to paint on
+ * @alloc_width: the width of the allocation
+ * @alloc_height: the height of the allocation
+ *
+ * Paints the paragraphs of a large document that intersect the visible
+ * part of @text, and releases the layouts of the ones far from it.
+ */
+static void
+clutter_text_paint_paragraphs (ClutterText     *text,
+                               CoglFramebuffer *fb,
+                               gfloat           alloc_width,
+                               gfloat           alloc_height)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterActor *actor = CLUTTER_ACTOR (text);
+  ClutterTextParagraphs *paragraphs;
+  ClutterRect visible;
+  CoglColor color = { 0, };
+  guint8 real_opacity;
+  gint64 y_1, y_2;
+  guint first, last, n_paragraphs;
+
+  paragraphs = clutter_text_ensure_paragraphs (text);
+  n_paragraphs = _clutter_text_paragraphs_get_size (paragraphs);
+
+  _clutter_text_paragraphs_set_width (paragraphs,
+                                      clutter_text_get_paragraph_width (text, alloc_width),
+                                      priv->wrap);
+
+  if (!_clutter_actor_get_visible_rect (actor, &visible))
+    clutter_rect_init (&visible, 0, 0, alloc_width, alloc_height);
+
+  y_1 = MAX (visible.origin.y, 0) * PANGO_SCALE;
+  y_2 = MIN (visible.origin.y + visible.size.height, alloc_height) * PANGO_SCALE;
+
+  cogl_framebuffer_push_rectangle_clip (fb, 0, 0, alloc_width, alloc_height);
+
+  priv->text_x = priv->text_y = 0;
+
+  real_opacity = clutter_actor_get_paint_opacity (actor)
+               * priv->text_color.alpha
+               / 255;
+
+  cogl_color_init_from_4ub (&color,
+                            priv->text_color.red,
+                            priv->text_color.green,
+                            priv->text_color.blue,
+                            real_opacity);
+
+  /* measuring a paragraph moves the following ones, so we look for
+   * the end of the visible range while we lay them out
+   */
+  first = last = _clutter_text_paragraphs_find_y (paragraphs, y_1);
+  while (last < n_paragraphs)
+    {
+      const ClutterTextParagraph *paragraph;
+      PangoLayout *layout;
+
+      /* the position of a paragraph does not depend on its own size */
+      paragraph = _clutter_text_paragraphs_get (paragraphs, last);
+      if (paragraph->y >= y_2 && last > first)
+        break;
+
+      layout = clutter_text_get_paragraph_layout (text, last);
+
+      if (real_opacity > 0)
+        cogl_pango_render_layout (layout, 0, paragraph->y / PANGO_SCALE, &color, 0);
+
+      last += 1;
+    }
+
+  priv->paint_first_paragraph = first;
+  priv->paint_last_paragraph = last - 1;
+
+  if (clutter_text_should_draw_cursor (text))
+    clutter_text_ensure_cursor_position (text);
+
+  selection_paint (text);
+
+  cogl_framebuffer_pop_clip (fb);
+
+  _clutter_text_paragraphs_trim (paragraphs, first, last - 1);
+
+  CLUTTER_NOTE (PAINT, "painted paragraphs %u-%u of %u (%u layouts)",
+                first, last - 1,
+                n_paragraphs,
+                _clutter_text_paragraphs_get_n_layouts (paragraphs));
+}
+
 static void
 clutter_text_paint (ClutterActor *self)
 {
@@ -2221,11 +3797,11 @@ clutter_text_paint (ClutterActor *self)
   PangoLayout *layout;
   ClutterActorBox alloc = { 0, };
   CoglColor color = { 0, };
+  ClutterColor bg_color;
   guint8 real_opacity;
   gint text_x = priv->text_x;
   gint text_y = priv->text_y;
   gboolean clip_set = FALSE;
-  gboolean bg_color_set = FALSE;
   guint n_chars;
   float alloc_width;
   float alloc_height;
@@ -2247,12 +3823,8 @@ clutter_text_paint (ClutterActor *self)
   alloc_width = alloc.x2 - alloc.x1;
   alloc_height = alloc.y2 - alloc.y1;
 
-  g_object_get (self, "background-color-set", &bg_color_set, NULL);
-  if (bg_color_set)
+  if (_clutter_actor_get_background_color_set (self, &bg_color))
     {
-      ClutterColor bg_color;
-
-      clutter_actor_get_background_color (self, &bg_color);
       bg_color.alpha = clutter_actor_get_paint_opacity (self)
                      * bg_color.alpha
                      / 255;
@@ -2272,6 +3844,12 @@ clutter_text_paint (ClutterActor *self)
       !clutter_text_should_draw_cursor (text))
     return;
 
+  if (clutter_text_use_paragraphs (text))
+    {
+      clutter_text_paint_paragraphs (text, fb, alloc_width, alloc_height);
+      return;
+    }
+
   if (priv->editable && priv->single_line_mode)
     layout = clutter_text_create_layout (text, -1, -1);
   else
@@ -2386,12 +3964,18 @@ clutter_text_paint (ClutterActor *self)
   CLUTTER_NOTE (PAINT, "painting text (text: '%s')",
                 clutter_text_buffer_get_text (get_buffer (text)));
 
-  cogl_color_init_from_4ub (&color,
-                            priv->text_color.red,
-                            priv->text_color.green,
-                            priv->text_color.blue,
-                            real_opacity);
-  cogl_pango_render_layout (layout, priv->text_x, priv->text_y, &color, 0);
+  /* a fully transparent text, e.g. at the start of a fade in, does
+   * not need to go through the glyph cache at all
+   */
+  if (real_opacity > 0)
+    {
+      cogl_color_init_from_4ub (&color,
+                                priv->text_color.red,
+                                priv->text_color.green,
+                                priv->text_color.blue,
+                                real_opacity);
+      clutter_text_render_layout (text, layout, &color);
+    }
 
   selection_paint (text);
 
@@ -2468,8 +4052,13 @@ clutter_text_get_paint_volume (ClutterActor       *self,
       ClutterVertex origin;
 
       /* If the text is single line editable then it gets clipped to
-         the allocation anyway so we can just use that */
-      if (priv->editable && priv->single_line_mode)
+         the allocation anyway so we can just use that; if the layout
+         is measured asynchronously, or laid out one paragraph at a
+         time, we use the allocation as well, so that culling does not
+         create the layout */
+      if ((priv->editable && priv->single_line_mode) ||
+          clutter_text_use_async_layout (text) ||
+          clutter_text_use_paragraphs (text))
         return _clutter_actor_set_default_paint_volume (self,
                                                         CLUTTER_TYPE_TEXT,
                                                         volume);
@@ -2482,7 +4071,7 @@ clutter_text_get_paint_volume (ClutterActor       *self,
 
       _clutter_paint_volume_init_static (&priv->paint_volume, self);
 
-      layout = clutter_text_get_layout (text);
+      layout = clutter_text_get_current_layout (text);
       pango_layout_get_extents (layout, &ink_rect, NULL);
 
       origin.x = ink_rect.x / (float) PANGO_SCALE;
@@ -2527,13 +4116,27 @@ clutter_text_get_preferred_width (ClutterActor *self,
   ClutterText *text = CLUTTER_TEXT (self);
   ClutterTextPrivate *priv = text->priv;
   PangoRectangle logical_rect = { 0, };
-  PangoLayout *layout;
   gint logical_width;
   gfloat layout_width;
 
-  layout = clutter_text_create_layout (text, -1, -1);
+  if (clutter_text_use_async_layout (text))
+    {
+      PangoRectangle line_rect;
+
+      clutter_text_get_async_extents (text, -1, &logical_rect, &line_rect);
+    }
+  else if (clutter_text_use_paragraphs (text))
+    {
+      ClutterTextParagraphs *paragraphs = clutter_text_ensure_paragraphs (text);
+
+      logical_rect.width = _clutter_text_paragraphs_get_width (paragraphs);
+    }
+  else
+    {
+      PangoLayout *layout = clutter_text_create_layout (text, -1, -1);
 
-  pango_layout_get_extents (layout, NULL, &logical_rect);
+      pango_layout_get_extents (layout, NULL, &logical_rect);
+    }
 
   /* the X coordinate of the logical rectangle might be non-zero
    * according to the Pango documentation; hence, we need to offset
@@ -2580,18 +4183,49 @@ clutter_text_get_preferred_height (ClutterActor *self,
     }
   else
     {
-      PangoLayout *layout;
+      PangoLayout *layout = NULL;
       PangoRectangle logical_rect = { 0, };
+      PangoRectangle line_rect = { 0, };
       gint logical_height;
       gfloat layout_height;
 
       if (priv->single_line_mode)
         for_width = -1;
 
-      layout = clutter_text_create_layout (CLUTTER_TEXT (self),
-                                           for_width, -1);
+      /* the paragraphs that were not laid out yet are estimated, and
+       * the estimate is replaced when they are painted; the total can
+       * be larger than what fits in a PangoRectangle
+       */
+      if (clutter_text_use_paragraphs (CLUTTER_TEXT (self)))
+        {
+          ClutterText *text = CLUTTER_TEXT (self);
+          gint64 height;
+
+          height = _clutter_text_paragraphs_estimate_height (clutter_text_ensure_paragraphs (text),
+                                                             clutter_text_get_paragraph_width (text, for_width),
+                                                             priv->wrap);
+          layout_height = ceil (height / 1024.0);
 
-      pango_layout_get_extents (layout, NULL, &logical_rect);
+          if (min_height_p)
+            *min_height_p = layout_height;
+
+          if (natural_height_p)
+            *natural_height_p = layout_height;
+
+          return;
+        }
+
+      if (clutter_text_use_async_layout (CLUTTER_TEXT (self)))
+        clutter_text_get_async_extents (CLUTTER_TEXT (self), for_width,
+                                        &logical_rect,
+                                        &line_rect);
+      else
+        {
+          layout = clutter_text_create_layout (CLUTTER_TEXT (self),
+                                               for_width, -1);
+
+          pango_layout_get_extents (layout, NULL, &logical_rect);
+        }
 
       /* the Y coordinate of the logical rectangle might be non-zero
        * according to the Pango documentation; hence, we need to offset
@@ -2607,13 +4241,17 @@ clutter_text_get_preferred_height (ClutterActor *self,
            */
           if ((priv->ellipsize && priv->wrap) && !priv->single_line_mode)
             {
-              PangoLayoutLine *line;
               gfloat line_height;
 
-              line = pango_layout_get_line_readonly (layout, 0);
-              pango_layout_line_get_extents (line, NULL, &logical_rect);
+              if (layout != NULL)
+                {
+                  PangoLayoutLine *line;
+
+                  line = pango_layout_get_line_readonly (layout, 0);
+                  pango_layout_line_get_extents (line, NULL, &line_rect);
+                }
 
-              logical_height = logical_rect.y + logical_rect.height;
+              logical_height = line_rect.y + line_rect.height;
               line_height = ceilf (logical_height / 1024.0f);
 
               *min_height_p = line_height;
@@ -2641,8 +4279,19 @@ clutter_text_allocate (ClutterActor           *self,
    * if the Text is editable and in single line mode we don't want
    * to have any limit on the layout size, since the paint will clip
    * it to the allocation of the actor
+   *
+   * if the layout is measured asynchronously, we defer creating it
+   * until the actor is painted, as most of the actors in a long list
+   * are never going to be; the same goes for the layouts of the
+   * paragraphs of a large document
    */
-  if (text->priv->editable && text->priv->single_line_mode)
+  if (clutter_text_use_async_layout (text))
+    ;
+  else if (clutter_text_use_paragraphs (text))
+    _clutter_text_paragraphs_set_width (clutter_text_ensure_paragraphs (text),
+                                        clutter_text_get_paragraph_width (text, box->x2 - box->x1),
+                                        text->priv->wrap);
+  else if (text->priv->editable && text->priv->single_line_mode)
     clutter_text_create_layout (text, -1, -1);
   else
     clutter_text_create_layout (text,
@@ -2772,15 +4421,25 @@ clutter_text_real_move_up (ClutterText         *self,
   gint index_, trailing;
   gint pos;
   gint x;
-  const gchar *text;
 
-  layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
+  if (clutter_text_use_paragraphs (self))
+    {
+      x = priv->x_pos;
+      pos = clutter_text_paragraphs_move_vertically (self, priv->position, &x, FALSE);
+      if (pos < 0)
+        return FALSE;
+
+      trailing = 0;
+
+      goto move;
+    }
+
+  layout = clutter_text_get_current_layout (self);
 
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (self), priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2799,9 +4458,11 @@ clutter_text_real_move_up (ClutterText         *self,
 
   pango_layout_line_x_to_index (layout_line, x, &index_, &trailing);
 
+  pos = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
+
+move:
   g_object_freeze_notify (G_OBJECT (self));
 
-  pos = bytes_to_offset (text, index_);
   clutter_text_set_cursor_position (self, pos + trailing);
 
   /* Store the target x position to avoid drifting left and right when
@@ -2829,15 +4490,25 @@ clutter_text_real_move_down (ClutterText         *self,
   gint index_, trailing;
   gint x;
   gint pos;
-  const gchar *text;
 
-  layout = clutter_text_get_layout (self);
-  text = clutter_text_buffer_get_text (get_buffer (self));
+  if (clutter_text_use_paragraphs (self))
+    {
+      x = priv->x_pos;
+      pos = clutter_text_paragraphs_move_vertically (self, priv->position, &x, TRUE);
+      if (pos < 0)
+        return FALSE;
+
+      trailing = 0;
+
+      goto move;
+    }
+
+  layout = clutter_text_get_current_layout (self);
 
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_offset_to_bytes (get_buffer (self), priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2852,9 +4523,11 @@ clutter_text_real_move_down (ClutterText         *self,
 
   pango_layout_line_x_to_index (layout_line, x, &index_, &trailing);
 
+  pos = _clutter_text_buffer_bytes_to_offset (get_buffer (self), index_);
+
+move:
   g_object_freeze_notify (G_OBJECT (self));
 
-  pos = bytes_to_offset (text, index_);
   clutter_text_set_cursor_position (self, pos + trailing);
 
   /* Store the target x position to avoid drifting left and right when
@@ -3184,7 +4857,10 @@ clutter_text_set_color_internal (ClutterText        *self,
       break;
     }
 
-  clutter_text_queue_redraw (CLUTTER_ACTOR (self));
+  /* colors change neither the paint volume nor the layout, so the
+   * glyphs cached by CoglPango are drawn again with the new color
+   */
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (self));
   g_object_notify_by_pspec (G_OBJECT (self), pspec);
   if (other)
     g_object_notify_by_pspec (G_OBJECT (self), other);
@@ -3363,6 +5039,8 @@ clutter_text_class_init (ClutterTextClass *klass)
   gobject_class->dispose = clutter_text_dispose;
   gobject_class->finalize = clutter_text_finalize;
 
+  quark_layout_lines = g_quark_from_static_string ("clutter-text-layout-lines");
+
   actor_class->paint = clutter_text_paint;
   actor_class->get_paint_volume = clutter_text_get_paint_volume;
   actor_class->get_preferred_width = clutter_text_get_preferred_width;
@@ -3869,6 +5547,43 @@ clutter_text_class_init (ClutterTextClass *klass)
   obj_props[PROP_SELECTED_TEXT_COLOR_SET] = pspec;
   g_object_class_install_property (gobject_class, PROP_SELECTED_TEXT_COLOR_SET, pspec);
 
+  /**
+   * ClutterText:async-layout:
+   *
+   * Whether the size of a non-editable #ClutterText should be measured
+   * on a worker thread.
+   *
+   * See clutter_text_set_async_layout().
+   *
+   * Since: 1.28
+   */
+  pspec = g_param_spec_boolean ("async-layout",
+                                P_("Asynchronous Layout"),
+                                P_("Whether the text should be measured on a worker thread"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_ASYNC_LAYOUT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_ASYNC_LAYOUT, pspec);
+
+  /**
+   * ClutterText:large-document:
+   *
+   * Whether a multi-line #ClutterText should lay out its contents
+   * one paragraph at a time, and only keep the layouts of the
+   * paragraphs that are visible.
+   *
+   * See clutter_text_set_large_document().
+   *
+   * Since: 1.28
+   */
+  pspec = g_param_spec_boolean ("large-document",
+                                P_("Large Document"),
+                                P_("Whether the text should be laid out one paragraph at a time"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_LARGE_DOCUMENT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_LARGE_DOCUMENT, pspec);
+
   /**
    * ClutterText::text-changed:
    * @self: the #ClutterText that emitted the signal
@@ -4272,6 +5987,15 @@ buffer_inserted_text (ClutterTextBuffer *buffer,
   gint new_selection_bound;
 
   priv = self->priv;
+
+  /* only the paragraph containing the new text is laid out again */
+  if (priv->paragraphs != NULL &&
+      _clutter_text_paragraphs_get_length (priv->paragraphs) + n_chars == clutter_text_buffer_get_length (buffer))
+    _clutter_text_paragraphs_insert_text (priv->paragraphs,
+                                          buffer,
+                                          position,
+                                          n_chars);
+
   if (priv->position >= 0 || priv->selection_bound >= 0)
     {
       new_position = priv->position;
@@ -4300,6 +6024,17 @@ buffer_deleted_text (ClutterTextBuffer *buffer,
   gint new_selection_bound;
 
   priv = self->priv;
+
+  /* only the paragraphs spanned by the deleted text are merged and
+   * laid out again
+   */
+  if (priv->paragraphs != NULL &&
+      _clutter_text_paragraphs_get_length (priv->paragraphs) == clutter_text_buffer_get_length (buffer) + n_chars)
+    _clutter_text_paragraphs_delete_text (priv->paragraphs,
+                                          buffer,
+                                          position,
+                                          n_chars);
+
   if (priv->position >= 0 || priv->selection_bound >= 0)
     {
       new_position = priv->position;
@@ -4322,7 +6057,7 @@ buffer_notify_text (ClutterTextBuffer *buffer,
 {
   g_object_freeze_notify (G_OBJECT (self));
 
-  clutter_text_dirty_cache (self);
+  clutter_text_dirty_contents (self);
 
   clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
 
@@ -4808,8 +6543,8 @@ clutter_text_get_selection (ClutterText *self)
     }
 
   text = clutter_text_buffer_get_text (get_buffer (self));
-  start_offset = offset_to_bytes (text, start_index);
-  end_offset = offset_to_bytes (text, end_index);
+  start_offset = _clutter_text_buffer_offset_to_bytes (get_buffer (self), start_index);
+  end_offset = _clutter_text_buffer_offset_to_bytes (get_buffer (self), end_index);
   len = end_offset - start_offset;
 
   str = g_malloc (len + 1);
@@ -5243,6 +6978,10 @@ clutter_text_set_markup (ClutterText *self,
  *
  * Retrieves the current #PangoLayout used by a #ClutterText actor.
  *
+ * The returned layout is private to @self, even if the layouts of
+ * non-editable #ClutterText actors showing the same contents are
+ * otherwise shared.
+ *
  * Return value: (transfer none): a #PangoLayout. The returned object is owned by
  *   the #ClutterText actor and should not be modified or freed
  *
@@ -5251,16 +6990,35 @@ clutter_text_set_markup (ClutterText *self,
 PangoLayout *
 clutter_text_get_layout (ClutterText *self)
 {
-  gfloat width, height;
+  ClutterTextPrivate *priv;
+  PangoLayout *layout;
+  gint i;
 
   g_return_val_if_fail (CLUTTER_IS_TEXT (self), NULL);
 
-  if (self->priv->editable && self->priv->single_line_mode)
-    return clutter_text_create_layout (self, -1, -1);
+  layout = clutter_text_get_current_layout (self);
+  if (!_clutter_text_layout_cache_is_shared (layout))
+    return layout;
 
-  clutter_actor_get_size (CLUTTER_ACTOR (self), &width, &height);
+  /* the layout we return can be modified by the caller, so it cannot
+   * be one of the layouts shared with other actors; we replace it with
+   * a private copy, which is kept until the contents change
+   */
+  priv = self->priv;
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      if (priv->cached_layouts[i].layout != layout)
+        continue;
 
-  return clutter_text_create_layout (self, width, height);
+      priv->cached_layouts[i].layout = pango_layout_copy (layout);
+      priv->cached_layouts[i].is_copy = TRUE;
+      cogl_pango_ensure_glyph_cache_for_layout (priv->cached_layouts[i].layout);
+      g_object_unref (layout);
+
+      return priv->cached_layouts[i].layout;
+    }
+
+  return layout;
 }
 
 /**
@@ -6103,8 +7861,8 @@ clutter_text_get_chars (ClutterText *self,
   start_pos = MIN (n_chars, start_pos);
   end_pos = MIN (n_chars, end_pos);
 
-  start_index = g_utf8_offset_to_pointer (text, start_pos) - text;
-  end_index   = g_utf8_offset_to_pointer (text, end_pos) - text;
+  start_index = _clutter_text_buffer_offset_to_bytes (get_buffer (self), start_pos);
+  end_index   = _clutter_text_buffer_offset_to_bytes (get_buffer (self), end_pos);
 
   return g_strndup (text + start_index, end_index - start_index);
 }
@@ -6243,7 +8001,10 @@ clutter_text_set_preedit_string (ClutterText   *self,
       priv->preedit_set = TRUE;
     }
 
-  clutter_text_dirty_cache (self);
+  /* the paragraphs are not used while the preedit string is shown,
+   * but the buffer did not change, so they are kept for later
+   */
+  clutter_text_dirty_layouts (self);
   clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
 }
 
@@ -6298,3 +8059,133 @@ clutter_text_get_cursor_rect (ClutterText *self,
 
   *rect = self->priv->cursor_rect;
 }
+
+/**
+ * clutter_text_set_async_layout:
+ * @self: a #ClutterText
+ * @async_layout: whether to measure the text on a worker thread
+ *
+ * Sets whether the size of @self should be measured on a worker
+ * thread. This only applies to non-editable #ClutterText actors.
+ *
+ * Populating a container with many #ClutterText actors requires
+ * laying out the text of each one of them, to compute their preferred
+ * size, even if most of them are not going to be visible. When
+ * @async_layout is %TRUE, the text is laid out on a worker thread,
+ * and @self reports an estimate of its size until the measurement
+ * completes, at which point it queues a relayout. The #PangoLayout
+ * used to paint @self is only created when @self is painted, and the
+ * paint volume of @self is its allocation.
+ *
+ * Since: 1.28
+ */
+void
+clutter_text_set_async_layout (ClutterText *self,
+                               gboolean     async_layout)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  async_layout = !!async_layout;
+
+  if (priv->async_layout != async_layout)
+    {
+      priv->async_layout = async_layout;
+
+      clutter_text_clear_async_extents (self);
+      clutter_text_dirty_paint_volume (self);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ASYNC_LAYOUT]);
+    }
+}
+
+/**
+ * clutter_text_get_async_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves whether the size of @self is measured on a worker thread.
+ *
+ * Return value: %TRUE if the text is measured asynchronously
+ *
+ * Since: 1.28
+ */
+gboolean
+clutter_text_get_async_layout (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->async_layout;
+}
+
+/**
+ * clutter_text_set_large_document:
+ * @self: a #ClutterText
+ * @large_document: whether to lay out the text one paragraph at a time
+ *
+ * Sets whether @self should lay out its contents one paragraph at a
+ * time. This only applies to multi-line #ClutterText actors without a
+ * #ClutterText:password-char.
+ *
+ * A single #PangoLayout for a text of a few megabytes, like a log file,
+ * keeps the shaped glyphs of every line in memory. When
+ * @large_document is %TRUE, each paragraph of the text is laid out on
+ * its own, and only the paragraphs close to the visible part of @self
+ * are kept laid out; the height of the paragraphs that were never laid
+ * out is estimated from the metrics of the font, and @self queues a
+ * relayout when painting replaces an estimate with the real height.
+ *
+ * The cursor and selection API keeps working in terms of the whole
+ * text. If @self is editable, each edit only lays out again the
+ * paragraphs it touched; while an input method shows a preedit string,
+ * the whole text is laid out instead. The #ClutterText:ellipsize
+ * property only applies to each line of text that is not wrapped,
+ * and clutter_text_get_layout() still returns a layout of the whole
+ * text, which defeats the purpose of this mode. The paint volume of @self is its allocation.
+ *
+ * Since: 1.28
+ */
+void
+clutter_text_set_large_document (ClutterText *self,
+                                 gboolean     large_document)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  large_document = !!large_document;
+
+  if (priv->large_document != large_document)
+    {
+      priv->large_document = large_document;
+
+      clutter_text_dirty_cache (self);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_LARGE_DOCUMENT]);
+    }
+}
+
+/**
+ * clutter_text_get_large_document:
+ * @self: a #ClutterText
+ *
+ * Retrieves whether @self lays out its contents one paragraph at a
+ * time.
+ *
+ * Return value: %TRUE if the text is laid out one paragraph at a time
+ *
+ * Since: 1.28
+ */
+gboolean
+clutter_text_get_large_document (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->large_document;
+}
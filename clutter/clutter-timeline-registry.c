@@ -0,0 +1,181 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTimelineRegistry: the set of running timelines of a master clock.
+ *
+ * The registry only holds the timelines that are playing: delayed and
+ * paused timelines are not part of it. Each timeline knows its position
+ * inside the registry, so adding and removing a timeline does not
+ * depend on the number of running timelines, and advancing them does
+ * not need to copy the set, or to take references on the timelines:
+ * a timeline removed while the registry is being advanced leaves a hole
+ * behind, which is skipped, and compacted once all the timelines have
+ * been advanced.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-timeline-registry.h"
+
+#include "clutter-master-clock.h"
+
+void
+_clutter_timeline_registry_init (ClutterTimelineRegistry *registry)
+{
+  registry->timelines = g_ptr_array_new ();
+  registry->n_timelines = 0;
+  registry->is_advancing = FALSE;
+}
+
+void
+_clutter_timeline_registry_clear (ClutterTimelineRegistry *registry)
+{
+  guint i;
+
+  for (i = 0; i < registry->timelines->len; i++)
+    {
+      ClutterTimeline *timeline = g_ptr_array_index (registry->timelines, i);
+
+      if (timeline != NULL)
+        _clutter_timeline_set_registry_index (timeline, -1);
+    }
+
+  g_ptr_array_unref (registry->timelines);
+  registry->timelines = NULL;
+  registry->n_timelines = 0;
+}
+
+/*< private >
+ * _clutter_timeline_registry_add:
+ * @registry: a #ClutterTimelineRegistry
+ * @timeline: a running #ClutterTimeline
+ *
+ * Adds @timeline to the running timelines. A timeline added while the
+ * registry is being advanced is only advanced on the next frame.
+ *
+ * Return value: %TRUE if @timeline is the only running timeline
+ */
+gboolean
+_clutter_timeline_registry_add (ClutterTimelineRegistry *registry,
+                                ClutterTimeline         *timeline)
+{
+  if (_clutter_timeline_get_registry_index (timeline) >= 0)
+    return FALSE;
+
+  _clutter_timeline_set_registry_index (timeline, registry->timelines->len);
+  g_ptr_array_add (registry->timelines, timeline);
+
+  registry->n_timelines += 1;
+
+  return registry->n_timelines == 1;
+}
+
+void
+_clutter_timeline_registry_remove (ClutterTimelineRegistry *registry,
+                                   ClutterTimeline         *timeline)
+{
+  gint index_ = _clutter_timeline_get_registry_index (timeline);
+  guint last;
+
+  if (index_ < 0)
+    return;
+
+  _clutter_timeline_set_registry_index (timeline, -1);
+  registry->n_timelines -= 1;
+
+  if (registry->is_advancing)
+    {
+      g_ptr_array_index (registry->timelines, index_) = NULL;
+      return;
+    }
+
+  /* move the last timeline into the slot */
+  last = registry->timelines->len - 1;
+  if ((guint) index_ != last)
+    {
+      ClutterTimeline *moved = g_ptr_array_index (registry->timelines, last);
+
+      g_ptr_array_index (registry->timelines, index_) = moved;
+      _clutter_timeline_set_registry_index (moved, index_);
+    }
+
+  g_ptr_array_set_size (registry->timelines, last);
+}
+
+gboolean
+_clutter_timeline_registry_is_empty (ClutterTimelineRegistry *registry)
+{
+  return registry->n_timelines == 0;
+}
+
+/*< private >
+ * _clutter_timeline_registry_advance:
+ * @registry: a #ClutterTimelineRegistry
+ * @tick_time: the time of the frame, in milliseconds
+ *
+ * Advances all the running timelines.
+ */
+void
+_clutter_timeline_registry_advance (ClutterTimelineRegistry *registry,
+                                    gint64                   tick_time)
+{
+  guint i, j, n_timelines;
+
+  g_assert (!registry->is_advancing);
+
+  /* the timelines added while advancing are appended after the
+   * ones we are going to advance
+   */
+  n_timelines = registry->timelines->len;
+
+  registry->is_advancing = TRUE;
+
+  for (i = 0; i < n_timelines; i++)
+    {
+      ClutterTimeline *timeline = g_ptr_array_index (registry->timelines, i);
+
+      if (timeline != NULL)
+        _clutter_timeline_do_tick (timeline, tick_time);
+    }
+
+  registry->is_advancing = FALSE;
+
+  if (registry->n_timelines == registry->timelines->len)
+    return;
+
+  /* fill the holes left by the timelines removed in the meantime */
+  for (i = 0, j = 0; i < registry->timelines->len; i++)
+    {
+      ClutterTimeline *timeline = g_ptr_array_index (registry->timelines, i);
+
+      if (timeline == NULL)
+        continue;
+
+      if (i != j)
+        {
+          g_ptr_array_index (registry->timelines, j) = timeline;
+          _clutter_timeline_set_registry_index (timeline, j);
+        }
+
+      j += 1;
+    }
+
+  g_ptr_array_set_size (registry->timelines, j);
+}
@@ -0,0 +1,58 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTimelineRegistry: the set of running timelines of a master clock.
+ */
+
+#ifndef __CLUTTER_TIMELINE_REGISTRY_H__
+#define __CLUTTER_TIMELINE_REGISTRY_H__
+
+#include <clutter/clutter-timeline.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTimelineRegistry ClutterTimelineRegistry;
+
+struct _ClutterTimelineRegistry
+{
+  /* the running timelines; while the timelines are advanced, removed
+   * timelines leave a NULL hole, which is compacted afterwards
+   */
+  GPtrArray *timelines;
+
+  guint n_timelines;
+
+  guint is_advancing : 1;
+};
+
+void            _clutter_timeline_registry_init         (ClutterTimelineRegistry *registry);
+void            _clutter_timeline_registry_clear        (ClutterTimelineRegistry *registry);
+
+gboolean        _clutter_timeline_registry_add          (ClutterTimelineRegistry *registry,
+                                                         ClutterTimeline         *timeline);
+void            _clutter_timeline_registry_remove       (ClutterTimelineRegistry *registry,
+                                                         ClutterTimeline         *timeline);
+
+gboolean        _clutter_timeline_registry_is_empty     (ClutterTimelineRegistry *registry);
+
+void            _clutter_timeline_registry_advance      (ClutterTimelineRegistry *registry,
+                                                         gint64                   tick_time);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TIMELINE_REGISTRY_H__ */
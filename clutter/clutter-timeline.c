@@ -114,7 +114,15 @@ struct _ClutterTimelinePrivate
 {
   ClutterTimelineDirection direction;
 
-  guint delay_id;
+  /* the position of the timeline in the queue of delayed timelines,
+   * or -1, and the time at which the delay expires, in microseconds
+   */
+  gint delay_index;
+  gint64 delay_deadline;
+  guint64 delay_sequence;
+
+  /* the position of the timeline in the registry of the master clock */
+  gint registry_index;
 
   /* The total length in milliseconds of this timeline */
   guint duration;
@@ -128,6 +136,15 @@ struct _ClutterTimelinePrivate
 
   GHashTable *markers_by_name;
 
+  /* the markers sorted by their position, and the index of the first
+   * marker after the range checked by the last frame
+   */
+  GPtrArray *markers_by_time;
+  guint marker_cursor;
+
+  /* bumped each time the markers change */
+  guint markers_age;
+
   /* Time we last advanced the elapsed time and showed a frame */
   gint64 last_frame_time;
 
@@ -150,6 +167,9 @@ struct _ClutterTimelinePrivate
   ClutterPoint cb_1;
   ClutterPoint cb_2;
 
+  /* the precomputed easing curve, if enabled and available */
+  ClutterEasingTable *progress_table;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -157,6 +177,7 @@ struct _ClutterTimelinePrivate
    */
   guint waiting_first_tick : 1;
   guint auto_reverse       : 1;
+  guint use_progress_table : 1;
 };
 
 typedef struct {
@@ -168,6 +189,12 @@ typedef struct {
     gdouble progress;
   } data;
 
+  /* the position in milliseconds, resolved against the duration of
+   * the timeline, and the order of insertion to break ties
+   */
+  guint position;
+  guint sequence;
+
   guint is_relative : 1;
 } TimelineMarker;
 
@@ -182,6 +209,7 @@ enum
   PROP_AUTO_REVERSE,
   PROP_REPEAT_COUNT,
   PROP_PROGRESS_MODE,
+  PROP_USE_PROGRESS_TABLE,
 
   PROP_LAST
 };
@@ -203,12 +231,16 @@ enum
 static guint timeline_signals[LAST_SIGNAL] = { 0, };
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
+static void delay_queue_remove (ClutterTimeline *timeline);
+static void clutter_timeline_update_progress_table (ClutterTimeline *timeline);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterTimeline, clutter_timeline, G_TYPE_OBJECT,
                          G_ADD_PRIVATE (ClutterTimeline)
                          G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_SCRIPTABLE,
                                                 clutter_scriptable_iface_init))
 
+#define TIMELINE_MARKER_AT(markers,i)   ((TimelineMarker *) g_ptr_array_index ((markers), (i)))
+
 static TimelineMarker *
 timeline_marker_new_time (const gchar *name,
                           guint        msecs)
@@ -249,12 +281,108 @@ timeline_marker_free (gpointer data)
     }
 }
 
+static guint
+timeline_marker_resolve (const TimelineMarker *marker,
+                         guint                 duration)
+{
+  if (marker->is_relative)
+    return marker->data.progress * duration;
+
+  return marker->data.msecs;
+}
+
+static gint
+timeline_marker_compare (gconstpointer a,
+                         gconstpointer b)
+{
+  const TimelineMarker *marker_a = *(const TimelineMarker **) a;
+  const TimelineMarker *marker_b = *(const TimelineMarker **) b;
+
+  if (marker_a->position != marker_b->position)
+    return marker_a->position < marker_b->position ? -1 : 1;
+
+  if (marker_a->sequence != marker_b->sequence)
+    return marker_a->sequence < marker_b->sequence ? -1 : 1;
+
+  return 0;
+}
+
+/*< private >
+ * timeline_markers_bisect:
+ * @markers: the markers sorted by time
+ * @position: a position, in milliseconds
+ * @sequence: a sequence number, or 0
+ *
+ * Retrieves the index of the first marker in @markers that is not
+ * placed before @position, or at @position but inserted before
+ * @sequence.
+ *
+ * Return value: an index between 0 and the number of markers
+ */
+static guint
+timeline_markers_bisect (GPtrArray *markers,
+                         gint64     position,
+                         guint      sequence)
+{
+  guint lo = 0, hi = markers->len;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+      const TimelineMarker *marker = g_ptr_array_index (markers, mid);
+
+      if (marker->position < position ||
+          (marker->position == position && marker->sequence < sequence))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/*< private >
+ * clutter_timeline_update_markers:
+ * @timeline: a #ClutterTimeline
+ *
+ * Resolves the position of the markers relative to the duration of
+ * @timeline, and sorts them again.
+ */
+static void
+clutter_timeline_update_markers (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gboolean has_relative = FALSE;
+  guint i;
+
+  if (priv->markers_by_time == NULL)
+    return;
+
+  for (i = 0; i < priv->markers_by_time->len; i++)
+    {
+      TimelineMarker *marker = g_ptr_array_index (priv->markers_by_time, i);
+
+      if (marker->is_relative)
+        {
+          marker->position = timeline_marker_resolve (marker, priv->duration);
+          has_relative = TRUE;
+        }
+    }
+
+  if (!has_relative)
+    return;
+
+  g_ptr_array_sort (priv->markers_by_time, timeline_marker_compare);
+  priv->markers_age += 1;
+}
+
 /*< private >
  * clutter_timeline_add_marker_internal:
  * @timeline: a #ClutterTimeline
  * @marker: a TimelineMarker
  *
- * Adds @marker into the hash table of markers for @timeline.
+ * Adds @marker into the hash table of markers for @timeline, and
+ * into the list of markers sorted by time.
  *
  * The TimelineMarker will either be added or, in case of collisions
  * with another existing marker, freed. In any case, this function
@@ -266,31 +394,38 @@ clutter_timeline_add_marker_internal (ClutterTimeline *timeline,
 {
   ClutterTimelinePrivate *priv = timeline->priv;
   TimelineMarker *old_marker;
+  guint index_;
 
   /* create the hash table that will hold the markers */
   if (G_UNLIKELY (priv->markers_by_name == NULL))
-    priv->markers_by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                                   NULL,
-                                                   timeline_marker_free);
+    {
+      priv->markers_by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     NULL,
+                                                     timeline_marker_free);
+      priv->markers_by_time = g_ptr_array_new ();
+    }
 
   old_marker = g_hash_table_lookup (priv->markers_by_name, marker->name);
   if (old_marker != NULL)
     {
-      guint msecs;
-
-      if (old_marker->is_relative)
-        msecs = old_marker->data.progress * priv->duration;
-      else
-        msecs = old_marker->data.msecs;
-
       g_warning ("A marker named '%s' already exists at time %d",
                  old_marker->name,
-                 msecs);
+                 old_marker->position);
       timeline_marker_free (marker);
       return;
     }
 
   g_hash_table_insert (priv->markers_by_name, marker->name, marker);
+
+  /* the new marker goes after the markers at the same position */
+  priv->markers_age += 1;
+  marker->position = timeline_marker_resolve (marker, priv->duration);
+  marker->sequence = priv->markers_age;
+
+  index_ = timeline_markers_bisect (priv->markers_by_time,
+                                    marker->position,
+                                    marker->sequence);
+  g_ptr_array_insert (priv->markers_by_time, index_, marker);
 }
 
 static inline void
@@ -474,6 +609,10 @@ clutter_timeline_set_property (GObject      *object,
       clutter_timeline_set_progress_mode (timeline, g_value_get_enum (value));
       break;
 
+    case PROP_USE_PROGRESS_TABLE:
+      clutter_timeline_set_use_progress_table (timeline, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -519,6 +658,10 @@ clutter_timeline_get_property (GObject    *object,
       g_value_set_enum (value, priv->progress_mode);
       break;
 
+    case PROP_USE_PROGRESS_TABLE:
+      g_value_set_boolean (value, priv->use_progress_table);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -535,6 +678,12 @@ clutter_timeline_finalize (GObject *object)
   if (priv->markers_by_name)
     g_hash_table_destroy (priv->markers_by_name);
 
+  if (priv->markers_by_time)
+    g_ptr_array_unref (priv->markers_by_time);
+
+  if (priv->progress_table != NULL)
+    clutter_easing_table_unref (priv->progress_table);
+
   if (priv->is_playing)
     {
       master_clock = _clutter_master_clock_get_default ();
@@ -552,11 +701,8 @@ clutter_timeline_dispose (GObject *object)
 
   priv = self->priv;
 
-  if (priv->delay_id)
-    {
-      g_source_remove (priv->delay_id);
-      priv->delay_id = 0;
-    }
+  if (priv->delay_index >= 0)
+    delay_queue_remove (self);
 
   if (priv->progress_notify != NULL)
     {
@@ -691,6 +837,23 @@ clutter_timeline_class_init (ClutterTimelineClass *klass)
                        CLUTTER_LINEAR,
                        CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterTimeline:use-progress-table:
+   *
+   * Whether the #ClutterTimeline should look the progress up in a
+   * precomputed table of the easing curve.
+   *
+   * See clutter_timeline_set_use_progress_table().
+   *
+   * Since: 1.28
+   */
+  obj_props[PROP_USE_PROGRESS_TABLE] =
+    g_param_spec_boolean ("use-progress-table",
+                          P_("Use Progress Table"),
+                          P_("Whether the progress should be looked up in a precomputed table"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
   object_class->dispose = clutter_timeline_dispose;
   object_class->finalize = clutter_timeline_finalize;
   object_class->set_property = clutter_timeline_set_property;
@@ -847,6 +1010,9 @@ clutter_timeline_init (ClutterTimeline *self)
 
   self->priv->progress_mode = CLUTTER_LINEAR;
 
+  self->priv->delay_index = -1;
+  self->priv->registry_index = -1;
+
   /* default steps() parameters are 1, end */
   self->priv->n_steps = 1;
   self->priv->step_mode = CLUTTER_STEP_MODE_END;
@@ -856,98 +1022,118 @@ clutter_timeline_init (ClutterTimeline *self)
   clutter_point_init (&self->priv->cb_2, 1, 1);
 }
 
-struct CheckIfMarkerHitClosure
+static void
+check_markers (ClutterTimeline *timeline,
+               gint delta)
 {
-  ClutterTimeline *timeline;
+  ClutterTimelinePrivate *priv = timeline->priv;
+  GPtrArray *markers = priv->markers_by_time;
   ClutterTimelineDirection direction;
-  gint new_time;
-  gint duration;
-  gint delta;
-};
+  gint64 new_time, duration;
+  gint64 first, last;
+  guint i;
 
-static gboolean
-have_passed_time (const struct CheckIfMarkerHitClosure *data,
-                  gint msecs)
-{
-  /* Ignore markers that are outside the duration of the timeline */
-  if (msecs < 0 || msecs > data->duration)
-    return FALSE;
+  /* shortcircuit here if we don't have any marker installed */
+  if (markers == NULL || markers->len == 0)
+    return;
 
-  if (data->direction == CLUTTER_TIMELINE_FORWARD)
+  /* store the details of the timeline so that changing them in a
+     marker signal handler won't affect which markers are hit */
+  direction = priv->direction;
+  new_time = priv->elapsed_time;
+  duration = priv->duration;
+
+  /* the range of positions crossed by this frame */
+  if (direction == CLUTTER_TIMELINE_FORWARD)
     {
+      first = new_time - delta + 1;
+      last = new_time;
+
       /* We need to special case when a marker is added at the
          beginning of the timeline */
-      if (msecs == 0 &&
-          data->delta > 0 &&
-          data->new_time - data->delta <= 0)
-        return TRUE;
-
-      /* Otherwise it's just a simple test if the time is in range of
-         the previous time and the new time */
-      return (msecs > data->new_time - data->delta &&
-              msecs <= data->new_time);
+      if (delta > 0 && new_time - delta <= 0)
+        first = 0;
     }
   else
     {
+      first = new_time;
+      last = new_time + delta - 1;
+
       /* We need to special case when a marker is added at the
          end of the timeline */
-      if (msecs == data->duration &&
-          data->delta > 0 &&
-          data->new_time + data->delta >= data->duration)
-        return TRUE;
-
-      /* Otherwise it's just a simple test if the time is in range of
-         the previous time and the new time */
-      return (msecs >= data->new_time &&
-              msecs < data->new_time + data->delta);
+      if (delta > 0 && new_time + delta >= duration)
+        last = duration;
     }
-}
 
-static void
-check_if_marker_hit (const gchar *name,
-                     TimelineMarker *marker,
-                     struct CheckIfMarkerHitClosure *data)
-{
-  gint msecs;
+  /* Ignore markers that are outside the duration of the timeline */
+  first = MAX (first, 0);
+  last = MIN (last, duration);
 
-  if (marker->is_relative)
-    msecs = (gdouble) data->duration * marker->data.progress;
+  if (first > last)
+    return;
+
+  /* the frames usually start where the previous frame stopped, so we
+   * can avoid the bisection by checking the cursor first
+   */
+  i = priv->marker_cursor;
+  if (direction == CLUTTER_TIMELINE_FORWARD)
+    {
+      if (!(i <= markers->len &&
+            (i == 0 || TIMELINE_MARKER_AT (markers, i - 1)->position < first) &&
+            (i == markers->len || TIMELINE_MARKER_AT (markers, i)->position >= first)))
+        i = timeline_markers_bisect (markers, first, 0);
+    }
   else
-    msecs = marker->data.msecs;
+    {
+      if (!(i <= markers->len &&
+            (i == 0 || TIMELINE_MARKER_AT (markers, i - 1)->position <= last) &&
+            (i == markers->len || TIMELINE_MARKER_AT (markers, i)->position > last)))
+        i = timeline_markers_bisect (markers, last + 1, 0);
+    }
 
-  if (have_passed_time (data, msecs))
+  /* going backwards, the markers are reached in reverse order */
+  while (direction == CLUTTER_TIMELINE_FORWARD
+           ? (i < markers->len && TIMELINE_MARKER_AT (markers, i)->position <= last)
+           : (i > 0 && TIMELINE_MARKER_AT (markers, i - 1)->position >= first))
     {
-      CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", name);
+      TimelineMarker *marker;
+      guint position, sequence, age;
 
-      g_signal_emit (data->timeline, timeline_signals[MARKER_REACHED],
+      if (direction == CLUTTER_TIMELINE_FORWARD)
+        marker = TIMELINE_MARKER_AT (markers, i++);
+      else
+        marker = TIMELINE_MARKER_AT (markers, --i);
+
+      position = marker->position;
+      sequence = marker->sequence;
+      age = priv->markers_age;
+
+      CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", marker->name);
+
+      g_signal_emit (timeline, timeline_signals[MARKER_REACHED],
                      marker->quark,
-                     name,
-                     msecs);
-    }
-}
+                     marker->name,
+                     (gint) position);
 
-static void
-check_markers (ClutterTimeline *timeline,
-               gint delta)
-{
-  ClutterTimelinePrivate *priv = timeline->priv;
-  struct CheckIfMarkerHitClosure data;
+      /* the handlers may have added or removed markers, so we need
+       * to find our place again
+       */
+      if (priv->markers_age != age)
+        {
+          markers = priv->markers_by_time;
+          if (markers == NULL)
+            return;
 
-  /* shortcircuit here if we don't have any marker installed */
-  if (priv->markers_by_name == NULL)
-    return;
+          i = timeline_markers_bisect (markers, position, sequence);
 
-  /* store the details of the timeline so that changing them in a
-     marker signal handler won't affect which markers are hit */
-  data.timeline = timeline;
-  data.direction = priv->direction;
-  data.new_time = priv->elapsed_time;
-  data.duration = priv->duration;
-  data.delta = delta;
+          if (direction == CLUTTER_TIMELINE_FORWARD &&
+              i < markers->len &&
+              TIMELINE_MARKER_AT (markers, i)->sequence == sequence)
+            i += 1;
+        }
+    }
 
-  g_hash_table_foreach (priv->markers_by_name,
-                        (GHFunc) check_if_marker_hit,
-                        &data);
+  priv->marker_cursor = i;
 }
 
 static void
@@ -1156,19 +1342,182 @@ clutter_timeline_do_frame (ClutterTimeline *timeline)
     }
 }
 
-static gboolean
-delay_timeout_func (gpointer data)
+static void
+timeline_delay_expired (ClutterTimeline *timeline)
 {
-  ClutterTimeline *timeline = data;
   ClutterTimelinePrivate *priv = timeline->priv;
 
-  priv->delay_id = 0;
   priv->msecs_delta = 0;
   set_is_playing (timeline, TRUE);
 
   g_signal_emit (timeline, timeline_signals[STARTED], 0);
+}
+
+/* the delayed timelines are kept in a binary heap ordered by their
+ * deadline, and a single source wakes up when the earliest deadline
+ * expires; timelines with the same deadline start in the order in
+ * which they were queued
+ */
+static GPtrArray *delay_queue = NULL;
+static GSource *delay_source = NULL;
+static guint64 delay_queue_sequence = 0;
+
+#define DELAY_QUEUE_NTH(n)      ((ClutterTimeline *) g_ptr_array_index (delay_queue, (n)))
+
+static inline gboolean
+delay_queue_less (ClutterTimeline *a,
+                  ClutterTimeline *b)
+{
+  if (a->priv->delay_deadline != b->priv->delay_deadline)
+    return a->priv->delay_deadline < b->priv->delay_deadline;
+
+  return a->priv->delay_sequence < b->priv->delay_sequence;
+}
+
+static inline void
+delay_queue_set (guint            index_,
+                 ClutterTimeline *timeline)
+{
+  g_ptr_array_index (delay_queue, index_) = timeline;
+  timeline->priv->delay_index = index_;
+}
+
+static void
+delay_queue_sift_up (guint index_)
+{
+  ClutterTimeline *timeline = DELAY_QUEUE_NTH (index_);
+
+  while (index_ > 0)
+    {
+      guint parent = (index_ - 1) / 2;
+
+      if (!delay_queue_less (timeline, DELAY_QUEUE_NTH (parent)))
+        break;
+
+      delay_queue_set (index_, DELAY_QUEUE_NTH (parent));
+      index_ = parent;
+    }
 
-  return FALSE;
+  delay_queue_set (index_, timeline);
+}
+
+static void
+delay_queue_sift_down (guint index_)
+{
+  ClutterTimeline *timeline = DELAY_QUEUE_NTH (index_);
+  guint len = delay_queue->len;
+
+  while (TRUE)
+    {
+      guint child = index_ * 2 + 1;
+
+      if (child >= len)
+        break;
+
+      if (child + 1 < len &&
+          delay_queue_less (DELAY_QUEUE_NTH (child + 1), DELAY_QUEUE_NTH (child)))
+        child += 1;
+
+      if (!delay_queue_less (DELAY_QUEUE_NTH (child), timeline))
+        break;
+
+      delay_queue_set (index_, DELAY_QUEUE_NTH (child));
+      index_ = child;
+    }
+
+  delay_queue_set (index_, timeline);
+}
+
+static void
+delay_queue_update_source (void)
+{
+  if (delay_queue->len == 0)
+    g_source_set_ready_time (delay_source, -1);
+  else
+    g_source_set_ready_time (delay_source, DELAY_QUEUE_NTH (0)->priv->delay_deadline);
+}
+
+static void
+delay_queue_remove (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  guint index_ = priv->delay_index;
+  guint last = delay_queue->len - 1;
+
+  priv->delay_index = -1;
+
+  if (index_ != last)
+    {
+      delay_queue_set (index_, DELAY_QUEUE_NTH (last));
+      g_ptr_array_set_size (delay_queue, last);
+
+      /* the last timeline can go either way from its new position */
+      timeline = DELAY_QUEUE_NTH (index_);
+      delay_queue_sift_up (index_);
+      delay_queue_sift_down (timeline->priv->delay_index);
+    }
+  else
+    g_ptr_array_set_size (delay_queue, last);
+
+  delay_queue_update_source ();
+}
+
+static gboolean
+delay_source_dispatch (GSource     *source,
+                       GSourceFunc  callback,
+                       gpointer     user_data)
+{
+  gint64 now = g_source_get_time (source);
+
+  _clutter_threads_acquire_lock ();
+
+  while (delay_queue->len > 0 &&
+         DELAY_QUEUE_NTH (0)->priv->delay_deadline <= now)
+    {
+      ClutterTimeline *timeline = g_object_ref (DELAY_QUEUE_NTH (0));
+
+      delay_queue_remove (timeline);
+      timeline_delay_expired (timeline);
+
+      g_object_unref (timeline);
+    }
+
+  delay_queue_update_source ();
+
+  _clutter_threads_release_lock ();
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs delay_source_funcs = {
+  NULL,
+  NULL,
+  delay_source_dispatch,
+  NULL
+};
+
+static void
+delay_queue_add (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  if (G_UNLIKELY (delay_queue == NULL))
+    {
+      delay_queue = g_ptr_array_new ();
+
+      delay_source = g_source_new (&delay_source_funcs, sizeof (GSource));
+      g_source_set_name (delay_source, "Clutter timeline delays");
+      g_source_set_ready_time (delay_source, -1);
+      g_source_attach (delay_source, NULL);
+    }
+
+  priv->delay_deadline = g_get_monotonic_time () + (gint64) priv->delay * 1000;
+  priv->delay_sequence = delay_queue_sequence++;
+
+  g_ptr_array_add (delay_queue, timeline);
+  delay_queue_sift_up (delay_queue->len - 1);
+
+  delay_queue_update_source ();
 }
 
 /**
@@ -1186,16 +1535,14 @@ clutter_timeline_start (ClutterTimeline *timeline)
 
   priv = timeline->priv;
 
-  if (priv->delay_id || priv->is_playing)
+  if (priv->delay_index >= 0 || priv->is_playing)
     return;
 
   if (priv->duration == 0)
     return;
 
   if (priv->delay)
-    priv->delay_id = clutter_threads_add_timeout (priv->delay,
-                                                  delay_timeout_func,
-                                                  timeline);
+    delay_queue_add (timeline);
   else
     {
       priv->msecs_delta = 0;
@@ -1220,14 +1567,11 @@ clutter_timeline_pause (ClutterTimeline *timeline)
 
   priv = timeline->priv;
 
-  if (priv->delay_id == 0 && !priv->is_playing)
+  if (priv->delay_index < 0 && !priv->is_playing)
     return;
 
-  if (priv->delay_id)
-    {
-      g_source_remove (priv->delay_id);
-      priv->delay_id = 0;
-    }
+  if (priv->delay_index >= 0)
+    delay_queue_remove (timeline);
 
   priv->msecs_delta = 0;
   set_is_playing (timeline, FALSE);
@@ -1565,6 +1909,9 @@ clutter_timeline_set_duration (ClutterTimeline *timeline,
     {
       priv->duration = msecs;
 
+      /* the position of the relative markers depends on the duration */
+      clutter_timeline_update_markers (timeline);
+
       g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_DURATION]);
     }
 }
@@ -1847,32 +2194,6 @@ clutter_timeline_add_marker_at_time (ClutterTimeline *timeline,
   clutter_timeline_add_marker_internal (timeline, marker);
 }
 
-struct CollectMarkersClosure
-{
-  guint duration;
-  guint msecs;
-  GArray *markers;
-};
-
-static void
-collect_markers (const gchar *key,
-                 TimelineMarker *marker,
-                 struct CollectMarkersClosure *data)
-{
-  guint msecs;
-
-  if (marker->is_relative)
-    msecs = marker->data.progress * data->duration;
-  else
-    msecs = marker->data.msecs;
-
-  if (msecs == data->msecs)
-    {
-      gchar *name_copy = g_strdup (key);
-      g_array_append_val (data->markers, name_copy);
-    }
-}
-
 /**
  * clutter_timeline_list_markers:
  * @timeline: a #ClutterTimeline
@@ -1881,7 +2202,7 @@ collect_markers (const gchar *key,
  *
  * Retrieves the list of markers at time @msecs. If @msecs is a
  * negative integer, all the markers attached to @timeline will be
- * returned.
+ * returned. The markers are sorted by their position on the timeline.
  *
  * Return value: (transfer full) (array zero-terminated=1 length=n_markers):
  *   a newly allocated, %NULL terminated string array containing the names
@@ -1896,6 +2217,7 @@ clutter_timeline_list_markers (ClutterTimeline *timeline,
 {
   ClutterTimelinePrivate *priv;
   gchar **retval = NULL;
+  guint first, last;
   gsize i;
 
   g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), NULL);
@@ -1912,30 +2234,23 @@ clutter_timeline_list_markers (ClutterTimeline *timeline,
 
   if (msecs < 0)
     {
-      GList *markers, *l;
-
-      markers = g_hash_table_get_keys (priv->markers_by_name);
-      retval = g_new0 (gchar*, g_list_length (markers) + 1);
-
-      for (i = 0, l = markers; l != NULL; i++, l = l->next)
-        retval[i] = g_strdup (l->data);
-
-      g_list_free (markers);
+      first = 0;
+      last = priv->markers_by_time->len;
     }
   else
     {
-      struct CollectMarkersClosure data;
+      first = timeline_markers_bisect (priv->markers_by_time, msecs, 0);
+      last = timeline_markers_bisect (priv->markers_by_time, (gint64) msecs + 1, 0);
+    }
 
-      data.duration = priv->duration;
-      data.msecs = msecs;
-      data.markers = g_array_new (TRUE, FALSE, sizeof (gchar *));
+  retval = g_new0 (gchar *, last - first + 1);
 
-      g_hash_table_foreach (priv->markers_by_name,
-                            (GHFunc) collect_markers,
-                            &data);
+  for (i = 0; first + i < last; i++)
+    {
+      TimelineMarker *marker;
 
-      i = data.markers->len;
-      retval = (gchar **) (void *) g_array_free (data.markers, FALSE);
+      marker = TIMELINE_MARKER_AT (priv->markers_by_time, first + i);
+      retval[i] = g_strdup (marker->name);
     }
 
   if (n_markers)
@@ -1964,7 +2279,6 @@ clutter_timeline_advance_to_marker (ClutterTimeline *timeline,
 {
   ClutterTimelinePrivate *priv;
   TimelineMarker *marker;
-  guint msecs;
 
   g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
   g_return_if_fail (marker_name != NULL);
@@ -1984,12 +2298,7 @@ clutter_timeline_advance_to_marker (ClutterTimeline *timeline,
       return;
     }
 
-  if (marker->is_relative)
-    msecs = marker->data.progress * priv->duration;
-  else
-    msecs = marker->data.msecs;
-
-  clutter_timeline_advance (timeline, msecs);
+  clutter_timeline_advance (timeline, marker->position);
 }
 
 /**
@@ -2007,6 +2316,7 @@ clutter_timeline_remove_marker (ClutterTimeline *timeline,
 {
   ClutterTimelinePrivate *priv;
   TimelineMarker *marker;
+  guint index_;
 
   g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
   g_return_if_fail (marker_name != NULL);
@@ -2026,6 +2336,12 @@ clutter_timeline_remove_marker (ClutterTimeline *timeline,
       return;
     }
 
+  index_ = timeline_markers_bisect (priv->markers_by_time,
+                                    marker->position,
+                                    marker->sequence);
+  g_ptr_array_remove_index (priv->markers_by_time, index_);
+  priv->markers_age += 1;
+
   /* this will take care of freeing the marker as well */
   g_hash_table_remove (priv->markers_by_name, marker_name);
 }
@@ -2236,9 +2552,33 @@ clutter_timeline_set_progress_func (ClutterTimeline             *timeline,
   else
     priv->progress_mode = CLUTTER_LINEAR;
 
+  clutter_timeline_update_progress_table (timeline);
+
   g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_PROGRESS_MODE]);
 }
 
+static void
+clutter_timeline_update_progress_table (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  if (priv->progress_table != NULL)
+    {
+      clutter_easing_table_unref (priv->progress_table);
+      priv->progress_table = NULL;
+    }
+
+  if (!priv->use_progress_table)
+    return;
+
+  if (priv->progress_mode == CLUTTER_CUBIC_BEZIER)
+    priv->progress_table =
+      clutter_easing_table_for_cubic_bezier (priv->cb_1.x, priv->cb_1.y,
+                                             priv->cb_2.x, priv->cb_2.y);
+  else
+    priv->progress_table = clutter_easing_table_for_mode (priv->progress_mode);
+}
+
 static gdouble
 clutter_timeline_progress_func (ClutterTimeline *timeline,
                                 gdouble          elapsed,
@@ -2247,6 +2587,9 @@ clutter_timeline_progress_func (ClutterTimeline *timeline,
 {
   ClutterTimelinePrivate *priv = timeline->priv;
 
+  if (priv->progress_table != NULL)
+    return clutter_easing_table_sample (priv->progress_table, elapsed / duration);
+
   /* parametrized easing functions need to be handled separately */
   switch (priv->progress_mode)
     {
@@ -2333,6 +2676,8 @@ clutter_timeline_set_progress_mode (ClutterTimeline      *timeline,
   priv->progress_data = NULL;
   priv->progress_notify = NULL;
 
+  clutter_timeline_update_progress_table (timeline);
+
   g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_PROGRESS_MODE]);
 }
 
@@ -2514,6 +2859,9 @@ clutter_timeline_set_cubic_bezier_progress (ClutterTimeline    *timeline,
   priv->cb_2.x = CLAMP (priv->cb_2.x, 0.f, 1.f);
 
   clutter_timeline_set_progress_mode (timeline, CLUTTER_CUBIC_BEZIER);
+
+  /* the mode might not have changed, but the curve did */
+  clutter_timeline_update_progress_table (timeline);
 }
 
 /**
@@ -2553,3 +2901,85 @@ clutter_timeline_get_cubic_bezier_progress (ClutterTimeline *timeline,
 
   return TRUE;
 }
+
+/*< private >
+ * _clutter_timeline_get_registry_index:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the position of @timeline in the registry of running
+ * timelines of the master clock.
+ *
+ * Return value: the position of @timeline, or -1
+ */
+gint
+_clutter_timeline_get_registry_index (ClutterTimeline *timeline)
+{
+  return timeline->priv->registry_index;
+}
+
+void
+_clutter_timeline_set_registry_index (ClutterTimeline *timeline,
+                                      gint             index_)
+{
+  timeline->priv->registry_index = index_;
+}
+
+/**
+ * clutter_timeline_set_use_progress_table:
+ * @timeline: a #ClutterTimeline
+ * @use_table: whether to use a precomputed table of the easing curve
+ *
+ * Sets whether @timeline should compute its progress by looking it up
+ * in a precomputed table of the easing curve set using
+ * clutter_timeline_set_progress_mode() or
+ * clutter_timeline_set_cubic_bezier_progress(), instead of evaluating
+ * the curve on every frame.
+ *
+ * The tables are shared between all the timelines using the same curve,
+ * and reproduce it within a thousandth of the progress. The linear and
+ * step modes, the curves that cannot be reproduced that closely and the
+ * progress functions set using clutter_timeline_set_progress_func() are
+ * always evaluated.
+ *
+ * Since: 1.28
+ */
+void
+clutter_timeline_set_use_progress_table (ClutterTimeline *timeline,
+                                         gboolean         use_table)
+{
+  ClutterTimelinePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
+
+  priv = timeline->priv;
+
+  use_table = !!use_table;
+
+  if (priv->use_progress_table != use_table)
+    {
+      priv->use_progress_table = use_table;
+
+      clutter_timeline_update_progress_table (timeline);
+
+      g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_USE_PROGRESS_TABLE]);
+    }
+}
+
+/**
+ * clutter_timeline_get_use_progress_table:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves whether @timeline looks its progress up in a precomputed
+ * table of the easing curve.
+ *
+ * Return value: %TRUE if the progress is looked up in a table
+ *
+ * Since: 1.28
+ */
+gboolean
+clutter_timeline_get_use_progress_table (ClutterTimeline *timeline)
+{
+  g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), FALSE);
+
+  return timeline->priv->use_progress_table;
+}
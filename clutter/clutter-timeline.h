@@ -215,6 +215,11 @@ CLUTTER_AVAILABLE_IN_1_12
 gboolean                        clutter_timeline_get_cubic_bezier_progress      (ClutterTimeline          *timeline,
                                                                                  ClutterPoint             *c_1,
                                                                                  ClutterPoint             *c_2);
+CLUTTER_AVAILABLE_IN_1_28
+void                            clutter_timeline_set_use_progress_table         (ClutterTimeline          *timeline,
+                                                                                 gboolean                  use_table);
+CLUTTER_AVAILABLE_IN_1_28
+gboolean                        clutter_timeline_get_use_progress_table         (ClutterTimeline          *timeline);
 
 CLUTTER_AVAILABLE_IN_1_10
 gint64                          clutter_timeline_get_duration_hint              (ClutterTimeline          *timeline);
@@ -0,0 +1,390 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTouchTable: flat table of per-touch-point state, keyed on the
+ * device and the event sequence of each touch point.
+ *
+ * The state of each touch point lives in a slot of a flat array; slots
+ * are identified by small integers that remain stable for as long as
+ * the touch point is in the table. Lookups by device and sequence go
+ * through a small open addressing index, so they are O(1) regardless
+ * of the number of touch points, and the table also keeps track of
+ * the order in which touch points were inserted.
+ *
+ * Growing the table moves the slots in memory, so pointers returned
+ * by the table are only valid until the next insertion.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-touch-table.h"
+
+/* enough for ten fingers without growing the table */
+#define INITIAL_N_SLOTS         16
+
+typedef struct
+{
+  ClutterInputDevice *device;
+  ClutterEventSequence *sequence;
+
+  guint in_use : 1;
+} TouchKey;
+
+struct _ClutterTouchTable
+{
+  gsize element_size;
+  GDestroyNotify clear_func;
+
+  /* number of allocated slots; always a power of two */
+  guint n_slots;
+
+  /* number of slots in use */
+  guint n_points;
+
+  TouchKey *keys;
+  guint8 *elements;
+
+  /* the slots in use, in insertion order */
+  guint16 *order;
+
+  /* maps the hash of a key to slot + 1, with linear probing; it has
+   * twice as many entries as there are slots, so it is never full
+   */
+  guint16 *index;
+};
+
+#define TOUCH_TABLE_ELEMENT(t,s)        ((gpointer) ((t)->elements + (gsize) (s) * (t)->element_size))
+
+static inline guint
+touch_key_hash (ClutterInputDevice   *device,
+                ClutterEventSequence *sequence)
+{
+  guint hash = GPOINTER_TO_UINT (sequence) * 2654435761u;
+
+  return hash ^ (GPOINTER_TO_UINT (device) >> 3);
+}
+
+static gint
+touch_table_find (ClutterTouchTable    *table,
+                  ClutterInputDevice   *device,
+                  ClutterEventSequence *sequence,
+                  guint                *index_pos)
+{
+  guint mask = table->n_slots * 2 - 1;
+  guint pos = touch_key_hash (device, sequence) & mask;
+
+  while (table->index[pos] != 0)
+    {
+      gint slot = table->index[pos] - 1;
+      const TouchKey *key = &table->keys[slot];
+
+      if (key->device == device && key->sequence == sequence)
+        return slot;
+
+      pos = (pos + 1) & mask;
+    }
+
+  if (index_pos != NULL)
+    *index_pos = pos;
+
+  return -1;
+}
+
+static void
+touch_table_rebuild_index (ClutterTouchTable *table)
+{
+  guint i;
+
+  memset (table->index, 0, sizeof (guint16) * table->n_slots * 2);
+
+  for (i = 0; i < table->n_points; i++)
+    {
+      gint slot = table->order[i];
+      guint pos = 0;
+
+      touch_table_find (table,
+                        table->keys[slot].device,
+                        table->keys[slot].sequence,
+                        &pos);
+
+      table->index[pos] = slot + 1;
+    }
+}
+
+static void
+touch_table_resize (ClutterTouchTable *table,
+                    guint              n_slots)
+{
+  guint old_n_slots = table->n_slots;
+
+  table->keys = g_renew (TouchKey, table->keys, n_slots);
+  table->elements = g_realloc (table->elements, table->element_size * n_slots);
+  table->order = g_renew (guint16, table->order, n_slots);
+  table->index = g_renew (guint16, table->index, n_slots * 2);
+
+  memset (table->keys + old_n_slots, 0,
+          sizeof (TouchKey) * (n_slots - old_n_slots));
+
+  table->n_slots = n_slots;
+
+  touch_table_rebuild_index (table);
+}
+
+/*< private >
+ * _clutter_touch_table_new:
+ * @element_size: the size of the per-touch-point state
+ * @clear_func: (allow-none): function used to clear the state of a
+ *   touch point when it is removed from the table
+ *
+ * Creates a new, empty #ClutterTouchTable.
+ *
+ * Return value: the newly created table
+ */
+ClutterTouchTable *
+_clutter_touch_table_new (gsize          element_size,
+                          GDestroyNotify clear_func)
+{
+  ClutterTouchTable *table;
+
+  g_return_val_if_fail (element_size > 0, NULL);
+
+  table = g_slice_new0 (ClutterTouchTable);
+  table->element_size = element_size;
+  table->clear_func = clear_func;
+
+  touch_table_resize (table, INITIAL_N_SLOTS);
+
+  return table;
+}
+
+void
+_clutter_touch_table_free (ClutterTouchTable *table)
+{
+  if (table == NULL)
+    return;
+
+  _clutter_touch_table_remove_all (table);
+
+  g_free (table->keys);
+  g_free (table->elements);
+  g_free (table->order);
+  g_free (table->index);
+
+  g_slice_free (ClutterTouchTable, table);
+}
+
+/*< private >
+ * _clutter_touch_table_insert:
+ * @table: a #ClutterTouchTable
+ * @device: (allow-none): the device of the touch point
+ * @sequence: (allow-none): the sequence of the touch point
+ * @slot: (out) (allow-none): return location for the slot id
+ *
+ * Adds a touch point to @table. If a touch point with the same
+ * @device and @sequence is already in the table, its state is
+ * cleared and reused.
+ *
+ * Return value: the zero-filled state of the touch point
+ */
+gpointer
+_clutter_touch_table_insert (ClutterTouchTable    *table,
+                             ClutterInputDevice   *device,
+                             ClutterEventSequence *sequence,
+                             gint                 *slot)
+{
+  gpointer element;
+  guint pos = 0;
+  gint res;
+
+  res = touch_table_find (table, device, sequence, &pos);
+  if (res >= 0)
+    {
+      element = TOUCH_TABLE_ELEMENT (table, res);
+
+      if (table->clear_func != NULL)
+        table->clear_func (element);
+
+      goto out;
+    }
+
+  if (table->n_points == table->n_slots)
+    {
+      g_return_val_if_fail (table->n_slots * 2 <= G_MAXUINT16, NULL);
+
+      touch_table_resize (table, table->n_slots * 2);
+      touch_table_find (table, device, sequence, &pos);
+    }
+
+  for (res = 0; res < (gint) table->n_slots; res++)
+    {
+      if (!table->keys[res].in_use)
+        break;
+    }
+
+  table->keys[res].device = device;
+  table->keys[res].sequence = sequence;
+  table->keys[res].in_use = TRUE;
+
+  table->order[table->n_points] = res;
+  table->n_points += 1;
+
+  table->index[pos] = res + 1;
+
+  element = TOUCH_TABLE_ELEMENT (table, res);
+
+out:
+  memset (element, 0, table->element_size);
+
+  if (slot != NULL)
+    *slot = res;
+
+  return element;
+}
+
+/*< private >
+ * _clutter_touch_table_lookup:
+ * @table: a #ClutterTouchTable
+ * @device: (allow-none): the device of the touch point
+ * @sequence: (allow-none): the sequence of the touch point
+ * @slot: (out) (allow-none): return location for the slot id
+ *
+ * Looks up the touch point for @device and @sequence.
+ *
+ * Return value: the state of the touch point, or %NULL
+ */
+gpointer
+_clutter_touch_table_lookup (ClutterTouchTable    *table,
+                             ClutterInputDevice   *device,
+                             ClutterEventSequence *sequence,
+                             gint                 *slot)
+{
+  gint res;
+
+  res = touch_table_find (table, device, sequence, NULL);
+  if (res < 0)
+    return NULL;
+
+  if (slot != NULL)
+    *slot = res;
+
+  return TOUCH_TABLE_ELEMENT (table, res);
+}
+
+/*< private >
+ * _clutter_touch_table_remove:
+ * @table: a #ClutterTouchTable
+ * @slot: the slot id of a touch point
+ *
+ * Removes the touch point stored at @slot, and clears its state.
+ */
+void
+_clutter_touch_table_remove (ClutterTouchTable *table,
+                             gint               slot)
+{
+  guint i;
+
+  g_return_if_fail (slot >= 0 && slot < (gint) table->n_slots);
+  g_return_if_fail (table->keys[slot].in_use);
+
+  if (table->clear_func != NULL)
+    table->clear_func (TOUCH_TABLE_ELEMENT (table, slot));
+
+  table->keys[slot].in_use = FALSE;
+
+  for (i = 0; i < table->n_points; i++)
+    {
+      if (table->order[i] == slot)
+        break;
+    }
+
+  memmove (table->order + i, table->order + i + 1,
+           sizeof (guint16) * (table->n_points - i - 1));
+  table->n_points -= 1;
+
+  /* the table is small enough that rebuilding the index is cheaper
+   * than keeping tombstones around
+   */
+  touch_table_rebuild_index (table);
+}
+
+void
+_clutter_touch_table_remove_all (ClutterTouchTable *table)
+{
+  guint i;
+
+  for (i = 0; i < table->n_points; i++)
+    {
+      gint slot = table->order[i];
+
+      if (table->clear_func != NULL)
+        table->clear_func (TOUCH_TABLE_ELEMENT (table, slot));
+
+      table->keys[slot].in_use = FALSE;
+    }
+
+  table->n_points = 0;
+
+  memset (table->index, 0, sizeof (guint16) * table->n_slots * 2);
+}
+
+gpointer
+_clutter_touch_table_get_slot (ClutterTouchTable *table,
+                               gint               slot)
+{
+  g_return_val_if_fail (slot >= 0 && slot < (gint) table->n_slots, NULL);
+  g_return_val_if_fail (table->keys[slot].in_use, NULL);
+
+  return TOUCH_TABLE_ELEMENT (table, slot);
+}
+
+/*< private >
+ * _clutter_touch_table_get_nth:
+ * @table: a #ClutterTouchTable
+ * @n: the position of a touch point, in insertion order
+ *
+ * Retrieves the state of the @n-th touch point still in @table.
+ *
+ * Return value: the state of the touch point
+ */
+gpointer
+_clutter_touch_table_get_nth (ClutterTouchTable *table,
+                              guint              n)
+{
+  g_return_val_if_fail (n < table->n_points, NULL);
+
+  return TOUCH_TABLE_ELEMENT (table, table->order[n]);
+}
+
+gint
+_clutter_touch_table_get_nth_slot (ClutterTouchTable *table,
+                                   guint              n)
+{
+  g_return_val_if_fail (n < table->n_points, -1);
+
+  return table->order[n];
+}
+
+guint
+_clutter_touch_table_get_size (ClutterTouchTable *table)
+{
+  return table->n_points;
+}
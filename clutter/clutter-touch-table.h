@@ -0,0 +1,58 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTouchTable: flat table of per-touch-point state, keyed on the
+ * device and the event sequence of each touch point.
+ */
+
+#ifndef __CLUTTER_TOUCH_TABLE_H__
+#define __CLUTTER_TOUCH_TABLE_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTouchTable       ClutterTouchTable;
+
+ClutterTouchTable *     _clutter_touch_table_new        (gsize                 element_size,
+                                                         GDestroyNotify        clear_func);
+void                    _clutter_touch_table_free       (ClutterTouchTable    *table);
+
+gpointer                _clutter_touch_table_insert     (ClutterTouchTable    *table,
+                                                         ClutterInputDevice   *device,
+                                                         ClutterEventSequence *sequence,
+                                                         gint                 *slot);
+gpointer                _clutter_touch_table_lookup     (ClutterTouchTable    *table,
+                                                         ClutterInputDevice   *device,
+                                                         ClutterEventSequence *sequence,
+                                                         gint                 *slot);
+void                    _clutter_touch_table_remove     (ClutterTouchTable    *table,
+                                                         gint                  slot);
+void                    _clutter_touch_table_remove_all (ClutterTouchTable    *table);
+
+gpointer                _clutter_touch_table_get_slot   (ClutterTouchTable    *table,
+                                                         gint                  slot);
+gpointer                _clutter_touch_table_get_nth    (ClutterTouchTable    *table,
+                                                         guint                 n);
+gint                    _clutter_touch_table_get_nth_slot (ClutterTouchTable  *table,
+                                                         guint                 n);
+guint                   _clutter_touch_table_get_size   (ClutterTouchTable    *table);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TOUCH_TABLE_H__ */
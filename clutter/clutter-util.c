@@ -521,11 +521,18 @@ typedef struct
 {
   GType value_type;
   ClutterProgressFunc func;
+
+  /* the typed version of func, if any */
+  ClutterIntervalKernel kernel;
+  gsize kernel_size;
 } ProgressData;
 
 G_LOCK_DEFINE_STATIC (progress_funcs);
 static GHashTable *progress_funcs = NULL;
 
+/* changes every time a progress function is registered */
+static volatile gint progress_funcs_serial = 0;
+
 gboolean
 _clutter_has_progress_function (GType gtype)
 {
@@ -570,6 +577,62 @@ out:
   return res;
 }
 
+/*< private >
+ * _clutter_get_interval_kernel:
+ * @gtype: a #GType
+ * @kernel: (out): return location for the kernel
+ * @size: (out): return location for the size of the values the
+ *   kernel works on
+ *
+ * Retrieves the typed version of the progress function registered
+ * for @gtype. Progress functions registered using the public API
+ * do not have a typed version.
+ *
+ * Return value: %TRUE if a progress function is registered for @gtype
+ */
+gboolean
+_clutter_get_interval_kernel (GType                  gtype,
+                              ClutterIntervalKernel *kernel,
+                              gsize                 *size)
+{
+  ProgressData *pdata = NULL;
+
+  G_LOCK (progress_funcs);
+
+  if (progress_funcs != NULL)
+    pdata = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+
+  if (pdata != NULL)
+    {
+      *kernel = pdata->kernel;
+      *size = pdata->kernel_size;
+    }
+  else
+    {
+      *kernel = NULL;
+      *size = 0;
+    }
+
+  G_UNLOCK (progress_funcs);
+
+  return pdata != NULL;
+}
+
+/*< private >
+ * _clutter_get_progress_functions_serial:
+ *
+ * Retrieves a number that changes every time a progress function
+ * is registered, so that the users of _clutter_get_interval_kernel()
+ * know when to look the kernels up again.
+ *
+ * Return value: the serial of the progress functions
+ */
+guint
+_clutter_get_progress_functions_serial (void)
+{
+  return g_atomic_int_get (&progress_funcs_serial);
+}
+
 static void
 progress_data_destroy (gpointer data_)
 {
@@ -643,16 +706,18 @@ clutter_interval_register_progress_func (GType               value_type,
   if (G_UNLIKELY (progress_func))
     {
       if (func == NULL)
+        g_hash_table_remove (progress_funcs, type_name);
+      else
         {
-          g_hash_table_remove (progress_funcs, type_name);
-          g_slice_free (ProgressData, progress_func);
+          /* the typed version does not match the new function */
+          progress_func->func = func;
+          progress_func->kernel = NULL;
+          progress_func->kernel_size = 0;
         }
-      else
-        progress_func->func = func;
     }
-  else
+  else if (func != NULL)
     {
-      progress_func = g_slice_new (ProgressData);
+      progress_func = g_slice_new0 (ProgressData);
       progress_func->value_type = value_type;
       progress_func->func = func;
 
@@ -661,5 +726,40 @@ clutter_interval_register_progress_func (GType               value_type,
                             progress_func);
     }
 
+  g_atomic_int_inc (&progress_funcs_serial);
+
+  G_UNLOCK (progress_funcs);
+}
+
+/*< private >
+ * _clutter_register_interval_kernel:
+ * @gtype: a #GType
+ * @func: a #ClutterProgressFunc
+ * @kernel: the typed version of @func
+ * @size: the size of the C type of @gtype
+ *
+ * Registers @func as the progress function for @gtype, like
+ * clutter_interval_register_progress_func() does, and @kernel as
+ * its typed version, which #ClutterInterval uses to interpolate the
+ * values of @gtype without a #GValue.
+ */
+void
+_clutter_register_interval_kernel (GType                 gtype,
+                                   ClutterProgressFunc   func,
+                                   ClutterIntervalKernel kernel,
+                                   gsize                 size)
+{
+  ProgressData *progress_func;
+
+  g_return_if_fail (func != NULL && kernel != NULL);
+
+  clutter_interval_register_progress_func (gtype, func);
+
+  G_LOCK (progress_funcs);
+
+  progress_func = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+  progress_func->kernel = kernel;
+  progress_func->kernel_size = size;
+
   G_UNLOCK (progress_funcs);
 }
@@ -53,6 +53,7 @@
 #include "clutter-backend-private.h"
 #include "clutter-evdev.h"
 #include "clutter-stage-private.h"
+#include "clutter-touch-table.h"
 
 #include "clutter-device-manager-evdev.h"
 
@@ -94,7 +95,8 @@ struct _ClutterSeatEvdev
   ClutterInputDevice *core_pointer;
   ClutterInputDevice *core_keyboard;
 
-  GHashTable *touches;
+  /* ClutterTouchState, keyed on the libinput slot */
+  ClutterTouchTable *touches;
 
   struct xkb_state *xkb;
   xkb_led_index_t caps_lock_led;
@@ -978,12 +980,6 @@ clutter_event_source_free (ClutterEventSource *source)
   g_source_unref (g_source);
 }
 
-static void
-clutter_touch_state_free (ClutterTouchState *touch_state)
-{
-  g_slice_free (ClutterTouchState, touch_state);
-}
-
 static void
 clutter_seat_evdev_set_libinput_seat (ClutterSeatEvdev *seat,
                                       struct libinput_seat *libinput_seat)
@@ -1027,8 +1023,7 @@ clutter_seat_evdev_new (ClutterDeviceManagerEvdev *manager_evdev)
   _clutter_device_manager_add_device (manager, device);
   seat->core_keyboard = device;
 
-  seat->touches = g_hash_table_new_full (NULL, NULL, NULL,
-                                         (GDestroyNotify) clutter_touch_state_free);
+  seat->touches = _clutter_touch_table_new (sizeof (ClutterTouchState), NULL);
 
   ctx = xkb_context_new(0);
   g_assert (ctx);
@@ -1075,7 +1070,7 @@ clutter_seat_evdev_free (ClutterSeatEvdev *seat)
       g_object_unref (device);
     }
   g_slist_free (seat->devices);
-  g_hash_table_unref (seat->touches);
+  _clutter_touch_table_free (seat->touches);
 
   xkb_state_unref (seat->xkb);
 
@@ -1350,11 +1345,11 @@ _device_seat_add_touch (ClutterInputDevice *input_device,
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
   ClutterTouchState *touch;
 
-  touch = g_slice_new0 (ClutterTouchState);
+  touch = _clutter_touch_table_insert (seat->touches,
+                                       NULL, GUINT_TO_POINTER (id),
+                                       NULL);
   touch->id = id;
 
-  g_hash_table_insert (seat->touches, GUINT_TO_POINTER (id), touch);
-
   return touch;
 }
 
@@ -1365,8 +1360,12 @@ _device_seat_remove_touch (ClutterInputDevice *input_device,
   ClutterInputDeviceEvdev *device_evdev =
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
+  gint slot;
 
-  g_hash_table_remove (seat->touches, GUINT_TO_POINTER (id));
+  if (_clutter_touch_table_lookup (seat->touches,
+                                   NULL, GUINT_TO_POINTER (id),
+                                   &slot) != NULL)
+    _clutter_touch_table_remove (seat->touches, slot);
 }
 
 static ClutterTouchState *
@@ -1377,7 +1376,9 @@ _device_seat_get_touch (ClutterInputDevice *input_device,
     CLUTTER_INPUT_DEVICE_EVDEV (input_device);
   ClutterSeatEvdev *seat = _clutter_input_device_evdev_get_seat (device_evdev);
 
-  return g_hash_table_lookup (seat->touches, GUINT_TO_POINTER (id));
+  return _clutter_touch_table_lookup (seat->touches,
+                                      NULL, GUINT_TO_POINTER (id),
+                                      NULL);
 }
 
 static void
@@ -1709,7 +1710,6 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
     case LIBINPUT_EVENT_TOUCH_CANCEL:
       {
         ClutterTouchState *touch_state;
-        GHashTableIter iter;
         guint64 time_us;
         struct libinput_event_touch *touch_event =
           libinput_event_get_touch_event (event);
@@ -1718,14 +1718,16 @@ process_device_event (ClutterDeviceManagerEvdev *manager_evdev,
         device = libinput_device_get_user_data (libinput_device);
         time_us = libinput_event_touch_get_time_usec (touch_event);
         seat = _clutter_input_device_evdev_get_seat (CLUTTER_INPUT_DEVICE_EVDEV (device));
-        g_hash_table_iter_init (&iter, seat->touches);
 
-        while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &touch_state))
+        while (_clutter_touch_table_get_size (seat->touches) > 0)
           {
+            touch_state = _clutter_touch_table_get_nth (seat->touches, 0);
+
             notify_touch_event (device, CLUTTER_TOUCH_CANCEL,
                                 time_us, touch_state->id,
                                 touch_state->coords.x, touch_state->coords.y);
-            g_hash_table_iter_remove (&iter);
+            _clutter_touch_table_remove (seat->touches,
+                                         _clutter_touch_table_get_nth_slot (seat->touches, 0));
           }
 
         break;
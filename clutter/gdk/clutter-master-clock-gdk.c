@@ -37,11 +37,14 @@
 
 #include "clutter-master-clock.h"
 #include "clutter-master-clock-gdk.h"
+#include "clutter-actor-private.h"
+#include "clutter-animation-table.h"
 #include "clutter-stage-gdk.h"
 #include "clutter-debug.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-timeline-registry.h"
 
 #ifdef CLUTTER_ENABLE_DEBUG
 #define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
@@ -63,8 +66,8 @@ struct _ClutterMasterClockGdk
 {
   GObject parent_instance;
 
-  /* the list of timelines handled by the clock */
-  GSList *timelines;
+  /* the running timelines handled by the clock */
+  ClutterTimelineRegistry timelines;
 
   /* mapping between ClutterStages and GdkFrameClocks.
    *
@@ -116,7 +119,7 @@ master_clock_schedule_forced_stages_updates (ClutterMasterClockGdk *master_clock
 static void
 master_clock_sync_frame_clock_update (ClutterMasterClockGdk *master_clock)
 {
-  gboolean updating = master_clock->timelines != NULL;
+  gboolean updating = !_clutter_timeline_registry_is_empty (&master_clock->timelines);
   gpointer frame_clock, stage_list;
   GHashTableIter iter;
 
@@ -156,7 +159,7 @@ master_clock_schedule_stage_update (ClutterMasterClockGdk *master_clock,
    * anymore redrawing. But in the case we still have timelines alive,
    * we have no choice, we need to advance the timelines for the next
    * frame. */
-  if (master_clock->timelines != NULL)
+  if (!_clutter_timeline_registry_is_empty (&master_clock->timelines))
     gdk_frame_clock_request_phase (frame_clock, GDK_FRAME_CLOCK_PHASE_PAINT);
 }
 
@@ -190,39 +193,25 @@ master_clock_process_stage_events (ClutterMasterClockGdk *master_clock,
 static void
 master_clock_advance_timelines (ClutterMasterClockGdk *master_clock)
 {
-  GSList *timelines, *l;
+  ClutterAnimationTable *table;
 #ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
 #endif
 
-  /* we protect ourselves from timelines being removed during
-   * the advancement by other timelines by copying the list of
-   * timelines, taking a reference on them, iterating over the
-   * copied list and then releasing the reference.
-   *
-   * we cannot simply take a reference on the timelines and still
-   * use the list held by the master clock because the do_tick()
-   * might result in the creation of a new timeline, which gets
-   * added at the end of the list with no reference increase and
-   * thus gets disposed at the end of the iteration.
-   *
-   * this implies that a newly added timeline will not be advanced
-   * by this clock iteration, which is perfectly fine since we're
-   * in its first cycle.
-   *
-   * we also cannot steal the master clock timelines list because
-   * a timeline might be removed as the direct result of do_tick()
-   * and remove_timeline() would not find the timeline, failing
-   * and leaving a dangling pointer behind.
+  /* the property transitions using the animation table only store
+   * their progress while the timelines are advanced; the values are
+   * interpolated and written all at once afterwards
    */
-  timelines = g_slist_copy (master_clock->timelines);
-  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+  table = _clutter_animation_table_get_default ();
+  _clutter_animation_table_defer_updates (table);
 
-  for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+  _clutter_timeline_registry_advance (&master_clock->timelines,
+                                      master_clock->cur_tick / 1000);
 
-  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
-  g_slist_free (timelines);
+  _clutter_animation_table_flush_updates (table);
+
+  CLUTTER_NOTE (ANIMATION, "Notifications saved by batching: %u",
+                _clutter_actor_get_saved_notifications ());
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -384,7 +373,7 @@ clutter_master_clock_gdk_add_stage_clock (ClutterMasterClockGdk *master_clock,
   else
     stages = g_list_append (stages, stage);
 
-  if (master_clock->timelines != NULL)
+  if (!_clutter_timeline_registry_is_empty (&master_clock->timelines))
     {
       _clutter_master_clock_start_running ((ClutterMasterClock *) master_clock);
       /* We only need to synchronize the frame clock state if we have
@@ -483,7 +472,7 @@ clutter_master_clock_gdk_finalize (GObject *gobject)
 
   g_hash_table_unref (master_clock->clock_to_stage);
   g_hash_table_unref (master_clock->stage_to_clock);
-  g_slist_free (master_clock->timelines);
+  _clutter_timeline_registry_clear (&master_clock->timelines);
 
   G_OBJECT_CLASS (clutter_master_clock_gdk_parent_class)->finalize (gobject);
 }
@@ -503,6 +492,8 @@ clutter_master_clock_gdk_init (ClutterMasterClockGdk *self)
   ClutterStageManager *manager;
   const GSList *stages, *l;
 
+  _clutter_timeline_registry_init (&self->timelines);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   self->frame_budget = G_USEC_PER_SEC / 60;
 #endif
@@ -531,17 +522,8 @@ clutter_master_clock_gdk_add_timeline (ClutterMasterClock *clock,
                                        ClutterTimeline    *timeline)
 {
   ClutterMasterClockGdk *master_clock = (ClutterMasterClockGdk *) clock;
-  gboolean is_first;
-
-  if (g_slist_find (master_clock->timelines, timeline))
-    return;
-
-  is_first = master_clock->timelines == NULL;
-
-  master_clock->timelines = g_slist_prepend (master_clock->timelines,
-                                             timeline);
 
-  if (is_first)
+  if (_clutter_timeline_registry_add (&master_clock->timelines, timeline))
     {
       _clutter_master_clock_start_running (clock);
       /* Sync frame clock update state if needed. */
@@ -555,11 +537,10 @@ clutter_master_clock_gdk_remove_timeline (ClutterMasterClock *clock,
 {
   ClutterMasterClockGdk *master_clock = (ClutterMasterClockGdk *) clock;
 
-  master_clock->timelines = g_slist_remove (master_clock->timelines,
-                                            timeline);
+  _clutter_timeline_registry_remove (&master_clock->timelines, timeline);
 
   /* Sync frame clock update state if we have no more timelines running. */
-  if (master_clock->timelines == NULL)
+  if (_clutter_timeline_registry_is_empty (&master_clock->timelines))
     master_clock_sync_frame_clock_update (master_clock);
 }
 
@@ -72,6 +72,11 @@ struct _ClutterEventSource
   ClutterBackendX11 *backend;
 
   GPollFD event_poll_fd;
+
+  /* an event that failed translation, kept around so that we can
+   * reuse it for the next XEvent instead of allocating a new one
+   */
+  ClutterEvent *spare_event;
 };
 
 ClutterEventX11 *
@@ -102,12 +107,13 @@ static gboolean clutter_event_check    (GSource     *source);
 static gboolean clutter_event_dispatch (GSource     *source,
                                         GSourceFunc  callback,
                                         gpointer     user_data);
+static void     clutter_event_finalize (GSource     *source);
 
 static GSourceFuncs event_funcs = {
   clutter_event_prepare,
   clutter_event_check,
   clutter_event_dispatch,
-  NULL
+  clutter_event_finalize
 };
 
 GSource *
@@ -272,33 +278,127 @@ clutter_event_check (GSource *source)
   return retval;
 }
 
+static ClutterEvent *
+event_source_get_event (ClutterEventSource *event_source)
+{
+  ClutterEvent *event = event_source->spare_event;
+
+  if (event == NULL)
+    return clutter_event_new (CLUTTER_NOTHING);
+
+  event_source->spare_event = NULL;
+
+  return event;
+}
+
 static void
-events_queue (ClutterBackendX11 *backend_x11)
+event_source_recycle_event (ClutterEventSource *event_source,
+                            ClutterEvent       *event)
+{
+  if (event_source->spare_event != NULL)
+    {
+      clutter_event_free (event);
+      return;
+    }
+
+  _clutter_event_reset (event);
+  event_source->spare_event = event;
+}
+
+/* checks whether @event supersedes @pending, in which case the stage
+ * would drop @pending anyway when processing its event queue
+ */
+static gboolean
+event_can_coalesce (const ClutterEvent *pending,
+                    const ClutterEvent *event)
 {
+  ClutterStage *stage = pending->any.stage;
+
+  if (stage == NULL || event->any.stage != stage)
+    return FALSE;
+
+  if (!clutter_stage_get_throttle_motion_events (stage))
+    return FALSE;
+
+  if (clutter_event_get_device (pending) != clutter_event_get_device (event))
+    return FALSE;
+
+  if (pending->type == CLUTTER_MOTION)
+    return event->type == CLUTTER_MOTION;
+
+  if (pending->type == CLUTTER_TOUCH_UPDATE)
+    return event->type == CLUTTER_TOUCH_UPDATE &&
+           pending->touch.sequence == event->touch.sequence;
+
+  return FALSE;
+}
+
+static void
+events_queue (ClutterEventSource *event_source)
+{
+  ClutterBackendX11 *backend_x11 = event_source->backend;
   ClutterBackend *backend = CLUTTER_BACKEND (backend_x11);
   Display *xdisplay = backend_x11->xdpy;
+  ClutterEvent *pending = NULL;
   ClutterEvent *event;
   XEvent xevent;
+  int n_events;
 
-  while (!clutter_events_pending () && XPending (xdisplay))
+  /* we translate all the events that are already queued on the
+   * connection in one go, instead of one per dispatch; we do not
+   * read more from the connection while doing so, otherwise a fast
+   * enough input device would starve the main loop
+   */
+  n_events = XPending (xdisplay);
+
+  while (n_events-- > 0)
     {
       XNextEvent (xdisplay, &xevent);
 
-      event = clutter_event_new (CLUTTER_NOTHING);
+      event = event_source_get_event (event_source);
 
 #ifdef HAVE_XGE
       XGetEventData (xdisplay, &xevent.xcookie);
 #endif
 
       if (_clutter_backend_translate_event (backend, &xevent, event))
-        _clutter_event_push (event, FALSE);
+        {
+          /* consecutive motion and touch update events are held
+           * back, so that we can replace them with newer ones from
+           * the same batch and recycle the stale event
+           */
+          if (pending != NULL)
+            {
+              if (event_can_coalesce (pending, event))
+                {
+                  CLUTTER_NOTE (EVENT, "Coalescing %s event",
+                                pending->type == CLUTTER_MOTION
+                                  ? "motion"
+                                  : "touch update");
+                  event_source_recycle_event (event_source, pending);
+                }
+              else
+                _clutter_event_push (pending, FALSE);
+
+              pending = NULL;
+            }
+
+          if (event->type == CLUTTER_MOTION ||
+              event->type == CLUTTER_TOUCH_UPDATE)
+            pending = event;
+          else
+            _clutter_event_push (event, FALSE);
+        }
       else
-        clutter_event_free (event);
+        event_source_recycle_event (event_source, event);
 
 #ifdef HAVE_XGE
       XFreeEventData (xdisplay, &xevent.xcookie);
 #endif
     }
+
+  if (pending != NULL)
+    _clutter_event_push (pending, FALSE);
 }
 
 static gboolean
@@ -306,7 +406,7 @@ clutter_event_dispatch (GSource     *source,
                         GSourceFunc  callback,
                         gpointer     user_data)
 {
-  ClutterBackendX11 *backend = ((ClutterEventSource *) source)->backend;
+  ClutterEventSource *event_source = (ClutterEventSource *) source;
   ClutterEvent *event;
 
   _clutter_threads_acquire_lock ();
@@ -314,21 +414,27 @@ clutter_event_dispatch (GSource     *source,
   /*  Grab the event(s), translate and figure out double click.
    *  The push onto queue (stack) if valid.
   */
-  events_queue (backend);
+  events_queue (event_source);
 
-  /* Pop an event off the queue if any */
-  event = clutter_event_get ();
-  if (event != NULL)
-    {
-      /* forward the event into clutter for emission etc. */
-      _clutter_stage_queue_event (event->any.stage, event, FALSE);
-    }
+  /* Forward all the queued events into clutter for emission etc.;
+   * the stage will process them all at the next frame anyway
+   */
+  while ((event = clutter_event_get ()) != NULL)
+    _clutter_stage_queue_event (event->any.stage, event, FALSE);
 
   _clutter_threads_release_lock ();
 
   return TRUE;
 }
 
+static void
+clutter_event_finalize (GSource *source)
+{
+  ClutterEventSource *event_source = (ClutterEventSource *) source;
+
+  g_clear_pointer (&event_source->spare_event, clutter_event_free);
+}
+
 /**
  * clutter_x11_get_current_event_time: (skip)
  *
@@ -0,0 +1,144 @@
+#include <clutter/clutter.h>
+
+#define ACTOR_X         100
+#define ACTOR_Y         100
+#define ACTOR_SIZE      50
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static gfloat
+get_paint_width (ClutterActor *actor)
+{
+  ClutterActorBox box;
+
+  g_assert (clutter_actor_get_paint_box (actor, &box));
+
+  return clutter_actor_box_get_width (&box);
+}
+
+static void
+actor_blur_effect_radius (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  ClutterEffect *effect;
+  gboolean was_painted;
+  guint radius;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (actor, ACTOR_X, ACTOR_Y);
+  clutter_actor_set_size (actor, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_add_child (stage, actor);
+
+  effect = clutter_blur_effect_new ();
+  clutter_actor_add_effect (actor, effect);
+
+  g_object_get (effect, "radius", &radius, NULL);
+  g_assert_cmpuint (radius, ==, clutter_blur_effect_get_radius (CLUTTER_BLUR_EFFECT (effect)));
+  g_assert_cmpuint (radius, >, 0);
+
+  was_painted = FALSE;
+  g_signal_connect (stage, "after-paint", G_CALLBACK (on_after_paint), &was_painted);
+
+  clutter_actor_show (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, FALSE);
+
+  /* the paint volume grows with the radius, including the radii large
+   * enough to be applied on a downsampled copy of the actor
+   */
+  g_assert_cmpfloat (get_paint_width (actor), >=, ACTOR_SIZE + 2 * radius);
+
+  clutter_blur_effect_set_radius (CLUTTER_BLUR_EFFECT (effect), 40);
+  g_assert_cmpuint (clutter_blur_effect_get_radius (CLUTTER_BLUR_EFFECT (effect)), ==, 40);
+  g_assert_cmpfloat (get_paint_width (actor), >=, ACTOR_SIZE + 2 * 40);
+
+  was_painted = FALSE;
+  while (!was_painted)
+    g_main_context_iteration (NULL, FALSE);
+
+  /* a radius of 0 disables the blur */
+  g_object_set (effect, "radius", 0, NULL);
+  g_assert_cmpfloat (get_paint_width (actor), <=, ACTOR_SIZE + 1);
+
+  g_signal_handlers_disconnect_by_func (stage, on_after_paint, &was_painted);
+  clutter_actor_destroy (actor);
+}
+
+static guint8
+get_green_at (ClutterActor *stage,
+              gfloat        x,
+              gfloat        y)
+{
+  ClutterPoint point = CLUTTER_POINT_INIT (x, y);
+  ClutterColor result;
+
+  clutter_test_check_color_at_point (stage, &point, CLUTTER_COLOR_White, &result);
+
+  return result.green;
+}
+
+static void
+check_blur_spread (ClutterActor *stage,
+                   guint         radius,
+                   guint         margin)
+{
+  gfloat y = ACTOR_Y + ACTOR_SIZE / 2;
+
+  /* the stage is white and the actor is red, so the blur lowers the
+   * green channel past the edges of the actor...
+   */
+  g_assert_cmpint (get_green_at (stage, ACTOR_X - radius / 2 - 1, y), <, 255 - 8);
+  g_assert_cmpint (get_green_at (stage, ACTOR_X + ACTOR_SIZE + radius / 2, y), <, 255 - 8);
+
+  /* ...but not much farther than the radius; @margin covers the texels
+   * of the downsampled copy of the actor
+   */
+  g_assert_cmpint (get_green_at (stage, ACTOR_X - radius - margin, y), >=, 255 - 2);
+  g_assert_cmpint (get_green_at (stage, ACTOR_X + ACTOR_SIZE + radius + margin, y), >=, 255 - 2);
+}
+
+static void
+actor_blur_effect_spread (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  ClutterEffect *effect;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (actor, ACTOR_X, ACTOR_Y);
+  clutter_actor_set_size (actor, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_add_child (stage, actor);
+
+  effect = clutter_blur_effect_new ();
+  clutter_actor_add_effect (actor, effect);
+
+  /* a radius blurred in a single pass at full size */
+  clutter_blur_effect_set_radius (CLUTTER_BLUR_EFFECT (effect), 4);
+  check_blur_spread (stage, 4, 2);
+
+  /* a radius blurred on a copy of the actor downsampled 8 times */
+  clutter_blur_effect_set_radius (CLUTTER_BLUR_EFFECT (effect), 40);
+  check_blur_spread (stage, 40, 2 * 8);
+
+  clutter_actor_destroy (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/blur-effect/radius", actor_blur_effect_radius)
+  CLUTTER_TEST_UNIT ("/actor/blur-effect/spread", actor_blur_effect_spread)
+)
@@ -0,0 +1,252 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *parent;
+  ClutterActor *child;
+
+  GString *log;
+  guint n_events;
+
+  /* the event to deliver from the handler of the child */
+  gboolean deliver_nested;
+} EventChainData;
+
+static const char *
+get_name (ClutterActor *actor)
+{
+  return clutter_actor_get_name (actor);
+}
+
+static gboolean
+on_captured_event (ClutterActor   *actor,
+                   ClutterEvent   *event,
+                   EventChainData *data)
+{
+  g_string_append_printf (data->log, "capture:%s ", get_name (actor));
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static gboolean
+on_event (ClutterActor   *actor,
+          ClutterEvent   *event,
+          EventChainData *data)
+{
+  g_string_append_printf (data->log, "bubble:%s ", get_name (actor));
+
+  if (actor == data->stage)
+    data->n_events += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static ClutterEvent *
+create_key_event (EventChainData *data,
+                  ClutterActor   *source)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+  ClutterEvent *event;
+
+  event = clutter_event_new (CLUTTER_KEY_PRESS);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+  clutter_event_set_source (event, source);
+  clutter_event_set_device (event,
+                            clutter_device_manager_get_core_device (manager,
+                                                                    CLUTTER_KEYBOARD_DEVICE));
+  clutter_event_set_key_symbol (event, CLUTTER_KEY_a);
+
+  return event;
+}
+
+static gboolean
+on_child_event (ClutterActor   *actor,
+                ClutterEvent   *event,
+                EventChainData *data)
+{
+  if (data->deliver_nested)
+    {
+      ClutterEvent *nested = create_key_event (data, data->parent);
+
+      data->deliver_nested = FALSE;
+
+      /* the nested event must not disturb the chain being walked */
+      clutter_do_event (nested);
+      clutter_event_free (nested);
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+deliver_event (EventChainData *data,
+               ClutterActor   *source,
+               guint           n_events)
+{
+  ClutterEvent *event = create_key_event (data, source);
+
+  data->n_events = 0;
+  g_string_truncate (data->log, 0);
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+
+  while (data->n_events < n_events)
+    g_main_context_iteration (NULL, FALSE);
+}
+
+static void
+connect_actor (ClutterActor   *actor,
+               const char     *name,
+               EventChainData *data)
+{
+  clutter_actor_set_name (actor, name);
+  clutter_actor_set_reactive (actor, TRUE);
+
+  g_signal_connect (actor, "captured-event", G_CALLBACK (on_captured_event), data);
+  g_signal_connect (actor, "event", G_CALLBACK (on_event), data);
+}
+
+static void
+setup (EventChainData *data)
+{
+  data->stage = clutter_test_get_stage ();
+  data->log = g_string_new (NULL);
+
+  data->parent = clutter_actor_new ();
+  clutter_actor_add_child (data->stage, data->parent);
+
+  data->child = clutter_actor_new ();
+  clutter_actor_add_child (data->parent, data->child);
+
+  connect_actor (data->stage, "stage", data);
+  connect_actor (data->parent, "parent", data);
+  connect_actor (data->child, "child", data);
+
+  clutter_actor_show (data->stage);
+}
+
+static void
+teardown (EventChainData *data)
+{
+  g_signal_handlers_disconnect_by_data (data->stage, data);
+  clutter_actor_destroy (data->parent);
+  g_string_free (data->log, TRUE);
+}
+
+#define CHILD_CHAIN \
+  "capture:stage capture:parent capture:child " \
+  "bubble:child bubble:parent bubble:stage "
+
+#define PARENT_CHAIN \
+  "capture:stage capture:parent " \
+  "bubble:parent bubble:stage "
+
+static void
+actor_event_chain_reuse (void)
+{
+  EventChainData data = { NULL, };
+
+  setup (&data);
+
+  /* the second event reuses the chain of the first */
+  deliver_event (&data, data.child, 1);
+  g_assert_cmpstr (data.log->str, ==, CHILD_CHAIN);
+
+  deliver_event (&data, data.child, 1);
+  g_assert_cmpstr (data.log->str, ==, CHILD_CHAIN);
+
+  /* a different source rebuilds it */
+  deliver_event (&data, data.parent, 1);
+  g_assert_cmpstr (data.log->str, ==, PARENT_CHAIN);
+
+  /* and so does a change in the scene graph */
+  clutter_actor_remove_child (data.parent, data.child);
+  clutter_actor_add_child (data.stage, data.child);
+
+  deliver_event (&data, data.child, 1);
+  g_assert_cmpstr (data.log->str, ==,
+                   "capture:stage capture:child bubble:child bubble:stage ");
+
+  /* moving it back builds the original chain again */
+  clutter_actor_remove_child (data.stage, data.child);
+  clutter_actor_add_child (data.parent, data.child);
+
+  deliver_event (&data, data.child, 1);
+  g_assert_cmpstr (data.log->str, ==, CHILD_CHAIN);
+
+  teardown (&data);
+}
+
+static void
+actor_event_chain_nested (void)
+{
+  EventChainData data = { NULL, };
+
+  setup (&data);
+
+  g_signal_connect (data.child, "event", G_CALLBACK (on_child_event), &data);
+
+  /* the event delivered from the handler of the child comes after the
+   * whole chain of the first one, and has its own chain
+   */
+  data.deliver_nested = TRUE;
+  deliver_event (&data, data.child, 2);
+  g_assert_cmpstr (data.log->str, ==, CHILD_CHAIN PARENT_CHAIN);
+
+  /* the chain of the device is still valid afterwards */
+  deliver_event (&data, data.child, 1);
+  g_assert_cmpstr (data.log->str, ==, CHILD_CHAIN);
+
+  teardown (&data);
+}
+
+static gboolean
+event_emission_hook (GSignalInvocationHint *hint,
+                     guint                  n_params,
+                     const GValue          *params,
+                     gpointer               user_data)
+{
+  guint *n_hooked = user_data;
+
+  *n_hooked += 1;
+
+  return TRUE;
+}
+
+static void
+actor_event_chain_emission_hook (void)
+{
+  EventChainData data = { NULL, };
+  ClutterActor *unhandled;
+  guint n_hooked = 0;
+  gulong hook_id;
+  guint signal_id;
+
+  setup (&data);
+
+  /* an actor without handlers still emits the event signals */
+  unhandled = clutter_actor_new ();
+  clutter_actor_set_reactive (unhandled, TRUE);
+  clutter_actor_add_child (data.child, unhandled);
+
+  signal_id = g_signal_lookup ("event", CLUTTER_TYPE_ACTOR);
+  hook_id = g_signal_add_emission_hook (signal_id, 0,
+                                        event_emission_hook,
+                                        &n_hooked, NULL);
+
+  deliver_event (&data, unhandled, 1);
+
+  /* the unhandled actor, the child, the parent and the stage */
+  g_assert_cmpuint (n_hooked, ==, 4);
+
+  g_signal_remove_emission_hook (signal_id, hook_id);
+
+  teardown (&data);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/event-chain/reuse", actor_event_chain_reuse)
+  CLUTTER_TEST_UNIT ("/actor/event-chain/nested", actor_event_chain_nested)
+  CLUTTER_TEST_UNIT ("/actor/event-chain/emission-hook", actor_event_chain_emission_hook)
+)
@@ -0,0 +1,265 @@
+#include <clutter/clutter.h>
+
+/* the size the render targets of the pool are rounded up to */
+#define BUCKET_SIZE     32
+
+typedef struct _FooPoolEffect      FooPoolEffect;
+typedef struct _FooPoolEffectClass FooPoolEffectClass;
+
+struct _FooPoolEffectClass
+{
+  ClutterOffscreenEffectClass parent_class;
+};
+
+struct _FooPoolEffect
+{
+  ClutterOffscreenEffect parent;
+
+  /* the texture and the target rectangle of the last paint */
+  CoglHandle texture;
+  ClutterRect rect;
+};
+
+GType foo_pool_effect_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (FooPoolEffect, foo_pool_effect, CLUTTER_TYPE_OFFSCREEN_EFFECT);
+
+static void
+foo_pool_effect_paint_target (ClutterOffscreenEffect *effect)
+{
+  FooPoolEffect *self = (FooPoolEffect *) effect;
+
+  self->texture = clutter_offscreen_effect_get_texture (effect);
+  g_assert (clutter_offscreen_effect_get_target_rect (effect, &self->rect));
+
+  CLUTTER_OFFSCREEN_EFFECT_CLASS (foo_pool_effect_parent_class)->paint_target (effect);
+}
+
+static void
+foo_pool_effect_class_init (FooPoolEffectClass *klass)
+{
+  ClutterOffscreenEffectClass *offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
+
+  offscreen_class->paint_target = foo_pool_effect_paint_target;
+}
+
+static void
+foo_pool_effect_init (FooPoolEffect *self)
+{
+}
+
+typedef struct {
+  ClutterActor *actor;
+  FooPoolEffect *effect;
+
+  guint n_paints;
+} PoolActor;
+
+static void
+on_paint (ClutterActor *actor,
+          PoolActor    *data)
+{
+  data->n_paints += 1;
+}
+
+static void
+pool_actor_init (PoolActor    *data,
+                 ClutterActor *stage,
+                 gfloat        x,
+                 gfloat        size,
+                 gboolean      persistent)
+{
+  data->actor = clutter_actor_new ();
+  clutter_actor_set_background_color (data->actor, CLUTTER_COLOR_Red);
+  clutter_actor_set_position (data->actor, x, 0);
+  clutter_actor_set_size (data->actor, size, size);
+
+  data->effect = g_object_new (foo_pool_effect_get_type (), NULL);
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (data->effect),
+                                                  persistent);
+  clutter_actor_add_effect (data->actor, CLUTTER_EFFECT (data->effect));
+
+  data->n_paints = 0;
+  g_signal_connect (data->actor, "paint", G_CALLBACK (on_paint), data);
+
+  clutter_actor_add_child (stage, data->actor);
+}
+
+static void
+redraw_stage (ClutterActor *stage)
+{
+  GMainLoop *main_loop = g_main_loop_new (NULL, FALSE);
+  guint paint_handler;
+
+  paint_handler = g_signal_connect_swapped (stage, "after-paint",
+                                            G_CALLBACK (g_main_loop_quit),
+                                            main_loop);
+
+  /* the actors are not dirty, so the effects can paint their target
+   * again without painting their actor
+   */
+  clutter_actor_queue_redraw (stage);
+  g_main_loop_run (main_loop);
+
+  g_signal_handler_disconnect (stage, paint_handler);
+  g_main_loop_unref (main_loop);
+}
+
+static void
+check_target_size (PoolActor *data,
+                   gboolean   persistent)
+{
+  gint width = cogl_texture_get_width (data->effect->texture);
+  gint height = cogl_texture_get_height (data->effect->texture);
+
+  if (persistent)
+    {
+      /* a persistent effect has a texture of the size of its actor */
+      g_assert_cmpint (width, ==, clutter_rect_get_width (&data->effect->rect));
+      g_assert_cmpint (height, ==, clutter_rect_get_height (&data->effect->rect));
+    }
+  else
+    {
+      /* a shared texture is rounded up */
+      g_assert_cmpint (width % BUCKET_SIZE, ==, 0);
+      g_assert_cmpint (height % BUCKET_SIZE, ==, 0);
+      g_assert_cmpint (width, >=, clutter_rect_get_width (&data->effect->rect));
+      g_assert_cmpint (height, >=, clutter_rect_get_height (&data->effect->rect));
+    }
+}
+
+static void
+actor_offscreen_pool_share (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  PoolActor first, second, persistent;
+
+  if (!cogl_features_available (COGL_FEATURE_OFFSCREEN))
+    return;
+
+  pool_actor_init (&first, stage, 0, 50, FALSE);
+  pool_actor_init (&second, stage, 100, 60, FALSE);
+  pool_actor_init (&persistent, stage, 200, 50, TRUE);
+
+  clutter_actor_show (stage);
+  redraw_stage (stage);
+
+  check_target_size (&first, FALSE);
+  check_target_size (&second, FALSE);
+  check_target_size (&persistent, TRUE);
+
+  /* the effects that are not persistent are painted one after the
+   * other, so they use the same render target
+   */
+  g_assert (first.effect->texture == second.effect->texture);
+  g_assert (persistent.effect->texture != first.effect->texture);
+
+  /* and each of them painted over the contents of the other, so they
+   * have to paint their actor again
+   */
+  first.n_paints = second.n_paints = persistent.n_paints = 0;
+  redraw_stage (stage);
+
+  g_assert_cmpuint (first.n_paints, ==, 1);
+  g_assert_cmpuint (second.n_paints, ==, 1);
+  g_assert_cmpuint (persistent.n_paints, ==, 0);
+
+  clutter_actor_destroy (first.actor);
+  clutter_actor_destroy (second.actor);
+  clutter_actor_destroy (persistent.actor);
+}
+
+static void
+actor_offscreen_pool_reclaim (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  PoolActor first, second;
+
+  if (!cogl_features_available (COGL_FEATURE_OFFSCREEN))
+    return;
+
+  pool_actor_init (&first, stage, 0, 50, FALSE);
+
+  clutter_actor_show (stage);
+  redraw_stage (stage);
+
+  /* nobody used the render target since the last paint, so the
+   * effect reclaims it with its contents
+   */
+  first.n_paints = 0;
+  redraw_stage (stage);
+  g_assert_cmpuint (first.n_paints, ==, 0);
+
+  /* an effect painted after it takes the render target over... */
+  pool_actor_init (&second, stage, 100, 50, FALSE);
+  redraw_stage (stage);
+  g_assert_cmpuint (first.n_paints, ==, 0);
+  g_assert_cmpuint (second.n_paints, ==, 1);
+  g_assert (first.effect->texture == second.effect->texture);
+
+  /* ...so the next paint cannot reclaim it */
+  first.n_paints = second.n_paints = 0;
+  redraw_stage (stage);
+  g_assert_cmpuint (first.n_paints, ==, 1);
+
+  clutter_actor_destroy (first.actor);
+  clutter_actor_destroy (second.actor);
+}
+
+static void
+actor_offscreen_pool_budget (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  PoolActor first, second;
+
+  if (!cogl_features_available (COGL_FEATURE_OFFSCREEN))
+    return;
+
+  /* render targets of different sizes are all kept, as long as they
+   * fit in the budget
+   */
+  pool_actor_init (&first, stage, 0, 50, FALSE);
+  pool_actor_init (&second, stage, 100, 100, FALSE);
+
+  clutter_actor_show (stage);
+  redraw_stage (stage);
+
+  g_assert (first.effect->texture != second.effect->texture);
+
+  first.n_paints = second.n_paints = 0;
+  redraw_stage (stage);
+  g_assert_cmpuint (first.n_paints, ==, 0);
+  g_assert_cmpuint (second.n_paints, ==, 0);
+
+  /* two targets of more than half a megabyte do not fit in a budget
+   * of one megabyte, so allocating one destroys the other
+   */
+  clutter_actor_set_size (first.actor, 416, 416);
+  clutter_actor_set_size (second.actor, 384, 384);
+  clutter_actor_set_x (second.actor, 224);
+  redraw_stage (stage);
+
+  first.n_paints = second.n_paints = 0;
+  redraw_stage (stage);
+  g_assert_cmpuint (first.n_paints, ==, 1);
+  g_assert_cmpuint (second.n_paints, ==, 1);
+
+  clutter_actor_destroy (first.actor);
+  clutter_actor_destroy (second.actor);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  /* the budget is read when Clutter is initialized, in megabytes */
+  g_setenv ("CLUTTER_OFFSCREEN_BUDGET", "1", TRUE);
+
+  clutter_test_init (&argc, &argv);
+
+  clutter_test_add ("/actor/offscreen/pool/share", actor_offscreen_pool_share);
+  clutter_test_add ("/actor/offscreen/pool/reclaim", actor_offscreen_pool_reclaim);
+  clutter_test_add ("/actor/offscreen/pool/budget", actor_offscreen_pool_budget);
+
+  return clutter_test_run ();
+}
@@ -0,0 +1,122 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actor;
+
+  ClutterInputDevice *pointer;
+
+  guint n_motion_events;
+  guint n_picks;
+} PickCacheData;
+
+static void
+on_pick (ClutterActor       *actor,
+         const ClutterColor *color,
+         PickCacheData      *data)
+{
+  data->n_picks += 1;
+}
+
+static gboolean
+on_captured_event (ClutterActor  *stage,
+                   ClutterEvent  *event,
+                   PickCacheData *data)
+{
+  if (clutter_event_type (event) == CLUTTER_MOTION)
+    data->n_motion_events += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static ClutterActor *
+move_pointer (PickCacheData *data,
+              gfloat         x,
+              gfloat         y)
+{
+  ClutterEvent *event;
+  guint n_motion_events;
+
+  event = clutter_event_new (CLUTTER_MOTION);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+  clutter_event_set_device (event, data->pointer);
+  clutter_event_set_coords (event, x, y);
+
+  clutter_input_device_update_from_event (data->pointer, event, TRUE);
+
+  n_motion_events = data->n_motion_events;
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+
+  while (data->n_motion_events == n_motion_events)
+    g_main_context_iteration (NULL, FALSE);
+
+  return clutter_input_device_get_pointer_actor (data->pointer);
+}
+
+static void
+actor_pick_cache_reactive (void)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+  PickCacheData data = { NULL, };
+  ClutterPoint point = CLUTTER_POINT_INIT (50, 50);
+  ClutterActor *result = NULL;
+
+  data.pointer = clutter_device_manager_get_core_device (manager,
+                                                         CLUTTER_POINTER_DEVICE);
+  if (data.pointer == NULL)
+    {
+      if (g_test_verbose ())
+        g_print ("No core pointer device available, skipping.\n");
+
+      return;
+    }
+
+  data.stage = clutter_test_get_stage ();
+  g_signal_connect (data.stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    &data);
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 100, 100);
+  clutter_actor_set_reactive (data.actor, TRUE);
+  clutter_actor_add_child (data.stage, data.actor);
+
+  g_signal_connect (data.actor, "pick", G_CALLBACK (on_pick), &data);
+
+  clutter_actor_show (data.stage);
+
+  /* wait until the stage has been laid out and painted */
+  clutter_test_check_actor_at_point (data.stage, &point, data.actor, &result);
+  g_assert (result == data.actor);
+
+  /* the following motions are inside the cached region of the actor,
+   * and nothing changed in the scene, so the stage is not picked again
+   */
+  g_assert (move_pointer (&data, 50, 50) == data.actor);
+
+  data.n_picks = 0;
+  g_assert (move_pointer (&data, 51, 51) == data.actor);
+  g_assert (move_pointer (&data, 50, 51) == data.actor);
+  g_assert_cmpuint (data.n_picks, ==, 0);
+
+  /* changing the reactive state does not queue a redraw, but it must
+   * still invalidate the cached region
+   */
+  clutter_actor_set_reactive (data.actor, FALSE);
+  g_assert (move_pointer (&data, 52, 52) == data.stage);
+
+  clutter_actor_set_flags (data.actor, CLUTTER_ACTOR_REACTIVE);
+  g_assert (move_pointer (&data, 53, 53) == data.actor);
+
+  clutter_actor_unset_flags (data.actor, CLUTTER_ACTOR_REACTIVE);
+  g_assert (move_pointer (&data, 54, 54) == data.stage);
+
+  g_signal_handlers_disconnect_by_data (data.stage, &data);
+  clutter_actor_destroy (data.actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/pick-cache/reactive", actor_pick_cache_reactive)
+)
@@ -194,16 +194,23 @@ foo_another_new_shader_effect_init (FooAnotherNewShaderEffect *self)
 /****************************************************************/
 
 static ClutterActor *
-make_actor (GType shader_type)
+make_actor (GType    shader_type,
+            gboolean persistent)
 {
   ClutterActor *rect;
+  ClutterEffect *effect;
   const ClutterColor white = { 0xff, 0xff, 0xff, 0xff };
 
   rect = clutter_rectangle_new ();
   clutter_rectangle_set_color (CLUTTER_RECTANGLE (rect), &white);
   clutter_actor_set_size (rect, 50, 50);
 
-  clutter_actor_add_effect (rect, g_object_new (shader_type, NULL));
+  effect = g_object_new (shader_type, NULL);
+  clutter_offscreen_effect_set_persistent_target (CLUTTER_OFFSCREEN_EFFECT (effect),
+                                                  persistent);
+  g_assert (clutter_offscreen_effect_get_persistent_target (CLUTTER_OFFSCREEN_EFFECT (effect)) == persistent);
+
+  clutter_actor_add_effect (rect, effect);
 
   return rect;
 }
@@ -241,8 +248,11 @@ paint_cb (ClutterStage *stage,
   *was_painted = TRUE;
 }
 
+/* the effects share their render targets, unless they are persistent;
+ * in both cases, each actor must be painted with its own contents
+ */
 static void
-actor_shader_effect (void)
+run_actor_shader_effect (gboolean persistent)
 {
   ClutterActor *stage;
   ClutterActor *rect;
@@ -253,18 +263,18 @@ actor_shader_effect (void)
 
   stage = clutter_stage_new ();
 
-  rect = make_actor (foo_old_shader_effect_get_type ());
+  rect = make_actor (foo_old_shader_effect_get_type (), persistent);
   clutter_container_add_actor (CLUTTER_CONTAINER (stage), rect);
 
-  rect = make_actor (foo_new_shader_effect_get_type ());
+  rect = make_actor (foo_new_shader_effect_get_type (), persistent);
   clutter_actor_set_x (rect, 100);
   clutter_container_add_actor (CLUTTER_CONTAINER (stage), rect);
 
-  rect = make_actor (foo_another_new_shader_effect_get_type ());
+  rect = make_actor (foo_another_new_shader_effect_get_type (), persistent);
   clutter_actor_set_x (rect, 200);
   clutter_container_add_actor (CLUTTER_CONTAINER (stage), rect);
 
-  rect = make_actor (foo_new_shader_effect_get_type ());
+  rect = make_actor (foo_new_shader_effect_get_type (), persistent);
   clutter_actor_set_x (rect, 300);
   clutter_container_add_actor (CLUTTER_CONTAINER (stage), rect);
 
@@ -277,8 +287,23 @@ actor_shader_effect (void)
 
   while (!was_painted)
     g_main_context_iteration (NULL, FALSE);
+
+  clutter_actor_destroy (stage);
+}
+
+static void
+actor_shader_effect (void)
+{
+  run_actor_shader_effect (FALSE);
+}
+
+static void
+actor_shader_effect_persistent (void)
+{
+  run_actor_shader_effect (TRUE);
 }
 
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/shader-effect", actor_shader_effect)
+  CLUTTER_TEST_UNIT ("/actor/shader-effect/persistent", actor_shader_effect_persistent)
 )
@@ -0,0 +1,214 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *actor;
+  GMainLoop *main_loop;
+  guint n_frames;
+  guint n_stopped;
+} TransitionData;
+
+static void
+on_opacity_new_frame (ClutterTimeline *timeline,
+                      gint             elapsed,
+                      TransitionData  *data)
+{
+  ClutterInterval *interval;
+  const GValue *value;
+
+  /* handlers of ::new-frame must see the value of the current frame */
+  interval = clutter_transition_get_interval (CLUTTER_TRANSITION (timeline));
+  value = clutter_interval_compute (interval, clutter_timeline_get_progress (timeline));
+
+  g_assert_cmpuint (clutter_actor_get_opacity (data->actor), ==, g_value_get_uint (value));
+
+  data->n_frames += 1;
+}
+
+static void
+on_transition_stopped (ClutterActor   *actor,
+                       const gchar    *name,
+                       gboolean        is_finished,
+                       TransitionData *data)
+{
+  ClutterColor color;
+
+  g_assert (is_finished);
+
+  /* the final values are set before the transitions are stopped */
+  if (g_strcmp0 (name, "x") == 0)
+    g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 150.f);
+  else if (g_strcmp0 (name, "opacity") == 0)
+    g_assert_cmpuint (clutter_actor_get_opacity (actor), ==, 0);
+  else if (g_strcmp0 (name, "background-color") == 0)
+    {
+      clutter_actor_get_background_color (actor, &color);
+      g_assert_cmpuint (color.red, ==, 0);
+      g_assert_cmpuint (color.green, ==, 0);
+      g_assert_cmpuint (color.blue, ==, 255);
+      g_assert_cmpuint (color.alpha, ==, 255);
+    }
+
+  data->n_stopped += 1;
+
+  if (data->n_stopped == 3)
+    g_main_loop_quit (data->main_loop);
+}
+
+static void
+actor_implicit_transitions (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  TransitionData data = { NULL, };
+  ClutterTransition *transition;
+  gfloat x;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 50, 50);
+  clutter_actor_set_background_color (data.actor, CLUTTER_COLOR_Red);
+  clutter_actor_add_child (stage, data.actor);
+  clutter_actor_show (stage);
+
+  g_signal_connect (data.actor, "transition-stopped",
+                    G_CALLBACK (on_transition_stopped),
+                    &data);
+
+  clutter_actor_save_easing_state (data.actor);
+  clutter_actor_set_easing_duration (data.actor, 250);
+  clutter_actor_set_easing_mode (data.actor, CLUTTER_LINEAR);
+  clutter_actor_set_x (data.actor, 100);
+  clutter_actor_set_opacity (data.actor, 0);
+  clutter_actor_set_background_color (data.actor, CLUTTER_COLOR_Blue);
+  clutter_actor_restore_easing_state (data.actor);
+
+  /* the implicit transitions do not change the value immediately */
+  g_assert_cmpfloat (clutter_actor_get_x (data.actor), ==, 0.f);
+
+  transition = clutter_actor_get_transition (data.actor, "opacity");
+  g_assert (CLUTTER_IS_PROPERTY_TRANSITION (transition));
+  g_signal_connect_after (transition, "new-frame",
+                          G_CALLBACK (on_opacity_new_frame),
+                          &data);
+
+  /* changing the interval of a running transition is honoured */
+  transition = clutter_actor_get_transition (data.actor, "x");
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, 150.f);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_stopped, ==, 3);
+  g_assert_cmpuint (data.n_frames, >, 0);
+  g_assert (clutter_actor_get_transition (data.actor, "x") == NULL);
+
+  x = clutter_actor_get_x (data.actor);
+  g_assert_cmpfloat (x, ==, 150.f);
+
+  clutter_actor_destroy (data.actor);
+  g_main_loop_unref (data.main_loop);
+}
+
+typedef struct {
+  GMainLoop *main_loop;
+  guint n_width_notify;
+  guint n_x_notify;
+  guint n_frames;
+  guint n_stopped;
+
+  /* the position of the actor at the last notify::x */
+  gfloat notified_x;
+} BatchData;
+
+static void
+on_batch_notify (GObject    *gobject,
+                 GParamSpec *pspec,
+                 BatchData  *data)
+{
+  if (g_strcmp0 (pspec->name, "width") == 0)
+    data->n_width_notify += 1;
+  else if (g_strcmp0 (pspec->name, "x") == 0)
+    {
+      data->n_x_notify += 1;
+      data->notified_x = clutter_actor_get_x (CLUTTER_ACTOR (gobject));
+    }
+}
+
+static void
+on_batch_after_paint (ClutterStage *stage,
+                      BatchData    *data)
+{
+  data->n_frames += 1;
+}
+
+static void
+on_batch_transition_stopped (ClutterActor *actor,
+                             const gchar  *name,
+                             gboolean      is_finished,
+                             BatchData    *data)
+{
+  /* the last value has been notified by the time the transition stops */
+  if (g_strcmp0 (name, "x") == 0)
+    g_assert_cmpfloat (data->notified_x, ==, 100.f);
+
+  data->n_stopped += 1;
+
+  if (data->n_stopped == 2)
+    g_main_loop_quit (data->main_loop);
+}
+
+static void
+actor_batched_transitions (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  BatchData data = { NULL, };
+  ClutterPoint point = CLUTTER_POINT_INIT (25, 25);
+  gulong after_paint_id;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_position (actor, 0, 0);
+  clutter_actor_set_size (actor, 50, 50);
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_add_child (stage, actor);
+  clutter_actor_show (stage);
+
+  /* wait until the actor has been allocated */
+  clutter_test_assert_actor_at_point (stage, &point, actor);
+
+  g_signal_connect (actor, "notify", G_CALLBACK (on_batch_notify), &data);
+  g_signal_connect (actor, "transition-stopped",
+                    G_CALLBACK (on_batch_transition_stopped),
+                    &data);
+  after_paint_id = g_signal_connect (stage, "after-paint",
+                                     G_CALLBACK (on_batch_after_paint),
+                                     &data);
+
+  /* moving diagonally animates two properties of the same actor */
+  clutter_actor_save_easing_state (actor);
+  clutter_actor_set_easing_duration (actor, 250);
+  clutter_actor_set_x (actor, 100);
+  clutter_actor_set_y (actor, 100);
+  clutter_actor_restore_easing_state (actor);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_frames, >, 0);
+
+  /* the size never changes, and the position is notified at most once
+   * per frame, when the actor is allocated
+   */
+  g_assert_cmpuint (data.n_width_notify, ==, 0);
+  g_assert_cmpuint (data.n_x_notify, <=, data.n_frames + 1);
+
+  g_signal_handler_disconnect (stage, after_paint_id);
+
+  clutter_actor_destroy (actor);
+  g_main_loop_unref (data.main_loop);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/transitions/implicit", actor_implicit_transitions)
+  CLUTTER_TEST_UNIT ("/actor/transitions/batched", actor_batched_transitions)
+)
@@ -0,0 +1,171 @@
+#include <clutter/clutter.h>
+
+#define SEQUENCE(n)     ((ClutterEventSequence *) GINT_TO_POINTER (n))
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actor;
+  ClutterGestureAction *action;
+
+  ClutterInputDevice *device;
+  guint32 time_;
+
+  guint n_events;
+} TouchPointsData;
+
+static gboolean
+on_captured_event (ClutterActor    *stage,
+                   ClutterEvent    *event,
+                   TouchPointsData *data)
+{
+  data->n_events += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+send_touch (TouchPointsData  *data,
+            ClutterEventType  event_type,
+            gint              sequence,
+            gfloat            x,
+            gfloat            y)
+{
+  ClutterEvent *event;
+  guint n_events;
+
+  data->time_ += 10;
+
+  event = clutter_event_new (event_type);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+  clutter_event_set_source (event, data->actor);
+  clutter_event_set_device (event, data->device);
+  clutter_event_set_coords (event, x, y);
+  clutter_event_set_time (event, data->time_);
+  event->touch.sequence = SEQUENCE (sequence);
+
+  n_events = data->n_events;
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+
+  /* consecutive updates are compressed, so we wait until each event
+   * has been delivered before sending the next one
+   */
+  while (data->n_events == n_events)
+    g_main_context_iteration (NULL, FALSE);
+}
+
+static void
+check_point (TouchPointsData *data,
+             guint            point,
+             gint             sequence,
+             gfloat           x,
+             gfloat           y)
+{
+  gfloat motion_x, motion_y;
+
+  g_assert (clutter_gesture_action_get_sequence (data->action, point) == SEQUENCE (sequence));
+  g_assert (clutter_gesture_action_get_device (data->action, point) == data->device);
+
+  clutter_gesture_action_get_motion_coords (data->action, point, &motion_x, &motion_y);
+  g_assert_cmpfloat (motion_x, ==, x);
+  g_assert_cmpfloat (motion_y, ==, y);
+}
+
+static void
+gesture_touch_points_sequences (void)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+  TouchPointsData data = { NULL, };
+
+  data.device = clutter_device_manager_get_core_device (manager,
+                                                        CLUTTER_POINTER_DEVICE);
+  if (data.device == NULL)
+    {
+      if (g_test_verbose ())
+        g_print ("No core pointer device available, skipping.\n");
+
+      return;
+    }
+
+  data.stage = clutter_test_get_stage ();
+  g_signal_connect (data.stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    &data);
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 200, 200);
+  clutter_actor_set_reactive (data.actor, TRUE);
+  clutter_actor_add_child (data.stage, data.actor);
+
+  /* more points than we are going to use, so that the gesture never
+   * begins and every touch point stays tracked
+   */
+  data.action = CLUTTER_GESTURE_ACTION (clutter_gesture_action_new ());
+  clutter_gesture_action_set_n_touch_points (data.action, 10);
+  clutter_actor_add_action (data.actor, CLUTTER_ACTION (data.action));
+
+  clutter_actor_show (data.stage);
+
+  /* several sequences on the same device are separate points, kept in
+   * the order they were pressed
+   */
+  send_touch (&data, CLUTTER_TOUCH_BEGIN, 1, 10, 10);
+  send_touch (&data, CLUTTER_TOUCH_BEGIN, 2, 20, 20);
+  send_touch (&data, CLUTTER_TOUCH_BEGIN, 3, 30, 30);
+
+  g_assert_cmpuint (clutter_gesture_action_get_n_current_points (data.action), ==, 3);
+  check_point (&data, 0, 1, 10, 10);
+  check_point (&data, 1, 2, 20, 20);
+  check_point (&data, 2, 3, 30, 30);
+
+  /* an update only moves the point of its own sequence */
+  send_touch (&data, CLUTTER_TOUCH_UPDATE, 2, 25, 25);
+
+  check_point (&data, 0, 1, 10, 10);
+  check_point (&data, 1, 2, 25, 25);
+  check_point (&data, 2, 3, 30, 30);
+
+  /* removing a point keeps the order of the others, and they can
+   * still be looked up
+   */
+  send_touch (&data, CLUTTER_TOUCH_END, 2, 25, 25);
+
+  g_assert_cmpuint (clutter_gesture_action_get_n_current_points (data.action), ==, 2);
+  check_point (&data, 0, 1, 10, 10);
+  check_point (&data, 1, 3, 30, 30);
+
+  send_touch (&data, CLUTTER_TOUCH_UPDATE, 3, 35, 35);
+  check_point (&data, 1, 3, 35, 35);
+
+  /* the sequence of a removed point can be used again */
+  send_touch (&data, CLUTTER_TOUCH_BEGIN, 4, 40, 40);
+  send_touch (&data, CLUTTER_TOUCH_BEGIN, 2, 50, 50);
+
+  g_assert_cmpuint (clutter_gesture_action_get_n_current_points (data.action), ==, 4);
+  check_point (&data, 0, 1, 10, 10);
+  check_point (&data, 1, 3, 35, 35);
+  check_point (&data, 2, 4, 40, 40);
+  check_point (&data, 3, 2, 50, 50);
+
+  send_touch (&data, CLUTTER_TOUCH_UPDATE, 2, 55, 55);
+  check_point (&data, 3, 2, 55, 55);
+
+  /* events of sequences that are not tracked are ignored */
+  send_touch (&data, CLUTTER_TOUCH_UPDATE, 5, 60, 60);
+  g_assert_cmpuint (clutter_gesture_action_get_n_current_points (data.action), ==, 4);
+
+  send_touch (&data, CLUTTER_TOUCH_END, 1, 10, 10);
+  send_touch (&data, CLUTTER_TOUCH_END, 2, 55, 55);
+  send_touch (&data, CLUTTER_TOUCH_END, 3, 35, 35);
+  send_touch (&data, CLUTTER_TOUCH_END, 4, 40, 40);
+
+  g_assert_cmpuint (clutter_gesture_action_get_n_current_points (data.action), ==, 0);
+
+  g_signal_handlers_disconnect_by_data (data.stage, &data);
+  clutter_actor_destroy (data.actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/gesture/touch-points/sequences", gesture_touch_points_sequences)
+)
@@ -110,8 +110,61 @@ interval_from_script (void)
   g_free (test_file);
 }
 
+static void
+interval_compute_boxed (void)
+{
+  ClutterInterval *interval;
+  const GValue *value;
+  const ClutterColor *color;
+  ClutterPoint a = CLUTTER_POINT_INIT (0, 0);
+  ClutterPoint b = CLUTTER_POINT_INIT (100, 50);
+  const ClutterPoint *point;
+  ClutterColor *copy;
+  GValue result = G_VALUE_INIT;
+
+  interval = clutter_interval_new (CLUTTER_TYPE_COLOR,
+                                   CLUTTER_COLOR_Black,
+                                   CLUTTER_COLOR_White);
+
+  value = clutter_interval_compute (interval, 0.5);
+  g_assert (CLUTTER_VALUE_HOLDS_COLOR (value));
+  color = clutter_value_get_color (value);
+  g_assert_cmpuint (color->red, ==, 127);
+  g_assert_cmpuint (color->alpha, ==, 255);
+
+  /* the computed value is kept up to date with the interval */
+  clutter_interval_set_final (interval, CLUTTER_COLOR_Red);
+  value = clutter_interval_compute (interval, 1.0);
+  color = clutter_value_get_color (value);
+  g_assert_cmpuint (color->red, ==, 255);
+  g_assert_cmpuint (color->green, ==, 0);
+
+  /* values computed into a caller GValue are copies */
+  g_value_init (&result, CLUTTER_TYPE_COLOR);
+  g_assert (clutter_interval_compute_value (interval, 0.0, &result));
+  copy = g_value_dup_boxed (&result);
+  clutter_interval_compute (interval, 1.0);
+  g_assert_cmpuint (copy->red, ==, 0);
+  g_assert_cmpuint (clutter_value_get_color (&result)->red, ==, 0);
+  clutter_color_free (copy);
+  g_value_unset (&result);
+
+  g_object_unref (interval);
+
+  interval = clutter_interval_new (CLUTTER_TYPE_POINT, &a, &b);
+
+  value = clutter_interval_compute (interval, 0.25);
+  g_assert (G_VALUE_HOLDS (value, CLUTTER_TYPE_POINT));
+  point = g_value_get_boxed (value);
+  g_assert_cmpfloat (point->x, ==, 25.f);
+  g_assert_cmpfloat (point->y, ==, 12.5f);
+
+  g_object_unref (interval);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/interval/initial-state", interval_initial_state)
   CLUTTER_TEST_UNIT ("/interval/transform", interval_transform)
+  CLUTTER_TEST_UNIT ("/interval/compute-boxed", interval_compute_boxed)
   CLUTTER_TEST_UNIT ("/interval/from-script", interval_from_script)
 )
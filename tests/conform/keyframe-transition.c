@@ -0,0 +1,193 @@
+#include <clutter/clutter.h>
+
+/* the key frames go back and forth between 0 and 100, so that each
+ * segment has to be found to compute the right value
+ */
+#define N_KEY_FRAMES    8
+#define DURATION        900
+#define FRAME_STEP      250
+
+typedef struct {
+  ClutterActor *actor;
+  GMainLoop *main_loop;
+  guint n_frames;
+} KeyframeData;
+
+static float
+key_frame_value (guint index_)
+{
+  return (index_ % 2) * 100.f;
+}
+
+static float
+expected_value (guint elapsed)
+{
+  double p = (double) elapsed / DURATION * (N_KEY_FRAMES + 1);
+  guint segment = MIN ((guint) p, N_KEY_FRAMES);
+  float from = key_frame_value (segment);
+  float to = key_frame_value (segment + 1);
+
+  return from + (to - from) * (p - segment);
+}
+
+static void
+on_new_frame (ClutterTimeline *timeline,
+              gint             elapsed,
+              KeyframeData    *data)
+{
+  float x = clutter_actor_get_x (data->actor);
+
+  g_assert_cmpfloat (ABS (x - expected_value (elapsed)), <, 0.5f);
+
+  data->n_frames += 1;
+
+  /* slow frames, so that each frame skips at least one key frame */
+  g_usleep (FRAME_STEP * 1000);
+}
+
+static void
+on_stopped (ClutterTimeline *timeline,
+            gboolean         is_finished,
+            KeyframeData    *data)
+{
+  g_main_loop_quit (data->main_loop);
+}
+
+static void
+run_keyframe_transition (ClutterTimelineDirection direction)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  KeyframeData data = { NULL, };
+  ClutterTransition *transition;
+  double keys[N_KEY_FRAMES];
+  GValue values[N_KEY_FRAMES] = { G_VALUE_INIT, };
+  guint i;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_add_child (stage, data.actor);
+
+  transition = clutter_keyframe_transition_new ("x");
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), DURATION);
+  clutter_timeline_set_direction (CLUTTER_TIMELINE (transition), direction);
+  clutter_transition_set_from (transition, G_TYPE_FLOAT, key_frame_value (0));
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, key_frame_value (N_KEY_FRAMES + 1));
+
+  /* set the key frames out of order */
+  for (i = 0; i < N_KEY_FRAMES; i++)
+    {
+      guint index_ = N_KEY_FRAMES - i;
+
+      keys[i] = (double) index_ / (N_KEY_FRAMES + 1);
+
+      g_value_init (&values[i], G_TYPE_FLOAT);
+      g_value_set_float (&values[i], key_frame_value (index_));
+    }
+
+  clutter_keyframe_transition_set_key_frames (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                              N_KEY_FRAMES, keys);
+  clutter_keyframe_transition_set_values (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                          N_KEY_FRAMES, values);
+
+  g_signal_connect_after (transition, "new-frame", G_CALLBACK (on_new_frame), &data);
+  g_signal_connect (transition, "stopped", G_CALLBACK (on_stopped), &data);
+
+  clutter_actor_add_transition (data.actor, "x", transition);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_frames, >, 0);
+  g_assert_cmpuint (data.n_frames, <, N_KEY_FRAMES);
+
+  for (i = 0; i < N_KEY_FRAMES; i++)
+    g_value_unset (&values[i]);
+
+  g_object_unref (transition);
+  clutter_actor_destroy (data.actor);
+  g_main_loop_unref (data.main_loop);
+}
+
+static void
+keyframe_transition_forward (void)
+{
+  run_keyframe_transition (CLUTTER_TIMELINE_FORWARD);
+}
+
+static void
+keyframe_transition_backward (void)
+{
+  run_keyframe_transition (CLUTTER_TIMELINE_BACKWARD);
+}
+
+static void
+on_mode_new_frame (ClutterTimeline *timeline,
+                   gint             elapsed,
+                   KeyframeData    *data)
+{
+  double p = (double) elapsed / DURATION;
+  float x = clutter_actor_get_x (data->actor);
+
+  /* the transition has already compiled its key frames when the first
+   * frame is emitted
+   */
+  if (data->n_frames++ == 0)
+    clutter_timeline_set_progress_mode (timeline, CLUTTER_EASE_IN_QUAD);
+
+  /* the implicit last key frame follows the mode of the transition */
+  if (p > 0.5)
+    {
+      double q = (p - 0.5) / 0.5;
+
+      g_assert_cmpfloat (ABS (x - (100.f + 100.f * q * q)), <, 0.5f);
+    }
+}
+
+static void
+keyframe_transition_progress_mode (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  KeyframeData data = { NULL, };
+  ClutterTransition *transition;
+  double key = 0.5;
+  GValue value = G_VALUE_INIT;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_add_child (stage, data.actor);
+
+  transition = clutter_keyframe_transition_new ("x");
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), DURATION);
+  clutter_timeline_set_progress_mode (CLUTTER_TIMELINE (transition), CLUTTER_LINEAR);
+  clutter_transition_set_from (transition, G_TYPE_FLOAT, 0.f);
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, 200.f);
+
+  g_value_init (&value, G_TYPE_FLOAT);
+  g_value_set_float (&value, 100.f);
+  clutter_keyframe_transition_set_key_frames (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                              1, &key);
+  clutter_keyframe_transition_set_values (CLUTTER_KEYFRAME_TRANSITION (transition),
+                                          1, &value);
+  g_value_unset (&value);
+
+  g_signal_connect_after (transition, "new-frame", G_CALLBACK (on_mode_new_frame), &data);
+  g_signal_connect (transition, "stopped", G_CALLBACK (on_stopped), &data);
+
+  clutter_actor_add_transition (data.actor, "x", transition);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_frames, >, 0);
+  g_assert_cmpfloat (clutter_actor_get_x (data.actor), ==, 200.f);
+
+  g_object_unref (transition);
+  clutter_actor_destroy (data.actor);
+  g_main_loop_unref (data.main_loop);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/keyframe-transition/forward", keyframe_transition_forward)
+  CLUTTER_TEST_UNIT ("/keyframe-transition/backward", keyframe_transition_backward)
+  CLUTTER_TEST_UNIT ("/keyframe-transition/progress-mode", keyframe_transition_progress_mode)
+)
@@ -0,0 +1,108 @@
+#include <clutter/clutter.h>
+
+#define DURATION        500
+
+typedef struct {
+  GMainLoop *main_loop;
+  GArray *elapsed;
+
+  /* how long each frame takes on the wall clock, in msecs */
+  guint frame_cost;
+} VirtualClockData;
+
+static void
+on_new_frame (ClutterTimeline  *timeline,
+              gint              elapsed,
+              VirtualClockData *data)
+{
+  g_array_append_val (data->elapsed, elapsed);
+
+  if (data->frame_cost > 0)
+    g_usleep (data->frame_cost * 1000);
+}
+
+static void
+on_completed (ClutterTimeline  *timeline,
+              VirtualClockData *data)
+{
+  g_main_loop_quit (data->main_loop);
+}
+
+static void
+run_timeline (VirtualClockData *data)
+{
+  ClutterTimeline *timeline = clutter_timeline_new (DURATION);
+
+  data->main_loop = g_main_loop_new (NULL, FALSE);
+  data->elapsed = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  g_signal_connect (timeline, "new-frame", G_CALLBACK (on_new_frame), data);
+  g_signal_connect (timeline, "completed", G_CALLBACK (on_completed), data);
+
+  clutter_timeline_start (timeline);
+
+  g_main_loop_run (data->main_loop);
+
+  g_object_unref (timeline);
+  g_main_loop_unref (data->main_loop);
+}
+
+static void
+check_frame_steps (GArray *elapsed,
+                   gint    min_step,
+                   gint    max_step)
+{
+  guint i;
+
+  /* the first frame starts the timeline, and the last one is clamped
+   * to its duration
+   */
+  g_assert_cmpint (g_array_index (elapsed, gint, 0), ==, 0);
+  g_assert_cmpint (g_array_index (elapsed, gint, elapsed->len - 1), ==, DURATION);
+
+  for (i = 1; i < elapsed->len - 1; i++)
+    {
+      gint step = g_array_index (elapsed, gint, i)
+                - g_array_index (elapsed, gint, i - 1);
+
+      g_assert_cmpint (step, >=, min_step);
+      g_assert_cmpint (step, <=, max_step);
+    }
+}
+
+static void
+master_clock_virtual_frames (void)
+{
+  VirtualClockData data = { NULL, };
+  gint frame_interval = 1000 / clutter_get_default_frame_rate ();
+
+  /* each frame takes longer than a frame interval on the wall clock,
+   * but the virtual time still advances by exactly one interval
+   */
+  data.frame_cost = frame_interval * 2;
+
+  run_timeline (&data);
+
+  /* the virtual time is kept in microseconds, so the timeline can see
+   * it move by one millisecond more than the interval
+   */
+  check_frame_steps (data.elapsed, frame_interval, frame_interval + 1);
+  g_assert_cmpuint (data.elapsed->len, >=, DURATION / (frame_interval + 1));
+  g_assert_cmpuint (data.elapsed->len, <=, DURATION / frame_interval + 2);
+
+  g_array_unref (data.elapsed);
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  /* the master clock is chosen when Clutter is initialized */
+  g_setenv ("CLUTTER_VIRTUAL_CLOCK", "1", TRUE);
+
+  clutter_test_init (&argc, &argv);
+
+  clutter_test_add ("/master-clock/virtual/frames", master_clock_virtual_frames);
+
+  return clutter_test_run ();
+}
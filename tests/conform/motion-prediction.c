@@ -0,0 +1,268 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actor;
+
+  ClutterInputDevice *pointer;
+  guint32 time_;
+
+  guint n_events;
+
+  /* the coordinates of the touch point at the last progress */
+  gfloat motion_x, motion_y;
+  gfloat predicted_x, predicted_y;
+
+  /* the child transform of the actor after the last ::pan */
+  gfloat pan_x, pan_y;
+} PredictionData;
+
+static gboolean
+on_captured_event (ClutterActor   *stage,
+                   ClutterEvent   *event,
+                   PredictionData *data)
+{
+  data->n_events += 1;
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+static void
+send_event (PredictionData   *data,
+            ClutterEventType  event_type,
+            gfloat            x,
+            gfloat            y,
+            guint32           d_t)
+{
+  ClutterEvent *event;
+  guint n_events;
+
+  data->time_ += d_t;
+
+  event = clutter_event_new (event_type);
+  clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+  clutter_event_set_source (event, data->actor);
+  clutter_event_set_device (event, data->pointer);
+  clutter_event_set_coords (event, x, y);
+  clutter_event_set_time (event, data->time_);
+
+  if (event_type == CLUTTER_MOTION)
+    clutter_event_set_state (event, CLUTTER_BUTTON1_MASK);
+  else
+    clutter_event_set_button (event, CLUTTER_BUTTON_PRIMARY);
+
+  n_events = data->n_events;
+
+  clutter_do_event (event);
+  clutter_event_free (event);
+
+  /* consecutive motion events are compressed, so we wait until each
+   * event has been delivered before sending the next one
+   */
+  while (data->n_events == n_events)
+    g_main_context_iteration (NULL, FALSE);
+}
+
+/* moves the pointer to the right at 1 pixel per millisecond */
+static void
+send_gesture (PredictionData *data)
+{
+  send_event (data, CLUTTER_BUTTON_PRESS, 10, 10, 100);
+  send_event (data, CLUTTER_MOTION, 20, 10, 10);
+  send_event (data, CLUTTER_MOTION, 30, 10, 10);
+  send_event (data, CLUTTER_MOTION, 40, 10, 10);
+  send_event (data, CLUTTER_BUTTON_RELEASE, 40, 10, 10);
+}
+
+static gboolean
+setup (PredictionData *data)
+{
+  ClutterDeviceManager *manager = clutter_device_manager_get_default ();
+
+  data->pointer = clutter_device_manager_get_core_device (manager,
+                                                          CLUTTER_POINTER_DEVICE);
+  if (data->pointer == NULL)
+    {
+      if (g_test_verbose ())
+        g_print ("No core pointer device available, skipping.\n");
+
+      return FALSE;
+    }
+
+  data->stage = clutter_test_get_stage ();
+  g_signal_connect (data->stage, "captured-event",
+                    G_CALLBACK (on_captured_event),
+                    data);
+
+  data->actor = clutter_actor_new ();
+  clutter_actor_set_size (data->actor, 100, 100);
+  clutter_actor_set_reactive (data->actor, TRUE);
+  clutter_actor_add_child (data->stage, data->actor);
+
+  clutter_actor_show (data->stage);
+
+  return TRUE;
+}
+
+static void
+teardown (PredictionData *data)
+{
+  g_signal_handlers_disconnect_by_data (data->stage, data);
+  clutter_actor_destroy (data->actor);
+}
+
+static void
+motion_prediction_properties (void)
+{
+  ClutterAction *gesture = clutter_gesture_action_new ();
+  ClutterAction *drag = clutter_drag_action_new ();
+  ClutterMotionPrediction prediction;
+
+  g_object_ref_sink (gesture);
+  g_object_ref_sink (drag);
+
+  g_assert_cmpint (clutter_gesture_action_get_motion_prediction (CLUTTER_GESTURE_ACTION (gesture)), ==,
+                   CLUTTER_MOTION_PREDICTION_NONE);
+  g_assert_cmpint (clutter_drag_action_get_motion_prediction (CLUTTER_DRAG_ACTION (drag)), ==,
+                   CLUTTER_MOTION_PREDICTION_NONE);
+
+  clutter_gesture_action_set_motion_prediction (CLUTTER_GESTURE_ACTION (gesture),
+                                                CLUTTER_MOTION_PREDICTION_LINEAR);
+  g_object_get (gesture, "motion-prediction", &prediction, NULL);
+  g_assert_cmpint (prediction, ==, CLUTTER_MOTION_PREDICTION_LINEAR);
+
+  g_object_set (drag, "motion-prediction", CLUTTER_MOTION_PREDICTION_SMOOTHED, NULL);
+  g_assert_cmpint (clutter_drag_action_get_motion_prediction (CLUTTER_DRAG_ACTION (drag)), ==,
+                   CLUTTER_MOTION_PREDICTION_SMOOTHED);
+
+  g_object_unref (gesture);
+  g_object_unref (drag);
+}
+
+static gboolean
+on_gesture_progress (ClutterGestureAction *action,
+                     ClutterActor         *actor,
+                     PredictionData       *data)
+{
+  clutter_gesture_action_get_motion_coords (action, 0,
+                                            &data->motion_x,
+                                            &data->motion_y);
+  clutter_gesture_action_get_predicted_coords (action, 0,
+                                               &data->predicted_x,
+                                               &data->predicted_y);
+
+  return TRUE;
+}
+
+static void
+check_predicted_coords (ClutterMotionPrediction prediction)
+{
+  PredictionData data = { NULL, };
+  ClutterAction *action;
+
+  if (!setup (&data))
+    return;
+
+  action = clutter_gesture_action_new ();
+  clutter_gesture_action_set_motion_prediction (CLUTTER_GESTURE_ACTION (action),
+                                                prediction);
+  g_signal_connect (action, "gesture-progress",
+                    G_CALLBACK (on_gesture_progress),
+                    &data);
+  clutter_actor_add_action (data.actor, action);
+
+  send_gesture (&data);
+
+  g_assert_cmpfloat (data.motion_x, ==, 40);
+  g_assert_cmpfloat (data.motion_y, ==, 10);
+
+  if (prediction == CLUTTER_MOTION_PREDICTION_NONE)
+    {
+      g_assert_cmpfloat (data.predicted_x, ==, data.motion_x);
+      g_assert_cmpfloat (data.predicted_y, ==, data.motion_y);
+    }
+  else
+    {
+      /* the pointer is ahead of the reported position, at least by a
+       * frame and never by more than the maximum prediction interval
+       */
+      g_assert_cmpfloat (data.predicted_x, >, data.motion_x);
+      g_assert_cmpfloat (data.predicted_x, <=, data.motion_x + 50);
+      g_assert_cmpfloat (data.predicted_y, ==, data.motion_y);
+    }
+
+  teardown (&data);
+}
+
+static void
+motion_prediction_gesture_none (void)
+{
+  check_predicted_coords (CLUTTER_MOTION_PREDICTION_NONE);
+}
+
+static void
+motion_prediction_gesture_linear (void)
+{
+  check_predicted_coords (CLUTTER_MOTION_PREDICTION_LINEAR);
+}
+
+static void
+motion_prediction_gesture_smoothed (void)
+{
+  check_predicted_coords (CLUTTER_MOTION_PREDICTION_SMOOTHED);
+}
+
+static gboolean
+on_pan (ClutterPanAction *action,
+        ClutterActor     *actor,
+        gboolean          is_interpolated,
+        PredictionData   *data)
+{
+  ClutterMatrix transform;
+
+  clutter_actor_get_child_transform (actor, &transform);
+  data->pan_x = transform.xw;
+  data->pan_y = transform.yw;
+
+  return TRUE;
+}
+
+static void
+motion_prediction_pan_settle (void)
+{
+  PredictionData data = { NULL, };
+  ClutterAction *action;
+  ClutterMatrix transform;
+
+  if (!setup (&data))
+    return;
+
+  action = clutter_pan_action_new ();
+  clutter_pan_action_set_interpolate (CLUTTER_PAN_ACTION (action), FALSE);
+  clutter_gesture_action_set_motion_prediction (CLUTTER_GESTURE_ACTION (action),
+                                                CLUTTER_MOTION_PREDICTION_LINEAR);
+  g_signal_connect_after (action, "pan", G_CALLBACK (on_pan), &data);
+  clutter_actor_add_action (data.actor, action);
+
+  send_gesture (&data);
+
+  /* while panning, the children follow the predicted position */
+  g_assert_cmpfloat (data.pan_x, >, 30);
+  g_assert_cmpfloat (data.pan_y, ==, 0);
+
+  /* and they end up where the pointer was released */
+  clutter_actor_get_child_transform (data.actor, &transform);
+  g_assert_cmpfloat (fabsf (transform.xw - 30), <, 0.01);
+  g_assert_cmpfloat (transform.yw, ==, 0);
+
+  teardown (&data);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/motion-prediction/properties", motion_prediction_properties)
+  CLUTTER_TEST_UNIT ("/motion-prediction/gesture-none", motion_prediction_gesture_none)
+  CLUTTER_TEST_UNIT ("/motion-prediction/gesture-linear", motion_prediction_gesture_linear)
+  CLUTTER_TEST_UNIT ("/motion-prediction/gesture-smoothed", motion_prediction_gesture_smoothed)
+  CLUTTER_TEST_UNIT ("/motion-prediction/pan-settle", motion_prediction_pan_settle)
+)
@@ -0,0 +1,91 @@
+#include <clutter/clutter.h>
+
+#define N_POSITIONS     64
+
+static void
+path_sampling_line (void)
+{
+  ClutterPath *path;
+  ClutterKnot position;
+  guint node;
+
+  path = clutter_path_new_with_description ("M 0 0 L 128 0 L 128 128 L 0 128 z");
+  g_object_ref_sink (path);
+
+  g_assert_cmpuint (clutter_path_get_length (path), ==, 512);
+
+  node = clutter_path_get_position (path, 0.125, &position);
+  g_assert_cmpuint (node, ==, 1);
+  g_assert_cmpint (position.x, ==, 64);
+  g_assert_cmpint (position.y, ==, 0);
+
+  node = clutter_path_get_position (path, 0.375, &position);
+  g_assert_cmpuint (node, ==, 2);
+  g_assert_cmpint (position.x, ==, 128);
+  g_assert_cmpint (position.y, ==, 64);
+
+  node = clutter_path_get_position (path, 0.875, &position);
+  g_assert_cmpuint (node, ==, 4);
+  g_assert_cmpint (position.x, ==, 0);
+  g_assert_cmpint (position.y, ==, 64);
+
+  /* the positions follow the changes of the path */
+  clutter_path_set_description (path, "M 0 0 L 0 512");
+
+  node = clutter_path_get_position (path, 0.125, &position);
+  g_assert_cmpuint (node, ==, 1);
+  g_assert_cmpint (position.x, ==, 0);
+  g_assert_cmpint (position.y, ==, 64);
+
+  g_object_unref (path);
+}
+
+static void
+path_sampling_batch (void)
+{
+  ClutterPath *path;
+  gdouble progress[N_POSITIONS];
+  ClutterKnot positions[N_POSITIONS];
+  guint nodes[N_POSITIONS];
+  guint i;
+
+  path = clutter_path_new_with_description ("M 21 22 "
+                                            "L 125 26 "
+                                            "C 229 30 31 232 233 134 "
+                                            "m 23 24 "
+                                            "l 27 28 "
+                                            "c 35 136 137 38 139 40 "
+                                            "z");
+  g_object_ref_sink (path);
+
+  /* the first half moves forward, the second half goes back */
+  for (i = 0; i < N_POSITIONS; i++)
+    {
+      if (i < N_POSITIONS / 2)
+        progress[i] = (gdouble) i / (N_POSITIONS / 2);
+      else
+        progress[i] = 1.0 - (gdouble) (i - N_POSITIONS / 2) / (N_POSITIONS / 2);
+    }
+
+  clutter_path_get_positions (path, N_POSITIONS, progress, positions, nodes);
+
+  /* the batch gives the same results as sampling each position */
+  for (i = 0; i < N_POSITIONS; i++)
+    {
+      ClutterKnot position;
+      guint node;
+
+      node = clutter_path_get_position (path, progress[i], &position);
+
+      g_assert_cmpuint (nodes[i], ==, node);
+      g_assert_cmpint (positions[i].x, ==, position.x);
+      g_assert_cmpint (positions[i].y, ==, position.y);
+    }
+
+  g_object_unref (path);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/path/sampling/line", path_sampling_line)
+  CLUTTER_TEST_UNIT ("/path/sampling/batch", path_sampling_batch)
+)
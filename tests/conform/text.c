@@ -1,6 +1,7 @@
 #include <glib.h>
 #include <clutter/clutter.h>
 #include <string.h>
+#include <math.h>
 
 typedef struct {
   gunichar   unichar;
@@ -273,6 +274,493 @@ text_get_chars (void)
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
 
+static void
+text_buffer_edits (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  ClutterTextBuffer *buffer = clutter_text_get_buffer (text);
+  GString *expected = g_string_new (NULL);
+  GRand *rand = g_rand_new_with_seed (42);
+  int i;
+
+  g_object_ref_sink (text);
+
+  /* enough edits, scattered across the buffer, to move the gap around
+   * and to need more than one entry of the offset index
+   */
+  for (i = 0; i < 2000; i++)
+    {
+      guint n_chars = g_utf8_strlen (expected->str, -1);
+      guint pos = g_rand_int_range (rand, 0, n_chars + 1);
+      gchar *chars;
+
+      if (n_chars > 0 && g_rand_int_range (rand, 0, 3) == 0)
+        {
+          guint len;
+          gsize start, end;
+
+          if (pos == n_chars)
+            pos -= 1;
+
+          len = g_rand_int_range (rand, 1, MIN (n_chars - pos, 8) + 1);
+
+          start = g_utf8_offset_to_pointer (expected->str, pos) - expected->str;
+          end = g_utf8_offset_to_pointer (expected->str, pos + len) - expected->str;
+          g_string_erase (expected, start, end - start);
+
+          clutter_text_buffer_delete_text (buffer, pos, len);
+        }
+      else
+        {
+          const TestData *t = &test_text_data[i % G_N_ELEMENTS (test_text_data)];
+          gsize at = g_utf8_offset_to_pointer (expected->str, pos) - expected->str;
+          char str[] = "ab\0\0\0";
+
+          memcpy (str + 2, t->bytes, t->nbytes);
+          g_string_insert (expected, at, str);
+
+          clutter_text_buffer_insert_text (buffer, pos, str, -1);
+        }
+
+      if (i % 100 == 0)
+        g_assert_cmpstr (clutter_text_get_text (text), ==, expected->str);
+
+      /* this maps the offsets without going through the whole text */
+      n_chars = g_utf8_strlen (expected->str, -1);
+      pos = g_rand_int_range (rand, 0, n_chars + 1);
+      chars = clutter_text_get_chars (text, pos, MIN (pos + 3, n_chars));
+      g_assert_cmpint (strncmp (chars,
+                                g_utf8_offset_to_pointer (expected->str, pos),
+                                strlen (chars)), ==, 0);
+      g_assert_cmpint (g_utf8_strlen (chars, -1), ==, MIN (pos + 3, n_chars) - pos);
+      g_free (chars);
+    }
+
+  g_assert_cmpstr (clutter_text_get_text (text), ==, expected->str);
+  g_assert_cmpint (clutter_text_buffer_get_length (buffer), ==,
+                   g_utf8_strlen (expected->str, -1));
+  g_assert_cmpint (clutter_text_buffer_get_bytes (buffer), ==, expected->len);
+
+  g_rand_free (rand);
+  g_string_free (expected, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
+static void
+text_shared_layout (void)
+{
+  ClutterText *a = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12px", "Shared"));
+  ClutterText *b = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12px", "Shared"));
+  PangoAttrList *attrs;
+  PangoLayout *layout;
+  gint width_a, width_b;
+
+  g_object_ref_sink (a);
+  g_object_ref_sink (b);
+
+  /* the public layouts of identical labels are private to each actor,
+   * and they are kept as long as the contents do not change
+   */
+  layout = clutter_text_get_layout (a);
+  g_assert (clutter_text_get_layout (b) != layout);
+  g_assert (clutter_text_get_layout (a) == layout);
+
+  pango_layout_set_text (layout, "Modified", -1);
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (b)), ==, "Shared");
+
+  clutter_text_set_text (a, "Not shared");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (a)), ==, "Not shared");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (b)), ==, "Shared");
+
+  /* modifying the attributes of a label in place does not change the
+   * layouts other labels find in the shared cache
+   */
+  clutter_text_set_text (a, "Shared");
+
+  attrs = pango_attr_list_new ();
+  clutter_text_set_attributes (a, attrs);
+  pango_layout_get_pixel_size (clutter_text_get_layout (a), &width_a, NULL);
+
+  pango_attr_list_insert (attrs, pango_attr_scale_new (PANGO_SCALE_XX_LARGE));
+  clutter_text_set_attributes (b, attrs);
+  pango_layout_get_pixel_size (clutter_text_get_layout (b), &width_b, NULL);
+
+  g_assert_cmpint (width_b, >, width_a);
+
+  pango_attr_list_unref (attrs);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (a));
+  clutter_actor_destroy (CLUTTER_ACTOR (b));
+}
+
+static void
+text_async_layout (void)
+{
+  ClutterActor *sync_text = clutter_text_new_with_text ("Sans 12px", "Measured on a thread");
+  ClutterActor *async_text = clutter_text_new_with_text ("Sans 12px", "Measured on a thread");
+  gfloat sync_width, async_width;
+  gint64 deadline;
+
+  g_object_ref_sink (sync_text);
+  g_object_ref_sink (async_text);
+
+  clutter_text_set_async_layout (CLUTTER_TEXT (async_text), TRUE);
+  g_assert (clutter_text_get_async_layout (CLUTTER_TEXT (async_text)));
+
+  clutter_actor_get_preferred_width (sync_text, -1, NULL, &sync_width);
+
+  /* the first request returns an estimate, and the actual width is
+   * available after the worker thread is done
+   */
+  clutter_actor_get_preferred_width (async_text, -1, NULL, &async_width);
+
+  deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (async_width != sync_width && g_get_monotonic_time () < deadline)
+    {
+      g_main_context_iteration (NULL, FALSE);
+      clutter_actor_get_preferred_width (async_text, -1, NULL, &async_width);
+    }
+
+  g_assert_cmpfloat (async_width, ==, sync_width);
+
+  clutter_actor_destroy (sync_text);
+  clutter_actor_destroy (async_text);
+}
+
+static void
+text_hit_test (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  PangoLayout *layout;
+  GString *str = g_string_new (NULL);
+  gint i, n_chars;
+  gfloat x, y;
+
+  g_object_ref_sink (text);
+
+  /* a long paragraph wrapping on many lines, and a few short ones */
+  for (i = 0; i < 200; i++)
+    g_string_append (str, "lorem ipsum ");
+  g_string_append (str, "\nshort\n\n\xe2\x99\xa5 heart\n");
+
+  clutter_text_set_font_name (text, "Sans 12px");
+  clutter_text_set_line_wrap (text, TRUE);
+  clutter_text_set_text (text, str->str);
+  clutter_actor_set_width (CLUTTER_ACTOR (text), 200);
+
+  layout = clutter_text_get_layout (text);
+  n_chars = g_utf8_strlen (str->str, -1);
+
+  for (i = 0; i <= n_chars; i++)
+    {
+      gint index_ = g_utf8_offset_to_pointer (str->str, i) - str->str;
+      PangoRectangle pos;
+      gfloat line_height;
+
+      pango_layout_get_cursor_pos (layout, index_, &pos, NULL);
+
+      g_assert (clutter_text_position_to_coords (text, i, &x, &y, &line_height));
+      g_assert_cmpfloat (x, ==, pos.x / 1024.0f);
+      g_assert_cmpfloat (y, ==, pos.y / 1024.0f);
+      g_assert_cmpfloat (line_height, ==, pos.height / 1024.0f);
+    }
+
+  for (y = -10; y < clutter_actor_get_height (CLUTTER_ACTOR (text)) + 10; y += 3.5f)
+    {
+      for (x = -10; x < 210; x += 7.5f)
+        {
+          gint index_, trailing;
+
+          pango_layout_xy_to_index (layout,
+                                    x * PANGO_SCALE,
+                                    y * PANGO_SCALE,
+                                    &index_, &trailing);
+
+          g_assert_cmpint (clutter_text_coords_to_position (text, x, y), ==, index_ + trailing);
+        }
+    }
+
+  g_string_free (str, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
+static void
+text_large_document (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  ClutterText *reference = CLUTTER_TEXT (clutter_text_new ());
+  GString *str = g_string_new (NULL);
+  gfloat height, reference_height;
+  gint i, n_chars;
+
+  g_object_ref_sink (text);
+  g_object_ref_sink (reference);
+
+  for (i = 0; i < 300; i++)
+    g_string_append_printf (str, "line %d of the \xe2\x99\xa5 log\n", i);
+
+  clutter_text_set_font_name (reference, "Sans 12px");
+  clutter_text_set_text (reference, str->str);
+
+  clutter_text_set_font_name (text, "Sans 12px");
+  clutter_text_set_large_document (text, TRUE);
+  clutter_text_set_text (text, str->str);
+  g_assert (clutter_text_get_large_document (text));
+
+  /* the height is estimated until the paragraphs are laid out */
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), -1, NULL, &height);
+  g_assert_cmpfloat (height, >, 0);
+
+  /* walking the text in order lays out each paragraph before the
+   * following ones are used, so the positions are exact
+   */
+  n_chars = g_utf8_strlen (str->str, -1);
+  for (i = 0; i <= n_chars; i++)
+    {
+      gfloat x, y, line_height;
+      gfloat ref_x, ref_y, ref_line_height;
+
+      g_assert (clutter_text_position_to_coords (text, i, &x, &y, &line_height));
+      g_assert (clutter_text_position_to_coords (reference, i, &ref_x, &ref_y, &ref_line_height));
+
+      g_assert_cmpfloat (x, ==, ref_x);
+      g_assert_cmpfloat (y, ==, ref_y);
+      g_assert_cmpfloat (line_height, ==, ref_line_height);
+
+      g_assert_cmpint (clutter_text_coords_to_position (text, x + 1, y + 1),
+                       ==,
+                       clutter_text_coords_to_position (reference, ref_x + 1, ref_y + 1));
+    }
+
+  /* once every paragraph has been measured, the height is exact */
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (text), -1, NULL, &height);
+  clutter_actor_get_preferred_height (CLUTTER_ACTOR (reference), -1, NULL, &reference_height);
+  g_assert_cmpfloat (height, ==, reference_height);
+
+  g_string_free (str, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (reference));
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
+static void
+text_large_document_width (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  ClutterText *reference = CLUTTER_TEXT (clutter_text_new ());
+  GString *str = g_string_new (NULL);
+  gfloat width, reference_width;
+  gint i, n_chars;
+
+  g_object_ref_sink (text);
+  g_object_ref_sink (reference);
+
+  /* narrow characters, so that the estimated width of each paragraph
+   * is larger than the measured one
+   */
+  for (i = 0; i < 100; i++)
+    g_string_append (str, "iiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiiii\n");
+
+  clutter_text_set_font_name (reference, "Sans 12px");
+  clutter_text_set_text (reference, str->str);
+
+  clutter_text_set_font_name (text, "Sans 12px");
+  clutter_text_set_large_document (text, TRUE);
+  clutter_text_set_text (text, str->str);
+
+  n_chars = g_utf8_strlen (str->str, -1);
+  for (i = 0; i <= n_chars; i++)
+    {
+      gfloat x, y, line_height;
+
+      g_assert (clutter_text_position_to_coords (text, i, &x, &y, &line_height));
+    }
+
+  /* once every paragraph has been measured, the width shrinks to the
+   * width of the widest one
+   */
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (text), -1, NULL, &width);
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (reference), -1, NULL, &reference_width);
+  g_assert_cmpfloat (width, ==, reference_width);
+
+  g_string_free (str, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (reference));
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
+#define COLOR_DURATION  200
+
+typedef struct {
+  GMainLoop *main_loop;
+  ClutterText *text;
+  PangoLayout *layout;
+  guint n_frames;
+} ColorAnimationData;
+
+static void
+on_color_after_paint (ClutterActor       *stage,
+                      ColorAnimationData *data)
+{
+  /* the layout, and the glyphs CoglPango keeps on it, is the same
+   * on every frame of the animation
+   */
+  g_assert (clutter_text_get_layout (data->text) == data->layout);
+
+  data->n_frames += 1;
+}
+
+static void
+on_color_transition_stopped (ClutterActor       *actor,
+                             const gchar        *name,
+                             gboolean            is_finished,
+                             ColorAnimationData *data)
+{
+  g_main_loop_quit (data->main_loop);
+}
+
+static void
+text_color_animation (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ColorAnimationData data = { NULL, };
+  ClutterColor color;
+  gulong after_paint_id;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  data.text = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12px", "Fading"));
+  clutter_text_set_color (data.text, CLUTTER_COLOR_Black);
+  clutter_actor_add_child (stage, CLUTTER_ACTOR (data.text));
+
+  clutter_actor_show (stage);
+
+  data.layout = clutter_text_get_layout (data.text);
+
+  clutter_actor_save_easing_state (CLUTTER_ACTOR (data.text));
+  clutter_actor_set_easing_duration (CLUTTER_ACTOR (data.text), COLOR_DURATION);
+  clutter_actor_set_easing_mode (CLUTTER_ACTOR (data.text), CLUTTER_LINEAR);
+  clutter_text_set_color (data.text, CLUTTER_COLOR_Red);
+  clutter_actor_restore_easing_state (CLUTTER_ACTOR (data.text));
+
+  g_signal_connect (data.text, "transition-stopped::color",
+                    G_CALLBACK (on_color_transition_stopped),
+                    &data);
+  after_paint_id = g_signal_connect (stage, "after-paint",
+                                     G_CALLBACK (on_color_after_paint),
+                                     &data);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_frames, >, 1);
+  g_assert (clutter_text_get_layout (data.text) == data.layout);
+
+  clutter_text_get_color (data.text, &color);
+  g_assert (clutter_color_equal (&color, CLUTTER_COLOR_Red));
+
+  g_signal_handler_disconnect (stage, after_paint_id);
+
+  clutter_actor_destroy (CLUTTER_ACTOR (data.text));
+  g_main_loop_unref (data.main_loop);
+}
+
+#define VIEW_WIDTH      200
+#define VIEW_HEIGHT     100
+
+static gboolean
+has_dark_pixel (const guchar *pixels,
+                gint          y_1,
+                gint          y_2)
+{
+  gint x, y;
+
+  for (y = MAX (y_1, 0); y < MIN (y_2, VIEW_HEIGHT); y++)
+    {
+      for (x = 0; x < VIEW_WIDTH; x++)
+        {
+          if (pixels[(y * VIEW_WIDTH + x) * 4] < 128)
+            return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static void
+text_visible_lines (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *view, *text;
+  GString *str = g_string_new (NULL);
+  gfloat scroll_offsets[3];
+  guint n_lines = 200;
+  guint i;
+
+  for (i = 0; i < n_lines; i++)
+    g_string_append (str, "MMMMMMMM\n");
+
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_White);
+
+  /* a long label scrolled inside a clipped parent only paints the
+   * lines intersecting the clip
+   */
+  view = clutter_actor_new ();
+  clutter_actor_set_position (view, 10, 10);
+  clutter_actor_set_size (view, VIEW_WIDTH, VIEW_HEIGHT);
+  clutter_actor_set_clip_to_allocation (view, TRUE);
+  clutter_actor_add_child (stage, view);
+
+  text = clutter_text_new_with_text ("Sans 12px", str->str);
+  clutter_text_set_color (CLUTTER_TEXT (text), CLUTTER_COLOR_Black);
+  clutter_actor_add_child (view, text);
+
+  clutter_actor_show (stage);
+
+  scroll_offsets[0] = 0;
+  scroll_offsets[1] = clutter_actor_get_height (text) / 2 + 3.5f;
+  scroll_offsets[2] = clutter_actor_get_height (text) - VIEW_HEIGHT - 3.5f;
+
+  for (i = 0; i < G_N_ELEMENTS (scroll_offsets); i++)
+    {
+      gfloat scroll = scroll_offsets[i];
+      guint n_checked = 0;
+      guchar *pixels;
+      guint line;
+
+      clutter_actor_set_y (text, -scroll);
+
+      /* reading the pixels paints the stage */
+      pixels = clutter_stage_read_pixels (CLUTTER_STAGE (stage),
+                                          10, 10,
+                                          VIEW_WIDTH, VIEW_HEIGHT);
+
+      for (line = 0; line < n_lines; line++)
+        {
+          gfloat x, y, line_height;
+          gint y_1, y_2;
+
+          g_assert (clutter_text_position_to_coords (CLUTTER_TEXT (text),
+                                                     line * 9,
+                                                     &x, &y, &line_height));
+
+          /* the middle of the glyphs of the line, in the parent */
+          y_1 = floorf (y - scroll + line_height * 0.35f);
+          y_2 = ceilf (y - scroll + line_height * 0.7f);
+
+          if (y_1 < 0 || y_2 > VIEW_HEIGHT)
+            continue;
+
+          g_assert (has_dark_pixel (pixels, y_1, y_2));
+          n_checked += 1;
+        }
+
+      g_assert_cmpuint (n_checked, >, 3);
+
+      g_free (pixels);
+    }
+
+  g_string_free (str, TRUE);
+  clutter_actor_destroy (view);
+}
+
 static void
 text_delete_text (void)
 {
@@ -478,6 +966,115 @@ validate_markup_attributes (ClutterText   *text,
   pango_attr_iterator_destroy (iter);
 }
 
+static void
+check_large_document_positions (ClutterText *text,
+                                ClutterText *reference)
+{
+  gint i, n_chars;
+
+  g_assert_cmpstr (clutter_text_get_text (text), ==, clutter_text_get_text (reference));
+
+  n_chars = clutter_text_buffer_get_length (clutter_text_get_buffer (reference));
+  for (i = 0; i <= n_chars; i++)
+    {
+      gfloat x, y, line_height;
+      gfloat ref_x, ref_y, ref_line_height;
+
+      g_assert (clutter_text_position_to_coords (text, i, &x, &y, &line_height));
+      g_assert (clutter_text_position_to_coords (reference, i, &ref_x, &ref_y, &ref_line_height));
+
+      g_assert_cmpfloat (x, ==, ref_x);
+      g_assert_cmpfloat (y, ==, ref_y);
+    }
+}
+
+static void
+text_large_document_edit (void)
+{
+  ClutterText *text = CLUTTER_TEXT (clutter_text_new ());
+  ClutterText *reference = CLUTTER_TEXT (clutter_text_new ());
+  ClutterText *texts[2] = { text, reference };
+  GString *str = g_string_new (NULL);
+  gint i, j;
+
+  g_object_ref_sink (text);
+  g_object_ref_sink (reference);
+
+  for (i = 0; i < 50; i++)
+    g_string_append_printf (str, "line %d of the \xe2\x99\xa5 log\n", i);
+
+  clutter_text_set_large_document (text, TRUE);
+
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    {
+      clutter_text_set_font_name (texts[j], "Sans 12px");
+      clutter_text_set_editable (texts[j], TRUE);
+      clutter_text_set_text (texts[j], str->str);
+    }
+
+  check_large_document_positions (text, reference);
+
+  /* inserting text without a separator only changes one paragraph */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    clutter_text_insert_text (texts[j], "\xe2\x99\xa5 more", 100);
+
+  check_large_document_positions (text, reference);
+
+  /* inserting separators splits a paragraph, and moves the following
+   * ones down
+   */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    clutter_text_insert_text (texts[j], "split\nin\nthree", 200);
+
+  check_large_document_positions (text, reference);
+
+  /* deleting text spanning several paragraphs merges them */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    clutter_text_delete_text (texts[j], 150, 400);
+
+  check_large_document_positions (text, reference);
+
+  /* so does deleting a single separator */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    clutter_text_delete_text (texts[j], 20, 21);
+
+  check_large_document_positions (text, reference);
+
+  /* editing at the end of the text */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    {
+      gint n_chars = clutter_text_buffer_get_length (clutter_text_get_buffer (texts[j]));
+
+      clutter_text_insert_text (texts[j], "last\n", n_chars);
+      clutter_text_delete_text (texts[j], 0, 5);
+    }
+
+  check_large_document_positions (text, reference);
+
+  /* moving the cursor up and down crosses the paragraphs, and typing
+   * edits the paragraph of the cursor
+   */
+  for (j = 0; j < G_N_ELEMENTS (texts); j++)
+    {
+      clutter_text_set_cursor_position (texts[j], 30);
+
+      for (i = 0; i < 3; i++)
+        send_keyval (texts[j], CLUTTER_KEY_Down);
+
+      send_keyval (texts[j], CLUTTER_KEY_Up);
+      send_unichar (texts[j], 'x');
+    }
+
+  g_assert_cmpint (clutter_text_get_cursor_position (text), ==,
+                   clutter_text_get_cursor_position (reference));
+
+  check_large_document_positions (text, reference);
+
+  g_string_free (str, TRUE);
+  clutter_actor_destroy (CLUTTER_ACTOR (reference));
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+}
+
 static void
 text_idempotent_use_markup (void)
 {
@@ -543,6 +1140,15 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/delete-chars", text_delete_chars)
   CLUTTER_TEST_UNIT ("/text/get-chars", text_get_chars)
   CLUTTER_TEST_UNIT ("/text/delete-text", text_delete_text)
+  CLUTTER_TEST_UNIT ("/text/buffer-edits", text_buffer_edits)
+  CLUTTER_TEST_UNIT ("/text/shared-layout", text_shared_layout)
+  CLUTTER_TEST_UNIT ("/text/async-layout", text_async_layout)
+  CLUTTER_TEST_UNIT ("/text/hit-test", text_hit_test)
+  CLUTTER_TEST_UNIT ("/text/large-document", text_large_document)
+  CLUTTER_TEST_UNIT ("/text/large-document-width", text_large_document_width)
+  CLUTTER_TEST_UNIT ("/text/large-document-edit", text_large_document_edit)
+  CLUTTER_TEST_UNIT ("/text/visible-lines", text_visible_lines)
+  CLUTTER_TEST_UNIT ("/text/color-animation", text_color_animation)
   CLUTTER_TEST_UNIT ("/text/password-char", text_password_char)
   CLUTTER_TEST_UNIT ("/text/cursor", text_cursor)
   CLUTTER_TEST_UNIT ("/text/event", text_event)
@@ -0,0 +1,135 @@
+#include <clutter/clutter.h>
+
+typedef struct {
+  GMainLoop *main_loop;
+
+  /* the delays of the timelines, in the order they started */
+  GArray *started;
+  guint n_expected;
+} DelayData;
+
+static void
+on_started (ClutterTimeline *timeline,
+            DelayData       *data)
+{
+  guint delay = clutter_timeline_get_delay (timeline);
+
+  g_array_append_val (data->started, delay);
+
+  if (data->started->len == data->n_expected)
+    g_main_loop_quit (data->main_loop);
+}
+
+static ClutterTimeline *
+add_delayed_timeline (DelayData *data,
+                      guint      delay)
+{
+  ClutterTimeline *timeline = clutter_timeline_new (1);
+
+  clutter_timeline_set_delay (timeline, delay);
+  g_signal_connect (timeline, "started", G_CALLBACK (on_started), data);
+
+  return timeline;
+}
+
+static void
+timeline_delay_order (void)
+{
+  /* out of order, so that the queue has to be reordered */
+  const guint delays[] = { 50, 10, 40, 20, 60, 30 };
+  ClutterTimeline *timelines[G_N_ELEMENTS (delays)];
+  DelayData data = { NULL, };
+  guint i;
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+  data.started = g_array_new (FALSE, FALSE, sizeof (guint));
+  data.n_expected = G_N_ELEMENTS (delays);
+
+  for (i = 0; i < G_N_ELEMENTS (delays); i++)
+    {
+      timelines[i] = add_delayed_timeline (&data, delays[i]);
+      clutter_timeline_start (timelines[i]);
+    }
+
+  g_main_loop_run (data.main_loop);
+
+  /* each timeline starts once, in the order of its delay */
+  g_assert_cmpuint (data.started->len, ==, G_N_ELEMENTS (delays));
+
+  for (i = 1; i < data.started->len; i++)
+    g_assert_cmpuint (g_array_index (data.started, guint, i - 1), <,
+                      g_array_index (data.started, guint, i));
+
+  for (i = 0; i < G_N_ELEMENTS (delays); i++)
+    g_object_unref (timelines[i]);
+
+  g_array_unref (data.started);
+  g_main_loop_unref (data.main_loop);
+}
+
+static void
+timeline_delay_remove (void)
+{
+  ClutterTimeline *first, *stopped, *paused, *disposed, *last;
+  DelayData data = { NULL, };
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+  data.started = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  first = add_delayed_timeline (&data, 10);
+  stopped = add_delayed_timeline (&data, 20);
+  paused = add_delayed_timeline (&data, 30);
+  disposed = add_delayed_timeline (&data, 40);
+  last = add_delayed_timeline (&data, 50);
+
+  clutter_timeline_start (last);
+  clutter_timeline_start (disposed);
+  clutter_timeline_start (paused);
+  clutter_timeline_start (stopped);
+  clutter_timeline_start (first);
+
+  /* remove the timelines from the middle of the queue while their
+   * delay is still pending
+   */
+  clutter_timeline_stop (stopped);
+  clutter_timeline_pause (paused);
+  g_object_unref (disposed);
+
+  g_assert (!clutter_timeline_is_playing (stopped));
+  g_assert (!clutter_timeline_is_playing (paused));
+
+  data.n_expected = 2;
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.started->len, ==, 2);
+  g_assert_cmpuint (g_array_index (data.started, guint, 0), ==, 10);
+  g_assert_cmpuint (g_array_index (data.started, guint, 1), ==, 50);
+
+  /* a stopped timeline waits for its whole delay again */
+  g_array_set_size (data.started, 0);
+
+  clutter_timeline_set_delay (stopped, 30);
+  clutter_timeline_set_delay (last, 10);
+  clutter_timeline_stop (last);
+
+  clutter_timeline_start (stopped);
+  clutter_timeline_start (last);
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (g_array_index (data.started, guint, 0), ==, 10);
+  g_assert_cmpuint (g_array_index (data.started, guint, 1), ==, 30);
+
+  g_object_unref (first);
+  g_object_unref (stopped);
+  g_object_unref (paused);
+  g_object_unref (last);
+
+  g_array_unref (data.started);
+  g_main_loop_unref (data.main_loop);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/delay/order", timeline_delay_order)
+  CLUTTER_TEST_UNIT ("/timeline/delay/remove", timeline_delay_remove)
+)
@@ -0,0 +1,137 @@
+#include <string.h>
+#include <clutter/clutter.h>
+
+#define N_MARKERS       200
+
+typedef struct {
+  GMainLoop *main_loop;
+  guint n_reached;
+  gint last_msecs;
+  gboolean seen[N_MARKERS];
+} MarkersData;
+
+static void
+on_marker_reached (ClutterTimeline *timeline,
+                   const gchar     *marker_name,
+                   gint             msecs,
+                   MarkersData     *data)
+{
+  guint index_;
+
+  g_assert (g_str_has_prefix (marker_name, "marker-"));
+
+  index_ = g_ascii_strtoull (marker_name + strlen ("marker-"), NULL, 10);
+  g_assert_cmpuint (index_, <, N_MARKERS);
+
+  /* each marker is reached once, in order */
+  g_assert (!data->seen[index_]);
+  g_assert_cmpint (msecs, >=, data->last_msecs);
+
+  data->seen[index_] = TRUE;
+  data->last_msecs = msecs;
+  data->n_reached += 1;
+}
+
+static void
+on_completed (ClutterTimeline *timeline,
+              MarkersData     *data)
+{
+  g_main_loop_quit (data->main_loop);
+}
+
+static void
+timeline_markers_reached (void)
+{
+  ClutterTimeline *timeline;
+  MarkersData data = { NULL, };
+  guint i;
+
+  timeline = clutter_timeline_new (400);
+
+  /* add the markers out of order, with some of them sharing a position */
+  for (i = 0; i < N_MARKERS; i++)
+    {
+      gchar *name = g_strdup_printf ("marker-%u", i);
+
+      clutter_timeline_add_marker_at_time (timeline, name, (i % 100) * 4);
+      g_free (name);
+    }
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+  data.last_msecs = -1;
+
+  g_signal_connect (timeline, "marker-reached",
+                    G_CALLBACK (on_marker_reached),
+                    &data);
+  g_signal_connect (timeline, "completed",
+                    G_CALLBACK (on_completed),
+                    &data);
+
+  clutter_timeline_start (timeline);
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpuint (data.n_reached, ==, N_MARKERS);
+
+  g_main_loop_unref (data.main_loop);
+  g_object_unref (timeline);
+}
+
+static void
+timeline_markers_list (void)
+{
+  ClutterTimeline *timeline;
+  gchar **markers;
+  gsize n_markers;
+
+  timeline = clutter_timeline_new (1000);
+
+  clutter_timeline_add_marker_at_time (timeline, "absolute", 500);
+  clutter_timeline_add_marker (timeline, "relative", 0.25);
+  clutter_timeline_add_marker_at_time (timeline, "start", 0);
+  clutter_timeline_add_marker_at_time (timeline, "end", 1000);
+
+  /* all the markers are returned in time order */
+  markers = clutter_timeline_list_markers (timeline, -1, &n_markers);
+  g_assert_cmpuint (n_markers, ==, 4);
+  g_assert_cmpstr (markers[0], ==, "start");
+  g_assert_cmpstr (markers[1], ==, "relative");
+  g_assert_cmpstr (markers[2], ==, "absolute");
+  g_assert_cmpstr (markers[3], ==, "end");
+  g_assert (markers[4] == NULL);
+  g_strfreev (markers);
+
+  /* relative markers follow the duration */
+  clutter_timeline_set_duration (timeline, 4000);
+
+  markers = clutter_timeline_list_markers (timeline, 1000, &n_markers);
+  g_assert_cmpuint (n_markers, ==, 2);
+  g_assert_cmpstr (markers[0], ==, "relative");
+  g_assert_cmpstr (markers[1], ==, "end");
+  g_strfreev (markers);
+
+  markers = clutter_timeline_list_markers (timeline, -1, &n_markers);
+  g_assert_cmpuint (n_markers, ==, 4);
+  g_assert_cmpstr (markers[1], ==, "absolute");
+  g_assert_cmpstr (markers[2], ==, "relative");
+  g_strfreev (markers);
+
+  clutter_timeline_remove_marker (timeline, "relative");
+  g_assert (!clutter_timeline_has_marker (timeline, "relative"));
+
+  markers = clutter_timeline_list_markers (timeline, 1000, &n_markers);
+  g_assert_cmpuint (n_markers, ==, 1);
+  g_assert_cmpstr (markers[0], ==, "end");
+  g_strfreev (markers);
+
+  markers = clutter_timeline_list_markers (timeline, 10, &n_markers);
+  g_assert_cmpuint (n_markers, ==, 0);
+  g_assert (markers != NULL && markers[0] == NULL);
+  g_strfreev (markers);
+
+  g_object_unref (timeline);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/markers/reached", timeline_markers_reached)
+  CLUTTER_TEST_UNIT ("/timeline/markers/list", timeline_markers_list)
+)
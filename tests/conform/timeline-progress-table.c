@@ -0,0 +1,101 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+#define DURATION        10000
+
+static void
+assert_progress_close (ClutterTimeline *exact,
+                       ClutterTimeline *table,
+                       gdouble          tolerance)
+{
+  guint msecs;
+
+  for (msecs = 0; msecs <= DURATION; msecs++)
+    {
+      gdouble a, b;
+
+      clutter_timeline_advance (exact, msecs);
+      clutter_timeline_advance (table, msecs);
+
+      a = clutter_timeline_get_progress (exact);
+      b = clutter_timeline_get_progress (table);
+
+      if (fabs (a - b) > tolerance)
+        g_error ("mode %d at %u ms: exact %g, table %g",
+                 clutter_timeline_get_progress_mode (exact),
+                 msecs, a, b);
+    }
+}
+
+static void
+timeline_progress_table_modes (void)
+{
+  GEnumClass *enum_class = g_type_class_ref (CLUTTER_TYPE_ANIMATION_MODE);
+  guint i;
+
+  for (i = 0; i < enum_class->n_values; i++)
+    {
+      ClutterAnimationMode mode = enum_class->values[i].value;
+      ClutterTimeline *exact, *table;
+
+      if (mode == CLUTTER_CUSTOM_MODE || mode >= CLUTTER_ANIMATION_LAST)
+        continue;
+
+      exact = clutter_timeline_new (DURATION);
+      clutter_timeline_set_progress_mode (exact, mode);
+
+      table = clutter_timeline_new (DURATION);
+      clutter_timeline_set_progress_mode (table, mode);
+      clutter_timeline_set_use_progress_table (table, TRUE);
+      g_assert (clutter_timeline_get_use_progress_table (table));
+
+      /* the tables reproduce the curves within a thousandth, allowing
+       * for the single precision of the samples
+       */
+      assert_progress_close (exact, table, 1e-3 + 1e-6);
+
+      g_object_unref (exact);
+      g_object_unref (table);
+    }
+
+  g_type_class_unref (enum_class);
+}
+
+static void
+timeline_progress_table_cubic_bezier (void)
+{
+  const ClutterPoint curves[][2] = {
+    { CLUTTER_POINT_INIT (0.1f, 0.7f), CLUTTER_POINT_INIT (1.0f, 0.1f) },
+    { CLUTTER_POINT_INIT (0.68f, -0.55f), CLUTTER_POINT_INIT (0.265f, 1.55f) },
+    /* too steep at the start to be tabulated */
+    { CLUTTER_POINT_INIT (0.0f, 1.0f), CLUTTER_POINT_INIT (0.0f, 1.0f) },
+  };
+  ClutterTimeline *exact, *table;
+  guint i;
+
+  exact = clutter_timeline_new (DURATION);
+
+  table = clutter_timeline_new (DURATION);
+  clutter_timeline_set_use_progress_table (table, TRUE);
+
+  for (i = 0; i < G_N_ELEMENTS (curves); i++)
+    {
+      clutter_timeline_set_cubic_bezier_progress (exact, &curves[i][0], &curves[i][1]);
+      clutter_timeline_set_cubic_bezier_progress (table, &curves[i][0], &curves[i][1]);
+
+      assert_progress_close (exact, table, 1e-3 + 1e-6);
+    }
+
+  /* the steps are always evaluated */
+  clutter_timeline_set_step_progress (exact, 7, CLUTTER_STEP_MODE_START);
+  clutter_timeline_set_step_progress (table, 7, CLUTTER_STEP_MODE_START);
+  assert_progress_close (exact, table, 0.0);
+
+  g_object_unref (exact);
+  g_object_unref (table);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/timeline/progress-table/modes", timeline_progress_table_modes)
+  CLUTTER_TEST_UNIT ("/timeline/progress-table/cubic-bezier", timeline_progress_table_cubic_bezier)
+)
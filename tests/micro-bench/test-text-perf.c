@@ -10,6 +10,10 @@ static int font_size;
 static int n_chars;
 static int rows, cols;
 
+/* the editable actor used by the "edit" benchmark */
+static ClutterText *edit_text = NULL;
+static int n_edits;
+
 static void
 on_paint (ClutterActor *actor, gconstpointer *data)
 {
@@ -24,12 +28,19 @@ on_paint (ClutterActor *actor, gconstpointer *data)
 
   if (g_timer_elapsed (timer, NULL) >= 1)
     {
-      printf ("fps=%d, strings/sec=%d, chars/sec=%d\n",
-	      fps,
-	      fps * rows * cols,
-	      fps * rows * cols * n_chars);
+      if (edit_text != NULL)
+        printf ("fps=%d, edits/sec=%d, buffer=%d bytes\n",
+                fps,
+                n_edits,
+                (int) strlen (clutter_text_get_text (edit_text)));
+      else
+        printf ("fps=%d, strings/sec=%d, chars/sec=%d\n",
+                fps,
+                fps * rows * cols,
+                fps * rows * cols * n_chars);
       g_timer_start (timer);
       fps = 0;
+      n_edits = 0;
     }
 
   ++fps;
@@ -77,6 +88,150 @@ get_character (int ch)
   return ch + ranges[i].first_letter;
 }
 
+/* types one character in the middle of the buffer and deletes it again
+ * on the following frame, like a user typing in a large text area; the
+ * cursor is at the edit point, so the cursor position has to be mapped
+ * on the layout as well
+ */
+static gboolean
+edit_text_idle (gpointer data)
+{
+  static gboolean insert = TRUE;
+  gint pos = clutter_text_buffer_get_length (clutter_text_get_buffer (edit_text)) / 2;
+
+  clutter_text_set_cursor_position (edit_text, pos);
+
+  if (insert)
+    clutter_text_insert_unichar (edit_text, 'x');
+  else
+    clutter_text_delete_chars (edit_text, 1);
+
+  insert = !insert;
+  n_edits += 1;
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* lines of 79 characters, like a log file */
+static GString *
+create_lines (int  n_bytes,
+              int *n_lines)
+{
+  GString *str;
+  int line;
+
+  str = g_string_sized_new (n_bytes + 80);
+  for (line = 0; str->len < n_bytes; line++)
+    {
+      int i;
+
+      for (i = 0; i < 79; i++)
+        g_string_append_unichar (str, get_character (line + i));
+
+      g_string_append_c (str, '\n');
+    }
+
+  *n_lines = line;
+
+  return str;
+}
+
+static int
+run_edit_benchmark (ClutterActor *stage,
+                    int           n_bytes)
+{
+  ClutterColor text_color = { 0xff, 0xff, 0xff, 0xff };
+  ClutterActor *text;
+  char *font_name;
+  GString *str;
+  int n_lines;
+
+  str = create_lines (n_bytes, &n_lines);
+
+  g_print ("Monospace %dpx, editing %d lines (%d bytes)\n",
+           font_size, n_lines, (int) str->len);
+
+  font_name = g_strdup_printf ("Monospace %dpx", font_size);
+  text = clutter_text_new_full (font_name, str->str, &text_color);
+  clutter_text_set_editable (CLUTTER_TEXT (text), TRUE);
+  clutter_text_set_line_wrap (CLUTTER_TEXT (text), TRUE);
+  clutter_actor_set_width (text, STAGE_WIDTH);
+  clutter_actor_add_child (stage, text);
+  clutter_stage_set_key_focus (CLUTTER_STAGE (stage), text);
+
+  edit_text = CLUTTER_TEXT (text);
+
+  g_free (font_name);
+  g_string_free (str, TRUE);
+
+  clutter_actor_show (stage);
+
+  clutter_threads_add_idle (edit_text_idle, NULL);
+
+  clutter_main ();
+
+  return 0;
+}
+
+/* scrolls a long text inside a viewport that only shows a page of
+ * it; the time it takes to paint a frame should only depend on the
+ * size of the viewport, and not on the length of the text
+ */
+static gboolean
+scroll_text_idle (gpointer data)
+{
+  ClutterActor *scroll = data;
+  ClutterActor *text = clutter_actor_get_first_child (scroll);
+  static float y = 0.f;
+  ClutterPoint point;
+
+  y += 7.f;
+  if (y > clutter_actor_get_height (text) - STAGE_HEIGHT)
+    y = 0.f;
+
+  clutter_point_init (&point, 0.f, y);
+  clutter_scroll_actor_scroll_to_point (CLUTTER_SCROLL_ACTOR (scroll), &point);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static int
+run_scroll_benchmark (ClutterActor *stage,
+                      int           n_bytes)
+{
+  ClutterColor text_color = { 0xff, 0xff, 0xff, 0xff };
+  ClutterActor *scroll, *text;
+  char *font_name;
+  GString *str;
+  int n_lines;
+
+  str = create_lines (n_bytes, &n_lines);
+
+  g_print ("Monospace %dpx, scrolling %d lines (%d bytes)\n",
+           font_size, n_lines, (int) str->len);
+
+  scroll = clutter_scroll_actor_new ();
+  clutter_scroll_actor_set_scroll_mode (CLUTTER_SCROLL_ACTOR (scroll),
+                                        CLUTTER_SCROLL_VERTICALLY);
+  clutter_actor_set_size (scroll, STAGE_WIDTH, STAGE_HEIGHT);
+  clutter_actor_add_child (stage, scroll);
+
+  font_name = g_strdup_printf ("Monospace %dpx", font_size);
+  text = clutter_text_new_full (font_name, str->str, &text_color);
+  clutter_actor_add_child (scroll, text);
+
+  g_free (font_name);
+  g_string_free (str, TRUE);
+
+  clutter_actor_show (stage);
+
+  clutter_threads_add_idle (scroll_text_idle, scroll);
+
+  clutter_main ();
+
+  return 0;
+}
+
 static ClutterActor *
 create_label (void)
 {
@@ -116,17 +271,25 @@ main (int argc, char *argv[])
   if (clutter_init (&argc, &argv) != CLUTTER_INIT_SUCCESS)
     return 1;
 
-  if (argc != 3)
+  if (argc == 4 &&
+      (strcmp (argv[1], "--edit") == 0 || strcmp (argv[1], "--scroll") == 0))
     {
-      g_printerr ("Usage test-text-perf FONT_SIZE N_CHARS\n");
+      font_size = atoi (argv[2]);
+      n_chars = atoi (argv[3]);
+    }
+  else if (argc == 3)
+    {
+      font_size = atoi (argv[1]);
+      n_chars = atoi (argv[2]);
+    }
+  else
+    {
+      g_printerr ("Usage test-text-perf FONT_SIZE N_CHARS\n"
+                  "      test-text-perf --edit FONT_SIZE N_BYTES\n"
+                  "      test-text-perf --scroll FONT_SIZE N_BYTES\n");
       exit (1);
     }
 
-  font_size = atoi (argv[1]);
-  n_chars = atoi (argv[2]);
-
-  g_print ("Monospace %dpx, string length = %d\n", font_size, n_chars);
-
   stage = clutter_stage_new ();
   clutter_actor_set_size (stage, STAGE_WIDTH, STAGE_HEIGHT);
   clutter_stage_set_color (CLUTTER_STAGE (stage), CLUTTER_COLOR_Black);
@@ -134,6 +297,14 @@ main (int argc, char *argv[])
 
   g_signal_connect (stage, "paint", G_CALLBACK (on_paint), NULL);
 
+  if (argc == 4 && strcmp (argv[1], "--edit") == 0)
+    return run_edit_benchmark (stage, n_chars);
+
+  if (argc == 4)
+    return run_scroll_benchmark (stage, n_chars);
+
+  g_print ("Monospace %dpx, string length = %d\n", font_size, n_chars);
+
   label = create_label ();
   w = clutter_actor_get_width (label);
   h = clutter_actor_get_height (label);